@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+"""
+Native Kernel Benchmarks
+
+Measures the native engine (meshmind._native) on synthetic inputs, so the
+numbers quoted for its kernels can be reproduced on any machine:
+
+- meshcnn: MeshCNN feature extraction, float vs INT8
+- icp: ICP pose refinement, time per pose and residual rotation error
+- morton: normals and FPFH on surface samples in draw order vs Morton order
+
+The native engine uses every core; for single-core figures run under
+`taskset -c 0`. Results are printed and optionally written as JSON.
+"""
+
+import argparse
+import json
+import tempfile
+import time
+from pathlib import Path
+
+import numpy as np
+import trimesh
+
+from meshmind import _native
+
+
+def best_of(repeats, fn):
+    """Best wall time of fn() over repeats runs, after one warm-up run."""
+    fn()
+    times = []
+    for _ in range(repeats):
+        start = time.perf_counter()
+        fn()
+        times.append(time.perf_counter() - start)
+    return min(times)
+
+
+def random_meshcnn_state(rng, dims=(3, 64, 128, 256)):
+    """SimplifiedMeshCNN feature layers with random weights, as NumPy arrays."""
+    state = {}
+    for layer, (in_dim, out_dim) in enumerate(zip(dims[:-1], dims[1:]), start=1):
+        state[f"fc{layer}.weight"] = rng.normal(0, 1 / np.sqrt(in_dim), (out_dim, in_dim))
+        state[f"fc{layer}.bias"] = rng.normal(0, 0.1, out_dim)
+        state[f"bn{layer}.weight"] = rng.uniform(0.5, 1.5, out_dim)
+        state[f"bn{layer}.bias"] = rng.normal(0, 0.1, out_dim)
+        state[f"bn{layer}.running_mean"] = rng.normal(0, 0.1, out_dim)
+        state[f"bn{layer}.running_var"] = rng.uniform(0.5, 1.5, out_dim)
+    return state
+
+
+def bench_meshcnn(args, rng):
+    """MeshCNN features of args.meshes vertex sets, float and INT8 weights."""
+    from meshmind.ml.models.meshcnn import export_native_weights, calibrate_input_scales
+
+    state = random_meshcnn_state(rng)
+    meshes = [rng.normal(0, 1, (args.vertices, 3)) for _ in range(args.meshes)]
+    scales = calibrate_input_scales(state, meshes[:32])
+
+    with tempfile.TemporaryDirectory() as tmp:
+        float_path, int8_path = Path(tmp) / "float.mmnn", Path(tmp) / "int8.mmnn"
+        export_native_weights(state, float_path)
+        export_native_weights(state, int8_path, input_scales=scales)
+        float_model = _native.MeshCNN(str(float_path))
+        int8_model = _native.MeshCNN(str(int8_path))
+
+    float_seconds = best_of(args.repeats, lambda: float_model.extract_batch(meshes))
+    int8_seconds = best_of(args.repeats, lambda: int8_model.extract_batch(meshes))
+
+    a, b = float_model.extract_batch(meshes), int8_model.extract_batch(meshes)
+    cosine = np.sum(a * b, axis=1) / (np.linalg.norm(a, axis=1) * np.linalg.norm(b, axis=1) + 1e-12)
+
+    return {
+        "meshes": args.meshes,
+        "vertices": args.vertices,
+        "kernels": int8_model.kernels,
+        "float_seconds": float_seconds,
+        "int8_seconds": int8_seconds,
+        "speedup": float_seconds / int8_seconds,
+        "mean_cosine": float(np.mean(cosine)),
+    }
+
+
+def rotation_error_degrees(a, b):
+    """Angle between the rotations of two 4x4 poses."""
+    cos_angle = (np.trace(a[:3, :3].T @ b[:3, :3]) - 1.0) / 2.0
+    return float(np.degrees(np.arccos(np.clip(cos_angle, -1.0, 1.0))))
+
+
+def bench_icp(args, rng):
+    """ICP refinement of args.poses poses perturbed by 3-11 degrees and 2% translation."""
+    from meshmind.core.recognition.fpfh_matcher import FPFHFeatureDetector
+
+    template = trimesh.creation.torus(0.3, 0.1)
+    template.apply_transform(trimesh.transformations.rotation_matrix(0.4, (1.0, 0.0, 0.0)))
+    body = trimesh.creation.box(extents=(4.0, 2.0, 1.0))
+    placed = template.copy()
+    truth = trimesh.transformations.translation_matrix((1.2, -1.0, -0.3))
+    placed.apply_transform(truth)
+    target = trimesh.util.concatenate([body, placed])
+
+    levels = FPFHFeatureDetector._icp_levels(np.asarray(template.vertices), np.asarray(template.faces))
+    transforms = []
+    for _ in range(args.poses):
+        axis = rng.normal(size=3)
+        angle = np.radians(rng.uniform(3.0, 11.0))
+        perturbation = trimesh.transformations.rotation_matrix(angle, axis / np.linalg.norm(axis))
+        perturbation[:3, 3] = rng.normal(0, 0.02 * template.scale, 3)
+        transforms.append(truth @ perturbation)
+    transforms = np.stack(transforms)
+
+    def refine():
+        return _native.icp_refine(transforms, [levels] * args.poses,
+                                  np.asarray(target.vertices, dtype=np.float64),
+                                  np.asarray(target.faces, dtype=np.int64),
+                                  iterations=args.icp_iterations)
+
+    seconds = best_of(args.repeats, refine)
+    refined, rms = refine()
+    errors = [rotation_error_degrees(pose, truth) for pose in refined]
+
+    return {
+        "poses": args.poses,
+        "iterations": args.icp_iterations,
+        "seconds": seconds,
+        "ms_per_pose": 1000.0 * seconds / args.poses,
+        "initial_error_degrees": float(np.mean([rotation_error_degrees(pose, truth) for pose in transforms])),
+        "final_error_degrees": float(np.mean(errors)),
+        "max_rms": float(np.max(rms)),
+    }
+
+
+def bench_morton(args, rng):
+    """Normal estimation and FPFH on args.samples surface samples, unordered and Z-ordered."""
+    body = trimesh.util.concatenate([
+        trimesh.creation.box(extents=(4.5, 1.8, 1.4)),
+        *[trimesh.creation.cylinder(0.35, 0.25, transform=trimesh.transformations.translation_matrix((x, y, -0.7)))
+          for x in (-1.4, 1.4) for y in (-0.9, 0.9)],
+        trimesh.creation.icosphere(subdivisions=5, radius=0.8).apply_translation((0.0, 0.0, 0.7)),
+    ])
+    points, _ = trimesh.sample.sample_surface(body, args.samples, seed=args.seed)
+    points = np.ascontiguousarray(points, dtype=np.float64)
+    order = _native.morton_order(points)
+    ordered = np.ascontiguousarray(points[order])
+
+    def describe(samples):
+        normals = _native.estimate_normals(samples, 0.1, 30)
+        return normals, _native.compute_fpfh(samples, normals, 0.25, 100)
+
+    random_normals = best_of(args.repeats, lambda: _native.estimate_normals(points, 0.1, 30))
+    morton_normals = best_of(args.repeats, lambda: _native.estimate_normals(ordered, 0.1, 30))
+    normals, features = describe(points)
+    ordered_normals, ordered_features = describe(ordered)
+    random_fpfh = best_of(args.repeats, lambda: _native.compute_fpfh(points, normals, 0.25, 100))
+    morton_fpfh = best_of(args.repeats, lambda: _native.compute_fpfh(ordered, ordered_normals, 0.25, 100))
+
+    return {
+        "samples": args.samples,
+        "normals_random_seconds": random_normals,
+        "normals_morton_seconds": morton_normals,
+        "fpfh_random_seconds": random_fpfh,
+        "fpfh_morton_seconds": morton_fpfh,
+        "fpfh_speedup": random_fpfh / morton_fpfh,
+        "max_fpfh_difference": float(np.max(np.abs(ordered_features - features[order]))),
+    }
+
+
+BENCHMARKS = {
+    "meshcnn": bench_meshcnn,
+    "icp": bench_icp,
+    "morton": bench_morton,
+}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmark the native engine kernels")
+    parser.add_argument("--only", nargs="+", choices=sorted(BENCHMARKS), help="Benchmarks to run (default: all)")
+    parser.add_argument("--repeats", type=int, default=3, help="Timed runs per measurement")
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--output", type=Path, help="Write results as JSON")
+    parser.add_argument("--meshes", type=int, default=2000, help="meshcnn: vertex sets per batch")
+    parser.add_argument("--vertices", type=int, default=2562, help="meshcnn: vertices per set")
+    parser.add_argument("--poses", type=int, default=256, help="icp: poses refined per call")
+    parser.add_argument("--icp-iterations", type=int, default=8, help="icp: iterations per level of detail")
+    parser.add_argument("--samples", type=int, default=400000, help="morton: surface samples")
+    args = parser.parse_args()
+
+    results = {}
+    for name in args.only or list(BENCHMARKS):
+        results[name] = BENCHMARKS[name](args, np.random.default_rng(args.seed))
+        print(f"{name}:")
+        for key, value in results[name].items():
+            print(f"  {key}: {value:.4g}" if isinstance(value, float) else f"  {key}: {value}")
+
+    if args.output:
+        args.output.write_text(json.dumps(results, indent=2))
+
+
+if __name__ == "__main__":
+    main()
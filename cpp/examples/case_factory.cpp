@@ -0,0 +1,68 @@
+/**
+ * MeshMind C++ SDK Example: Case Factory
+ * 
+ * Detects and meshes a sweep of geometries, overlapping the detection of the
+ * next case with the mesher process of the previous one.
+ * 
+ * Usage: case_factory <output_dir> <model.stl>... 
+ * Without MESHMIND_MESHER set, a stand-in command copies the target into the
+ * case directory after a delay.
+ */
+
+#include <meshmind/core.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <output_dir> <model.stl>...\n", argv[0]);
+        return 1;
+    }
+    
+    MeshMindDetector detector = meshmind_create_detector();
+    if (!detector) {
+        fprintf(stderr, "Failed to initialize MeshMind\n");
+        return 1;
+    }
+    meshmind_add_template(detector, "wheel.stl", "wheel");
+    
+    std::vector<std::string> case_dirs;
+    for (int i = 2; i < argc; i++) {
+        case_dirs.push_back(std::string(argv[1]) + "/case_" + std::to_string(i - 2));
+    }
+    std::vector<MeshMindCase> cases;
+    for (int i = 2; i < argc; i++) {
+        cases.push_back({argv[i], case_dirs[i - 2].c_str()});
+    }
+    
+    // $1 = target, $2 = sizing field, $3 = case directory
+    const char* mesher = getenv("MESHMIND_MESHER");
+    MeshMindPipelineOptions options = {};
+    options.generator = "ftetwild";
+    options.command = mesher ? mesher : "sleep 2 && cp \"$1\" \"$3/mesh.stl\"";
+    options.cpus_per_case = 2;
+    options.cpu_budget = 0;
+    options.timeout_seconds = 3600.0;
+    
+    std::vector<MeshMindCaseResult> results(cases.size());
+    int succeeded = meshmind_run_pipeline(detector, cases.data(), static_cast<int>(cases.size()),
+                                          &options, results.data());
+    if (succeeded < 0) {
+        fprintf(stderr, "Error: %s\n", meshmind_get_error(detector));
+        meshmind_destroy_detector(detector);
+        return 1;
+    }
+    
+    for (size_t i = 0; i < cases.size(); i++) {
+        const MeshMindCaseResult& r = results[i];
+        printf("%-30s status %d, %d features, detect %.2fs, queued %.2fs, mesh %.2fs, exit %d%s\n",
+               cases[i].target_path, r.status, r.detections, r.detect_seconds,
+               r.queue_seconds, r.mesh_seconds, r.exit_code, r.timed_out ? " (timed out)" : "");
+    }
+    printf("\n%d of %zu cases meshed\n", succeeded, cases.size());
+    
+    meshmind_destroy_detector(detector);
+    return succeeded == static_cast<int>(cases.size()) ? 0 : 1;
+}
@@ -0,0 +1,46 @@
+/**
+ * MeshMind C++ SDK Example: C++ API
+ *
+ * RAII handles, exceptions and zero-copy result views via meshmind.hpp
+ */
+
+#include <meshmind/meshmind.hpp>
+#include <iostream>
+
+int main() {
+    std::cout << "MeshMind-AFID C++ SDK v" << meshmind::Detector::version() << "\n\n";
+
+    try {
+        meshmind::Detector detector;
+        detector.load_target("assets/test_data/drivaer/DrivAer_Notchback_MOCK.stl");
+        detector.add_template("assets/templates/automotive/wheel_18inch.stl", "wheel");
+        detector.add_template("assets/templates/automotive/mirror_standard.stl", "mirror");
+
+        // Detection runs in the background; results are views, not copies
+        auto pending = detector.detect_async();
+        meshmind::Results results = pending.get();
+
+        std::cout << "Found " << results.size() << " features:\n";
+        for (std::size_t i = 0; i < results.size(); i++) {
+            meshmind::Detection det = results[i];
+            std::cout << "  " << det.feature_type << "_" << det.instance
+                      << " @ [" << det.position[0] << ", " << det.position[1] << ", " << det.position[2] << "]"
+                      << " (" << det.confidence * 100 << "% confidence)\n";
+        }
+
+        // Vectorised consumers can take whole columns at once
+        double best = 0.0;
+        for (double confidence : results.confidences()) {
+            best = confidence > best ? confidence : best;
+        }
+        std::cout << "\nBest confidence: " << best * 100 << "%\n";
+
+        detector.export_openfoam_case("./case/", /*enable_mrf=*/true);
+
+    } catch (const meshmind::Error& e) {
+        std::cerr << "MeshMind error " << e.code() << ": " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
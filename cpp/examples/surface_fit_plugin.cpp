@@ -0,0 +1,138 @@
+/**
+ * MeshMind C++ SDK Example: Native Detector Plugin
+ *
+ * A minimal plugin built against include/meshmind/plugin.h. It places the
+ * template at its best descriptor match, refines the translation against
+ * the target surface with the host's BVH closest-point query, and scores
+ * the fraction of template vertices that end up on the surface.
+ *
+ * Load it with meshmind_load_plugin(detector, "libsurface_fit_plugin.so", "tolerance=0.01").
+ */
+
+#include <meshmind/plugin.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct SurfaceFit {
+    double tolerance = 0.01;   /* on-surface distance, relative to the template size */
+    int iterations = 10;
+    std::string error;
+};
+
+void* create(const char* config) {
+    SurfaceFit* fit = new SurfaceFit;
+    if (config && std::strncmp(config, "tolerance=", 10) == 0) {
+        fit->tolerance = std::atof(config + 10);
+    }
+    return fit;
+}
+
+void destroy(void* instance) {
+    delete static_cast<SurfaceFit*>(instance);
+}
+
+const char* get_error(void* instance) {
+    return static_cast<SurfaceFit*>(instance)->error.c_str();
+}
+
+int detect(void* instance, const MeshMindTargetView* target, const MeshMindTemplateView* tmpl,
+           MeshMindPluginDetection* detections, int max_detections) {
+    SurfaceFit& fit = *static_cast<SurfaceFit*>(instance);
+    if (tmpl->num_vertices == 0 || target->num_points == 0) {
+        fit.error = "empty template or target";
+        return MESHMIND_PLUGIN_ERROR;
+    }
+    if (max_detections < 1) {
+        return 0;
+    }
+
+    // Template centroid and size
+    double centroid[3] = {0.0, 0.0, 0.0};
+    for (size_t i = 0; i < tmpl->num_vertices; i++) {
+        for (int d = 0; d < 3; d++) {
+            centroid[d] += tmpl->vertices[3 * i + d] / double(tmpl->num_vertices);
+        }
+    }
+    double size = 0.0;
+    for (size_t i = 0; i < tmpl->num_vertices; i++) {
+        double r2 = 0.0;
+        for (int d = 0; d < 3; d++) {
+            r2 += (tmpl->vertices[3 * i + d] - centroid[d]) * (tmpl->vertices[3 * i + d] - centroid[d]);
+        }
+        size = std::fmax(size, std::sqrt(r2));
+    }
+    double tolerance = fit.tolerance * (size > 0.0 ? size : 1.0);
+
+    // Start at the target sample whose descriptor is closest to the mean target descriptor
+    std::vector<double> mean(target->descriptor_dims, 0.0);
+    for (size_t i = 0; i < target->num_points; i++) {
+        for (size_t d = 0; d < target->descriptor_dims; d++) {
+            mean[d] += target->descriptors[i * target->descriptor_dims + d] / double(target->num_points);
+        }
+    }
+    size_t seed = 0;
+    double sq_distance = 0.0;
+    target->nearest_descriptors(target->context, mean.data(), 1, &seed, &sq_distance);
+
+    double t[3];
+    for (int d = 0; d < 3; d++) {
+        t[d] = target->points[3 * seed + d] - centroid[d];
+    }
+
+    // Translation-only ICP against the surface
+    size_t on_surface = 0;
+    for (int iteration = 0; iteration <= fit.iterations; iteration++) {
+        double shift[3] = {0.0, 0.0, 0.0};
+        on_surface = 0;
+        for (size_t i = 0; i < tmpl->num_vertices; i++) {
+            double p[3], closest[3], distance;
+            for (int d = 0; d < 3; d++) {
+                p[d] = tmpl->vertices[3 * i + d] + t[d];
+            }
+            if (target->closest_point(target->context, p, INFINITY, closest, &distance) < 0) {
+                continue;
+            }
+            for (int d = 0; d < 3; d++) {
+                shift[d] += (closest[d] - p[d]) / double(tmpl->num_vertices);
+            }
+            on_surface += distance <= tolerance;
+        }
+        if (iteration < fit.iterations) {
+            for (int d = 0; d < 3; d++) {
+                t[d] += shift[d];
+            }
+        }
+    }
+
+    MeshMindPluginDetection& detection = detections[0];
+    std::memset(&detection, 0, sizeof(detection));
+    for (int d = 0; d < 3; d++) {
+        detection.transform[4 * d + d] = 1.0;
+        detection.transform[4 * d + 3] = t[d];
+    }
+    detection.transform[15] = 1.0;
+    detection.confidence = double(on_surface) / double(tmpl->num_vertices);
+    return 1;
+}
+
+const MeshMindDetectorPlugin plugin = {
+    MESHMIND_PLUGIN_ABI_VERSION,
+    sizeof(MeshMindDetectorPlugin),
+    "surface_fit",
+    create,
+    destroy,
+    detect,
+    get_error,
+};
+
+}  // namespace
+
+MESHMIND_PLUGIN_EXPORT const MeshMindDetectorPlugin* meshmind_detector_plugin(void) {
+    return &plugin;
+}
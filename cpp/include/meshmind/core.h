@@ -20,6 +20,12 @@ typedef struct MeshMindDetector_t* MeshMindDetector;
 #define MESHMIND_ERROR_DETECT -3
 #define MESHMIND_ERROR_EXPORT -4
 #define MESHMIND_ERROR_INVALID_PARAM -5
+#define MESHMIND_ERROR_SNAPSHOT -6
+#define MESHMIND_ERROR_BUSY -7
+#define MESHMIND_ERROR_MESHER -8
+
+/* Status returned by meshmind_wait while detection is still running */
+#define MESHMIND_PENDING 1
 
 /* Core API */
 
@@ -56,11 +62,233 @@ int meshmind_add_template(
     const char* feature_id
 );
 
+/* Search regions */
+
+/*
+ * Where a feature type is searched for in the target. All given constraints
+ * apply together; a zero-initialised region places no restriction.
+ */
+typedef struct {
+    const double* boxes;       /* [num_boxes * 6] xmin, ymin, zmin, xmax, ymax, zmax; the union is searched */
+    int num_boxes;
+    const int* part_ids;       /* Parts to search: ASCII STL solids / OBJ groups in file order, from 0 */
+    int num_part_ids;
+    int up_axis;               /* Ground-plane normal: 0 = x, 1 = y, 2 = z */
+    double height_min;         /* Height band as fractions of the target height above its */
+    double height_max;         /* lowest point, e.g. 0 and 0.33; off if height_max <= height_min */
+} MeshMindSearchRegion;
+
+/**
+ * Restrict the search for all templates of a feature type (including ones
+ * added later) to a region of the target. Only the target surface inside
+ * the region is sampled and described; templates sharing a region share
+ * one prepared index. Plugins are restricted to the region as well.
+ * @param detector Detector handle
+ * @param feature_id Feature type, as passed to meshmind_add_template
+ * @param region Region to search, or NULL to search the whole target again
+ * @return MESHMIND_SUCCESS or error code
+ */
+int meshmind_set_search_region(
+    MeshMindDetector detector,
+    const char* feature_id,
+    const MeshMindSearchRegion* region
+);
+
+/**
+ * Seed the search for a bulky feature type (wheels, fans) with FFT
+ * localisation: target and template surfaces are voxelised and all
+ * translations of each template are scored by 3D FFT cross-correlation.
+ * Descriptor matching and pose estimation then only use the target surface
+ * around the best translations (within the feature type's search region).
+ * Templates are assumed to be roughly in the target's orientation.
+ * @param detector Detector handle
+ * @param feature_id Feature type, as passed to meshmind_add_template
+ * @param max_peaks Candidate locations per template, or 0 to disable
+ * @param voxel_size Voxel edge length, or 0 for 1/96 of the target's largest extent
+ * @return MESHMIND_SUCCESS or error code
+ */
+int meshmind_set_fft_localisation(
+    MeshMindDetector detector,
+    const char* feature_id,
+    int max_peaks,
+    double voxel_size
+);
+
+/**
+ * Enable early rejection between template levels of detail. Templates are
+ * scored on a few surface samples first; only those whose descriptor
+ * distance is within (1 + margin) of the best template of the same feature
+ * type are scored at the next level, and only templates that pass every
+ * level are matched at full resolution. Rejected templates produce no
+ * detection, so this is off by default. Prepared levels are kept with the
+ * template across targets.
+ * @param detector Detector handle
+ * @param margin Relative margin, e.g. 0.25, or negative (default) to match every template at full detail
+ * @return MESHMIND_SUCCESS or error code
+ */
+int meshmind_set_lod_margin(MeshMindDetector detector, double margin);
+
+/**
+ * Estimate template poses by RANSAC over 3-point hypotheses instead of
+ * Procrustes on all descriptor correspondences. Hypotheses are solved and
+ * scored in SIMD batches on all threads; the best one is refitted on its
+ * inliers. Applies to templates matched afterwards.
+ * @param detector Detector handle
+ * @param iterations Hypotheses per template, or 0 for Procrustes (default)
+ * @param inlier_threshold Inlier distance in target units, or 0 for 5% of the template size
+ * @return MESHMIND_SUCCESS or error code
+ */
+int meshmind_set_ransac(MeshMindDetector detector, int iterations, double inlier_threshold);
+
+/**
+ * Estimate template poses by max-clique registration: the largest set of
+ * descriptor correspondences with mutually consistent distances is found
+ * exactly, and the pose is solved on it with a truncated least squares
+ * cost. Stays reliable at outlier rates where RANSAC would need too many
+ * hypotheses, at a cost quadratic in the number of correspondences. Takes
+ * precedence over RANSAC while enabled.
+ * @param detector Detector handle
+ * @param enabled Non-zero to enable, 0 to restore RANSAC/Procrustes
+ * @param noise_bound Largest inlier residual in target units, or 0 for 2.5% of the template size
+ * @return MESHMIND_SUCCESS or error code
+ */
+int meshmind_set_max_clique(MeshMindDetector detector, int enabled, double noise_bound);
+
+/* Query planning */
+
+/* Pose strategies of a template plan */
+#define MESHMIND_STRATEGY_NONE -1          /* not matched yet */
+#define MESHMIND_STRATEGY_PROCRUSTES 0
+#define MESHMIND_STRATEGY_RANSAC 1
+#define MESHMIND_STRATEGY_MAX_CLIQUE 2
+
+/* How a template was matched in the last detection */
+typedef struct {
+    int strategy;              /* MESHMIND_STRATEGY_* */
+    int coarse_points;         /* Template samples used for pose estimation */
+    int ransac_iterations;     /* Hypotheses, if strategy is RANSAC */
+    double inlier_ratio;       /* Expected fraction of correct correspondences (planned only) */
+    double estimated_cost;     /* Relative cost the plan was chosen by (planned only) */
+    int planned;               /* 1 if chosen by the query planner, 0 if by the fixed settings */
+    int feasible;              /* 0 if no strategy was expected to succeed and the most robust was taken */
+} MeshMindTemplatePlan;
+
+/**
+ * Choose the pose strategy and the number of template samples per template
+ * from a cost model instead of the fixed settings (meshmind_set_ransac,
+ * meshmind_set_max_clique). The expected fraction of correct correspondences
+ * follows from the template's surface area against the searched target
+ * surface; the cheapest strategy expected to succeed at that rate is taken.
+ * @param detector Detector handle
+ * @param enabled Non-zero to plan per template, 0 for the fixed settings (default)
+ * @return MESHMIND_SUCCESS or error code
+ */
+int meshmind_set_planner(MeshMindDetector detector, int enabled);
+
+/**
+ * Expected number of instances of a feature type in the target, e.g. 4 for
+ * wheels. More instances make correct correspondences likelier.
+ * @param detector Detector handle
+ * @param feature_id Feature type
+ * @param instances Expected instances (default 1)
+ * @return MESHMIND_SUCCESS or error code
+ */
+int meshmind_set_expected_instances(MeshMindDetector detector, const char* feature_id, int instances);
+
+/**
+ * The plan a template was matched with in the last detection.
+ * @param detector Detector handle
+ * @param template_index Template in the order of meshmind_add_template
+ * @param plan Filled in; strategy is MESHMIND_STRATEGY_NONE before matching
+ * @return MESHMIND_SUCCESS or error code
+ */
+int meshmind_get_template_plan(MeshMindDetector detector, int template_index, MeshMindTemplatePlan* plan);
+
+/**
+ * Refine detected poses by point-to-plane ICP against the target surface,
+ * coarse to fine over the template's sampled levels of detail, trimming the
+ * worst 10% of correspondences. Detections are refined in parallel. The
+ * scale of each pose is kept.
+ * @param detector Detector handle
+ * @param iterations Iterations per level of detail, e.g. 8, or 0 to skip refinement (default)
+ * @param symmetric Non-zero for the symmetric objective (residuals along both normals)
+ * @return MESHMIND_SUCCESS or error code
+ */
+int meshmind_set_icp(MeshMindDetector detector, int iterations, int symmetric);
+
+/**
+ * Detection confidence is verified geometrically: the fraction of the
+ * template's surface samples that lie within tolerance of the target surface
+ * once moved by the detected pose. Detections below min_confidence are
+ * dropped, usually after checking only part of the samples.
+ * @param detector Detector handle
+ * @param tolerance Inlier distance relative to the template size (default 0.02)
+ * @param min_confidence Smallest confidence kept, in [0,1] (default 0 keeps all)
+ * @return MESHMIND_SUCCESS or error code
+ */
+int meshmind_set_verification(MeshMindDetector detector, double tolerance, double min_confidence);
+
+/**
+ * Near-duplicate templates share matching work: templates of a feature type
+ * are grouped into families by the distribution of their FPFH descriptors,
+ * each family's representative is matched in full, and the other members
+ * are only evaluated when the representative is found. Members start from
+ * the representative's pose, composed with the similarity that matches the
+ * member's surface centroid and area to the representative's (templates of
+ * a family are expected to differ by position and scale, like scaled
+ * variants), and are then refined and verified.
+ * @param detector Detector handle
+ * @param max_distance Largest descriptor distribution distance within a family,
+ *                     in [0,1] (0.08 groups scaled variants; negative disables, the default)
+ * @param min_confidence Representative confidence needed to evaluate its members (default 0.5)
+ * @return MESHMIND_SUCCESS or error code
+ */
+int meshmind_set_template_families(MeshMindDetector detector, double max_distance, double min_confidence);
+
+/**
+ * Build a template pack: a vocabulary tree (hierarchical k-means over the
+ * FPFH descriptors of all added templates) and each template's word
+ * histogram, indexed by normalised template path (absolute, symbolic links
+ * resolved). The pack replaces any loaded one.
+ * @param detector Detector handle
+ * @param pack_path Where to write the .mmvt pack (NULL keeps it in memory only)
+ * @param branching Clusters per tree node (>= 2, default 8)
+ * @param depth Tree levels (>= 1, default 4)
+ * @return MESHMIND_SUCCESS or error code
+ */
+int meshmind_build_template_pack(MeshMindDetector detector, const char* pack_path, int branching, int depth);
+
+/**
+ * Load a template pack written by meshmind_build_template_pack. Templates
+ * are looked up by normalised path, so the pack can be built once for a
+ * template library and reused with any subset of it, also through relative
+ * or symbolically linked paths. A pack that indexes none of the added
+ * templates (e.g. after the library was moved) is not loaded; if only some
+ * templates are missing it is loaded and meshmind_get_error names how many.
+ * @param detector Detector handle
+ * @param pack_path Path to .mmvt pack
+ * @return MESHMIND_SUCCESS, or MESHMIND_ERROR_LOAD for an unreadable pack
+ *         or one that indexes none of the added templates
+ */
+int meshmind_load_template_pack(MeshMindDetector detector, const char* pack_path);
+
+/**
+ * Retrieve candidate templates from the template pack before matching:
+ * each search region keeps the top_k templates whose descriptor words best
+ * match its own, and only those are matched. Templates without a search
+ * region (matched against the whole target) and templates missing from
+ * the pack are always matched.
+ * @param detector Detector handle
+ * @param top_k Candidates per search region (0 disables retrieval, the default)
+ * @return MESHMIND_SUCCESS or error code
+ */
+int meshmind_set_template_retrieval(MeshMindDetector detector, int top_k);
+
 /* Detection results */
 typedef struct {
     char feature_id[256];      /* Feature identifier */
     double transform[16];      /* 4x4 transform matrix (row-major) */
-    double confidence;         /* Detection confidence [0,1] */
+    double confidence;         /* Fraction of the template on the target surface [0,1] */
     double position[3];        /* XYZ position (convenience) */
     double radius;             /* Feature radius (if applicable) */
 } MeshMindDetection;
@@ -70,7 +298,8 @@ typedef struct {
  * @param detector Detector handle
  * @param results Array to store detection results
  * @param max_results Maximum number of results to return
- * @return Number of detections found, or negative error code
+ * @return Number of detections copied (at most max_results), or negative
+ *         error code. Use meshmind_detect_results to get all detections.
  */
 int meshmind_detect(
     MeshMindDetector detector,
@@ -78,10 +307,203 @@ int meshmind_detect(
     int max_results
 );
 
+/* Structure-of-arrays results */
+
+/*
+ * Zero-copy views of all detections, sorted by confidence. Arrays are owned
+ * by the detector and sized by the engine (no max_results cap). Views stay
+ * valid until the next call that changes results (meshmind_detect*,
+ * meshmind_load_target, meshmind_load_snapshot, meshmind_add_template) or
+ * until the detector is destroyed.
+ */
+typedef struct {
+    int count;                             /* Number of detections */
+    int num_feature_types;                 /* Number of interned feature types */
+    const char* const* feature_type_names; /* [num_feature_types] names, indexed by ID */
+    const int* feature_types;              /* [count] interned feature type ID */
+    const int* instances;                  /* [count] instance number within its type */
+    const double* positions;               /* [count * 3] XYZ positions */
+    const double* transforms;              /* [count * 16] 4x4 transforms (row-major) */
+    const double* confidences;             /* [count] detection confidence [0,1], see meshmind_set_verification */
+    const double* radii;                   /* [count] feature radius (0 if unknown) */
+    const double* scales;                  /* [count] uniform scale of the transform */
+} MeshMindResults;
+
+/**
+ * Run feature detection and return views of all results.
+ * @param detector Detector handle
+ * @param results Filled with views of the detector's result arrays
+ * @return Number of detections found, or negative error code
+ */
+int meshmind_detect_results(MeshMindDetector detector, MeshMindResults* results);
+
+/**
+ * Get views of the results of the last detection (or restored snapshot)
+ * without running detection again.
+ * @param detector Detector handle
+ * @param results Filled with views of the detector's result arrays
+ * @return Number of detections, or negative error code
+ */
+int meshmind_get_results(MeshMindDetector detector, MeshMindResults* results);
+
+/**
+ * Get the name of an interned feature type.
+ * IDs are assigned by meshmind_add_template and stay stable for the
+ * lifetime of the detector.
+ * @param detector Detector handle
+ * @param feature_type Feature type ID
+ * @return Feature type name, or NULL if the ID is unknown
+ */
+const char* meshmind_feature_type_name(MeshMindDetector detector, int feature_type);
+
+/* Asynchronous detection */
+
+/**
+ * Start feature detection on a background thread and return immediately.
+ * Until meshmind_wait has collected the job's status, other calls on this
+ * detector return MESHMIND_ERROR_BUSY; afterwards read the results with
+ * meshmind_get_results.
+ * @param detector Detector handle
+ * @return MESHMIND_SUCCESS if the job was started, or error code
+ */
+int meshmind_detect_async(MeshMindDetector detector);
+
+/**
+ * Wait for a job started by meshmind_detect_async.
+ * @param detector Detector handle
+ * @param timeout_seconds Maximum time to wait, or negative to wait until done
+ * @return MESHMIND_PENDING if the job is still running after the timeout,
+ *         otherwise the job's status (MESHMIND_SUCCESS or error code)
+ */
+int meshmind_wait(MeshMindDetector detector, double timeout_seconds);
+
+/* Snapshots (resume after preemption) */
+
+/**
+ * Save detector state to a compact binary snapshot.
+ * Stores the target path and fingerprint, the prepared target index,
+ * the template list with each template's prepared levels of detail, all
+ * completed template results, the detection settings (meshmind_set_*,
+ * including the template pack) and the checkpoint settings. The file is
+ * written to "<snapshot_path>.tmp" and renamed into place, so an
+ * interrupted write never leaves a truncated snapshot behind.
+ * @param detector Detector handle
+ * @param snapshot_path Path for snapshot file
+ * @return MESHMIND_SUCCESS or error code
+ */
+int meshmind_save_snapshot(MeshMindDetector detector, const char* snapshot_path);
+
+/**
+ * Restore detector state from a snapshot.
+ * Reloads the target (which must be unchanged since the snapshot was taken),
+ * restores the target index, template preparation, completed results,
+ * detection settings and checkpoint settings. Unlike the meshmind_set_*
+ * calls, restoring the settings keeps the completed results, and a following
+ * meshmind_detect only processes templates that had not completed. If the
+ * snapshot cannot be loaded the detector is left unchanged. Snapshots of
+ * format version 1 (without template preparation) and 2 (without settings,
+ * which then stay as they are) are still read.
+ * @param detector Detector handle
+ * @param snapshot_path Path to snapshot file
+ * @return MESHMIND_SUCCESS or error code
+ */
+int meshmind_load_snapshot(MeshMindDetector detector, const char* snapshot_path);
+
+/**
+ * Enable periodic checkpoints during meshmind_detect.
+ * After each completed template, a snapshot is written if at least
+ * interval_seconds have passed since the last one (0 = after every template).
+ * A final snapshot is written when detection completes.
+ * @param detector Detector handle
+ * @param snapshot_path Path for checkpoint file, or NULL to disable
+ * @param interval_seconds Minimum time between checkpoints
+ * @return MESHMIND_SUCCESS or error code
+ */
+int meshmind_set_checkpoint(
+    MeshMindDetector detector,
+    const char* snapshot_path,
+    double interval_seconds
+);
+
+/* ML-assisted matching (native MeshCNN feature extractor) */
+
+/**
+ * Load MeshCNN feature-layer weights for ML-assisted matching.
+ * Inference runs natively on the CPU (no PyTorch); convert trained
+ * weights with scripts/export_meshcnn_weights.py (.pth -> .mmnn).
+ * @param detector Detector handle
+ * @param weights_path Path to .mmnn weights file
+ * @return MESHMIND_SUCCESS or error code
+ */
+int meshmind_load_feature_model(MeshMindDetector detector, const char* weights_path);
+
+/**
+ * Compute the global MeshCNN feature vector of a mesh, as
+ * SimplifiedMeshCNN.extract_features does on its vertices.
+ * @param detector Detector handle
+ * @param mesh_path Path to STL/OBJ file
+ * @param features Output array, or NULL to query the feature size
+ * @param max_features Size of features array (at least the feature size)
+ * @return Number of features (written), or error code
+ */
+int meshmind_extract_features(
+    MeshMindDetector detector,
+    const char* mesh_path,
+    float* features,
+    int max_features
+);
+
+/**
+ * Feature similarity of each registered template to the target, as
+ * MLFeatureDetector.match_template: (cosine similarity + 1) / 2.
+ * All templates are evaluated in one batch; target features are cached
+ * until the target changes.
+ * @param detector Detector handle
+ * @param similarities Output array, one value per template in registration order
+ * @param max_templates Size of similarities array
+ * @return Number of values written, or error code
+ */
+int meshmind_template_similarity(
+    MeshMindDetector detector,
+    double* similarities,
+    int max_templates
+);
+
+/* Native detector plugins (ABI in meshmind/plugin.h) */
+
+/**
+ * Load a native detector plugin from a shared library.
+ * On meshmind_detect, every plugin runs on each pending template against
+ * the prepared target (shared without copying) and its detections are
+ * fused in pose space with the built-in matcher's result. Plugins see the
+ * samples of the template's search region, and detections they place
+ * outside it are dropped.
+ * @param detector Detector handle
+ * @param library_path Shared library exporting meshmind_detector_plugin
+ * @param config Plugin configuration string, or NULL
+ * @return Plugin index (>= 0), or error code
+ */
+int meshmind_load_plugin(
+    MeshMindDetector detector,
+    const char* library_path,
+    const char* config
+);
+
+/**
+ * Get the name of a loaded plugin.
+ * @param detector Detector handle
+ * @param plugin Index returned by meshmind_load_plugin
+ * @return Plugin name, or NULL if the index is unknown or an asynchronous
+ *         detection is in progress
+ */
+const char* meshmind_plugin_name(MeshMindDetector detector, int plugin);
+
 /* Refinement export */
 
 /**
  * Export snappyHexMeshDict for OpenFOAM.
+ * A file path is written by the native generator; a directory receives
+ * the full case structure (including MRF files).
  * @param detector Detector handle
  * @param output_path Path for output file/directory
  * @return MESHMIND_SUCCESS or error code
@@ -115,6 +537,76 @@ int meshmind_export_ftetwild_sizing(
     const char* output_path
 );
 
+/**
+ * Export inputs for several mesh generators from the current results in one
+ * pass. Refinement regions are generated once and the native backends
+ * ("snappyhexmesh": snappyHexMeshDict, "ftetwild": .sizing.json) write
+ * their files concurrently.
+ * @param detector Detector handle
+ * @param generators Generator names [count]
+ * @param output_paths Output file per generator [count]
+ * @param count Number of generators
+ * @return MESHMIND_SUCCESS or error code
+ */
+int meshmind_export_mesher_inputs(
+    MeshMindDetector detector,
+    const char* const* generators,
+    const char* const* output_paths,
+    int count
+);
+
+/* Case pipeline */
+
+/* One geometry of a sweep */
+typedef struct {
+    const char* target_path;   /* Geometry to run detection on */
+    const char* case_dir;      /* Created if missing; receives mesher input and mesher.log */
+} MeshMindCase;
+
+typedef struct {
+    const char* generator;     /* Mesher input to export: "snappyhexmesh" or "ftetwild" */
+    const char* config_file;   /* File name in case_dir, or NULL ("snappyHexMeshDict" / "sizing.json") */
+    /*
+     * Mesher command run with /bin/sh -c, or NULL to only detect and export.
+     * $1 is the target path, $2 the exported config file, $3 the case
+     * directory, e.g. "ftetwild \"$1\" -o \"$3/mesh.msh\" --sizing-field \"$2\"".
+     */
+    const char* command;
+    int cpus_per_case;         /* CPUs one mesher process uses */
+    int cpu_budget;            /* CPUs shared by concurrent meshers (0 = all hardware threads) */
+    double timeout_seconds;    /* Per mesher process (0 = no limit) */
+} MeshMindPipelineOptions;
+
+typedef struct {
+    int status;                /* MESHMIND_SUCCESS or error code of detection/export/launch */
+    int detections;            /* Number of detections in this case */
+    int exit_code;             /* Mesher exit status (-1 if not run, killed or timed out) */
+    int timed_out;             /* Nonzero if the mesher was killed after timeout_seconds */
+    double detect_seconds;     /* Loading, detection and input export */
+    double queue_seconds;      /* Waiting for the CPU budget */
+    double mesh_seconds;       /* Mesher run time */
+} MeshMindCaseResult;
+
+/**
+ * Run detection and meshing for a sequence of cases with the registered
+ * templates. Detection of case N+1 overlaps with the mesher process of
+ * case N; mesher processes run concurrently while their cpus_per_case fit
+ * into cpu_budget. Returns after all processes have finished.
+ * @param detector Detector handle (its target changes to each case in turn)
+ * @param cases Cases to run [count]
+ * @param count Number of cases
+ * @param options Generator, mesher command and scheduling
+ * @param results Per-case status and timings [count]
+ * @return Number of cases that were detected and meshed successfully, or error code
+ */
+int meshmind_run_pipeline(
+    MeshMindDetector detector,
+    const MeshMindCase* cases,
+    int count,
+    const MeshMindPipelineOptions* options,
+    MeshMindCaseResult* results
+);
+
 /* Utility functions */
 
 /**
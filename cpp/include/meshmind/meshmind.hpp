@@ -0,0 +1,365 @@
+/*
+ * MeshMind-AFID C++ API
+ *
+ * Header-only RAII wrapper around the C API in core.h: move-only handles,
+ * zero-copy span views of results and exceptions instead of status codes.
+ */
+
+#pragma once
+
+#include "meshmind/core.h"
+
+#include <cstddef>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#endif
+
+namespace meshmind {
+
+#if defined(__cpp_lib_span)
+template <typename T>
+using span = std::span<T>;
+#else
+/* Minimal read-only stand-in for std::span when compiling as C++17 */
+template <typename T>
+class span {
+public:
+    constexpr span() noexcept = default;
+    constexpr span(T* data, std::size_t size) noexcept : data_(data), size_(size) {}
+
+    constexpr T* data() const noexcept { return data_; }
+    constexpr std::size_t size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr T& operator[](std::size_t i) const { return data_[i]; }
+    constexpr T* begin() const noexcept { return data_; }
+    constexpr T* end() const noexcept { return data_ + size_; }
+    constexpr span subspan(std::size_t offset, std::size_t count) const {
+        return span(data_ + offset, count);
+    }
+
+private:
+    T* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+#endif
+
+/* Error raised for any non-success status from the C API */
+class Error : public std::runtime_error {
+public:
+    Error(int code, const std::string& message)
+        : std::runtime_error(message), code_(code) {}
+
+    /* MESHMIND_ERROR_* code */
+    int code() const noexcept { return code_; }
+
+private:
+    int code_;
+};
+
+/* One detection, as views into the owning Results */
+struct Detection {
+    std::string_view feature_type;
+    int instance;
+    span<const double> transform;  /* 16 values, row-major 4x4 */
+    span<const double> position;   /* 3 values */
+    double confidence;
+    double radius;
+    double scale;
+};
+
+/*
+ * Zero-copy views of a detector's results. Valid until the next call that
+ * changes results on the same Detector (detect, load_target, load_snapshot,
+ * add_template) or until the Detector is destroyed.
+ */
+class Results {
+public:
+    Results() noexcept : raw_() {}
+    explicit Results(const MeshMindResults& raw) noexcept : raw_(raw) {}
+
+    std::size_t size() const noexcept { return static_cast<std::size_t>(raw_.count); }
+    bool empty() const noexcept { return raw_.count == 0; }
+
+    span<const int> feature_types() const noexcept { return {raw_.feature_types, size()}; }
+    span<const int> instances() const noexcept { return {raw_.instances, size()}; }
+    span<const double> positions() const noexcept { return {raw_.positions, size() * 3}; }
+    span<const double> transforms() const noexcept { return {raw_.transforms, size() * 16}; }
+    span<const double> confidences() const noexcept { return {raw_.confidences, size()}; }
+    span<const double> radii() const noexcept { return {raw_.radii, size()}; }
+    span<const double> scales() const noexcept { return {raw_.scales, size()}; }
+
+    std::size_t num_feature_types() const noexcept {
+        return static_cast<std::size_t>(raw_.num_feature_types);
+    }
+    std::string_view feature_type_name(int feature_type) const {
+        return raw_.feature_type_names[feature_type];
+    }
+
+    Detection operator[](std::size_t i) const {
+        return Detection{
+            feature_type_name(raw_.feature_types[i]),
+            raw_.instances[i],
+            span<const double>(raw_.transforms + i * 16, 16),
+            span<const double>(raw_.positions + i * 3, 3),
+            raw_.confidences[i],
+            raw_.radii[i],
+            raw_.scales[i],
+        };
+    }
+
+    const MeshMindResults& raw() const noexcept { return raw_; }
+
+private:
+    MeshMindResults raw_;
+};
+
+/* Move-only owner of a MeshMindDetector handle */
+class Detector {
+public:
+    Detector() : handle_(meshmind_create_detector()) {
+        if (!handle_) {
+            throw Error(MESHMIND_ERROR_INIT, "Failed to initialize MeshMind");
+        }
+    }
+
+    ~Detector() { reset(); }
+
+    Detector(Detector&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    Detector& operator=(Detector&& other) noexcept {
+        if (this != &other) {
+            reset();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    Detector(const Detector&) = delete;
+    Detector& operator=(const Detector&) = delete;
+
+    void load_target(const std::string& path) {
+        check(meshmind_load_target(handle_, path.c_str()));
+    }
+
+    /* An empty feature_id derives the type from the file name ("wheel_18inch.stl" -> "wheel") */
+    void add_template(const std::string& path, const std::string& feature_id = {}) {
+        check(meshmind_add_template(handle_, path.c_str(),
+                                    feature_id.empty() ? nullptr : feature_id.c_str()));
+    }
+
+    /* Search templates of a feature type only inside a region of the target */
+    void set_search_region(const std::string& feature_id, const MeshMindSearchRegion& region) {
+        check(meshmind_set_search_region(handle_, feature_id.c_str(), &region));
+    }
+
+    void clear_search_region(const std::string& feature_id) {
+        check(meshmind_set_search_region(handle_, feature_id.c_str(), nullptr));
+    }
+
+    /* Restrict matching of a feature type to FFT correlation peaks; max_peaks = 0 disables */
+    void set_fft_localisation(const std::string& feature_id, int max_peaks = 4, double voxel_size = 0.0) {
+        check(meshmind_set_fft_localisation(handle_, feature_id.c_str(), max_peaks, voxel_size));
+    }
+
+    /* Early rejection between template levels of detail; negative matches all at full detail */
+    void set_lod_margin(double margin) {
+        check(meshmind_set_lod_margin(handle_, margin));
+    }
+
+    /* RANSAC pose estimation with the given hypotheses per template; 0 restores Procrustes */
+    void set_ransac(int iterations, double inlier_threshold = 0.0) {
+        check(meshmind_set_ransac(handle_, iterations, inlier_threshold));
+    }
+
+    /* Max-clique pose estimation, robust to extreme outlier rates; takes precedence over RANSAC */
+    void set_max_clique(bool enabled, double noise_bound = 0.0) {
+        check(meshmind_set_max_clique(handle_, enabled ? 1 : 0, noise_bound));
+    }
+
+    /* Per-template strategy and sample count from the cost model instead of the fixed settings */
+    void set_planner(bool enabled) {
+        check(meshmind_set_planner(handle_, enabled ? 1 : 0));
+    }
+
+    /* Expected instances of a feature type, for the planner */
+    void set_expected_instances(const std::string& feature_id, int instances) {
+        check(meshmind_set_expected_instances(handle_, feature_id.c_str(), instances));
+    }
+
+    /* How a template (in order of add_template) was matched in the last detection */
+    MeshMindTemplatePlan template_plan(int template_index) {
+        MeshMindTemplatePlan plan;
+        check(meshmind_get_template_plan(handle_, template_index, &plan));
+        return plan;
+    }
+
+    /* ICP pose refinement with the given iterations per level of detail; 0 skips it */
+    void set_icp(int iterations, bool symmetric = false) {
+        check(meshmind_set_icp(handle_, iterations, symmetric ? 1 : 0));
+    }
+
+    /* Geometric confidence: inlier tolerance relative to the template size, and the smallest confidence kept */
+    void set_verification(double tolerance, double min_confidence = 0.0) {
+        check(meshmind_set_verification(handle_, tolerance, min_confidence));
+    }
+
+    /* Match one representative per family of near-duplicate templates; negative max_distance disables */
+    void set_template_families(double max_distance, double min_confidence = 0.5) {
+        check(meshmind_set_template_families(handle_, max_distance, min_confidence));
+    }
+
+    /* Build a template pack from the added templates; an empty path keeps it in memory only */
+    void build_template_pack(const std::string& pack_path = {}, int branching = 8, int depth = 4) {
+        check(meshmind_build_template_pack(handle_, pack_path.empty() ? nullptr : pack_path.c_str(),
+                                           branching, depth));
+    }
+
+    void load_template_pack(const std::string& pack_path) {
+        check(meshmind_load_template_pack(handle_, pack_path.c_str()));
+    }
+
+    /* Match only the top_k templates retrieved from the template pack per search region; 0 matches all */
+    void set_template_retrieval(int top_k) {
+        check(meshmind_set_template_retrieval(handle_, top_k));
+    }
+
+    Results detect() {
+        MeshMindResults raw;
+        check(meshmind_detect_results(handle_, &raw));
+        return Results(raw);
+    }
+
+    /* Results of the last detection (or restored snapshot) */
+    Results results() const {
+        MeshMindResults raw;
+        check(meshmind_get_results(handle_, &raw));
+        return Results(raw);
+    }
+
+    /*
+     * Run detection on a background thread (meshmind_detect_async). The
+     * Detector must outlive the returned future; other calls on it throw
+     * Error(MESHMIND_ERROR_BUSY) until the future is ready.
+     */
+    std::future<Results> detect_async() {
+        check(meshmind_detect_async(handle_));
+        MeshMindDetector handle = handle_;
+        return std::async(std::launch::async, [handle]() {
+            int status = meshmind_wait(handle, -1.0);
+            if (status < 0) {
+                throw Error(status, meshmind_get_error(handle));
+            }
+            MeshMindResults raw;
+            status = meshmind_get_results(handle, &raw);
+            if (status < 0) {
+                throw Error(status, meshmind_get_error(handle));
+            }
+            return Results(raw);
+        });
+    }
+
+    void save_snapshot(const std::string& path) {
+        check(meshmind_save_snapshot(handle_, path.c_str()));
+    }
+
+    void load_snapshot(const std::string& path) {
+        check(meshmind_load_snapshot(handle_, path.c_str()));
+    }
+
+    void set_checkpoint(const std::string& path, double interval_seconds) {
+        check(meshmind_set_checkpoint(handle_, path.c_str(), interval_seconds));
+    }
+
+    void disable_checkpoint() {
+        check(meshmind_set_checkpoint(handle_, nullptr, 0.0));
+    }
+
+    /* ML-assisted matching with the native MeshCNN extractor (.mmnn weights) */
+    void load_feature_model(const std::string& weights_path) {
+        check(meshmind_load_feature_model(handle_, weights_path.c_str()));
+    }
+
+    std::vector<float> extract_features(const std::string& mesh_path) {
+        int dim = meshmind_extract_features(handle_, mesh_path.c_str(), nullptr, 0);
+        check(dim);
+        std::vector<float> features(static_cast<size_t>(dim));
+        check(meshmind_extract_features(handle_, mesh_path.c_str(), features.data(), dim));
+        return features;
+    }
+
+    /* (cosine + 1) / 2 feature similarity of each template to the target, in registration order */
+    std::vector<double> template_similarity(size_t template_count) {
+        std::vector<double> similarities(template_count);
+        int count = meshmind_template_similarity(handle_, similarities.data(),
+                                                 static_cast<int>(template_count));
+        check(count);
+        similarities.resize(static_cast<size_t>(count));
+        return similarities;
+    }
+
+    /* Load a native detector plugin (see meshmind/plugin.h); returns its name */
+    std::string load_plugin(const std::string& library_path, const std::string& config = "") {
+        int index = meshmind_load_plugin(handle_, library_path.c_str(), config.empty() ? nullptr : config.c_str());
+        check(index);
+        return meshmind_plugin_name(handle_, index);
+    }
+
+    void export_snappy_dict(const std::string& output_path) {
+        check(meshmind_export_snappy_dict(handle_, output_path.c_str()));
+    }
+
+    void export_openfoam_case(const std::string& case_dir, bool enable_mrf = true) {
+        check(meshmind_export_openfoam_case(handle_, case_dir.c_str(), enable_mrf ? 1 : 0));
+    }
+
+    void export_ftetwild_sizing(const std::string& output_path) {
+        check(meshmind_export_ftetwild_sizing(handle_, output_path.c_str()));
+    }
+
+    /* Inputs for several mesh generators ("snappyhexmesh", "ftetwild") from one detection */
+    void export_mesher_inputs(const std::vector<std::pair<std::string, std::string>>& generator_paths) {
+        std::vector<const char*> generators, paths;
+        for (const auto& entry : generator_paths) {
+            generators.push_back(entry.first.c_str());
+            paths.push_back(entry.second.c_str());
+        }
+        check(meshmind_export_mesher_inputs(handle_, generators.data(), paths.data(),
+                                            static_cast<int>(generators.size())));
+    }
+
+    MeshMindDetector native_handle() const noexcept { return handle_; }
+
+    static const char* version() noexcept { return meshmind_version(); }
+
+private:
+    void reset() noexcept {
+        if (handle_) {
+            meshmind_destroy_detector(handle_);
+            handle_ = nullptr;
+        }
+    }
+
+    void check(int status) const {
+        if (status >= 0) {
+            return;
+        }
+        if (status == MESHMIND_ERROR_BUSY) {
+            throw Error(status, "Detector is busy with an asynchronous detection");
+        }
+        if (!handle_) {
+            throw Error(status, "Detector has been moved from");
+        }
+        throw Error(status, meshmind_get_error(handle_));
+    }
+
+    MeshMindDetector handle_;
+};
+
+}  // namespace meshmind
@@ -0,0 +1,148 @@
+/*
+ * MeshMind-AFID Native Detector Plugin ABI
+ *
+ * Stable C interface for detectors shipped as shared libraries and loaded
+ * by meshmind_core with dlopen (LoadLibrary on Windows). A plugin sees the
+ * target exactly as the built-in FPFH matcher prepared it: mesh, surface
+ * samples with normals, FPFH descriptors and the triangle BVH are passed as
+ * read-only pointers into the engine's own storage, with no copies and no
+ * Python in between.
+ *
+ * A plugin library exports one function:
+ *
+ *     MESHMIND_PLUGIN_EXPORT const MeshMindDetectorPlugin* meshmind_detector_plugin(void);
+ *
+ * Compatibility rules: plugins are accepted when their abi_version equals
+ * MESHMIND_PLUGIN_ABI_VERSION. Within one ABI version, structs only grow by
+ * appending fields; every struct starts with its struct_size, so plugins
+ * must check struct_size before reading fields added after their build.
+ * The host likewise reads only the descriptor fields within the plugin's
+ * struct_size; fields up to detect are required.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MESHMIND_PLUGIN_ABI_VERSION 1
+#define MESHMIND_PLUGIN_ENTRY_SYMBOL "meshmind_detector_plugin"
+
+#if defined(_WIN32)
+#define MESHMIND_PLUGIN_VISIBILITY __declspec(dllexport)
+#else
+#define MESHMIND_PLUGIN_VISIBILITY __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+#define MESHMIND_PLUGIN_EXPORT extern "C" MESHMIND_PLUGIN_VISIBILITY
+#else
+#define MESHMIND_PLUGIN_EXPORT MESHMIND_PLUGIN_VISIBILITY
+#endif
+
+/* Status codes returned by MeshMindDetectorPlugin.detect */
+#define MESHMIND_PLUGIN_ERROR -1
+
+/* BVH node, flattened depth-first: the left child of an inner node is the next node */
+typedef struct {
+    double bounds_min[3];
+    double bounds_max[3];
+    int32_t offset;   /* leaf: first entry in bvh_triangles; inner: index of the right child */
+    int32_t count;    /* leaf: number of triangles; inner: 0 */
+} MeshMindBVHNode;
+
+/*
+ * Read-only view of the prepared target. All arrays are owned by the engine
+ * and stay valid for the duration of the detect call.
+ */
+typedef struct MeshMindTargetView {
+    uint32_t struct_size;   /* sizeof(MeshMindTargetView) of the host */
+
+    /* Full-resolution mesh */
+    const double* vertices;           /* [num_vertices * 3] */
+    const int32_t* faces;             /* [num_faces * 3] vertex indices */
+    size_t num_vertices;
+    size_t num_faces;
+
+    /* Surface samples used for matching, with the normals of their faces */
+    const double* points;             /* [num_points * 3] */
+    const double* normals;            /* [num_points * 3] unit normals */
+    size_t num_points;
+
+    /* FPFH descriptors of the samples */
+    const double* descriptors;        /* [num_points * descriptor_dims] */
+    size_t descriptor_dims;
+
+    /* Triangle BVH over the mesh faces */
+    const MeshMindBVHNode* bvh_nodes; /* [num_bvh_nodes], root first */
+    const int32_t* bvh_triangles;     /* [num_faces] face indices in leaf order */
+    size_t num_bvh_nodes;
+
+    /*
+     * Queries on the engine's indexes; pass context as the first argument.
+     * All are thread-safe, so plugins may call them from their own threads.
+     */
+    const void* context;
+
+    /* Closest surface point within max_distance; returns the face index, or -1 */
+    int64_t (*closest_point)(const void* context, const double* query, double max_distance,
+                             double* point, double* distance);
+
+    /* k nearest samples to a 3D point; returns the number found (sorted, squared distances) */
+    size_t (*nearest_points)(const void* context, const double* query, size_t k,
+                             size_t* indices, double* sq_distances);
+
+    /* k nearest samples in descriptor space; query has descriptor_dims values */
+    size_t (*nearest_descriptors)(const void* context, const double* descriptor, size_t k,
+                                  size_t* indices, double* sq_distances);
+} MeshMindTargetView;
+
+/* Template to locate in the target */
+typedef struct MeshMindTemplateView {
+    uint32_t struct_size;   /* sizeof(MeshMindTemplateView) of the host */
+    const char* path;
+    const char* feature_id;
+    const double* vertices; /* [num_vertices * 3] */
+    const int32_t* faces;   /* [num_faces * 3] */
+    size_t num_vertices;
+    size_t num_faces;
+} MeshMindTemplateView;
+
+/* One template instance found by a plugin */
+typedef struct {
+    double transform[16];   /* 4x4 row-major, maps template onto target */
+    double confidence;      /* [0, 1] */
+    double radius;          /* feature radius, 0 if unknown */
+} MeshMindPluginDetection;
+
+/* Plugin descriptor returned by the entry point; must stay valid while loaded */
+typedef struct MeshMindDetectorPlugin {
+    uint32_t abi_version;   /* MESHMIND_PLUGIN_ABI_VERSION the plugin was built against */
+    uint32_t struct_size;   /* sizeof(MeshMindDetectorPlugin) of the plugin */
+    const char* name;       /* detector name, e.g. for DetectorRegistry */
+
+    /* Create an instance from a configuration string (may be NULL); returns NULL on failure */
+    void* (*create)(const char* config);
+    void (*destroy)(void* instance);
+
+    /*
+     * Locate one template in the target.
+     * @return Number of detections written (at most max_detections), or
+     *         MESHMIND_PLUGIN_ERROR
+     */
+    int (*detect)(void* instance, const MeshMindTargetView* target, const MeshMindTemplateView* tmpl,
+                  MeshMindPluginDetection* detections, int max_detections);
+
+    /* Message for the last failed call on instance (may be NULL) */
+    const char* (*get_error)(void* instance);
+} MeshMindDetectorPlugin;
+
+typedef const MeshMindDetectorPlugin* (*MeshMindPluginEntry)(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,793 @@
+/**
+ * MeshMind-AFID Native Python Module (meshmind._native)
+ *
+ * Exposes the native engine to the Python SDK. Inputs are accepted as
+ * C-contiguous float64 NumPy arrays (no copy when already in that layout),
+ * outputs are returned as NumPy arrays owning the engine's buffers, and the
+ * GIL is released for all geometry work.
+ */
+
+#include "native/dataset.h"
+#include "native/descriptors.h"
+#include "native/ensemble.h"
+#include "native/exporters.h"
+#include "native/families.h"
+#include "native/kdtree.h"
+#include "native/localizer.h"
+#include "native/matcher.h"
+#include "native/meshcnn.h"
+#include "native/meshcnn_kernels.h"
+#include "native/mesh.h"
+#include "native/morton.h"
+#include "native/parallel.h"
+#include "native/planner.h"
+#include "native/plugin_host.h"
+#include "native/region.h"
+#include "native/registration.h"
+#include "native/robust.h"
+#include "native/rotation.h"
+#include "native/transform.h"
+#include "native/verify.h"
+#include "native/vocab.h"
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace py = pybind11;
+using namespace meshmind;
+
+using DoubleArray = py::array_t<double, py::array::c_style | py::array::forcecast>;
+using IndexArray = py::array_t<int64_t, py::array::c_style | py::array::forcecast>;
+
+namespace {
+
+/* Hand a vector to NumPy without copying; the array keeps the buffer alive */
+template <typename T>
+py::array_t<T> to_numpy(std::vector<T>&& data, std::vector<py::ssize_t> shape) {
+    auto* owned = new std::vector<T>(std::move(data));
+    py::capsule release(owned, [](void* p) { delete static_cast<std::vector<T>*>(p); });
+    return py::array_t<T>(shape, owned->data(), release);
+}
+
+/* Validate an (N, cols) array and return N */
+size_t rows(const py::array& array, py::ssize_t cols, const char* name) {
+    if (array.ndim() != 2 || array.shape(1) != cols) {
+        throw std::invalid_argument(std::string(name) + " must have shape (N, " +
+                                    std::to_string(cols) + ")");
+    }
+    return size_t(array.shape(0));
+}
+
+TriangleMesh to_mesh(const DoubleArray& vertices, const IndexArray& faces) {
+    size_t num_vertices = rows(vertices, 3, "vertices");
+    size_t num_faces = rows(faces, 3, "faces");
+    TriangleMesh mesh;
+    mesh.vertices.assign(vertices.data(), vertices.data() + num_vertices * 3);
+    mesh.faces.resize(num_faces * 3);
+    const int64_t* f = faces.data();
+    for (size_t i = 0; i < num_faces * 3; i++) {
+        if (f[i] < 0 || size_t(f[i]) >= num_vertices) {
+            throw std::out_of_range("Face index out of range");
+        }
+        mesh.faces[i] = int32_t(f[i]);
+    }
+    return mesh;
+}
+
+py::array_t<double> transform_to_numpy(const double* transform) {
+    return to_numpy(std::vector<double>(transform, transform + 16), {4, 4});
+}
+
+/* Plugin target that keeps its mesh and matcher alive */
+struct OwnedPluginTarget {
+    TriangleMesh mesh;
+    std::shared_ptr<TemplateMatcher> index;
+    std::unique_ptr<BVH> bvh;
+    std::unique_ptr<PluginTarget> target;
+};
+
+const double* transform_data(const DoubleArray& transform) {
+    if (transform.ndim() != 2 || transform.shape(0) != 4 || transform.shape(1) != 4) {
+        throw std::invalid_argument("transform must have shape (4, 4)");
+    }
+    return transform.data();
+}
+
+/* (k, n, 3) points under each of k poses, in the precision of the points */
+template <typename T>
+py::array_t<T> transform_batch_numpy(const DoubleArray& transforms, const py::array& array, bool vectors) {
+    if (transforms.ndim() != 3 || transforms.shape(1) != 4 || transforms.shape(2) != 4) {
+        throw std::invalid_argument("transforms must have shape (k, 4, 4)");
+    }
+    auto points = array.cast<py::array_t<T, py::array::c_style | py::array::forcecast>>();
+    size_t n = rows(points, 3, "points");
+    size_t k = size_t(transforms.shape(0));
+    std::vector<T> out(k * n * 3);
+    {
+        py::gil_scoped_release release;
+        const T* p = points.data();
+        std::vector<T> x(n), y(n), z(n), moved(3 * k * n);
+        for (size_t i = 0; i < n; i++) {
+            x[i] = p[3 * i];
+            y[i] = p[3 * i + 1];
+            z[i] = p[3 * i + 2];
+        }
+        T* moved_x = moved.data();
+        T* moved_y = moved_x + k * n;
+        T* moved_z = moved_y + k * n;
+        transform_batch(transforms.data(), k, x.data(), y.data(), z.data(), n, moved_x, moved_y, moved_z, !vectors);
+        for (size_t i = 0; i < k * n; i++) {
+            out[3 * i] = moved_x[i];
+            out[3 * i + 1] = moved_y[i];
+            out[3 * i + 2] = moved_z[i];
+        }
+    }
+    return to_numpy(std::move(out), {py::ssize_t(k), py::ssize_t(n), 3});
+}
+
+}  // namespace
+
+PYBIND11_MODULE(_native, m) {
+    m.doc() = "MeshMind native detection engine";
+    m.attr("FPFH_DIMS") = FPFH_DIMS;
+
+    m.def("load_mesh", [](const std::string& path) {
+        TriangleMesh mesh;
+        {
+            py::gil_scoped_release release;
+            mesh = load_mesh(path);
+        }
+        std::vector<int64_t> faces(mesh.faces.begin(), mesh.faces.end());
+        py::ssize_t nv = py::ssize_t(mesh.num_vertices());
+        py::ssize_t nf = py::ssize_t(mesh.num_faces());
+        return py::make_tuple(to_numpy(std::move(mesh.vertices), {nv, 3}),
+                              to_numpy(std::move(faces), {nf, 3}));
+    }, py::arg("path"), "Load an STL/OBJ/OFF file; returns (vertices, faces)");
+
+    m.def("write_dataset_shards", [](const std::vector<std::string>& paths, const std::vector<int32_t>& labels,
+                                     const std::string& prefix, size_t points_per_sample,
+                                     size_t samples_per_shard, uint64_t seed) {
+        if (paths.size() != labels.size()) {
+            throw std::invalid_argument("paths and labels must have the same length");
+        }
+        std::vector<DatasetSample> samples(paths.size());
+        for (size_t i = 0; i < paths.size(); i++) {
+            samples[i] = DatasetSample{paths[i], labels[i]};
+        }
+        ShardOptions options;
+        options.points_per_sample = points_per_sample;
+        options.samples_per_shard = samples_per_shard;
+        options.seed = seed;
+        ShardResult result;
+        {
+            py::gil_scoped_release release;
+            result = write_dataset_shards(samples, prefix, options);
+        }
+        return py::make_tuple(result.shards, result.counts, result.skipped);
+    }, py::arg("paths"), py::arg("labels"), py::arg("prefix"), py::arg("points_per_sample") = 1024,
+       py::arg("samples_per_shard") = 1024, py::arg("seed") = 0,
+       "Preprocess meshes into .mmds shards; returns (shard_paths, counts, skipped)");
+
+    m.def("sample_surface", [](DoubleArray vertices, IndexArray faces, size_t count, uint64_t seed) {
+        PointSet samples;
+        {
+            TriangleMesh mesh = to_mesh(vertices, faces);
+            py::gil_scoped_release release;
+            samples = sample_surface(mesh, count, seed);
+        }
+        py::ssize_t n = py::ssize_t(samples.size());
+        return py::make_tuple(to_numpy(std::move(samples.points), {n, 3}),
+                              to_numpy(std::move(samples.normals), {n, 3}));
+    }, py::arg("vertices"), py::arg("faces"), py::arg("count"), py::arg("seed") = 0,
+       "Area-weighted surface samples in Morton order; returns (points, normals)");
+
+    m.def("morton_order", [](DoubleArray points) {
+        size_t n = rows(points, 3, "points");
+        std::vector<uint32_t> order;
+        {
+            py::gil_scoped_release release;
+            order = morton_order(points.data(), n);
+        }
+        return to_numpy(std::move(order), {py::ssize_t(n)});
+    }, py::arg("points"),
+       "Permutation of (N, 3) points into Morton (Z) order: points[order] keeps close points close in memory");
+
+    m.def("estimate_normals", [](DoubleArray points, double radius, size_t max_nn) {
+        size_t n = rows(points, 3, "points");
+        std::vector<double> normals;
+        {
+            py::gil_scoped_release release;
+            normals = estimate_normals(points.data(), n, radius, max_nn);
+        }
+        return to_numpy(std::move(normals), {py::ssize_t(n), 3});
+    }, py::arg("points"), py::arg("radius") = 0.1, py::arg("max_nn") = 30);
+
+    m.def("compute_fpfh", [](DoubleArray points, DoubleArray normals, double radius, size_t max_nn) {
+        size_t n = rows(points, 3, "points");
+        if (rows(normals, 3, "normals") != n) {
+            throw std::invalid_argument("points and normals must have the same length");
+        }
+        std::vector<double> features;
+        {
+            py::gil_scoped_release release;
+            features = compute_fpfh(PointsView{points.data(), normals.data(), n}, radius, max_nn);
+        }
+        return to_numpy(std::move(features), {py::ssize_t(n), py::ssize_t(FPFH_DIMS)});
+    }, py::arg("points"), py::arg("normals"), py::arg("radius") = 0.25, py::arg("max_nn") = 100,
+       "FPFH descriptors, shape (N, 33)");
+
+    m.def("procrustes", [](DoubleArray source, DoubleArray target, bool with_scale) {
+        size_t n = rows(source, 3, "source");
+        if (rows(target, 3, "target") != n) {
+            throw std::invalid_argument("source and target must have the same length");
+        }
+        Pose pose;
+        {
+            py::gil_scoped_release release;
+            pose = procrustes(source.data(), target.data(), n, with_scale);
+        }
+        return py::make_tuple(transform_to_numpy(pose.transform), pose.cost);
+    }, py::arg("source"), py::arg("target"), py::arg("scale") = true,
+       "Returns (transform, cost) mapping source onto target");
+
+    m.def("ransac_procrustes", [](DoubleArray source, DoubleArray target, double threshold, size_t iterations,
+                                  bool with_scale, uint64_t seed) {
+        size_t n = rows(source, 3, "source");
+        if (rows(target, 3, "target") != n) {
+            throw std::invalid_argument("source and target must have the same length");
+        }
+        RansacParams params;
+        params.iterations = iterations;
+        params.inlier_threshold = threshold;
+        params.with_scale = with_scale;
+        params.seed = seed;
+        RansacPose result;
+        {
+            py::gil_scoped_release release;
+            result = ransac_procrustes(source.data(), target.data(), n, params);
+        }
+        return py::make_tuple(transform_to_numpy(result.pose.transform), result.inliers, result.pose.cost);
+    }, py::arg("source"), py::arg("target"), py::arg("threshold"), py::arg("iterations") = 1000,
+       py::arg("scale") = true, py::arg("seed") = 0,
+       "Returns (transform, inliers, cost) of the best 3-point hypothesis refitted on its inliers");
+
+    m.def("robust_registration", [](DoubleArray source, DoubleArray target, double noise_bound, bool with_scale,
+                                    size_t max_correspondences) {
+        size_t n = rows(source, 3, "source");
+        if (rows(target, 3, "target") != n) {
+            throw std::invalid_argument("source and target must have the same length");
+        }
+        RobustParams params;
+        params.noise_bound = noise_bound;
+        params.with_scale = with_scale;
+        params.max_correspondences = max_correspondences;
+        RobustPose result;
+        {
+            py::gil_scoped_release release;
+            result = robust_registration(source.data(), target.data(), n, params);
+        }
+        return py::make_tuple(transform_to_numpy(result.pose.transform), result.inliers, result.clique_size);
+    }, py::arg("source"), py::arg("target"), py::arg("noise_bound"), py::arg("scale") = true,
+       py::arg("max_correspondences") = 1000,
+       "Returns (transform, inliers, clique_size) from max-clique registration of the correspondences");
+
+    m.def("verify_pose", [](DoubleArray transform, DoubleArray samples, DoubleArray vertices, IndexArray faces,
+                            double inlier_distance, double min_coverage) {
+        const double* t = transform_data(transform);
+        size_t n = rows(samples, 3, "samples");
+        TriangleMesh mesh = to_mesh(vertices, faces);
+        VerifyParams params;
+        params.inlier_distance = inlier_distance;
+        params.min_coverage = min_coverage;
+        Verification result;
+        {
+            py::gil_scoped_release release;
+            BVH bvh(mesh);
+            result = verify_pose(t, samples.data(), n, bvh, params);
+        }
+        return py::make_tuple(result.coverage, result.rms, result.rejected);
+    }, py::arg("transform"), py::arg("samples"), py::arg("vertices"), py::arg("faces"), py::arg("inlier_distance"),
+       py::arg("min_coverage") = 0.0,
+       "Returns (coverage, rms, rejected) of the samples moved by transform against the target surface");
+
+    m.def("icp_refine", [](DoubleArray transforms, py::list levels, DoubleArray vertices, IndexArray faces,
+                           size_t iterations, double trim, bool symmetric) {
+        if (transforms.ndim() != 3 || transforms.shape(1) != 4 || transforms.shape(2) != 4) {
+            throw std::invalid_argument("transforms must have shape (k, 4, 4)");
+        }
+        const size_t count = size_t(transforms.shape(0));
+        if (py::len(levels) != count) {
+            throw std::invalid_argument("levels must hold one list of point arrays per transform");
+        }
+        // Each level is (n, 3) points or (n, 6) points with normals
+        std::vector<std::vector<PointSet>> samples(count);
+        for (size_t k = 0; k < count; k++) {
+            for (py::handle level : levels[k].cast<py::list>()) {
+                DoubleArray array = level.cast<DoubleArray>();
+                if (array.ndim() != 2 || (array.shape(1) != 3 && array.shape(1) != 6)) {
+                    throw std::invalid_argument("each level must have shape (n, 3) or (n, 6)");
+                }
+                const size_t n = size_t(array.shape(0)), cols = size_t(array.shape(1));
+                PointSet set;
+                for (size_t i = 0; i < n; i++) {
+                    set.points.insert(set.points.end(), array.data() + i * cols, array.data() + i * cols + 3);
+                    if (cols == 6) {
+                        set.normals.insert(set.normals.end(), array.data() + i * cols + 3, array.data() + i * cols + 6);
+                    }
+                }
+                samples[k].push_back(std::move(set));
+            }
+        }
+        TriangleMesh mesh = to_mesh(vertices, faces);
+        ICPParams params;
+        params.iterations = iterations;
+        params.trim = trim;
+        params.symmetric = symmetric;
+        std::vector<ICPSource> sources(count);
+        for (size_t k = 0; k < count; k++) {
+            for (const PointSet& set : samples[k]) {
+                sources[k].levels.push_back(set.view());
+            }
+            std::copy(transforms.data() + 16 * k, transforms.data() + 16 * (k + 1), sources[k].transform);
+        }
+        std::vector<ICPResult> results;
+        {
+            py::gil_scoped_release release;
+            BVH bvh(mesh);
+            results = icp_refine(sources, bvh, params);
+        }
+        std::vector<double> refined(16 * count), rms(count);
+        for (size_t k = 0; k < count; k++) {
+            std::copy(results[k].transform, results[k].transform + 16, &refined[16 * k]);
+            rms[k] = results[k].rms;
+        }
+        return py::make_tuple(to_numpy(std::move(refined), {py::ssize_t(count), 4, 4}),
+                              to_numpy(std::move(rms), {py::ssize_t(count)}));
+    }, py::arg("transforms"), py::arg("levels"), py::arg("vertices"), py::arg("faces"), py::arg("iterations") = 8,
+       py::arg("trim") = 0.9, py::arg("symmetric") = false,
+       "Returns (transforms, rms): the poses refined by ICP over each pose's levels, coarse to fine, in parallel");
+
+    m.def("plan_query", [](double template_area, double region_area, size_t instances) {
+        SurfaceStats tmpl, region;
+        tmpl.area = template_area;
+        region.area = region_area;
+        QueryPlan plan = plan_query(tmpl, region, instances);
+        static const char* const names[] = {"procrustes", "ransac", "max_clique"};
+        py::dict result;
+        result["strategy"] = names[int(plan.strategy)];
+        result["coarse_points"] = plan.coarse_points;
+        result["ransac_iterations"] = plan.ransac_iterations;
+        result["inlier_ratio"] = plan.inlier_ratio;
+        result["cost"] = plan.cost;
+        result["feasible"] = plan.feasible;
+        return result;
+    }, py::arg("template_area"), py::arg("region_area"), py::arg("instances") = 1,
+       "Pose strategy and template sample count the query planner picks for these surface areas");
+
+    m.def("transform_points", [](DoubleArray transform, DoubleArray points) {
+        const double* t = transform_data(transform);
+        size_t n = rows(points, 3, "points");
+        std::vector<double> out(n * 3);
+        {
+            py::gil_scoped_release release;
+            transform_points(t, points.data(), n, out.data());
+        }
+        return to_numpy(std::move(out), {py::ssize_t(n), 3});
+    }, py::arg("transform"), py::arg("points"));
+
+    m.def("transform_batch", [](DoubleArray transforms, py::array points, bool vectors) -> py::array {
+        if (py::isinstance<py::array_t<float>>(points)) {
+            return transform_batch_numpy<float>(transforms, points, vectors);
+        }
+        return transform_batch_numpy<double>(transforms, points, vectors);
+    }, py::arg("transforms"), py::arg("points"), py::arg("vectors") = false,
+       "(k, n, 3) points moved by each of k (4, 4) transforms, float32 or float64 as the points; "
+       "vectors=True skips the translation");
+
+    py::class_<KDTree, std::shared_ptr<KDTree>>(m, "KDTree")
+        .def(py::init([](DoubleArray points, size_t leaf_size) {
+            if (points.ndim() != 2) {
+                throw std::invalid_argument("points must be a 2-D array");
+            }
+            size_t n = size_t(points.shape(0));
+            size_t dim = size_t(points.shape(1));
+            py::gil_scoped_release release;
+            return std::make_shared<KDTree>(points.data(), n, dim, leaf_size);
+        }), py::arg("points"), py::arg("leaf_size") = 16)
+        .def_property_readonly("n", &KDTree::size)
+        .def_property_readonly("m", &KDTree::dim)
+        .def("query", [](const KDTree& tree, DoubleArray x, size_t k) {
+            size_t n = rows(x, py::ssize_t(tree.dim()), "x");
+            if (k == 0 || k > tree.size()) {
+                throw std::invalid_argument("k must be in [1, n]");
+            }
+            std::vector<double> distances(n * k);
+            std::vector<int64_t> indices(n * k);
+            {
+                py::gil_scoped_release release;
+                const double* queries = x.data();
+                parallel_for(n, [&](size_t begin, size_t end) {
+                    std::vector<size_t> found(k);
+                    for (size_t i = begin; i < end; i++) {
+                        tree.knn(queries + i * tree.dim(), k, found.data(), &distances[i * k]);
+                        for (size_t j = 0; j < k; j++) {
+                            indices[i * k + j] = int64_t(found[j]);
+                            distances[i * k + j] = std::sqrt(distances[i * k + j]);
+                        }
+                    }
+                });
+            }
+            if (k == 1) {
+                return py::make_tuple(to_numpy(std::move(distances), {py::ssize_t(n)}),
+                                      to_numpy(std::move(indices), {py::ssize_t(n)}));
+            }
+            return py::make_tuple(to_numpy(std::move(distances), {py::ssize_t(n), py::ssize_t(k)}),
+                                  to_numpy(std::move(indices), {py::ssize_t(n), py::ssize_t(k)}));
+        }, py::arg("x"), py::arg("k") = 1,
+           "Same contract as scipy.spatial.KDTree.query: (distances, indices)");
+
+    py::class_<TemplateMatcher, std::shared_ptr<TemplateMatcher>>(m, "TemplateMatcher")
+        .def(py::init([](DoubleArray vertices, IndexArray faces, size_t coarse_points, uint64_t seed,
+                         py::object boxes) {
+            TriangleMesh mesh = to_mesh(vertices, faces);
+            MatcherParams params;
+            params.coarse_points = coarse_points;
+            params.seed = seed;
+            SearchRegion region;
+            if (!boxes.is_none()) {
+                DoubleArray box_array = boxes.cast<DoubleArray>();
+                size_t n = rows(box_array, 6, "boxes");
+                region.boxes.assign(box_array.data(), box_array.data() + n * 6);
+            }
+            py::gil_scoped_release release;
+            if (region.unrestricted()) {
+                return std::make_shared<TemplateMatcher>(mesh, params);
+            }
+            // Only the target surface inside the boxes is sampled and described
+            BVH bvh(mesh);
+            return std::make_shared<TemplateMatcher>(
+                sample_region(bvh, region, params.coarse_points, params.seed), params);
+        }), py::arg("vertices"), py::arg("faces"), py::arg("coarse_points") = 500, py::arg("seed") = 0,
+            py::arg("boxes") = py::none())
+        .def_static("from_index", [](DoubleArray coarse_points, DoubleArray features) {
+            size_t n = rows(coarse_points, 3, "coarse_points");
+            if (rows(features, py::ssize_t(FPFH_DIMS), "features") != n) {
+                throw std::invalid_argument("coarse_points and features must have the same length");
+            }
+            std::vector<double> points(coarse_points.data(), coarse_points.data() + n * 3);
+            std::vector<double> descriptors(features.data(), features.data() + n * FPFH_DIMS);
+            py::gil_scoped_release release;
+            return std::make_shared<TemplateMatcher>(std::move(points), std::move(descriptors));
+        }, py::arg("coarse_points"), py::arg("features"))
+        .def_property_readonly("coarse_points", [](py::object self) {
+            // Views into the matcher's storage, kept alive by the matcher object
+            const TemplateMatcher& matcher = self.cast<const TemplateMatcher&>();
+            return py::array_t<double>({py::ssize_t(matcher.size()), py::ssize_t(3)},
+                                       matcher.coarse_points().data(), self);
+        })
+        .def_property_readonly("features", [](py::object self) {
+            const TemplateMatcher& matcher = self.cast<const TemplateMatcher&>();
+            return py::array_t<double>({py::ssize_t(matcher.size()), py::ssize_t(FPFH_DIMS)},
+                                       matcher.features().data(), self);
+        })
+        .def("match", [](const TemplateMatcher& matcher, DoubleArray vertices, IndexArray faces) {
+            MatchResult result;
+            {
+                TriangleMesh mesh = to_mesh(vertices, faces);
+                py::gil_scoped_release release;
+                result = matcher.match(mesh);
+            }
+            py::dict info;
+            info["confidence"] = result.confidence;
+            info["mean_feature_distance"] = result.mean_feature_distance;
+            info["coarse_feature_distance"] = result.coarse_feature_distance;
+            info["matches_indices"] = py::cast(result.matches);
+            return info;
+        }, py::arg("vertices"), py::arg("faces"),
+           "Same dictionary as meshmind.core.matcher.TemplateMatcher.match")
+        .def("detect", [](const TemplateMatcher& matcher, DoubleArray vertices, IndexArray faces) {
+            TemplateDetection detection;
+            {
+                TriangleMesh mesh = to_mesh(vertices, faces);
+                py::gil_scoped_release release;
+                detection = matcher.detect(mesh);
+            }
+            return py::make_tuple(transform_to_numpy(detection.transform), detection.confidence,
+                                  detection.mean_feature_distance, detection.alignment_cost);
+        }, py::arg("vertices"), py::arg("faces"),
+           "Returns (transform, confidence, mean_feature_distance, alignment_cost)");
+
+    py::class_<FFTLocalizer, std::shared_ptr<FFTLocalizer>>(m, "FFTLocalizer")
+        .def(py::init([](DoubleArray vertices, IndexArray faces, double voxel_size) {
+            TriangleMesh mesh = to_mesh(vertices, faces);
+            py::gil_scoped_release release;
+            return std::make_shared<FFTLocalizer>(mesh, voxel_size);
+        }), py::arg("vertices"), py::arg("faces"), py::arg("voxel_size") = 0.0)
+        .def_property_readonly("voxel_size", &FFTLocalizer::voxel_size)
+        .def("locate", [](const FFTLocalizer& localizer, DoubleArray vertices, IndexArray faces,
+                          size_t max_peaks, double min_score) {
+            std::vector<TranslationPeak> peaks;
+            {
+                TriangleMesh mesh = to_mesh(vertices, faces);
+                py::gil_scoped_release release;
+                peaks = localizer.locate(mesh, max_peaks, min_score);
+            }
+            std::vector<double> translations, scores;
+            for (const auto& peak : peaks) {
+                translations.insert(translations.end(), peak.translation, peak.translation + 3);
+                scores.push_back(peak.score);
+            }
+            py::ssize_t n = py::ssize_t(peaks.size());
+            return py::make_tuple(to_numpy(std::move(translations), {n, 3}), to_numpy(std::move(scores), {n}));
+        }, py::arg("vertices"), py::arg("faces"), py::arg("max_peaks") = 4, py::arg("min_score") = 0.3,
+           "Returns (translations, scores) of the best template placements, strongest first");
+
+    py::class_<RotationSearch, std::shared_ptr<RotationSearch>>(m, "RotationSearch")
+        .def(py::init([](DoubleArray points, DoubleArray center, double radius, int bandwidth) {
+            size_t n = rows(points, 3, "points");
+            if (center.size() != 3) {
+                throw std::invalid_argument("center must have 3 values");
+            }
+            RotationParams params;
+            params.bandwidth = bandwidth;
+            py::gil_scoped_release release;
+            return std::make_shared<RotationSearch>(points.data(), n, center.data(), radius, params);
+        }), py::arg("points"), py::arg("center"), py::arg("radius"), py::arg("bandwidth") = 8,
+           "Spherical harmonic expansion of template points within radius of center")
+        .def("search", [](const RotationSearch& search, DoubleArray points, DoubleArray center, size_t max_rotations) {
+            size_t n = rows(points, 3, "points");
+            if (center.size() != 3) {
+                throw std::invalid_argument("center must have 3 values");
+            }
+            std::vector<RotationCandidate> candidates;
+            {
+                py::gil_scoped_release release;
+                candidates = search.search(points.data(), n, center.data(), max_rotations);
+            }
+            std::vector<double> rotations, scores;
+            for (const auto& candidate : candidates) {
+                rotations.insert(rotations.end(), candidate.rotation, candidate.rotation + 9);
+                scores.push_back(candidate.score);
+            }
+            py::ssize_t k = py::ssize_t(candidates.size());
+            return py::make_tuple(to_numpy(std::move(rotations), {k, 3, 3}), to_numpy(std::move(scores), {k}));
+        }, py::arg("points"), py::arg("center"), py::arg("max_rotations") = 4,
+           "Returns (rotations, scores) of the template about its center onto the target points, strongest first");
+
+    py::class_<MeshCNNExtractor, std::shared_ptr<MeshCNNExtractor>>(m, "MeshCNN")
+        .def(py::init([](const std::string& path) {
+            py::gil_scoped_release release;
+            return std::make_shared<MeshCNNExtractor>(MeshCNNExtractor::load(path));
+        }), py::arg("weights_path"), "Load feature layers exported by export_native_weights")
+        .def_property_readonly("feature_dim", &MeshCNNExtractor::feature_dim)
+        .def_property_readonly("quantized", &MeshCNNExtractor::quantized)
+        .def_property_readonly("kernels", [](const MeshCNNExtractor&) {
+            return std::string(meshcnn_kernels().isa);
+        }, "Instruction set of the kernels picked for this CPU")
+        .def("extract_features", [](const MeshCNNExtractor& model, DoubleArray vertices) {
+            size_t n = rows(vertices, 3, "vertices");
+            std::vector<float> features(model.feature_dim());
+            {
+                py::gil_scoped_release release;
+                model.extract(vertices.data(), n, features.data());
+            }
+            return to_numpy(std::move(features), {py::ssize_t(model.feature_dim())});
+        }, py::arg("vertices"), "Same result as SimplifiedMeshCNN.extract_features (eval mode)")
+        .def("extract_batch", [](const MeshCNNExtractor& model, std::vector<DoubleArray> meshes) {
+            std::vector<PointsView> views;
+            for (const auto& vertices : meshes) {
+                views.push_back(PointsView{vertices.data(), nullptr, rows(vertices, 3, "vertices")});
+            }
+            std::vector<float> features;
+            {
+                py::gil_scoped_release release;
+                features = model.extract_batch(views);
+            }
+            return to_numpy(std::move(features),
+                            {py::ssize_t(meshes.size()), py::ssize_t(model.feature_dim())});
+        }, py::arg("meshes"), "Features of several vertex arrays, shape (M, feature_dim)");
+
+    m.def("cluster_templates", [](std::vector<DoubleArray> descriptors, double max_distance, std::vector<int> groups) {
+        if (groups.empty()) {
+            groups.assign(descriptors.size(), 0);
+        }
+        std::vector<std::vector<double>> signatures;
+        for (const auto& features : descriptors) {
+            signatures.push_back(descriptor_signature(features.data(), rows(features, FPFH_DIMS, "descriptors")));
+        }
+        TemplateFamilies families;
+        {
+            py::gil_scoped_release release;
+            families = cluster_templates(signatures, groups, max_distance);
+        }
+        return py::make_tuple(to_numpy(std::move(families.family), {py::ssize_t(descriptors.size())}),
+                              to_numpy(std::move(families.representatives),
+                                       {py::ssize_t(families.representatives.size())}));
+    }, py::arg("descriptors"), py::arg("max_distance") = 0.08, py::arg("groups") = std::vector<int>(),
+       "Returns (family, representatives): the family of each template's (N, 33) FPFH descriptors and the "
+       "template matched in full per family");
+
+    py::class_<VocabularyTree, std::shared_ptr<VocabularyTree>>(m, "VocabularyTree")
+        .def(py::init([](DoubleArray descriptors, size_t branching, size_t depth, size_t iterations, uint64_t seed) {
+            if (descriptors.ndim() != 2) {
+                throw std::invalid_argument("descriptors must be a 2-D array");
+            }
+            VocabularyParams params;
+            params.branching = branching;
+            params.depth = depth;
+            params.iterations = iterations;
+            params.seed = seed;
+            size_t n = size_t(descriptors.shape(0));
+            size_t dims = size_t(descriptors.shape(1));
+            py::gil_scoped_release release;
+            return std::make_shared<VocabularyTree>(descriptors.data(), n, dims, params);
+        }), py::arg("descriptors"), py::arg("branching") = 8, py::arg("depth") = 4, py::arg("iterations") = 10,
+           py::arg("seed") = 0, "Train the vocabulary by hierarchical k-means on (N, D) descriptors")
+        .def_static("load", [](const std::string& path) {
+            py::gil_scoped_release release;
+            return std::make_shared<VocabularyTree>(VocabularyTree::load(path));
+        }, py::arg("path"), "Load a template pack (.mmvt)")
+        .def("save", [](const VocabularyTree& tree, const std::string& path) {
+            py::gil_scoped_release release;
+            tree.save(path);
+        }, py::arg("path"))
+        .def_property_readonly("dims", &VocabularyTree::dims)
+        .def_property_readonly("words", &VocabularyTree::words)
+        .def_property_readonly("documents", &VocabularyTree::documents)
+        .def("add_document", [](VocabularyTree& tree, std::string label, DoubleArray descriptors) {
+            size_t n = rows(descriptors, py::ssize_t(tree.dims()), "descriptors");
+            py::gil_scoped_release release;
+            return tree.add_document(std::move(label), descriptors.data(), n);
+        }, py::arg("label"), py::arg("descriptors"), "Index a template's descriptors; returns its document id")
+        .def("query", [](const VocabularyTree& tree, DoubleArray descriptors, size_t top_k) {
+            size_t n = rows(descriptors, py::ssize_t(tree.dims()), "descriptors");
+            std::vector<Retrieval> hits;
+            {
+                py::gil_scoped_release release;
+                hits = tree.query(descriptors.data(), n, top_k);
+            }
+            py::list result;
+            for (const auto& hit : hits) {
+                result.append(py::make_tuple(tree.label(hit.document), hit.score));
+            }
+            return result;
+        }, py::arg("descriptors"), py::arg("top_k") = 5,
+           "Returns [(label, score)] of the top_k templates by TF-IDF similarity, best first");
+
+    m.def("fuse_poses", [](DoubleArray transforms, DoubleArray confidences, IndexArray groups,
+                           IndexArray sources, std::vector<double> source_weights,
+                           double translation_bandwidth, double rotation_bandwidth, int max_iterations) {
+        size_t n = size_t(confidences.size());
+        if (size_t(transforms.size()) != n * 16 || size_t(groups.size()) != n || size_t(sources.size()) != n) {
+            throw std::invalid_argument("hypothesis columns must all have the same length");
+        }
+        std::vector<PoseHypothesis> hypotheses(n);
+        for (size_t i = 0; i < n; i++) {
+            std::copy_n(transforms.data() + 16 * i, 16, hypotheses[i].transform);
+            hypotheses[i].confidence = confidences.data()[i];
+            hypotheses[i].group = static_cast<int32_t>(groups.data()[i]);
+            hypotheses[i].source = static_cast<int32_t>(sources.data()[i]);
+        }
+        FusionOptions options;
+        options.translation_bandwidth = translation_bandwidth;
+        options.rotation_bandwidth = rotation_bandwidth;
+        options.max_iterations = max_iterations;
+        options.source_weights = std::move(source_weights);
+
+        std::vector<FusedPose> fused;
+        std::vector<size_t> assignment;
+        {
+            py::gil_scoped_release release;
+            fused = fuse_poses(hypotheses, options, &assignment);
+        }
+        size_t m = fused.size();
+        std::vector<double> out_transforms(m * 16), out_confidences(m);
+        std::vector<int64_t> representatives(m), support(m);
+        for (size_t c = 0; c < m; c++) {
+            std::copy_n(fused[c].transform, 16, &out_transforms[16 * c]);
+            out_confidences[c] = fused[c].confidence;
+            representatives[c] = int64_t(fused[c].representative);
+            support[c] = int64_t(fused[c].support);
+        }
+        std::vector<int64_t> clusters(assignment.begin(), assignment.end());
+        py::ssize_t pm = py::ssize_t(m);
+        return py::make_tuple(to_numpy(std::move(out_transforms), {pm, 4, 4}),
+                              to_numpy(std::move(out_confidences), {pm}),
+                              to_numpy(std::move(representatives), {pm}),
+                              to_numpy(std::move(support), {pm}),
+                              to_numpy(std::move(clusters), {py::ssize_t(n)}));
+    }, py::arg("transforms"), py::arg("confidences"), py::arg("groups"), py::arg("sources"),
+       py::arg("source_weights"), py::arg("translation_bandwidth"), py::arg("rotation_bandwidth") = 0.35,
+       py::arg("max_iterations") = 30,
+       "Mean-shift fusion in SE(3); returns (transforms, confidences, representatives, support, assignment)");
+
+    py::class_<OwnedPluginTarget, std::shared_ptr<OwnedPluginTarget>>(m, "PluginTarget")
+        .def(py::init([](std::shared_ptr<TemplateMatcher> matcher, DoubleArray vertices, IndexArray faces) {
+            auto owned = std::make_shared<OwnedPluginTarget>();
+            owned->mesh = to_mesh(vertices, faces);
+            owned->index = std::move(matcher);
+            py::gil_scoped_release release;
+            owned->bvh = std::make_unique<BVH>(owned->mesh);
+            owned->target = std::make_unique<PluginTarget>(owned->mesh, *owned->index, *owned->bvh);
+            return owned;
+        }), py::arg("matcher"), py::arg("vertices"), py::arg("faces"),
+           "Target mesh + prepared matcher as shared with native plugins (builds the BVH)");
+
+    py::class_<NativePlugin, std::shared_ptr<NativePlugin>>(m, "NativePlugin")
+        .def(py::init([](const std::string& path, const std::string& config) {
+            return std::make_shared<NativePlugin>(path, config);
+        }), py::arg("path"), py::arg("config") = "")
+        .def_property_readonly("name", &NativePlugin::name)
+        .def_property_readonly("path", &NativePlugin::path)
+        .def("detect", [](const NativePlugin& plugin, const OwnedPluginTarget& target, DoubleArray vertices,
+                          IndexArray faces, const std::string& feature_id, const std::string& template_path) {
+            std::vector<MeshMindPluginDetection> detections;
+            {
+                TriangleMesh mesh = to_mesh(vertices, faces);
+                py::gil_scoped_release release;
+                detections = plugin.detect(*target.target, mesh, template_path, feature_id);
+            }
+            size_t n = detections.size();
+            std::vector<double> transforms(n * 16), confidences(n), radii(n);
+            for (size_t i = 0; i < n; i++) {
+                std::copy_n(detections[i].transform, 16, &transforms[16 * i]);
+                confidences[i] = detections[i].confidence;
+                radii[i] = detections[i].radius;
+            }
+            py::ssize_t pn = py::ssize_t(n);
+            return py::make_tuple(to_numpy(std::move(transforms), {pn, 4, 4}),
+                                  to_numpy(std::move(confidences), {pn}),
+                                  to_numpy(std::move(radii), {pn}));
+        }, py::arg("target"), py::arg("vertices"), py::arg("faces"), py::arg("feature_id") = "",
+           py::arg("template_path") = "",
+           "Run the plugin on one template; returns (transforms, confidences, radii)");
+
+    m.def("write_snappy_dict", [](const std::string& path, std::vector<std::string> names,
+                                  std::vector<std::string> modes, DoubleArray level_sizes,
+                                  IndexArray levels, DoubleArray transforms, DoubleArray bounds) {
+        size_t n = names.size();
+        if (modes.size() != n || size_t(level_sizes.size()) != n || size_t(levels.size()) != n ||
+            size_t(transforms.size()) != n * 16 || size_t(bounds.size()) != n * 6) {
+            throw std::invalid_argument("region columns must all have the same length");
+        }
+        std::vector<RefinementRegion> regions(n);
+        for (size_t i = 0; i < n; i++) {
+            regions[i].name = std::move(names[i]);
+            regions[i].mode = std::move(modes[i]);
+            regions[i].level_size = level_sizes.data()[i];
+            regions[i].level = int(levels.data()[i]);
+            std::copy(transforms.data() + 16 * i, transforms.data() + 16 * i + 16, regions[i].transform);
+            std::copy(bounds.data() + 6 * i, bounds.data() + 6 * i + 6, regions[i].bounds);
+        }
+        py::gil_scoped_release release;
+        write_snappy_dict(path, regions);
+    }, py::arg("path"), py::arg("names"), py::arg("modes"), py::arg("level_sizes"), py::arg("levels"),
+       py::arg("transforms"), py::arg("bounds"),
+       "Columns: transforms (N, 4, 4), bounds (N, 2, 3) as [min, max] in local space");
+
+    m.def("write_ftetwild_sizing", [](const std::string& path, DoubleArray centers,
+                                      DoubleArray radii, DoubleArray sizes) {
+        size_t n = rows(centers, 3, "centers");
+        if (size_t(radii.size()) != n || size_t(sizes.size()) != n) {
+            throw std::invalid_argument("centers, radii and sizes must have the same length");
+        }
+        std::vector<SizingSphere> spheres(n);
+        for (size_t i = 0; i < n; i++) {
+            std::copy(centers.data() + 3 * i, centers.data() + 3 * i + 3, spheres[i].center);
+            spheres[i].radius = radii.data()[i];
+            spheres[i].size = sizes.data()[i];
+        }
+        py::gil_scoped_release release;
+        write_ftetwild_sizing(path, spheres);
+    }, py::arg("path"), py::arg("centers"), py::arg("radii"), py::arg("sizes"));
+
+    m.def("format_float", &format_python_float, py::arg("value"));
+}
@@ -1,152 +1,2060 @@
 /**
  * MeshMind-AFID C++ Implementation
  * 
- * Wraps Python SDK using pybind11 embedded interpreter
+ * Detection, snapshots and the mesher inputs run on the native engine
+ * (src/native). The embedded Python interpreter (pybind11) only holds the
+ * SDK's AutoMesher, which receives the published detections for the
+ * refinement-region generation and the OpenFOAM exporters.
  */
 
 #include "meshmind/core.h"
+#include "snapshot.h"
+#include "native/descriptors.h"
+#include "native/ensemble.h"
+#include "native/exporters.h"
+#include "native/families.h"
+#include "native/generators.h"
+#include "native/icp.h"
+#include "native/localizer.h"
+#include "native/matcher.h"
+#include "native/meshcnn.h"
+#include "native/parallel.h"
+#include "native/pipeline.h"
+#include "native/planner.h"
+#include "native/plugin_host.h"
+#include "native/region.h"
+#include "native/registration.h"
+#include "native/robust.h"
+#include "native/rotation.h"
+#include "native/transform.h"
+#include "native/verify.h"
+#include "native/vocab.h"
 #include <pybind11/embed.h>
 #include <pybind11/numpy.h>
 #include <pybind11/stl.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
 #include <string>
+#include <thread>
 #include <vector>
 #include <cstring>
 
 namespace py = pybind11;
+namespace fs = std::filesystem;
+
+/* A template registered via meshmind_add_template and its results */
+struct TemplateEntry {
+    std::string path;
+    std::string feature_id;
+    int feature_type = 0;      /* interned feature_id */
+    bool completed = false;
+    std::vector<meshmind::SnapshotResult> results;
+    std::shared_ptr<meshmind::PreparedTemplate> prepared;   /* levels of detail, kept across targets */
+    meshmind::QueryPlan plan;  /* how the template was last matched */
+    bool matched = false;      /* plan is set */
+    bool planned = false;      /* plan came from the query planner, not the fixed settings */
+};
+
+/* FFT localisation settings of a feature type */
+struct FFTLocalisation {
+    int max_peaks;
+    double voxel_size;
+};
+
+/* A template's search region narrowed to its FFT correlation peaks */
+struct SeededRegion {
+    meshmind::SearchRegion region;
+    std::vector<meshmind::TranslationPeak> peaks;
+};
+
+/* Detection results in structure-of-arrays layout, exposed zero-copy via MeshMindResults */
+using ResultTable = meshmind::DetectionTable;
+
+/* Lifecycle of a meshmind_detect_async job */
+enum class AsyncJob {
+    NONE,       /* no job, or its status was collected by meshmind_wait */
+    RUNNING,
+    FINISHED    /* done, status not yet collected */
+};
 
 struct MeshMindDetector_t {
     py::scoped_interpreter* guard;
     py::object mesher;
     std::string last_error;
-    std::vector<MeshMindDetection> cached_detections;
+    ResultTable results;
+
+    /* Interned feature types; deque keeps name storage stable as it grows */
+    std::deque<std::string> feature_type_names;
+    std::vector<const char*> feature_type_name_ptrs;
+    std::unordered_map<std::string, int> feature_type_ids;
+
+    std::string target_path;
+    meshmind::TriangleMesh target_mesh;
+    std::unique_ptr<meshmind::TemplateMatcher> target_index;   /* prepared once per target */
+    std::unique_ptr<meshmind::BVH> target_bvh;                 /* region sampling, pose verification */
+    std::map<std::string, meshmind::SearchRegion> search_regions;   /* by feature_id */
+    std::map<std::string, std::unique_ptr<meshmind::TemplateMatcher>> region_indexes;   /* by region key */
+    std::map<std::string, FFTLocalisation> localisations;                      /* by feature_id */
+    std::map<double, std::unique_ptr<meshmind::FFTLocalizer>> localizers;       /* by voxel size */
+    std::map<size_t, SeededRegion> seeded_regions;                             /* FFT peaks by template */
+    std::map<std::string, std::unique_ptr<meshmind::PluginTarget>> plugin_targets;   /* by region key */
+    std::vector<std::unique_ptr<meshmind::NativePlugin>> plugins;
+    
+    std::unique_ptr<meshmind::MeshCNNExtractor> feature_model;
+    std::vector<float> target_features;   /* cached MeshCNN features of the target */
+    std::vector<TemplateEntry> templates;
+    double lod_margin = -1.0;   /* early rejection between levels of detail; < 0 matches all at full detail */
+    meshmind::RansacParams ransac;   /* pose estimation; 0 iterations for Procrustes */
+    bool max_clique = false;         /* max-clique registration instead of RANSAC/Procrustes */
+    meshmind::RobustParams robust;
+    bool planner = false;            /* per-template strategy from the cost model */
+    std::map<std::string, int> expected_instances;             /* per feature type, for the planner */
+    std::map<std::string, meshmind::SurfaceStats> region_stats;   /* by SearchRegion::key() */
+    meshmind::ICPParams icp;         /* pose refinement; 0 iterations to skip */
+    double verify_tolerance = 0.02;   /* inlier distance for confidence, relative to the template size */
+    double min_confidence = 0.0;      /* detections below are dropped */
+    std::unique_ptr<meshmind::VocabularyTree> template_pack;   /* template retrieval by descriptor words */
+    size_t retrieval_top_k = 0;       /* candidates per search region; 0 matches all */
+    double family_distance = -1.0;    /* near-duplicate template clustering; < 0 matches every template in full */
+    double family_confidence = 0.5;   /* representative confidence needed to evaluate its family */
+
+    std::string checkpoint_path;
+    double checkpoint_interval = 0.0;
+
+    /* The creating thread gives up the GIL so detection can run on other threads */
+    PyThreadState* main_thread_state = nullptr;
+    
+    /*
+     * API calls hold mutex while they run. From meshmind_detect_async until
+     * meshmind_wait collects the status the job thread owns the detector
+     * state, and other calls return MESHMIND_ERROR_BUSY.
+     */
+    std::mutex mutex;
+    std::condition_variable job_done;
+    AsyncJob job = AsyncJob::NONE;
+    int job_status = MESHMIND_SUCCESS;
+    std::thread job_thread;
 };
 
-// Version string
-static const char* MESHMIND_VERSION_STRING = "1.0.0";
+// True from meshmind_detect_async until meshmind_wait collects the job; mutex must be held
+static bool is_busy(MeshMindDetector detector) {
+    return detector->job != AsyncJob::NONE;
+}
+
+// Version string
+static const char* MESHMIND_VERSION_STRING = "1.0.0";
+
+MeshMindDetector meshmind_create_detector() {
+    try {
+        auto detector = new MeshMindDetector_t;
+        detector->guard = new py::scoped_interpreter();
+        
+        // Import MeshMind SDK
+        py::module_ meshmind = py::module_::import("meshmind.sdk.mesher");
+        detector->mesher = meshmind.attr("AutoMesher")();
+        
+        detector->last_error = "";
+        detector->main_thread_state = PyEval_SaveThread();
+        return detector;
+        
+    } catch (const py::error_already_set& e) {
+        return nullptr;
+    } catch (const std::exception& e) {
+        return nullptr;
+    }
+}
+
+void meshmind_destroy_detector(MeshMindDetector detector) {
+    if (detector) {
+        if (detector->job_thread.joinable()) {
+            detector->job_thread.join();
+        }
+        PyEval_RestoreThread(detector->main_thread_state);
+        
+        // Python objects must be released before the interpreter shuts down
+        detector->mesher = py::object();
+        delete detector->guard;
+        delete detector;
+    }
+}
+
+static int load_target(MeshMindDetector detector, const char* stl_path) {
+    try {
+        detector->target_mesh = meshmind::load_mesh(stl_path);
+        
+        // A new target invalidates the prepared index and all template results
+        detector->target_path = stl_path;
+        detector->plugin_targets.clear();
+        detector->target_index.reset();
+        detector->region_indexes.clear();
+        detector->region_stats.clear();
+        detector->localizers.clear();
+        detector->seeded_regions.clear();
+        detector->target_bvh.reset();
+        detector->target_features.clear();
+        for (auto& tmpl : detector->templates) {
+            tmpl.completed = false;
+            tmpl.results.clear();
+        }
+        detector->results.clear();
+        return MESHMIND_SUCCESS;
+    } catch (const std::exception& e) {
+        detector->last_error = e.what();
+        return MESHMIND_ERROR_LOAD;
+    }
+}
+
+int meshmind_load_target(MeshMindDetector detector, const char* stl_path) {
+    if (!detector || !stl_path) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    return load_target(detector, stl_path);
+}
+
+// Feature type from filename (e.g., "wheel_18inch.stl" -> "wheel"), as in AutoMesher
+static std::string default_feature_id(const std::string& path) {
+    std::string stem = fs::path(path).stem().string();
+    return stem.substr(0, stem.find('_'));
+}
+
+static int intern_feature_type(MeshMindDetector detector, const std::string& name) {
+    auto it = detector->feature_type_ids.find(name);
+    if (it != detector->feature_type_ids.end()) {
+        return it->second;
+    }
+    int id = static_cast<int>(detector->feature_type_names.size());
+    detector->feature_type_names.push_back(name);
+    detector->feature_type_name_ptrs.push_back(detector->feature_type_names.back().c_str());
+    detector->feature_type_ids.emplace(name, id);
+    return id;
+}
+
+int meshmind_add_template(
+    MeshMindDetector detector,
+    const char* template_path,
+    const char* feature_id
+) {
+    if (!detector || !template_path) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    std::string ext = fs::path(template_path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    if (ext != ".stl" && ext != ".obj") {
+        detector->last_error = std::string("Unsupported template format: ") + template_path;
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    if (!fs::exists(template_path)) {
+        detector->last_error = std::string("Template not found: ") + template_path;
+        return MESHMIND_ERROR_LOAD;
+    }
+    
+    TemplateEntry entry;
+    entry.path = template_path;
+    entry.feature_id = (feature_id && *feature_id) ? feature_id : default_feature_id(template_path);
+    entry.feature_type = intern_feature_type(detector, entry.feature_id);
+    detector->templates.push_back(std::move(entry));
+    return MESHMIND_SUCCESS;
+}
+
+/* Templates (of one feature type, or all) have to be matched again after a settings change */
+static void reset_templates(MeshMindDetector detector, const char* feature_id = nullptr) {
+    for (auto& tmpl : detector->templates) {
+        if (!feature_id || tmpl.feature_id == feature_id) {
+            tmpl.completed = false;
+            tmpl.results.clear();
+        }
+    }
+}
+
+int meshmind_set_search_region(
+    MeshMindDetector detector,
+    const char* feature_id,
+    const MeshMindSearchRegion* region
+) {
+    if (!detector || !feature_id) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    meshmind::SearchRegion search;
+    if (region) {
+        if (region->num_boxes < 0 || region->num_part_ids < 0 ||
+            (region->num_boxes > 0 && !region->boxes) ||
+            (region->num_part_ids > 0 && !region->part_ids) ||
+            region->up_axis < 0 || region->up_axis > 2) {
+            return MESHMIND_ERROR_INVALID_PARAM;
+        }
+        for (int i = 0; i < region->num_boxes; i++) {
+            const double* box = &region->boxes[6 * i];
+            if (box[0] > box[3] || box[1] > box[4] || box[2] > box[5]) {
+                detector->last_error = "Search region box has min > max";
+                return MESHMIND_ERROR_INVALID_PARAM;
+            }
+        }
+        search.boxes.assign(region->boxes, region->boxes + 6 * region->num_boxes);
+        search.parts.assign(region->part_ids, region->part_ids + region->num_part_ids);
+        search.up_axis = region->up_axis;
+        search.height_min = region->height_min;
+        search.height_max = region->height_max;
+    }
+    
+    if (search.unrestricted()) {
+        detector->search_regions.erase(feature_id);
+    } else {
+        detector->search_regions[feature_id] = std::move(search);
+    }
+    
+    // Templates of this type have to be matched again against the new region
+    detector->seeded_regions.clear();
+    reset_templates(detector, feature_id);
+    return MESHMIND_SUCCESS;
+}
+
+int meshmind_set_fft_localisation(
+    MeshMindDetector detector,
+    const char* feature_id,
+    int max_peaks,
+    double voxel_size
+) {
+    if (!detector || !feature_id || max_peaks < 0 || !(voxel_size >= 0)) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    if (max_peaks == 0) {
+        detector->localisations.erase(feature_id);
+    } else {
+        detector->localisations[feature_id] = FFTLocalisation{max_peaks, voxel_size};
+    }
+    
+    detector->seeded_regions.clear();
+    reset_templates(detector, feature_id);
+    return MESHMIND_SUCCESS;
+}
+
+int meshmind_set_lod_margin(MeshMindDetector detector, double margin) {
+    if (!detector || std::isnan(margin)) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    detector->lod_margin = margin;
+    reset_templates(detector);
+    return MESHMIND_SUCCESS;
+}
+
+int meshmind_set_ransac(MeshMindDetector detector, int iterations, double inlier_threshold) {
+    if (!detector || iterations < 0 || !(inlier_threshold >= 0)) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    detector->ransac.iterations = size_t(iterations);
+    detector->ransac.inlier_threshold = inlier_threshold;
+    reset_templates(detector);
+    return MESHMIND_SUCCESS;
+}
+
+int meshmind_set_max_clique(MeshMindDetector detector, int enabled, double noise_bound) {
+    if (!detector || !(noise_bound >= 0)) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    detector->max_clique = enabled != 0;
+    detector->robust.noise_bound = noise_bound;
+    reset_templates(detector);
+    return MESHMIND_SUCCESS;
+}
+
+int meshmind_set_planner(MeshMindDetector detector, int enabled) {
+    if (!detector) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    detector->planner = enabled != 0;
+    reset_templates(detector);
+    return MESHMIND_SUCCESS;
+}
+
+int meshmind_set_expected_instances(MeshMindDetector detector, const char* feature_id, int instances) {
+    if (!detector || !feature_id || instances < 1) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    detector->expected_instances[feature_id] = instances;
+    reset_templates(detector, feature_id);
+    return MESHMIND_SUCCESS;
+}
+
+int meshmind_get_template_plan(MeshMindDetector detector, int template_index, MeshMindTemplatePlan* plan) {
+    if (!detector || !plan || template_index < 0) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    if (size_t(template_index) >= detector->templates.size()) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    
+    const TemplateEntry& tmpl = detector->templates[size_t(template_index)];
+    memset(plan, 0, sizeof(*plan));
+    plan->strategy = tmpl.matched ? int(tmpl.plan.strategy) : MESHMIND_STRATEGY_NONE;
+    if (tmpl.matched) {
+        plan->coarse_points = int(tmpl.plan.coarse_points);
+        plan->ransac_iterations = int(tmpl.plan.ransac_iterations);
+        plan->inlier_ratio = tmpl.plan.inlier_ratio;
+        plan->estimated_cost = tmpl.plan.cost;
+        plan->planned = tmpl.planned ? 1 : 0;
+        plan->feasible = tmpl.plan.feasible ? 1 : 0;
+    }
+    return MESHMIND_SUCCESS;
+}
+
+int meshmind_set_icp(MeshMindDetector detector, int iterations, int symmetric) {
+    if (!detector || iterations < 0) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    detector->icp.iterations = size_t(iterations);
+    detector->icp.symmetric = symmetric != 0;
+    reset_templates(detector);
+    return MESHMIND_SUCCESS;
+}
+
+int meshmind_set_verification(MeshMindDetector detector, double tolerance, double min_confidence) {
+    if (!detector || !(tolerance > 0) || !(min_confidence >= 0 && min_confidence <= 1)) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    detector->verify_tolerance = tolerance;
+    detector->min_confidence = min_confidence;
+    reset_templates(detector);
+    return MESHMIND_SUCCESS;
+}
+
+int meshmind_set_template_families(MeshMindDetector detector, double max_distance, double min_confidence) {
+    if (!detector || !(min_confidence >= 0 && min_confidence <= 1) || !(max_distance <= 1)) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    detector->family_distance = max_distance;
+    detector->family_confidence = min_confidence;
+    reset_templates(detector);
+    return MESHMIND_SUCCESS;
+}
+
+int meshmind_set_template_retrieval(MeshMindDetector detector, int top_k) {
+    if (!detector || top_k < 0) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    detector->retrieval_top_k = size_t(top_k);
+    reset_templates(detector);
+    return MESHMIND_SUCCESS;
+}
+
+// Closest-point hierarchy over the target, built on first use
+static const meshmind::BVH& ensure_target_bvh(MeshMindDetector detector) {
+    if (!detector->target_bvh) {
+        detector->target_bvh = std::make_unique<meshmind::BVH>(detector->target_mesh);
+    }
+    return *detector->target_bvh;
+}
+
+// Build the coarse target samples + descriptor index once per target
+static const meshmind::TemplateMatcher& ensure_target_index(MeshMindDetector detector) {
+    if (!detector->target_index) {
+        detector->target_index = std::make_unique<meshmind::TemplateMatcher>(detector->target_mesh);
+    }
+    return *detector->target_index;
+}
+
+// Index of the target surface inside a search region, shared by equal regions
+static const meshmind::TemplateMatcher& region_index(MeshMindDetector detector, const meshmind::SearchRegion& region) {
+    if (region.unrestricted()) {
+        return ensure_target_index(detector);
+    }
+    std::unique_ptr<meshmind::TemplateMatcher>& index = detector->region_indexes[region.key()];
+    if (!index) {
+        meshmind::MatcherParams params;
+        meshmind::PointSet samples = meshmind::sample_region(ensure_target_bvh(detector), region,
+                                                             params.coarse_points, params.seed);
+        index = std::make_unique<meshmind::TemplateMatcher>(samples, params);
+    }
+    return *index;
+}
+
+static const meshmind::PreparedTemplate& prepare_template(TemplateEntry& tmpl) {
+    if (!tmpl.prepared) {
+        tmpl.prepared = std::make_shared<meshmind::PreparedTemplate>(meshmind::load_mesh(tmpl.path));
+    }
+    return *tmpl.prepared;
+}
+
+/*
+ * Narrow the feature type's search region to boxes around the FFT
+ * correlation peaks of the template (its bounds, grown by a quarter on each
+ * side). Without peaks the search falls back to the whole region.
+ */
+static SeededRegion seed_region(
+    MeshMindDetector detector,
+    TemplateEntry& tmpl,
+    const FFTLocalisation& localisation
+) {
+    SeededRegion seeded;
+    meshmind::SearchRegion& region = seeded.region;
+    auto base = detector->search_regions.find(tmpl.feature_id);
+    if (base != detector->search_regions.end()) {
+        region = base->second;
+    }
+    
+    std::unique_ptr<meshmind::FFTLocalizer>& localizer = detector->localizers[localisation.voxel_size];
+    if (!localizer) {
+        localizer = std::make_unique<meshmind::FFTLocalizer>(detector->target_mesh, localisation.voxel_size);
+    }
+    const meshmind::TriangleMesh& mesh = prepare_template(tmpl).mesh();
+    seeded.peaks = localizer->locate(mesh, size_t(localisation.max_peaks));
+    
+    double lo[3] = {HUGE_VAL, HUGE_VAL, HUGE_VAL}, hi[3] = {-HUGE_VAL, -HUGE_VAL, -HUGE_VAL};
+    for (size_t v = 0; v < mesh.num_vertices(); v++) {
+        for (int d = 0; d < 3; d++) {
+            lo[d] = std::min(lo[d], mesh.vertices[3 * v + d]);
+            hi[d] = std::max(hi[d], mesh.vertices[3 * v + d]);
+        }
+    }
+    
+    std::vector<double> boxes;
+    for (const auto& peak : seeded.peaks) {
+        double box[6];
+        for (int d = 0; d < 3; d++) {
+            double pad = 0.25 * (hi[d] - lo[d]) + localizer->voxel_size();
+            box[d] = lo[d] + peak.translation[d] - pad;
+            box[d + 3] = hi[d] + peak.translation[d] + pad;
+        }
+        if (region.boxes.empty()) {
+            boxes.insert(boxes.end(), box, box + 6);
+            continue;
+        }
+        for (size_t b = 0; b < region.boxes.size(); b += 6) {
+            double clipped[6];
+            bool empty = false;
+            for (int d = 0; d < 3; d++) {
+                clipped[d] = std::max(box[d], region.boxes[b + d]);
+                clipped[d + 3] = std::min(box[d + 3], region.boxes[b + d + 3]);
+                empty = empty || clipped[d] > clipped[d + 3];
+            }
+            if (!empty) {
+                boxes.insert(boxes.end(), clipped, clipped + 6);
+            }
+        }
+    }
+    if (!boxes.empty()) {
+        region.boxes = std::move(boxes);
+    }
+    return seeded;
+}
+
+// Index a template is matched against: its feature type's region, narrowed to FFT peaks if enabled
+static const meshmind::TemplateMatcher& template_index(MeshMindDetector detector, size_t i) {
+    TemplateEntry& tmpl = detector->templates[i];
+    auto localisation = detector->localisations.find(tmpl.feature_id);
+    if (localisation == detector->localisations.end()) {
+        auto region = detector->search_regions.find(tmpl.feature_id);
+        return region == detector->search_regions.end() ? ensure_target_index(detector)
+                                                         : region_index(detector, region->second);
+    }
+    auto seeded = detector->seeded_regions.find(i);
+    if (seeded == detector->seeded_regions.end()) {
+        seeded = detector->seeded_regions.emplace(i, seed_region(detector, tmpl, localisation->second)).first;
+    }
+    return region_index(detector, seeded->second.region);
+}
+
+// Search region a template is matched in, as chosen by template_index
+static meshmind::SearchRegion template_region(MeshMindDetector detector, size_t i) {
+    template_index(detector, i);
+    auto seeded = detector->seeded_regions.find(i);
+    if (seeded != detector->seeded_regions.end()) {
+        return seeded->second.region;
+    }
+    auto search = detector->search_regions.find(detector->templates[i].feature_id);
+    return search == detector->search_regions.end() ? meshmind::SearchRegion() : search->second;
+}
+
+// Target surface a template is matched against, as chosen by template_index
+static const meshmind::SurfaceStats& template_region_stats(MeshMindDetector detector, size_t i) {
+    meshmind::SearchRegion region = template_region(detector, i);
+    auto cached = detector->region_stats.find(region.key());
+    if (cached == detector->region_stats.end()) {
+        meshmind::SurfaceStats stats = region.unrestricted()
+            ? meshmind::surface_stats(detector->target_mesh)
+            : meshmind::surface_stats(detector->target_mesh, meshmind::region_faces(ensure_target_bvh(detector), region));
+        cached = detector->region_stats.emplace(region.key(), stats).first;
+    }
+    return cached->second;
+}
+
+/*
+ * Estimate a template's pose. With the planner on, the strategy and the
+ * number of template samples come from the cost model (re-sampling the
+ * template if needed); otherwise from the fixed detector settings. Either
+ * way the choice is kept as the template's plan.
+ */
+static meshmind::TemplateDetection detect_template(MeshMindDetector detector, size_t i) {
+    TemplateEntry& tmpl = detector->templates[i];
+    meshmind::QueryPlan plan;
+    if (detector->planner) {
+        auto instances = detector->expected_instances.find(tmpl.feature_id);
+        plan = meshmind::plan_query(meshmind::surface_stats(prepare_template(tmpl).mesh()),
+                                    template_region_stats(detector, i),
+                                    instances == detector->expected_instances.end() ? 1 : size_t(instances->second));
+    } else {
+        plan.strategy = detector->max_clique ? meshmind::PoseStrategy::MAX_CLIQUE
+                      : detector->ransac.iterations > 0 ? meshmind::PoseStrategy::RANSAC
+                      : meshmind::PoseStrategy::PROCRUSTES;
+        plan.coarse_points = meshmind::MatcherParams().coarse_points;
+        plan.ransac_iterations = detector->ransac.iterations;
+        plan.inlier_ratio = 0.0;
+    }
+    // Only the coarse level is re-sampled; the other levels are kept
+    if (plan.coarse_points != prepare_template(tmpl).params().coarse_points) {
+        tmpl.prepared = tmpl.prepared->with_coarse_points(plan.coarse_points);
+    }
+    tmpl.plan = plan;
+    tmpl.matched = true;
+    tmpl.planned = detector->planner;
+    
+    const meshmind::PreparedTemplate& prepared = prepare_template(tmpl);
+    const meshmind::TemplateMatcher& index = template_index(detector, i);
+    switch (plan.strategy) {
+        case meshmind::PoseStrategy::MAX_CLIQUE:
+            return index.detect(prepared, detector->robust);
+        case meshmind::PoseStrategy::RANSAC: {
+            meshmind::RansacParams ransac = detector->ransac;
+            ransac.iterations = plan.ransac_iterations;
+            return index.detect(prepared, ransac);
+        }
+        default:
+            return index.detect(prepared);
+    }
+}
+
+/*
+ * Mean squared distance of points moved by transform (columns [count]) to
+ * the target surface, in template units so that a pose that shrinks the
+ * template gains nothing.
+ */
+static double alignment_residual(const double* transform, const double* moved_x, const double* moved_y,
+                                 const double* moved_z, size_t count, const meshmind::BVH& target) {
+    double sum = 0.0;
+    for (size_t p = 0; p < count; p++) {
+        double point[3] = {moved_x[p], moved_y[p], moved_z[p]};
+        sum += target.closest_point(point).sq_distance;
+    }
+    const double* m = transform;
+    double det = m[0] * (m[5] * m[10] - m[6] * m[9]) - m[1] * (m[4] * m[10] - m[6] * m[8]) +
+                 m[2] * (m[4] * m[9] - m[5] * m[8]);
+    double scale2 = std::pow(std::fabs(det), 2.0 / 3.0);
+    return count > 0 && scale2 > 0 ? sum / double(count) / scale2 : HUGE_VAL;
+}
+
+/*
+ * Orientation without correspondences for FFT-localised templates: at each
+ * translation peak, the rotations whose spherical harmonic expansion best
+ * correlates with the target patch become pose hypotheses. The detection
+ * keeps whichever pose, these or the Procrustes one, leaves the smallest
+ * residual to the target surface.
+ */
+static void orient_from_peaks(MeshMindDetector detector, size_t i, meshmind::TemplateDetection& detection) {
+    auto seeded = detector->seeded_regions.find(i);
+    if (seeded == detector->seeded_regions.end() || seeded->second.peaks.empty()) {
+        return;
+    }
+    const meshmind::PointSet& samples = prepare_template(detector->templates[i]).level(1).points;
+    if (samples.size() == 0) {
+        return;
+    }
+    double center[3] = {0, 0, 0}, radius = 0.0;
+    for (size_t p = 0; p < samples.size(); p++) {
+        for (int d = 0; d < 3; d++) {
+            center[d] += samples.points[3 * p + d] / double(samples.size());
+        }
+    }
+    for (size_t p = 0; p < samples.size(); p++) {
+        double r2 = 0.0;
+        for (int d = 0; d < 3; d++) {
+            r2 += (samples.points[3 * p + d] - center[d]) * (samples.points[3 * p + d] - center[d]);
+        }
+        radius = std::max(radius, std::sqrt(r2));
+    }
+    if (!(radius > 0)) {
+        return;
+    }
+    
+    ensure_target_bvh(detector);
+    meshmind::RotationSearch search(samples.points.data(), samples.size(), center, radius);
+    
+    // Hypotheses are moved in batches (all rotations of a peak at once), from columns built once
+    const size_t count = samples.size();
+    meshmind::PointColumns columns = meshmind::point_columns(samples.points.data(), count);
+    std::vector<double> moved(3 * count);
+    meshmind::transform_batch(detection.transform, 1, columns.x.data(), columns.y.data(), columns.z.data(), count,
+                              moved.data(), moved.data() + count, moved.data() + 2 * count);
+    double best = alignment_residual(detection.transform, moved.data(), moved.data() + count, moved.data() + 2 * count,
+                                     count, *detector->target_bvh);
+    for (const auto& peak : seeded->second.peaks) {
+        // The peak places the unrotated template bounds; let the patch centre drift to the local centroid
+        double patch_center[3];
+        for (int d = 0; d < 3; d++) {
+            patch_center[d] = center[d] + peak.translation[d];
+        }
+        meshmind::SearchRegion patch;
+        for (int bound = 0; bound < 2; bound++) {
+            for (int d = 0; d < 3; d++) {
+                patch.boxes.push_back(patch_center[d] + (bound ? 1.5 : -1.5) * radius);
+            }
+        }
+        meshmind::PointSet patch_samples;
+        try {
+            patch_samples = meshmind::sample_region(*detector->target_bvh, patch, 2 * samples.size(), 0);
+        } catch (const std::runtime_error&) {
+            continue;
+        }
+        for (int step = 0; step < 3; step++) {
+            double sum[3] = {0, 0, 0};
+            size_t inside = 0;
+            for (size_t p = 0; p < patch_samples.size(); p++) {
+                const double* x = &patch_samples.points[3 * p];
+                double r2 = 0.0;
+                for (int d = 0; d < 3; d++) {
+                    r2 += (x[d] - patch_center[d]) * (x[d] - patch_center[d]);
+                }
+                if (r2 <= radius * radius) {
+                    for (int d = 0; d < 3; d++) {
+                        sum[d] += x[d];
+                    }
+                    inside++;
+                }
+            }
+            for (int d = 0; d < 3 && inside > 0; d++) {
+                patch_center[d] = sum[d] / double(inside);
+            }
+        }
+        
+        std::vector<meshmind::RotationCandidate> candidates =
+            search.search(patch_samples.points.data(), patch_samples.size(), patch_center, 3);
+        const size_t poses = candidates.size();
+        std::vector<double> transforms(16 * poses, 0.0);
+        for (size_t h = 0; h < poses; h++) {
+            double* transform = &transforms[16 * h];
+            for (int r = 0; r < 3; r++) {
+                transform[4 * r + 3] = patch_center[r];
+                for (int c = 0; c < 3; c++) {
+                    transform[4 * r + c] = candidates[h].rotation[3 * r + c];
+                    transform[4 * r + 3] -= candidates[h].rotation[3 * r + c] * center[c];
+                }
+            }
+            transform[15] = 1.0;
+        }
+        moved.resize(3 * poses * count);
+        double* moved_x = moved.data();
+        double* moved_y = moved_x + poses * count;
+        double* moved_z = moved_y + poses * count;
+        
+        // Translation-only closest-point steps before the hypotheses are compared
+        for (int step = 0; step < 3; step++) {
+            meshmind::transform_batch(transforms.data(), poses, columns.x.data(), columns.y.data(), columns.z.data(),
+                                      count, moved_x, moved_y, moved_z);
+            for (size_t h = 0; h < poses; h++) {
+                double shift[3] = {0, 0, 0};
+                for (size_t p = h * count; p < (h + 1) * count; p++) {
+                    double point[3] = {moved_x[p], moved_y[p], moved_z[p]};
+                    meshmind::ClosestPoint closest = detector->target_bvh->closest_point(point);
+                    for (int d = 0; d < 3; d++) {
+                        shift[d] += (closest.point[d] - point[d]) / double(count);
+                    }
+                }
+                for (int d = 0; d < 3; d++) {
+                    transforms[16 * h + 4 * d + 3] += shift[d];
+                }
+            }
+        }
+        
+        meshmind::transform_batch(transforms.data(), poses, columns.x.data(), columns.y.data(), columns.z.data(), count,
+                                  moved_x, moved_y, moved_z);
+        for (size_t h = 0; h < poses; h++) {
+            const double* transform = &transforms[16 * h];
+            double residual = alignment_residual(transform, moved_x + h * count, moved_y + h * count,
+                                                 moved_z + h * count, count, *detector->target_bvh);
+            if (residual < best) {
+                best = residual;
+                std::copy(transform, transform + 16, detection.transform);
+                detection.alignment_cost = residual;
+            }
+        }
+    }
+}
+
+/*
+ * Geometric confidence of a detection: the fraction of the template's
+ * surface samples within verify_tolerance (relative to the template size,
+ * scaled by the pose) of the target surface.
+ */
+static meshmind::Verification verify_detection(MeshMindDetector detector, const meshmind::PreparedTemplate& prepared,
+                                               const double* transform) {
+    const meshmind::PointSet& samples = prepared.level(1).points;
+    double lo[3] = {HUGE_VAL, HUGE_VAL, HUGE_VAL}, hi[3] = {-HUGE_VAL, -HUGE_VAL, -HUGE_VAL};
+    for (size_t p = 0; p < samples.size(); p++) {
+        for (int d = 0; d < 3; d++) {
+            lo[d] = std::min(lo[d], samples.points[3 * p + d]);
+            hi[d] = std::max(hi[d], samples.points[3 * p + d]);
+        }
+    }
+    double size = std::sqrt((hi[0] - lo[0]) * (hi[0] - lo[0]) + (hi[1] - lo[1]) * (hi[1] - lo[1]) +
+                            (hi[2] - lo[2]) * (hi[2] - lo[2]));
+    const double* m = transform;
+    double det = m[0] * (m[5] * m[10] - m[6] * m[9]) - m[1] * (m[4] * m[10] - m[6] * m[8]) +
+                 m[2] * (m[4] * m[9] - m[5] * m[8]);
+    
+    meshmind::VerifyParams params;
+    params.inlier_distance = detector->verify_tolerance * size * std::cbrt(std::fabs(det));
+    params.min_coverage = detector->min_confidence;
+    if (!(params.inlier_distance > 0)) {
+        meshmind::Verification degenerate;
+        degenerate.rejected = params.min_coverage > 0;
+        return degenerate;
+    }
+    return meshmind::verify_pose(transform, samples.points.data(), samples.size(), ensure_target_bvh(detector), params);
+}
+
+/*
+ * ICP refinement of detected poses against the target surface, over the
+ * two sampled levels of detail of each template, in parallel across the
+ * detections.
+ */
+static void refine_detections(MeshMindDetector detector, const std::vector<size_t>& indices,
+                              std::vector<meshmind::TemplateDetection>& detections) {
+    if (detector->icp.iterations == 0 || detections.empty()) {
+        return;
+    }
+    std::vector<meshmind::ICPSource> sources(detections.size());
+    for (size_t k = 0; k < detections.size(); k++) {
+        const meshmind::PreparedTemplate& prepared = prepare_template(detector->templates[indices[k]]);
+        sources[k].levels = {prepared.level(0).points.view(), prepared.level(1).points.view()};
+        std::copy(detections[k].transform, detections[k].transform + 16, sources[k].transform);
+    }
+    std::vector<meshmind::ICPResult> refined = meshmind::icp_refine(sources, ensure_target_bvh(detector), detector->icp);
+    for (size_t k = 0; k < detections.size(); k++) {
+        std::copy(refined[k].transform, refined[k].transform + 16, detections[k].transform);
+        detections[k].alignment_cost = refined[k].rms * refined[k].rms;
+    }
+}
+
+/*
+ * Template pack label of a template path: absolute, with symbolic links and
+ * "." / ".." resolved, so that equivalent paths find the same document.
+ */
+static std::string template_label(const std::string& path) {
+    std::error_code error;
+    fs::path label = fs::weakly_canonical(path, error);
+    return error ? fs::path(path).lexically_normal().string() : label.string();
+}
+
+int meshmind_build_template_pack(MeshMindDetector detector, const char* pack_path, int branching, int depth) {
+    if (!detector || branching < 2 || depth < 1) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    if (detector->templates.empty()) {
+        detector->last_error = "No templates to build a template pack from";
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    
+    // Words are learnt from the coarse descriptors that pose estimation matches
+    try {
+        std::vector<TemplateEntry>& templates = detector->templates;
+        meshmind::parallel_for(templates.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                prepare_template(templates[i]).level(1);
+            }
+        }, 1);
+        
+        std::vector<double> descriptors;
+        std::vector<std::pair<std::string, const TemplateEntry*>> documents;
+        std::set<std::string> labels;
+        for (const auto& tmpl : templates) {
+            std::string label = template_label(tmpl.path);
+            if (labels.insert(label).second) {
+                const std::vector<double>& features = tmpl.prepared->level(1).features;
+                descriptors.insert(descriptors.end(), features.begin(), features.end());
+                documents.emplace_back(std::move(label), &tmpl);
+            }
+        }
+        
+        meshmind::VocabularyParams params;
+        params.branching = size_t(branching);
+        params.depth = size_t(depth);
+        auto pack = std::make_unique<meshmind::VocabularyTree>(
+            descriptors.data(), descriptors.size() / meshmind::FPFH_DIMS, meshmind::FPFH_DIMS, params);
+        for (const auto& document : documents) {
+            const meshmind::TemplateLevel& level = document.second->prepared->level(1);
+            pack->add_document(document.first, level.features.data(), level.points.size());
+        }
+        if (pack_path) {
+            pack->save(pack_path);
+        }
+        detector->template_pack = std::move(pack);
+        reset_templates(detector);
+        return MESHMIND_SUCCESS;
+    } catch (const std::exception& e) {
+        detector->last_error = e.what();
+        return MESHMIND_ERROR_EXPORT;
+    }
+}
+
+int meshmind_load_template_pack(MeshMindDetector detector, const char* pack_path) {
+    if (!detector || !pack_path) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    try {
+        auto pack = std::make_unique<meshmind::VocabularyTree>(meshmind::VocabularyTree::load(pack_path));
+        if (pack->dims() != meshmind::FPFH_DIMS) {
+            detector->last_error = "Template pack does not index FPFH descriptors: " + std::string(pack_path);
+            return MESHMIND_ERROR_LOAD;
+        }
+        
+        // A pack of another template library (or of a moved one) would silently disable retrieval
+        std::set<std::string> labels;
+        for (size_t doc = 0; doc < pack->documents(); doc++) {
+            labels.insert(template_label(pack->label(doc)));
+        }
+        size_t missing = 0;
+        for (const auto& tmpl : detector->templates) {
+            missing += labels.count(template_label(tmpl.path)) ? 0 : 1;
+        }
+        if (missing > 0 && missing == detector->templates.size()) {
+            detector->last_error = "Template pack indexes none of the added templates: " + std::string(pack_path);
+            return MESHMIND_ERROR_LOAD;
+        }
+        
+        detector->template_pack = std::move(pack);
+        reset_templates(detector);
+        if (missing > 0) {
+            detector->last_error = std::to_string(missing) + " of " + std::to_string(detector->templates.size()) +
+                                   " templates are not in template pack " + pack_path + " and are always matched";
+        }
+        return MESHMIND_SUCCESS;
+    } catch (const std::exception& e) {
+        detector->last_error = e.what();
+        return MESHMIND_ERROR_LOAD;
+    }
+}
+
+/*
+ * Template retrieval: the descriptors of each search region (a target patch)
+ * are looked up in the template pack, and of the templates matched against
+ * that region only the retrieval_top_k best are kept. Returns the rejected
+ * templates; templates matched against the whole target, whose features
+ * compete with every other feature type there, and templates missing from
+ * the pack (compared by template_label) are never rejected.
+ */
+static std::vector<bool> retrieve_templates(MeshMindDetector detector) {
+    std::vector<bool> rejected(detector->templates.size(), false);
+    if (!detector->template_pack || detector->retrieval_top_k == 0) {
+        return rejected;
+    }
+    const meshmind::VocabularyTree& pack = *detector->template_pack;
+    
+    std::vector<std::string> documents;
+    for (size_t doc = 0; doc < pack.documents(); doc++) {
+        documents.push_back(template_label(pack.label(doc)));
+    }
+    std::set<std::string> indexed(documents.begin(), documents.end());
+    std::vector<std::string> labels;
+    std::map<const meshmind::TemplateMatcher*, std::vector<size_t>> patches;
+    for (size_t i = 0; i < detector->templates.size(); i++) {
+        const TemplateEntry& tmpl = detector->templates[i];
+        labels.push_back(template_label(tmpl.path));
+        if (!tmpl.completed && indexed.count(labels[i]) && !template_region(detector, i).unrestricted()) {
+            patches[&template_index(detector, i)].push_back(i);
+        }
+    }
+    
+    for (const auto& patch : patches) {
+        const meshmind::TemplateMatcher& index = *patch.first;
+        std::set<std::string> retrieved;
+        for (const auto& hit : pack.query(index.features().data(), index.size(), detector->retrieval_top_k)) {
+            retrieved.insert(documents[hit.document]);
+        }
+        for (size_t i : patch.second) {
+            rejected[i] = !retrieved.count(labels[i]);
+        }
+    }
+    return rejected;
+}
+
+/*
+ * Early rejection of pending templates. Templates not retrieved from the
+ * template pack are dropped first. The rest are scored at the lowest
+ * level of detail; only those within lod_margin of the best template
+ * of their feature type are promoted to the next level, and those still
+ * left at the full level are matched. Returns the rejected templates.
+ */
+static std::vector<bool> reject_templates(MeshMindDetector detector) {
+    std::vector<bool> rejected = retrieve_templates(detector);
+    if (detector->lod_margin < 0) {
+        return rejected;
+    }
+    
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i < detector->templates.size(); i++) {
+        if (!detector->templates[i].completed && !rejected[i]) {
+            candidates.push_back(i);
+        }
+    }
+    for (size_t level = 0; level + 1 < meshmind::PreparedTemplate::NUM_LEVELS; level++) {
+        std::vector<double> distances;
+        std::vector<int> groups;
+        for (size_t i : candidates) {
+            TemplateEntry& tmpl = detector->templates[i];
+            const meshmind::TemplateMatcher& index = template_index(detector, i);
+            distances.push_back(index.match_level(prepare_template(tmpl), level).feature_distance);
+            groups.push_back(tmpl.feature_type);
+        }
+        std::vector<bool> promoted = meshmind::promote_candidates(distances, groups, detector->lod_margin);
+        std::vector<size_t> next;
+        for (size_t c = 0; c < candidates.size(); c++) {
+            if (promoted[c]) {
+                next.push_back(candidates[c]);
+            } else {
+                rejected[candidates[c]] = true;
+            }
+        }
+        candidates = std::move(next);
+    }
+    return rejected;
+}
+
+/* A template waiting on its family representative */
+struct FamilyMember {
+    size_t index;
+    double alignment[16];   /* member frame onto the representative's, see member_alignment */
+};
+
+/*
+ * Near-duplicate templates among pending, clustered per feature type by
+ * the descriptor distribution of their lowest level of detail. Only the
+ * family representatives are left in pending; returns the members waiting
+ * on each representative.
+ */
+static std::map<size_t, std::vector<FamilyMember>> group_families(MeshMindDetector detector, std::vector<size_t>& pending) {
+    std::map<size_t, std::vector<FamilyMember>> members;
+    if (detector->family_distance < 0 || pending.size() < 2) {
+        return members;
+    }
+    
+    std::vector<std::vector<double>> signatures(pending.size());
+    std::vector<int> groups;
+    meshmind::parallel_for(pending.size(), [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; k++) {
+            const meshmind::TemplateLevel& level = prepare_template(detector->templates[pending[k]]).level(0);
+            signatures[k] = meshmind::descriptor_signature(level.features.data(), level.points.size());
+        }
+    }, 1);
+    for (size_t i : pending) {
+        groups.push_back(detector->templates[i].feature_type);
+    }
+    
+    meshmind::TemplateFamilies families = meshmind::cluster_templates(signatures, groups, detector->family_distance);
+    std::vector<size_t> representatives;
+    for (size_t k = 0; k < pending.size(); k++) {
+        size_t representative = pending[families.representatives[families.family[k]]];
+        if (representative == pending[k]) {
+            representatives.push_back(pending[k]);
+        } else {
+            FamilyMember member;
+            member.index = pending[k];
+            meshmind::member_alignment(prepare_template(detector->templates[pending[k]]).mesh(),
+                                       prepare_template(detector->templates[representative]).mesh(),
+                                       member.alignment);
+            members[representative].push_back(member);
+        }
+    }
+    pending = std::move(representatives);
+    return members;
+}
+
+/*
+ * Rebuild the result table from per-template results: sort by confidence,
+ * number instances per feature type ("<feature_id>_<n>") and hand the
+ * columns to the Python mesher as a DetectionTable so that the exporters
+ * see the same detections as the C caller.
+ */
+static void publish_detections(MeshMindDetector detector) {
+    struct Entry {
+        const TemplateEntry* tmpl;
+        const meshmind::SnapshotResult* result;
+    };
+    std::vector<Entry> entries;
+    for (const auto& tmpl : detector->templates) {
+        for (const auto& result : tmpl.results) {
+            entries.push_back({&tmpl, &result});
+        }
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.result->confidence > b.result->confidence;
+    });
+    
+    ResultTable& table = detector->results;
+    table.clear();
+    table.feature_type_names.assign(detector->feature_type_names.begin(), detector->feature_type_names.end());
+    table.feature_types.reserve(entries.size());
+    table.instances.reserve(entries.size());
+    table.positions.reserve(entries.size() * 3);
+    table.transforms.reserve(entries.size() * 16);
+    table.confidences.reserve(entries.size());
+    table.radii.reserve(entries.size());
+    table.scales.reserve(entries.size());
+    
+    std::vector<int> instance_counts(detector->feature_type_names.size(), 0);
+    
+    for (const auto& entry : entries) {
+        const double* m = entry.result->transform;
+        int instance = instance_counts[entry.tmpl->feature_type]++;
+        
+        table.feature_types.push_back(entry.tmpl->feature_type);
+        table.instances.push_back(instance);
+        table.transforms.insert(table.transforms.end(), m, m + 16);
+        
+        // Position is the translation part of the row-major transform
+        table.positions.push_back(m[3]);
+        table.positions.push_back(m[7]);
+        table.positions.push_back(m[11]);
+        
+        table.confidences.push_back(entry.result->confidence);
+        table.radii.push_back(entry.result->radius);
+        
+        // Uniform scale of the linear part (Procrustes fits similarity transforms)
+        double det3 = m[0] * (m[5] * m[10] - m[6] * m[9])
+                    - m[1] * (m[4] * m[10] - m[6] * m[8])
+                    + m[2] * (m[4] * m[9] - m[5] * m[8]);
+        table.scales.push_back(std::cbrt(std::fabs(det3)));
+    }
+    
+    // One array per column; a radius of 0 means "not known" (NaN in the table)
+    py::ssize_t n = static_cast<py::ssize_t>(table.size());
+    py::array_t<double> radii(n);
+    for (py::ssize_t i = 0; i < n; i++) {
+        radii.mutable_data()[i] = table.radii[i] > 0 ? table.radii[i] : std::nan("");
+    }
+    py::module_ detection_table = py::module_::import("meshmind.core.recognition.detection_table");
+    detector->mesher.attr("detections") = detection_table.attr("DetectionTable").attr("from_arrays")(
+        py::cast(table.feature_type_names),
+        py::array_t<int>(n, table.feature_types.data()),
+        py::array_t<int>(n, table.instances.data()),
+        py::array_t<double>(std::vector<py::ssize_t>{n, 4, 4}, table.transforms.data()),
+        py::array_t<double>(n, table.confidences.data()),
+        radii
+    );
+}
+
+static std::string save_snapshot(MeshMindDetector detector, const std::string& path) {
+    meshmind::DetectorSnapshot snapshot;
+    snapshot.target_path = detector->target_path;
+    if (!snapshot.target_path.empty() && !meshmind::fingerprint_target(snapshot)) {
+        return "Cannot stat target: " + snapshot.target_path;
+    }
+    
+    if (detector->target_index) {
+        const meshmind::TemplateMatcher& index = *detector->target_index;
+        snapshot.index_points = static_cast<uint32_t>(index.size());
+        snapshot.index_dims = static_cast<uint32_t>(meshmind::FPFH_DIMS);
+        snapshot.index_vertices = index.coarse_points();
+        snapshot.index_features = index.features();
+    }
+    
+    snapshot.checkpoint_path = detector->checkpoint_path;
+    snapshot.checkpoint_interval = detector->checkpoint_interval;
+    snapshot.level_dims = static_cast<uint32_t>(meshmind::FPFH_DIMS);
+    
+    // Settings, so that a resumed run matches the remaining templates as the completed ones were
+    meshmind::SnapshotSettings& settings = snapshot.settings;
+    for (const auto& search : detector->search_regions) {
+        meshmind::SnapshotRegion region;
+        region.feature_id = search.first;
+        region.boxes = search.second.boxes;
+        region.parts = search.second.parts;
+        region.up_axis = search.second.up_axis;
+        region.height_min = search.second.height_min;
+        region.height_max = search.second.height_max;
+        settings.search_regions.push_back(std::move(region));
+    }
+    for (const auto& localisation : detector->localisations) {
+        settings.localisations.push_back({localisation.first, localisation.second.max_peaks,
+                                          localisation.second.voxel_size});
+    }
+    settings.lod_margin = detector->lod_margin;
+    settings.ransac_iterations = detector->ransac.iterations;
+    settings.ransac_inlier_threshold = detector->ransac.inlier_threshold;
+    settings.max_clique = detector->max_clique;
+    settings.noise_bound = detector->robust.noise_bound;
+    settings.planner = detector->planner;
+    settings.expected_instances.assign(detector->expected_instances.begin(), detector->expected_instances.end());
+    settings.icp_iterations = detector->icp.iterations;
+    settings.icp_symmetric = detector->icp.symmetric;
+    settings.verify_tolerance = detector->verify_tolerance;
+    settings.min_confidence = detector->min_confidence;
+    settings.family_distance = detector->family_distance;
+    settings.family_confidence = detector->family_confidence;
+    settings.retrieval_top_k = detector->retrieval_top_k;
+    if (detector->template_pack) {
+        settings.template_pack = detector->template_pack->serialise();
+    }
+    
+    for (const auto& tmpl : detector->templates) {
+        meshmind::SnapshotTemplate entry;
+        entry.path = tmpl.path;
+        entry.feature_id = tmpl.feature_id;
+        entry.completed = tmpl.completed;
+        entry.results = tmpl.results;
+        
+        // Levels of detail prepared so far, so that a resumed run skips their sampling and descriptors
+        if (tmpl.prepared) {
+            const meshmind::MatcherParams& params = tmpl.prepared->params();
+            entry.lod_points = params.lod_points;
+            entry.coarse_points = params.coarse_points;
+            entry.radius_normal = params.radius_normal;
+            entry.radius_feature = params.radius_feature;
+            entry.seed = params.seed;
+            for (size_t l = 0; l < meshmind::PreparedTemplate::NUM_LEVELS; l++) {
+                if (!tmpl.prepared->computed(l)) {
+                    continue;
+                }
+                const meshmind::TemplateLevel& lod = tmpl.prepared->level(l);
+                meshmind::SnapshotLevel level;
+                level.level = static_cast<uint32_t>(l);
+                level.points = lod.points.points;
+                level.normals = lod.points.normals;
+                level.order = lod.points.order;
+                level.features = lod.features;
+                entry.levels.push_back(std::move(level));
+            }
+        }
+        snapshot.templates.push_back(std::move(entry));
+    }
+    
+    return meshmind::write_snapshot(snapshot, path);
+}
+
+/*
+ * Run the loaded plugins on one template and fuse their detections with the
+ * built-in one in SE(3), as EnsembleDetector does for Python detectors:
+ * poses the detectors agree on become one result with a noisy-OR confidence.
+ * Plugins see the template's search region as the built-in matcher does,
+ * and their detections outside it are dropped.
+ */
+static std::vector<meshmind::SnapshotResult> fuse_with_plugins(
+    MeshMindDetector detector,
+    size_t i,
+    const meshmind::TriangleMesh& template_mesh,
+    const meshmind::SnapshotResult& builtin
+) {
+    const TemplateEntry& tmpl = detector->templates[i];
+    meshmind::SearchRegion region = template_region(detector, i);
+    std::unique_ptr<meshmind::PluginTarget>& target = detector->plugin_targets[region.key()];
+    if (!target) {
+        target = std::make_unique<meshmind::PluginTarget>(
+            detector->target_mesh, region_index(detector, region), ensure_target_bvh(detector));
+    }
+    meshmind::RegionBounds bounds(ensure_target_bvh(detector), region);
+    
+    std::vector<meshmind::PoseHypothesis> hypotheses;
+    std::vector<double> radii;
+    meshmind::PoseHypothesis hypothesis;
+    memcpy(hypothesis.transform, builtin.transform, sizeof(hypothesis.transform));
+    hypothesis.confidence = builtin.confidence;
+    hypothesis.group = 0;
+    hypothesis.source = 0;
+    hypotheses.push_back(hypothesis);
+    radii.push_back(builtin.radius);
+    
+    for (size_t p = 0; p < detector->plugins.size(); p++) {
+        for (const auto& detection : detector->plugins[p]->detect(*target, template_mesh,
+                                                                  tmpl.path, tmpl.feature_id)) {
+            const double position[3] = {detection.transform[3], detection.transform[7], detection.transform[11]};
+            if (!region.unrestricted() && !bounds.contains(position)) {
+                continue;
+            }
+            memcpy(hypothesis.transform, detection.transform, sizeof(hypothesis.transform));
+            hypothesis.confidence = detection.confidence;
+            hypothesis.source = int32_t(p + 1);
+            hypotheses.push_back(hypothesis);
+            radii.push_back(detection.radius);
+        }
+    }
+    
+    // Kernel width: 2% of the target's diagonal, the EnsembleDetector default
+    const std::vector<double>& vertices = detector->target_mesh.vertices;
+    double lo[3] = {INFINITY, INFINITY, INFINITY};
+    double hi[3] = {-INFINITY, -INFINITY, -INFINITY};
+    for (size_t i = 0; i < vertices.size(); i++) {
+        lo[i % 3] = std::min(lo[i % 3], vertices[i]);
+        hi[i % 3] = std::max(hi[i % 3], vertices[i]);
+    }
+    double diagonal = vertices.empty() ? 0.0 : std::sqrt((hi[0] - lo[0]) * (hi[0] - lo[0]) +
+                                                         (hi[1] - lo[1]) * (hi[1] - lo[1]) +
+                                                         (hi[2] - lo[2]) * (hi[2] - lo[2]));
+    meshmind::FusionOptions options;
+    options.translation_bandwidth = diagonal > 0 ? 0.02 * diagonal : 1.0;
+    
+    std::vector<meshmind::SnapshotResult> results;
+    for (const auto& fused : meshmind::fuse_poses(hypotheses, options)) {
+        meshmind::SnapshotResult result;
+        memcpy(result.transform, fused.transform, sizeof(result.transform));
+        result.confidence = fused.confidence;
+        result.radius = radii[fused.representative];
+        results.push_back(result);
+    }
+    return results;
+}
+
+// Run all pending templates and rebuild the result table; returns a status code
+static int run_detection(MeshMindDetector detector) {
+    if (detector->target_path.empty()) {
+        detector->last_error = "No target loaded";
+        return MESHMIND_ERROR_DETECT;
+    }
+    
+    using clock = std::chrono::steady_clock;
+    auto last_checkpoint = clock::now();
+    
+    // Called after each completed template; writes at most one snapshot per checkpoint_interval
+    auto checkpoint = [&]() {
+        if (detector->checkpoint_path.empty()) {
+            return MESHMIND_SUCCESS;
+        }
+        std::chrono::duration<double> elapsed = clock::now() - last_checkpoint;
+        if (elapsed.count() < detector->checkpoint_interval) {
+            return MESHMIND_SUCCESS;
+        }
+        std::string error = save_snapshot(detector, detector->checkpoint_path);
+        if (!error.empty()) {
+            detector->last_error = error;
+            return MESHMIND_ERROR_SNAPSHOT;
+        }
+        last_checkpoint = clock::now();
+        return MESHMIND_SUCCESS;
+    };
+    
+    // Matching runs natively; the GIL is only needed to publish results
+    try {
+        std::vector<bool> rejected = reject_templates(detector);
+        
+        // Templates completed before (e.g. restored from a snapshot) are skipped
+        std::vector<size_t> pending;
+        for (size_t i = 0; i < detector->templates.size(); i++) {
+            TemplateEntry& tmpl = detector->templates[i];
+            if (tmpl.completed) {
+                continue;
+            }
+            if (rejected[i]) {
+                tmpl.results.clear();
+                tmpl.completed = true;
+                if (checkpoint() != MESHMIND_SUCCESS) {
+                    return MESHMIND_ERROR_SNAPSHOT;
+                }
+                continue;
+            }
+            pending.push_back(i);
+        }
+        
+        std::map<size_t, std::vector<FamilyMember>> families = group_families(detector, pending);
+        
+        // Poses are estimated template by template, then refined in parallel a batch at a time
+        auto match_batches = [&](const std::vector<size_t>& indices, auto estimate) {
+            const size_t batch_size = meshmind::hardware_threads();
+            for (size_t first = 0; first < indices.size(); first += batch_size) {
+                std::vector<size_t> batch(indices.begin() + std::ptrdiff_t(first),
+                                          indices.begin() + std::ptrdiff_t(std::min(indices.size(), first + batch_size)));
+                std::vector<meshmind::TemplateDetection> detections;
+                for (size_t i : batch) {
+                    detections.push_back(estimate(i));
+                }
+                refine_detections(detector, batch, detections);
+                
+                for (size_t k = 0; k < batch.size(); k++) {
+                    TemplateEntry& tmpl = detector->templates[batch[k]];
+                    const meshmind::PreparedTemplate& prepared = prepare_template(tmpl);
+                    const meshmind::TemplateDetection& detection = detections[k];
+                    meshmind::Verification verification = verify_detection(detector, prepared, detection.transform);
+                    if (verification.rejected) {
+                        tmpl.results.clear();
+                    } else {
+                        meshmind::SnapshotResult result;
+                        memset(&result, 0, sizeof(result));
+                        memcpy(result.transform, detection.transform, sizeof(result.transform));
+                        result.confidence = verification.coverage;
+                        
+                        tmpl.results.assign(1, result);
+                        if (!detector->plugins.empty()) {
+                            tmpl.results = fuse_with_plugins(detector, batch[k], prepared.mesh(), result);
+                        }
+                    }
+                    tmpl.completed = true;
+                    
+                    if (checkpoint() != MESHMIND_SUCCESS) {
+                        return MESHMIND_ERROR_SNAPSHOT;
+                    }
+                }
+            }
+            return MESHMIND_SUCCESS;
+        };
+        
+        int status = match_batches(pending, [&](size_t i) {
+            meshmind::TemplateDetection detection = detect_template(detector, i);
+            orient_from_peaks(detector, i, detection);
+            return detection;
+        });
+        if (status != MESHMIND_SUCCESS) {
+            return status;
+        }
+        
+        // Family members start from their representative's best pose, and only if it was found
+        std::vector<size_t> seeded;
+        std::map<size_t, meshmind::SnapshotResult> seeds;
+        for (const auto& family : families) {
+            const meshmind::SnapshotResult* best = nullptr;
+            for (const auto& result : detector->templates[family.first].results) {
+                if (!best || result.confidence > best->confidence) {
+                    best = &result;
+                }
+            }
+            for (const FamilyMember& member : family.second) {
+                if (best && best->confidence >= detector->family_confidence) {
+                    // Representative pose after the member-to-representative similarity
+                    meshmind::SnapshotResult seed = *best;
+                    for (int r = 0; r < 4; r++) {
+                        for (int c = 0; c < 4; c++) {
+                            double sum = 0.0;
+                            for (int k = 0; k < 4; k++) {
+                                sum += best->transform[4 * r + k] * member.alignment[4 * k + c];
+                            }
+                            seed.transform[4 * r + c] = sum;
+                        }
+                    }
+                    seeds[member.index] = seed;
+                    seeded.push_back(member.index);
+                } else {
+                    detector->templates[member.index].results.clear();
+                    detector->templates[member.index].completed = true;
+                    if (checkpoint() != MESHMIND_SUCCESS) {
+                        return MESHMIND_ERROR_SNAPSHOT;
+                    }
+                }
+            }
+        }
+        status = match_batches(seeded, [&](size_t i) {
+            meshmind::TemplateDetection detection;
+            memcpy(detection.transform, seeds[i].transform, sizeof(detection.transform));
+            detection.confidence = seeds[i].confidence;
+            detection.mean_feature_distance = 0.0;
+            detection.alignment_cost = 0.0;
+            return detection;
+        });
+        if (status != MESHMIND_SUCCESS) {
+            return status;
+        }
+    } catch (const std::exception& e) {
+        detector->last_error = e.what();
+        return MESHMIND_ERROR_DETECT;
+    }
+    
+    py::gil_scoped_acquire gil;
+    try {
+        publish_detections(detector);
+    } catch (const py::error_already_set& e) {
+        detector->last_error = e.what();
+        return MESHMIND_ERROR_DETECT;
+    }
+    
+    if (!detector->checkpoint_path.empty()) {
+        std::string error = save_snapshot(detector, detector->checkpoint_path);
+        if (!error.empty()) {
+            detector->last_error = error;
+            return MESHMIND_ERROR_SNAPSHOT;
+        }
+    }
+    return MESHMIND_SUCCESS;
+}
+
+int meshmind_detect(
+    MeshMindDetector detector,
+    MeshMindDetection* results,
+    int max_results
+) {
+    if (!detector || !results || max_results <= 0) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    int status = run_detection(detector);
+    if (status != MESHMIND_SUCCESS) {
+        return status;
+    }
+    
+    const ResultTable& table = detector->results;
+    int count = std::min((int)table.size(), max_results);
+    for (int i = 0; i < count; i++) {
+        MeshMindDetection& result = results[i];
+        memset(&result, 0, sizeof(result));
+        
+        std::string feature_id = table.feature_id(i);
+        strncpy(result.feature_id, feature_id.c_str(), sizeof(result.feature_id) - 1);
+        memcpy(result.transform, &table.transforms[i * 16], sizeof(result.transform));
+        memcpy(result.position, &table.positions[i * 3], sizeof(result.position));
+        result.confidence = table.confidences[i];
+        result.radius = table.radii[i];
+    }
+    return count;
+}
 
-MeshMindDetector meshmind_create_detector() {
+static int get_results(MeshMindDetector detector, MeshMindResults* results) {
+    const ResultTable& table = detector->results;
+    results->count = (int)table.size();
+    results->num_feature_types = (int)detector->feature_type_names.size();
+    results->feature_type_names = detector->feature_type_name_ptrs.data();
+    results->feature_types = table.feature_types.data();
+    results->instances = table.instances.data();
+    results->positions = table.positions.data();
+    results->transforms = table.transforms.data();
+    results->confidences = table.confidences.data();
+    results->radii = table.radii.data();
+    results->scales = table.scales.data();
+    return results->count;
+}
+
+int meshmind_get_results(MeshMindDetector detector, MeshMindResults* results) {
+    if (!detector || !results) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    return get_results(detector, results);
+}
+
+int meshmind_detect_results(MeshMindDetector detector, MeshMindResults* results) {
+    if (!detector || !results) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    int status = run_detection(detector);
+    if (status != MESHMIND_SUCCESS) {
+        return status;
+    }
+    return get_results(detector, results);
+}
+
+int meshmind_detect_async(MeshMindDetector detector) {
+    if (!detector) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    // The previous job has been collected, so its thread has finished
+    if (detector->job_thread.joinable()) {
+        detector->job_thread.join();
+    }
+    detector->job = AsyncJob::RUNNING;
+    detector->job_thread = std::thread([detector]() {
+        int status = run_detection(detector);
+        std::lock_guard<std::mutex> lock(detector->mutex);
+        detector->job_status = status;
+        detector->job = AsyncJob::FINISHED;
+        detector->job_done.notify_all();
+    });
+    return MESHMIND_SUCCESS;
+}
+
+int meshmind_wait(MeshMindDetector detector, double timeout_seconds) {
+    if (!detector) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::unique_lock<std::mutex> lock(detector->mutex);
+    if (detector->job == AsyncJob::NONE) {
+        detector->last_error = "No asynchronous detection in progress";
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    
+    auto done = [detector]() { return detector->job != AsyncJob::RUNNING; };
+    if (timeout_seconds < 0) {
+        detector->job_done.wait(lock, done);
+    } else if (!detector->job_done.wait_for(lock, std::chrono::duration<double>(timeout_seconds), done)) {
+        return MESHMIND_PENDING;
+    }
+    
+    // Concurrent waiters all see the status; the detector is free again once collected
+    detector->job = AsyncJob::NONE;
+    return detector->job_status;
+}
+
+const char* meshmind_feature_type_name(MeshMindDetector detector, int feature_type) {
+    if (!detector || feature_type < 0) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector) || feature_type >= (int)detector->feature_type_names.size()) {
+        return nullptr;
+    }
+    return detector->feature_type_name_ptrs[feature_type];
+}
+
+int meshmind_save_snapshot(MeshMindDetector detector, const char* snapshot_path) {
+    if (!detector || !snapshot_path) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    std::string error = save_snapshot(detector, snapshot_path);
+    if (!error.empty()) {
+        detector->last_error = error;
+        return MESHMIND_ERROR_SNAPSHOT;
+    }
+    return MESHMIND_SUCCESS;
+}
+
+int meshmind_load_snapshot(MeshMindDetector detector, const char* snapshot_path) {
+    if (!detector || !snapshot_path) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    meshmind::DetectorSnapshot snapshot;
+    std::string error = meshmind::read_snapshot(snapshot_path, snapshot);
+    if (!error.empty()) {
+        detector->last_error = error;
+        return MESHMIND_ERROR_SNAPSHOT;
+    }
+    
+    if (!snapshot.target_path.empty()) {
+        meshmind::DetectorSnapshot current;
+        current.target_path = snapshot.target_path;
+        if (!meshmind::fingerprint_target(current) ||
+            current.target_size != snapshot.target_size ||
+            current.target_mtime != snapshot.target_mtime) {
+            detector->last_error = "Target changed since snapshot was taken: " + snapshot.target_path;
+            return MESHMIND_ERROR_SNAPSHOT;
+        }
+    }
+    
+    // Everything is rebuilt aside and only swapped in once the whole snapshot has loaded
+    meshmind::TriangleMesh target_mesh;
+    std::unique_ptr<meshmind::TemplateMatcher> target_index;
+    std::vector<TemplateEntry> templates;
+    std::unique_ptr<meshmind::VocabularyTree> template_pack;
     try {
-        auto detector = new MeshMindDetector_t;
-        detector->guard = new py::scoped_interpreter();
+        if (!snapshot.target_path.empty()) {
+            target_mesh = meshmind::load_mesh(snapshot.target_path);
+        }
         
-        // Import MeshMind SDK
-        py::module_ meshmind = py::module_::import("meshmind.sdk.mesher");
-        detector->mesher = meshmind.attr("AutoMesher")();
+        if (snapshot.index_points > 0) {
+            if (snapshot.index_dims != meshmind::FPFH_DIMS) {
+                detector->last_error = "Snapshot index has unexpected descriptor size";
+                return MESHMIND_ERROR_SNAPSHOT;
+            }
+            target_index = std::make_unique<meshmind::TemplateMatcher>(
+                std::move(snapshot.index_vertices), std::move(snapshot.index_features));
+        }
         
-        detector->last_error = "";
-        return detector;
+        for (auto& tmpl : snapshot.templates) {
+            TemplateEntry entry;
+            entry.path = std::move(tmpl.path);
+            entry.feature_id = std::move(tmpl.feature_id);
+            entry.completed = tmpl.completed;
+            entry.results = std::move(tmpl.results);
+            if (!tmpl.levels.empty()) {
+                meshmind::MatcherParams params;
+                params.lod_points = tmpl.lod_points;
+                params.coarse_points = tmpl.coarse_points;
+                params.radius_normal = tmpl.radius_normal;
+                params.radius_feature = tmpl.radius_feature;
+                params.seed = tmpl.seed;
+                // restore() checks the level sizes against the descriptor size
+                entry.prepared = std::make_shared<meshmind::PreparedTemplate>(meshmind::load_mesh(entry.path), params);
+                for (auto& level : tmpl.levels) {
+                    meshmind::TemplateLevel lod;
+                    lod.points.points = std::move(level.points);
+                    lod.points.normals = std::move(level.normals);
+                    lod.points.order = std::move(level.order);
+                    lod.features = std::move(level.features);
+                    entry.prepared->restore(level.level, std::move(lod));
+                }
+            }
+            templates.push_back(std::move(entry));
+        }
         
-    } catch (const py::error_already_set& e) {
-        return nullptr;
+        if (!snapshot.settings.template_pack.empty()) {
+            template_pack = std::make_unique<meshmind::VocabularyTree>(
+                meshmind::VocabularyTree::deserialise(snapshot.settings.template_pack, snapshot_path));
+        }
     } catch (const std::exception& e) {
-        return nullptr;
+        detector->last_error = e.what();
+        return MESHMIND_ERROR_SNAPSHOT;
+    }
+    
+    detector->target_path = snapshot.target_path;
+    detector->target_mesh = std::move(target_mesh);
+    detector->target_index = std::move(target_index);
+    detector->plugin_targets.clear();
+    detector->region_indexes.clear();
+    detector->region_stats.clear();
+    detector->localizers.clear();
+    detector->seeded_regions.clear();
+    detector->target_bvh.reset();
+    detector->target_features.clear();
+    for (auto& entry : templates) {
+        entry.feature_type = intern_feature_type(detector, entry.feature_id);
+    }
+    detector->templates = std::move(templates);
+    detector->checkpoint_path = snapshot.checkpoint_path;
+    detector->checkpoint_interval = snapshot.checkpoint_interval;
+    
+    // Settings are restored as saved, without the template reset the meshmind_set_* calls make
+    if (snapshot.has_settings) {
+        const meshmind::SnapshotSettings& settings = snapshot.settings;
+        detector->search_regions.clear();
+        for (const auto& saved : settings.search_regions) {
+            meshmind::SearchRegion& region = detector->search_regions[saved.feature_id];
+            region.boxes = saved.boxes;
+            region.parts = saved.parts;
+            region.up_axis = saved.up_axis;
+            region.height_min = saved.height_min;
+            region.height_max = saved.height_max;
+        }
+        detector->localisations.clear();
+        for (const auto& localisation : settings.localisations) {
+            detector->localisations[localisation.feature_id] = FFTLocalisation{localisation.max_peaks,
+                                                                               localisation.voxel_size};
+        }
+        detector->lod_margin = settings.lod_margin;
+        detector->ransac.iterations = size_t(settings.ransac_iterations);
+        detector->ransac.inlier_threshold = settings.ransac_inlier_threshold;
+        detector->max_clique = settings.max_clique;
+        detector->robust.noise_bound = settings.noise_bound;
+        detector->planner = settings.planner;
+        detector->expected_instances = std::map<std::string, int>(settings.expected_instances.begin(),
+                                                                  settings.expected_instances.end());
+        detector->icp.iterations = size_t(settings.icp_iterations);
+        detector->icp.symmetric = settings.icp_symmetric;
+        detector->verify_tolerance = settings.verify_tolerance;
+        detector->min_confidence = settings.min_confidence;
+        detector->family_distance = settings.family_distance;
+        detector->family_confidence = settings.family_confidence;
+        detector->retrieval_top_k = size_t(settings.retrieval_top_k);
+        detector->template_pack = std::move(template_pack);
+    }
+    
+    py::gil_scoped_acquire gil;
+    try {
+        // Make restored results visible to the exporters right away
+        publish_detections(detector);
+        return MESHMIND_SUCCESS;
+        
+    } catch (const py::error_already_set& e) {
+        detector->last_error = e.what();
+        return MESHMIND_ERROR_SNAPSHOT;
     }
 }
 
-void meshmind_destroy_detector(MeshMindDetector detector) {
-    if (detector) {
-        delete detector->guard;
-        delete detector;
+int meshmind_set_checkpoint(
+    MeshMindDetector detector,
+    const char* snapshot_path,
+    double interval_seconds
+) {
+    if (!detector || interval_seconds < 0) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
     }
+    
+    detector->checkpoint_path = snapshot_path ? snapshot_path : "";
+    detector->checkpoint_interval = interval_seconds;
+    return MESHMIND_SUCCESS;
 }
 
-int meshmind_load_target(MeshMindDetector detector, const char* stl_path) {
-    if (!detector || !stl_path) {
+int meshmind_load_feature_model(MeshMindDetector detector, const char* weights_path) {
+    if (!detector || !weights_path) {
         return MESHMIND_ERROR_INVALID_PARAM;
     }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
     
     try {
-        detector->mesher.attr("load_target")(stl_path);
+        detector->feature_model = std::make_unique<meshmind::MeshCNNExtractor>(
+            meshmind::MeshCNNExtractor::load(weights_path));
+        detector->target_features.clear();
         return MESHMIND_SUCCESS;
-    } catch (const py::error_already_set& e) {
+    } catch (const std::exception& e) {
         detector->last_error = e.what();
         return MESHMIND_ERROR_LOAD;
     }
 }
 
-int meshmind_add_template(
+int meshmind_extract_features(
     MeshMindDetector detector,
-    const char* template_path,
-    const char* feature_id
+    const char* mesh_path,
+    float* features,
+    int max_features
 ) {
-    if (!detector || !template_path) {
+    if (!detector || !mesh_path) {
         return MESHMIND_ERROR_INVALID_PARAM;
     }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    if (!detector->feature_model) {
+        detector->last_error = "No feature model loaded";
+        return MESHMIND_ERROR_DETECT;
+    }
     
-    // Templates are added via detect_features in the Python SDK
-    // We'll store them and use them in detect()
-    // For now, just validate the path exists
-    return MESHMIND_SUCCESS;
+    int dim = static_cast<int>(detector->feature_model->feature_dim());
+    if (!features) {
+        return dim;
+    }
+    if (max_features < dim) {
+        detector->last_error = "Feature buffer too small: need " + std::to_string(dim);
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    
+    try {
+        meshmind::TriangleMesh mesh = meshmind::load_mesh(mesh_path);
+        detector->feature_model->extract(mesh.vertices.data(), mesh.num_vertices(), features);
+        return dim;
+    } catch (const std::exception& e) {
+        detector->last_error = e.what();
+        return MESHMIND_ERROR_LOAD;
+    }
 }
 
-int meshmind_detect(
+static double cosine_similarity(const float* a, const float* b, size_t dim) {
+    double dot = 0.0, norm_a = 0.0, norm_b = 0.0;
+    for (size_t d = 0; d < dim; d++) {
+        dot += double(a[d]) * b[d];
+        norm_a += double(a[d]) * a[d];
+        norm_b += double(b[d]) * b[d];
+    }
+    return dot / (std::sqrt(norm_a) * std::sqrt(norm_b));
+}
+
+int meshmind_template_similarity(
     MeshMindDetector detector,
-    MeshMindDetection* results,
-    int max_results
+    double* similarities,
+    int max_templates
 ) {
-    if (!detector || !results || max_results <= 0) {
+    if (!detector || !similarities || max_templates < 0) {
         return MESHMIND_ERROR_INVALID_PARAM;
     }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    if (!detector->feature_model) {
+        detector->last_error = "No feature model loaded";
+        return MESHMIND_ERROR_DETECT;
+    }
+    if (detector->target_path.empty()) {
+        detector->last_error = "No target loaded";
+        return MESHMIND_ERROR_DETECT;
+    }
     
     try {
-        // For this implementation, we need to pass template paths
-        // In a full implementation, we'd track added templates
-        // For now, this is a minimal example
+        const meshmind::MeshCNNExtractor& model = *detector->feature_model;
+        const size_t dim = model.feature_dim();
         
-        py::list detections = detector->mesher.attr("detections");
-        int count = std::min((int)py::len(detections), max_results);
-        
-        detector->cached_detections.clear();
-        
-        for (int i = 0; i < count; i++) {
-            py::object det = detections[i];
-            
-            MeshMindDetection result;
-            memset(&result, 0, sizeof(result));
-            
-            // Extract feature_id
-            std::string feature_id = py::str(det.attr("feature_id"));
-            strncpy(result.feature_id, feature_id.c_str(), sizeof(result.feature_id) - 1);
-            
-            // Extract transform matrix
-            py::array_t<double> transform = det.attr("transform");
-            auto transform_buf = transform.unchecked<2>();
-            for (int r = 0; r < 4; r++) {
-                for (int c = 0; c < 4; c++) {
-                    result.transform[r * 4 + c] = transform_buf(r, c);
-                }
-            }
-            
-            // Extract position (translation part of transform)
-            result.position[0] = result.transform[3];   // [0,3]
-            result.position[1] = result.transform[7];   // [1,3]
-            result.position[2] = result.transform[11];  // [2,3]
-            
-            // Extract confidence
-            result.confidence = py::float_(det.attr("confidence"));
-            
-            // Extract radius from metadata if available
-            try {
-                py::dict metadata = det.attr("region_metadata");
-                if (metadata.contains("radius")) {
-                    result.radius = py::float_(metadata["radius"]);
-                }
-            } catch (...) {
-                result.radius = 0.0;
-            }
-            
-            results[i] = result;
-            detector->cached_detections.push_back(result);
+        // One batch: the target (unless cached) followed by the requested templates
+        size_t count = std::min(detector->templates.size(), static_cast<size_t>(max_templates));
+        std::vector<meshmind::TriangleMesh> meshes;
+        for (size_t i = 0; i < count; i++) {
+            meshes.push_back(meshmind::load_mesh(detector->templates[i].path));
+        }
+        std::vector<meshmind::PointsView> views;
+        bool need_target = detector->target_features.empty();
+        if (need_target) {
+            const meshmind::TriangleMesh& target = detector->target_mesh;
+            views.push_back(meshmind::PointsView{target.vertices.data(), nullptr, target.num_vertices()});
+        }
+        for (const auto& mesh : meshes) {
+            views.push_back(meshmind::PointsView{mesh.vertices.data(), nullptr, mesh.num_vertices()});
         }
         
-        return count;
+        std::vector<float> features = model.extract_batch(views);
+        const float* template_features = features.data();
+        if (need_target) {
+            detector->target_features.assign(features.begin(), features.begin() + dim);
+            template_features += dim;
+        }
         
-    } catch (const py::error_already_set& e) {
+        for (size_t i = 0; i < count; i++) {
+            double cosine = cosine_similarity(detector->target_features.data(),
+                                              template_features + i * dim, dim);
+            similarities[i] = (cosine + 1.0) / 2.0;
+        }
+        return static_cast<int>(count);
+    } catch (const std::exception& e) {
         detector->last_error = e.what();
         return MESHMIND_ERROR_DETECT;
     }
 }
 
+int meshmind_load_plugin(MeshMindDetector detector, const char* library_path, const char* config) {
+    if (!detector || !library_path) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    try {
+        detector->plugins.push_back(std::make_unique<meshmind::NativePlugin>(
+            library_path, config ? config : ""));
+        return static_cast<int>(detector->plugins.size()) - 1;
+    } catch (const std::exception& e) {
+        detector->last_error = e.what();
+        return MESHMIND_ERROR_LOAD;
+    }
+}
+
+const char* meshmind_plugin_name(MeshMindDetector detector, int plugin) {
+    if (!detector || plugin < 0) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector) || plugin >= static_cast<int>(detector->plugins.size())) {
+        return nullptr;
+    }
+    return detector->plugins[plugin]->name().c_str();
+}
+
+/*
+ * Write mesher inputs from the result table with the native generator
+ * backends; regions are generated once and the backends run concurrently.
+ */
+static int export_mesher_inputs(
+    MeshMindDetector detector,
+    const std::vector<std::string>& names,
+    const std::vector<std::string>& paths
+) {
+    try {
+        std::vector<std::unique_ptr<meshmind::MeshGenerator>> generators;
+        std::vector<const meshmind::MeshGenerator*> backends;
+        for (const auto& name : names) {
+            generators.push_back(meshmind::make_generator(name));
+            backends.push_back(generators.back().get());
+        }
+        meshmind::RegionTable regions = meshmind::generate_regions(detector->results);
+        meshmind::export_mesher_inputs(backends, paths, detector->results, regions);
+        return MESHMIND_SUCCESS;
+    } catch (const std::invalid_argument& e) {
+        detector->last_error = e.what();
+        return MESHMIND_ERROR_INVALID_PARAM;
+    } catch (const std::exception& e) {
+        detector->last_error = e.what();
+        return MESHMIND_ERROR_EXPORT;
+    }
+}
+
 int meshmind_export_snappy_dict(
     MeshMindDetector detector,
     const char* output_path
@@ -154,7 +2062,22 @@ int meshmind_export_snappy_dict(
     if (!detector || !output_path) {
         return MESHMIND_ERROR_INVALID_PARAM;
     }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    // A directory gets the full case (with MRF files) from the Python exporters
+    std::string path = output_path;
+    if (!path.empty() && path.back() != '/' && !std::filesystem::is_directory(path)) {
+        if (detector->results.size() == 0) {
+            detector->last_error = "No refinement regions generated to export.";
+            return MESHMIND_ERROR_EXPORT;
+        }
+        return export_mesher_inputs(detector, {"snappyhexmesh"}, {path});
+    }
     
+    py::gil_scoped_acquire gil;
     try {
         // Generate refinement regions
         detector->mesher.attr("generate_refinement")();
@@ -178,7 +2101,12 @@ int meshmind_export_openfoam_case(
     if (!detector || !case_dir) {
         return MESHMIND_ERROR_INVALID_PARAM;
     }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
     
+    py::gil_scoped_acquire gil;
     try {
         // Generate refinement with MRF
         py::dict kwargs;
@@ -203,30 +2131,125 @@ int meshmind_export_ftetwild_sizing(
     if (!detector || !output_path) {
         return MESHMIND_ERROR_INVALID_PARAM;
     }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
     
-    try {
-        // Import fTetWild generator
-        py::module_ generators = py::module_::import("meshmind.plugins.mesh_generators.ftetwild");
-        py::object ftetwild_gen = generators.attr("FTetWildGenerator")();
-        
-        // Get detections
-        py::list detections = detector->mesher.attr("detections");
-        
-        // Generate config
-        py::dict params;
-        params["base_size"] = 0.1;
-        params["refinement_factor"] = 0.2;
-        
-        py::dict config = ftetwild_gen.attr("generate_refinement_config")(detections, params);
+    return export_mesher_inputs(detector, {"ftetwild"}, {output_path});
+}
+
+int meshmind_export_mesher_inputs(
+    MeshMindDetector detector,
+    const char* const* generators,
+    const char* const* output_paths,
+    int count
+) {
+    if (!detector || !generators || !output_paths || count <= 0) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    
+    std::vector<std::string> names, paths;
+    for (int i = 0; i < count; i++) {
+        if (!generators[i] || !output_paths[i]) {
+            return MESHMIND_ERROR_INVALID_PARAM;
+        }
+        names.push_back(generators[i]);
+        paths.push_back(output_paths[i]);
+    }
+    return export_mesher_inputs(detector, names, paths);
+}
+
+int meshmind_run_pipeline(
+    MeshMindDetector detector,
+    const MeshMindCase* cases,
+    int count,
+    const MeshMindPipelineOptions* options,
+    MeshMindCaseResult* results
+) {
+    if (!detector || !cases || count <= 0 || !options || !options->generator || !results) {
+        return MESHMIND_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (is_busy(detector)) {
+        return MESHMIND_ERROR_BUSY;
+    }
+    for (int i = 0; i < count; i++) {
+        if (!cases[i].target_path || !cases[i].case_dir) {
+            return MESHMIND_ERROR_INVALID_PARAM;
+        }
+    }
+    
+    std::string generator = options->generator;
+    std::string config_file = options->config_file ? options->config_file
+                            : generator == "ftetwild" ? "sizing.json" : "snappyHexMeshDict";
+    
+    for (int i = 0; i < count; i++) {
+        memset(&results[i], 0, sizeof(results[i]));
+        results[i].exit_code = -1;
+    }
+    
+    // Case N+1 is detected on this thread while case N is being meshed
+    auto prepare = [&](size_t i, meshmind::MesherJob& job) {
+        using clock = std::chrono::steady_clock;
+        auto start = clock::now();
+        MeshMindCaseResult& result = results[i];
+        std::string case_dir = cases[i].case_dir;
+        std::string config_path = case_dir + "/" + config_file;
         
-        // Export
-        ftetwild_gen.attr("export_config")(config, output_path);
+        std::error_code error;
+        std::filesystem::create_directories(case_dir, error);
+        int status = error ? MESHMIND_ERROR_EXPORT : load_target(detector, cases[i].target_path);
+        if (error) {
+            detector->last_error = "Cannot create " + case_dir + ": " + error.message();
+        }
+        if (status == MESHMIND_SUCCESS) {
+            status = run_detection(detector);
+        }
+        if (status == MESHMIND_SUCCESS) {
+            status = export_mesher_inputs(detector, {generator}, {config_path});
+        }
+        result.status = status;
+        result.detections = status == MESHMIND_SUCCESS ? static_cast<int>(detector->results.size()) : 0;
+        result.detect_seconds = std::chrono::duration<double>(clock::now() - start).count();
+        if (status != MESHMIND_SUCCESS || !options->command) {
+            return false;
+        }
         
-        return MESHMIND_SUCCESS;
+        // Paths are passed as positional parameters, so the command needs no quoting
+        job.argv = {"/bin/sh", "-c", options->command, "meshmind", cases[i].target_path, config_path, case_dir};
+        job.log_path = case_dir + "/mesher.log";
+        job.cpus = std::max(options->cpus_per_case, 1);
+        job.timeout_seconds = options->timeout_seconds;
+        return true;
+    };
+    
+    try {
+        meshmind::PipelineExecutor executor(options->cpu_budget);
+        std::vector<meshmind::JobResult> jobs = executor.run(static_cast<size_t>(count), prepare);
         
-    } catch (const py::error_already_set& e) {
+        int failed = 0;
+        for (int i = 0; i < count; i++) {
+            const meshmind::JobResult& job = jobs[i];
+            results[i].exit_code = job.exit_code;
+            results[i].timed_out = job.timed_out ? 1 : 0;
+            results[i].queue_seconds = job.queue_seconds;
+            results[i].mesh_seconds = job.run_seconds;
+            if (results[i].status == MESHMIND_SUCCESS && options->command && !job.launched) {
+                results[i].status = MESHMIND_ERROR_MESHER;
+                detector->last_error = job.error;
+            }
+            bool ok = results[i].status == MESHMIND_SUCCESS && (!options->command || job.exit_code == 0);
+            failed += ok ? 0 : 1;
+        }
+        return count - failed;
+    } catch (const std::exception& e) {
         detector->last_error = e.what();
-        return MESHMIND_ERROR_EXPORT;
+        return MESHMIND_ERROR_DETECT;
     }
 }
 
@@ -238,5 +2261,9 @@ const char* meshmind_get_error(MeshMindDetector detector) {
     if (!detector) {
         return "Invalid detector handle";
     }
+    std::lock_guard<std::mutex> lock(detector->mutex);
+    if (detector->job == AsyncJob::RUNNING) {
+        return "Asynchronous detection in progress";
+    }
     return detector->last_error.c_str();
 }
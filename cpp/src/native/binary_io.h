@@ -0,0 +1,129 @@
+/**
+ * MeshMind-AFID Native Engine: Binary File Helpers
+ *
+ * Shared by the binary formats (detector snapshots, MeshCNN weights,
+ * template packs). Values are stored in host byte order, strings with a
+ * uint32 length prefix, and each payload is followed by its FNV-1a checksum.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace meshmind {
+
+inline uint64_t fnv1a(const char* data, size_t size) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+class BinaryWriter {
+public:
+    template <typename T>
+    void put(const T& value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void put_string(const std::string& value) {
+        put(static_cast<uint32_t>(value.size()));
+        buffer.append(value);
+    }
+
+    template <typename T>
+    void put_array(const std::vector<T>& values) {
+        put_array(values.data(), values.size());
+    }
+
+    template <typename T>
+    void put_array(const T* values, size_t count) {
+        buffer.append(reinterpret_cast<const char*>(values), count * sizeof(T));
+    }
+
+    std::string buffer;
+};
+
+/*
+ * Bounds-checked reads from a payload. get* report a short payload by
+ * returning false; read* throw std::runtime_error("<name> is truncated").
+ */
+class BinaryReader {
+public:
+    BinaryReader(const char* data, size_t size, const char* name = "Binary file")
+        : data(data), size(size), name(name) {}
+
+    template <typename T>
+    bool get(T& value) {
+        if (size - offset < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    bool get_string(std::string& value) {
+        uint32_t length = 0;
+        if (!get(length) || size - offset < length) {
+            return false;
+        }
+        value.assign(data + offset, length);
+        offset += length;
+        return true;
+    }
+
+    template <typename T>
+    bool get_array(std::vector<T>& values, size_t count) {
+        if ((size - offset) / sizeof(T) < count) {
+            return false;
+        }
+        values.resize(count);
+        std::memcpy(values.data(), data + offset, count * sizeof(T));
+        offset += count * sizeof(T);
+        return true;
+    }
+
+    template <typename T>
+    T read() {
+        T value;
+        check(get(value));
+        return value;
+    }
+
+    std::string read_string() {
+        std::string value;
+        check(get_string(value));
+        return value;
+    }
+
+    template <typename T>
+    std::vector<T> read_array(size_t count) {
+        std::vector<T> values;
+        check(get_array(values, count));
+        return values;
+    }
+
+    bool at_end() const { return offset == size; }
+
+private:
+    void check(bool ok) const {
+        if (!ok) {
+            throw std::runtime_error(std::string(name) + " is truncated");
+        }
+    }
+
+    const char* data;
+    size_t size;
+    const char* name;
+    size_t offset = 0;
+};
+
+}  // namespace meshmind
@@ -0,0 +1,212 @@
+/**
+ * MeshMind-AFID Native Engine: Triangle BVH
+ */
+
+#include "native/bvh.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace meshmind {
+
+namespace {
+
+inline double dot3(const double* a, const double* b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+double box_sq_distance(const BVHNode& node, const double* p) {
+    double d2 = 0.0;
+    for (int d = 0; d < 3; d++) {
+        double v = std::max({node.bounds_min[d] - p[d], 0.0, p[d] - node.bounds_max[d]});
+        d2 += v * v;
+    }
+    return d2;
+}
+
+}  // namespace
+
+double closest_point_on_triangle(const double* p, const double* a, const double* b, const double* c, double* out) {
+    // Voronoi-region walk (Ericson, Real-Time Collision Detection 5.1.5)
+    double ab[3], ac[3], ap[3];
+    for (int d = 0; d < 3; d++) {
+        ab[d] = b[d] - a[d];
+        ac[d] = c[d] - a[d];
+        ap[d] = p[d] - a[d];
+    }
+    double v = 0.0, w = 0.0;
+    double d1 = dot3(ab, ap), d2 = dot3(ac, ap);
+    if (d1 <= 0.0 && d2 <= 0.0) {
+        // Vertex a
+    } else {
+        double bp[3] = {p[0] - b[0], p[1] - b[1], p[2] - b[2]};
+        double d3 = dot3(ab, bp), d4 = dot3(ac, bp);
+        double cp[3] = {p[0] - c[0], p[1] - c[1], p[2] - c[2]};
+        double d5 = dot3(ab, cp), d6 = dot3(ac, cp);
+        double vc = d1 * d4 - d3 * d2;
+        double vb = d5 * d2 - d1 * d6;
+        double va = d3 * d6 - d5 * d4;
+        if (d3 >= 0.0 && d4 <= d3) {
+            v = 1.0;                                    // vertex b
+        } else if (d6 >= 0.0 && d5 <= d6) {
+            w = 1.0;                                    // vertex c
+        } else if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) {
+            v = d1 / (d1 - d3);                         // edge ab
+        } else if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) {
+            w = d2 / (d2 - d6);                         // edge ac
+        } else if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0) {
+            w = (d4 - d3) / ((d4 - d3) + (d5 - d6));    // edge bc
+            v = 1.0 - w;
+        } else {
+            double denom = va + vb + vc;                // interior
+            if (denom > 0.0) {
+                v = vb / denom;
+                w = vc / denom;
+            }
+        }
+    }
+    double d2sum = 0.0;
+    for (int d = 0; d < 3; d++) {
+        out[d] = a[d] + v * ab[d] + w * ac[d];
+        d2sum += (p[d] - out[d]) * (p[d] - out[d]);
+    }
+    return d2sum;
+}
+
+BVH::BVH(const TriangleMesh& mesh, size_t leaf_size) : mesh_(&mesh) {
+    size_t num_faces = mesh.num_faces();
+    if (num_faces == 0) {
+        return;
+    }
+    if (num_faces > size_t(INT32_MAX)) {
+        throw std::invalid_argument("Mesh has too many faces for the BVH");
+    }
+    std::vector<double> centroids(num_faces * 3);
+    triangles_.resize(num_faces);
+    for (size_t f = 0; f < num_faces; f++) {
+        triangles_[f] = int32_t(f);
+        for (int d = 0; d < 3; d++) {
+            centroids[3 * f + d] = (mesh.vertices[3 * mesh.faces[3 * f] + d] +
+                                    mesh.vertices[3 * mesh.faces[3 * f + 1] + d] +
+                                    mesh.vertices[3 * mesh.faces[3 * f + 2] + d]) / 3.0;
+        }
+    }
+    nodes_.reserve(2 * (num_faces / std::max<size_t>(leaf_size, 1)) + 1);
+    build(centroids, 0, uint32_t(num_faces), std::max<size_t>(leaf_size, 1));
+}
+
+int32_t BVH::build(std::vector<double>& centroids, uint32_t begin, uint32_t end, size_t leaf_size) {
+    int32_t index = int32_t(nodes_.size());
+    nodes_.emplace_back();
+
+    BVHNode node;
+    double centroid_min[3], centroid_max[3];
+    for (int d = 0; d < 3; d++) {
+        node.bounds_min[d] = centroid_min[d] = std::numeric_limits<double>::infinity();
+        node.bounds_max[d] = centroid_max[d] = -std::numeric_limits<double>::infinity();
+    }
+    for (uint32_t i = begin; i < end; i++) {
+        int32_t f = triangles_[i];
+        for (int corner = 0; corner < 3; corner++) {
+            const double* v = &mesh_->vertices[3 * size_t(mesh_->faces[3 * size_t(f) + corner])];
+            for (int d = 0; d < 3; d++) {
+                node.bounds_min[d] = std::min(node.bounds_min[d], v[d]);
+                node.bounds_max[d] = std::max(node.bounds_max[d], v[d]);
+            }
+        }
+        for (int d = 0; d < 3; d++) {
+            centroid_min[d] = std::min(centroid_min[d], centroids[3 * size_t(f) + d]);
+            centroid_max[d] = std::max(centroid_max[d], centroids[3 * size_t(f) + d]);
+        }
+    }
+
+    int axis = 0;
+    for (int d = 1; d < 3; d++) {
+        if (centroid_max[d] - centroid_min[d] > centroid_max[axis] - centroid_min[axis]) {
+            axis = d;
+        }
+    }
+
+    if (end - begin <= leaf_size || centroid_max[axis] <= centroid_min[axis]) {
+        node.offset = int32_t(begin);
+        node.count = int32_t(end - begin);
+        nodes_[index] = node;
+        return index;
+    }
+
+    // Median split on the widest centroid axis
+    uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(triangles_.begin() + begin, triangles_.begin() + mid, triangles_.begin() + end,
+                     [&](int32_t a, int32_t b) {
+                         return centroids[3 * size_t(a) + axis] < centroids[3 * size_t(b) + axis];
+                     });
+
+    build(centroids, begin, mid, leaf_size);
+    node.offset = build(centroids, mid, end, leaf_size);
+    node.count = 0;
+    nodes_[index] = node;
+    return index;
+}
+
+ClosestPoint BVH::closest_point(const double* query, double max_sq_distance) const {
+    ClosestPoint best;
+    best.sq_distance = max_sq_distance;
+    if (nodes_.empty()) {
+        return best;
+    }
+
+    struct Entry {
+        int32_t node;
+        double sq_distance;
+    };
+    Entry stack[64];
+    int top = 0;
+    stack[top++] = {0, box_sq_distance(nodes_[0], query)};
+
+    while (top > 0) {
+        Entry entry = stack[--top];
+        if (entry.sq_distance >= best.sq_distance) {
+            continue;
+        }
+        const BVHNode& node = nodes_[entry.node];
+        if (node.count > 0) {
+            for (int32_t i = node.offset; i < node.offset + node.count; i++) {
+                const int32_t* face = &mesh_->faces[3 * size_t(triangles_[i])];
+                double point[3];
+                double d2 = closest_point_on_triangle(query,
+                                                      &mesh_->vertices[3 * size_t(face[0])],
+                                                      &mesh_->vertices[3 * size_t(face[1])],
+                                                      &mesh_->vertices[3 * size_t(face[2])],
+                                                      point);
+                if (d2 < best.sq_distance) {
+                    best.sq_distance = d2;
+                    best.face = triangles_[i];
+                    std::copy(point, point + 3, best.point);
+                }
+            }
+            continue;
+        }
+
+        // Push the farther child first so the nearer one is visited next
+        int32_t left = entry.node + 1;
+        int32_t right = node.offset;
+        Entry near_entry{left, box_sq_distance(nodes_[left], query)};
+        Entry far_entry{right, box_sq_distance(nodes_[right], query)};
+        if (far_entry.sq_distance < near_entry.sq_distance) {
+            std::swap(near_entry, far_entry);
+        }
+        if (far_entry.sq_distance < best.sq_distance) {
+            stack[top++] = far_entry;
+        }
+        if (near_entry.sq_distance < best.sq_distance) {
+            stack[top++] = near_entry;
+        }
+    }
+
+    if (best.face < 0) {
+        best.sq_distance = std::numeric_limits<double>::infinity();
+    }
+    return best;
+}
+
+}  // namespace meshmind
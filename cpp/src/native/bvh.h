@@ -0,0 +1,71 @@
+/**
+ * MeshMind-AFID Native Engine: Triangle BVH
+ *
+ * Bounding volume hierarchy over the triangles of a mesh for exact
+ * closest-point-on-surface queries. Nodes are stored flattened in
+ * depth-first order (the left child of an inner node directly follows it),
+ * so the arrays can be handed to native plugins as they are.
+ */
+
+#pragma once
+
+#include "native/mesh.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace meshmind {
+
+struct BVHNode {
+    double bounds_min[3];
+    double bounds_max[3];
+    int32_t offset;   /* leaf: first entry in triangles(); inner: index of the right child */
+    int32_t count;    /* leaf: number of triangles; inner: 0 */
+};
+
+struct ClosestPoint {
+    double point[3];
+    double sq_distance = std::numeric_limits<double>::infinity();
+    int64_t face = -1;   /* -1 if nothing was found within the search radius */
+};
+
+class BVH {
+public:
+    BVH() = default;
+
+    /* Builds the hierarchy; the mesh must outlive the BVH */
+    explicit BVH(const TriangleMesh& mesh, size_t leaf_size = 4);
+
+    const std::vector<BVHNode>& nodes() const { return nodes_; }
+    const std::vector<int32_t>& triangles() const { return triangles_; }   /* face indices in leaf order */
+    const TriangleMesh* mesh() const { return mesh_; }
+
+    /**
+     * Closest point on the surface to query, considering only points with
+     * squared distance below max_sq_distance.
+     */
+    ClosestPoint closest_point(
+        const double* query,
+        double max_sq_distance = std::numeric_limits<double>::infinity()
+    ) const;
+
+private:
+    int32_t build(std::vector<double>& centroids, uint32_t begin, uint32_t end, size_t leaf_size);
+
+    const TriangleMesh* mesh_ = nullptr;
+    std::vector<BVHNode> nodes_;
+    std::vector<int32_t> triangles_;
+};
+
+/* Closest point to p on triangle (a, b, c); returns the squared distance */
+double closest_point_on_triangle(
+    const double* p,
+    const double* a,
+    const double* b,
+    const double* c,
+    double* out
+);
+
+}  // namespace meshmind
@@ -0,0 +1,134 @@
+/**
+ * MeshMind-AFID Native Engine: Preprocessed Training Shards
+ */
+
+#include "native/dataset.h"
+
+#include "native/mesh.h"
+#include "native/parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+namespace meshmind {
+
+namespace {
+
+const char SHARD_MAGIC[4] = {'M', 'M', 'D', 'S'};
+const uint32_t SHARD_VERSION = 1;
+
+/* Sample one mesh into points/normals [points_per_sample * 3]; returns an error message or "" */
+std::string preprocess_sample(const DatasetSample& sample, size_t points_per_sample, uint64_t seed,
+                              float* points, float* normals) {
+    try {
+        TriangleMesh mesh = load_mesh(sample.path);
+        PointSet samples = sample_surface(mesh, points_per_sample, seed);
+
+        double center[3] = {0.0, 0.0, 0.0};
+        const size_t n = mesh.num_vertices();
+        for (size_t i = 0; i < n; i++) {
+            for (int k = 0; k < 3; k++) {
+                center[k] += mesh.vertices[3 * i + k];
+            }
+        }
+        for (int k = 0; k < 3; k++) {
+            center[k] /= double(n);
+        }
+        double extent = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            for (int k = 0; k < 3; k++) {
+                extent = std::max(extent, std::abs(mesh.vertices[3 * i + k] - center[k]));
+            }
+        }
+        double scale = 1.0 / (extent + 1e-8);
+
+        for (size_t i = 0; i < points_per_sample; i++) {
+            for (int k = 0; k < 3; k++) {
+                points[3 * i + k] = float((samples.points[3 * i + k] - center[k]) * scale);
+                normals[3 * i + k] = float(samples.normals[3 * i + k]);
+            }
+        }
+        return {};
+    } catch (const std::exception& e) {
+        return sample.path + ": " + e.what();
+    }
+}
+
+}  // namespace
+
+ShardResult write_dataset_shards(
+    const std::vector<DatasetSample>& samples,
+    const std::string& prefix,
+    const ShardOptions& options
+) {
+    if (options.points_per_sample == 0 || options.samples_per_shard == 0) {
+        throw std::invalid_argument("points_per_sample and samples_per_shard must be positive");
+    }
+    const size_t stride = options.points_per_sample * 3;
+
+    ShardResult result;
+    std::vector<float> points, normals;
+    std::vector<int32_t> labels;
+    std::vector<std::string> errors;
+
+    // One shard in memory at a time; the meshes of a shard are processed in parallel
+    for (size_t first = 0; first < samples.size(); first += options.samples_per_shard) {
+        size_t count = std::min(options.samples_per_shard, samples.size() - first);
+        points.assign(count * stride, 0.0f);
+        normals.assign(count * stride, 0.0f);
+        errors.assign(count, std::string());
+
+        parallel_for(count, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                errors[i] = preprocess_sample(samples[first + i], options.points_per_sample,
+                                              options.seed + first + i,
+                                              &points[i * stride], &normals[i * stride]);
+            }
+        }, 1);
+
+        // Drop failed samples, keeping the order of the rest
+        labels.clear();
+        size_t kept = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (!errors[i].empty()) {
+                result.skipped.push_back(errors[i]);
+                continue;
+            }
+            if (kept != i) {
+                std::copy_n(&points[i * stride], stride, &points[kept * stride]);
+                std::copy_n(&normals[i * stride], stride, &normals[kept * stride]);
+            }
+            labels.push_back(samples[first + i].label);
+            kept++;
+        }
+        if (kept == 0) {
+            continue;
+        }
+
+        char suffix[16];
+        std::snprintf(suffix, sizeof(suffix), "-%05zu.mmds", result.shards.size());
+        std::string path = prefix + suffix;
+        std::ofstream out(path, std::ios::binary);
+        if (!out) {
+            throw std::runtime_error("Cannot write dataset shard: " + path);
+        }
+        uint32_t header[3] = {SHARD_VERSION, uint32_t(kept), uint32_t(options.points_per_sample)};
+        out.write(SHARD_MAGIC, sizeof(SHARD_MAGIC));
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(points.data()), kept * stride * sizeof(float));
+        out.write(reinterpret_cast<const char*>(normals.data()), kept * stride * sizeof(float));
+        out.write(reinterpret_cast<const char*>(labels.data()), kept * sizeof(int32_t));
+        if (!out) {
+            throw std::runtime_error("Failed writing dataset shard: " + path);
+        }
+
+        result.shards.push_back(path);
+        result.counts.push_back(kept);
+    }
+    return result;
+}
+
+}  // namespace meshmind
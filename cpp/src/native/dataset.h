@@ -0,0 +1,59 @@
+/**
+ * MeshMind-AFID Native Engine: Preprocessed Training Shards
+ *
+ * Converts a mesh dataset (e.g. ModelNet OFF files) into fixed-size samples
+ * once, so MeshCNN training reads memory-mapped arrays instead of parsing
+ * and re-sampling meshes every epoch. Each mesh is sampled to a fixed number
+ * of surface points with normals and normalised the way
+ * scripts/train_meshcnn.py normalises vertices (centred on the vertex mean,
+ * scaled by the largest absolute coordinate).
+ *
+ * Shard file (little-endian, read by meshmind.datasets.shards):
+ *   char[4]  magic "MMDS"
+ *   uint32   format version
+ *   uint32   sample count
+ *   uint32   points per sample
+ *   float32  points[count][points_per_sample][3]
+ *   float32  normals[count][points_per_sample][3]
+ *   int32    labels[count]
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace meshmind {
+
+struct DatasetSample {
+    std::string path;
+    int32_t label = 0;
+};
+
+struct ShardOptions {
+    size_t points_per_sample = 1024;
+    size_t samples_per_shard = 1024;
+    uint64_t seed = 0;               /* sample i uses seed + i, independent of threading */
+};
+
+struct ShardResult {
+    std::vector<std::string> shards;    /* written files, in order */
+    std::vector<size_t> counts;         /* samples per shard */
+    std::vector<std::string> skipped;   /* "path: error" for meshes that could not be used */
+};
+
+/**
+ * Load, sample and normalise all meshes in parallel and write them to
+ * <prefix>-00000.mmds, <prefix>-00001.mmds, ... Unreadable or degenerate
+ * meshes are skipped and reported rather than aborting the run.
+ * @throws std::runtime_error if a shard cannot be written
+ */
+ShardResult write_dataset_shards(
+    const std::vector<DatasetSample>& samples,
+    const std::string& prefix,
+    const ShardOptions& options
+);
+
+}  // namespace meshmind
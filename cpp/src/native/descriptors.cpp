@@ -0,0 +1,204 @@
+/**
+ * MeshMind-AFID Native Engine: Local Shape Descriptors
+ */
+
+#include "native/descriptors.h"
+
+#include "native/kdtree.h"
+#include "native/linalg.h"
+#include "native/parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace meshmind {
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+/*
+ * Darboux-frame pair features (f1 angle, f2, f3) between two oriented points.
+ * @return false for coincident points or degenerate frames
+ */
+bool pair_features(const double* p1, const double* n1, const double* p2, const double* n2,
+                   double& f1, double& f2, double& f3) {
+    double dp[3] = {p2[0] - p1[0], p2[1] - p1[1], p2[2] - p1[2]};
+    double dist = std::sqrt(dp[0] * dp[0] + dp[1] * dp[1] + dp[2] * dp[2]);
+    if (dist == 0.0) {
+        return false;
+    }
+
+    const double* u_src = n1;
+    const double* n_dst = n2;
+    double angle1 = (n1[0] * dp[0] + n1[1] * dp[1] + n1[2] * dp[2]) / dist;
+    double angle2 = (n2[0] * dp[0] + n2[1] * dp[1] + n2[2] * dp[2]) / dist;
+    if (std::acos(std::fabs(angle1)) > std::acos(std::fabs(angle2))) {
+        u_src = n2;
+        n_dst = n1;
+        dp[0] = -dp[0];
+        dp[1] = -dp[1];
+        dp[2] = -dp[2];
+        f3 = -angle2;
+    } else {
+        f3 = angle1;
+    }
+
+    double v[3] = {dp[1] * u_src[2] - dp[2] * u_src[1],
+                   dp[2] * u_src[0] - dp[0] * u_src[2],
+                   dp[0] * u_src[1] - dp[1] * u_src[0]};
+    double v_norm = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    if (v_norm == 0.0) {
+        return false;
+    }
+    v[0] /= v_norm;
+    v[1] /= v_norm;
+    v[2] /= v_norm;
+
+    double w[3] = {u_src[1] * v[2] - u_src[2] * v[1],
+                   u_src[2] * v[0] - u_src[0] * v[2],
+                   u_src[0] * v[1] - u_src[1] * v[0]};
+
+    f2 = v[0] * n_dst[0] + v[1] * n_dst[1] + v[2] * n_dst[2];
+    f1 = std::atan2(w[0] * n_dst[0] + w[1] * n_dst[1] + w[2] * n_dst[2],
+                    u_src[0] * n_dst[0] + u_src[1] * n_dst[1] + u_src[2] * n_dst[2]);
+    return true;
+}
+
+inline size_t histogram_bin(double normalised) {
+    long bin = static_cast<long>(std::floor(FPFH_BINS * normalised));
+    return static_cast<size_t>(std::clamp<long>(bin, 0, FPFH_BINS - 1));
+}
+
+}  // namespace
+
+std::vector<double> estimate_normals(
+    const double* points,
+    size_t count,
+    double radius,
+    size_t max_nn
+) {
+    KDTree tree(points, count, 3);
+    std::vector<double> normals(count * 3, 0.0);
+
+    parallel_for(count, [&](size_t begin, size_t end) {
+        std::vector<size_t> indices(max_nn);
+        std::vector<double> sq_distances(max_nn);
+        for (size_t i = begin; i < end; i++) {
+            size_t found = tree.knn(points + 3 * i, max_nn, indices.data(), sq_distances.data(),
+                                    radius * radius);
+            double* normal = &normals[3 * i];
+            if (found < 3) {
+                normal[2] = 1.0;
+                continue;
+            }
+
+            double mean[3] = {0, 0, 0};
+            for (size_t k = 0; k < found; k++) {
+                for (int d = 0; d < 3; d++) {
+                    mean[d] += points[3 * indices[k] + d];
+                }
+            }
+            for (int d = 0; d < 3; d++) {
+                mean[d] /= double(found);
+            }
+
+            double cov[3][3] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+            for (size_t k = 0; k < found; k++) {
+                const double* p = points + 3 * indices[k];
+                double dx[3] = {p[0] - mean[0], p[1] - mean[1], p[2] - mean[2]};
+                for (int r = 0; r < 3; r++) {
+                    for (int c = 0; c < 3; c++) {
+                        cov[r][c] += dx[r] * dx[c];
+                    }
+                }
+            }
+
+            double eigenvalues[3];
+            double eigenvectors[3][3];
+            symmetric_eigen<3>(cov, eigenvalues, eigenvectors);
+            for (int d = 0; d < 3; d++) {
+                normal[d] = eigenvectors[d][0];  // smallest eigenvalue
+            }
+        }
+    }, 64);
+
+    return normals;
+}
+
+std::vector<double> compute_fpfh(const PointsView& points, double radius, size_t max_nn) {
+    if (!points.normals) {
+        throw std::invalid_argument("compute_fpfh requires normals");
+    }
+    const size_t count = points.size;
+    KDTree tree(points.points, count, 3);
+
+    // Neighbourhoods are used twice (SPFH, then FPFH weighting), so keep them
+    std::vector<uint32_t> neighbours(count * max_nn);
+    std::vector<double> neighbour_d2(count * max_nn);
+    std::vector<uint32_t> neighbour_count(count);
+    std::vector<double> spfh(count * FPFH_DIMS, 0.0);
+
+    parallel_for(count, [&](size_t begin, size_t end) {
+        std::vector<size_t> indices(max_nn);
+        for (size_t i = begin; i < end; i++) {
+            size_t found = tree.knn(points.points + 3 * i, max_nn, indices.data(),
+                                    &neighbour_d2[i * max_nn], radius * radius);
+            neighbour_count[i] = static_cast<uint32_t>(found);
+            for (size_t k = 0; k < found; k++) {
+                neighbours[i * max_nn + k] = static_cast<uint32_t>(indices[k]);
+            }
+            if (found <= 1) {
+                continue;
+            }
+
+            double* hist = &spfh[i * FPFH_DIMS];
+            double increment = 100.0 / double(found - 1);
+            const double* p1 = points.points + 3 * i;
+            const double* n1 = points.normals + 3 * i;
+            for (size_t k = 0; k < found; k++) {
+                size_t j = indices[k];
+                if (j == i) {
+                    continue;
+                }
+                double f1, f2, f3;
+                if (!pair_features(p1, n1, points.points + 3 * j, points.normals + 3 * j, f1, f2, f3)) {
+                    continue;
+                }
+                hist[histogram_bin((f1 + PI) / (2.0 * PI))] += increment;
+                hist[FPFH_BINS + histogram_bin((f2 + 1.0) * 0.5)] += increment;
+                hist[2 * FPFH_BINS + histogram_bin((f3 + 1.0) * 0.5)] += increment;
+            }
+        }
+    }, 64);
+
+    std::vector<double> fpfh(count * FPFH_DIMS, 0.0);
+    parallel_for(count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            double* out = &fpfh[i * FPFH_DIMS];
+            double sums[3] = {0, 0, 0};
+            for (size_t k = 0; k < neighbour_count[i]; k++) {
+                size_t j = neighbours[i * max_nn + k];
+                double d2 = neighbour_d2[i * max_nn + k];
+                if (j == i || d2 == 0.0) {
+                    continue;
+                }
+                const double* hist = &spfh[j * FPFH_DIMS];
+                for (size_t b = 0; b < FPFH_DIMS; b++) {
+                    double value = hist[b] / d2;
+                    sums[b / FPFH_BINS] += value;
+                    out[b] += value;
+                }
+            }
+            for (size_t b = 0; b < FPFH_DIMS; b++) {
+                double sum = sums[b / FPFH_BINS];
+                out[b] = (sum != 0.0 ? out[b] * 100.0 / sum : 0.0) + spfh[i * FPFH_DIMS + b];
+            }
+        }
+    }, 64);
+
+    return fpfh;
+}
+
+}  // namespace meshmind
@@ -0,0 +1,41 @@
+/**
+ * MeshMind-AFID Native Engine: Local Shape Descriptors
+ *
+ * Normal estimation and Fast Point Feature Histograms (Rusu et al. 2009),
+ * following the Open3D formulation used by meshmind.core.descriptors.
+ */
+
+#pragma once
+
+#include "native/mesh.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace meshmind {
+
+/* Bins per FPFH angle feature and total descriptor length */
+constexpr size_t FPFH_BINS = 11;
+constexpr size_t FPFH_DIMS = 3 * FPFH_BINS;
+
+/**
+ * PCA normals from up to max_nn neighbours within radius.
+ * Normals are unit length with arbitrary sign; points with fewer than three
+ * neighbours get (0, 0, 1).
+ * @return [count * 3] normals
+ */
+std::vector<double> estimate_normals(
+    const double* points,
+    size_t count,
+    double radius,
+    size_t max_nn = 30
+);
+
+/**
+ * FPFH descriptors from up to max_nn neighbours within radius.
+ * @param points Points with normals (points.normals must be set)
+ * @return [points.size * FPFH_DIMS] descriptors, row-major
+ */
+std::vector<double> compute_fpfh(const PointsView& points, double radius, size_t max_nn = 100);
+
+}  // namespace meshmind
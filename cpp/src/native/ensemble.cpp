@@ -0,0 +1,248 @@
+/**
+ * MeshMind-AFID Native Engine: Ensemble Pose Fusion
+ */
+
+#include "native/ensemble.h"
+
+#include "native/linalg.h"
+#include "native/parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+
+namespace meshmind {
+
+namespace {
+
+/* A pose split into translation, unit quaternion (w, x, y, z) and uniform scale */
+struct PoseParams {
+    double t[3];
+    double q[4];
+    double scale;
+};
+
+/* Top eigenvector of a symmetric 4x4 matrix */
+void top_eigenvector(double (&m)[4][4], double (&q)[4]) {
+    double eigenvalues[4];
+    double eigenvectors[4][4];
+    symmetric_eigen<4>(m, eigenvalues, eigenvectors);
+    for (int i = 0; i < 4; i++) {
+        q[i] = eigenvectors[i][3];
+    }
+}
+
+PoseParams decompose(const double* transform) {
+    PoseParams pose;
+    double M[3][3];
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            M[r][c] = transform[4 * r + c];
+        }
+        pose.t[r] = transform[4 * r + 3];
+    }
+    double det = M[0][0] * (M[1][1] * M[2][2] - M[1][2] * M[2][1]) -
+                 M[0][1] * (M[1][0] * M[2][2] - M[1][2] * M[2][0]) +
+                 M[0][2] * (M[1][0] * M[2][1] - M[1][1] * M[2][0]);
+    pose.scale = det > 0.0 ? std::cbrt(det) : 1.0;
+
+    // Nearest rotation as in procrustes(): Horn's matrix for S = R^T
+    double S[3][3];
+    for (int a = 0; a < 3; a++) {
+        for (int b = 0; b < 3; b++) {
+            S[a][b] = M[b][a] / pose.scale;
+        }
+    }
+    double N[4][4] = {
+        {S[0][0] + S[1][1] + S[2][2], S[1][2] - S[2][1], S[2][0] - S[0][2], S[0][1] - S[1][0]},
+        {S[1][2] - S[2][1], S[0][0] - S[1][1] - S[2][2], S[0][1] + S[1][0], S[2][0] + S[0][2]},
+        {S[2][0] - S[0][2], S[0][1] + S[1][0], -S[0][0] + S[1][1] - S[2][2], S[1][2] + S[2][1]},
+        {S[0][1] - S[1][0], S[2][0] + S[0][2], S[1][2] + S[2][1], -S[0][0] - S[1][1] + S[2][2]},
+    };
+    top_eigenvector(N, pose.q);
+    return pose;
+}
+
+void compose(const PoseParams& pose, double* transform) {
+    const double qw = pose.q[0], qx = pose.q[1], qy = pose.q[2], qz = pose.q[3];
+    const double R[3][3] = {
+        {qw * qw + qx * qx - qy * qy - qz * qz, 2 * (qx * qy - qw * qz), 2 * (qx * qz + qw * qy)},
+        {2 * (qx * qy + qw * qz), qw * qw - qx * qx + qy * qy - qz * qz, 2 * (qy * qz - qw * qx)},
+        {2 * (qx * qz - qw * qy), 2 * (qy * qz + qw * qx), qw * qw - qx * qx - qy * qy + qz * qz},
+    };
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            transform[4 * r + c] = pose.scale * R[r][c];
+        }
+        transform[4 * r + 3] = pose.t[r];
+    }
+    transform[12] = transform[13] = transform[14] = 0.0;
+    transform[15] = 1.0;
+}
+
+double rotation_angle(const double* a, const double* b) {
+    double dot = std::fabs(a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]);
+    return 2.0 * std::acos(std::min(1.0, dot));
+}
+
+/* Squared kernel distance in bandwidth units */
+double pose_distance2(const PoseParams& a, const PoseParams& b, double inv_t2, double inv_r2) {
+    double dx = a.t[0] - b.t[0], dy = a.t[1] - b.t[1], dz = a.t[2] - b.t[2];
+    double angle = rotation_angle(a.q, b.q);
+    return (dx * dx + dy * dy + dz * dz) * inv_t2 + angle * angle * inv_r2;
+}
+
+/* Kernel truncated at 3 bandwidths; modes closer than half a bandwidth are merged */
+constexpr double KERNEL_CUTOFF2 = 9.0;
+constexpr double MERGE_RADIUS2 = 0.25;
+constexpr double CONVERGED2 = 1e-10;
+
+}  // namespace
+
+std::vector<FusedPose> fuse_poses(
+    const std::vector<PoseHypothesis>& hypotheses,
+    const FusionOptions& options,
+    std::vector<size_t>* assignment
+) {
+    if (options.translation_bandwidth <= 0.0 || options.rotation_bandwidth <= 0.0) {
+        throw std::invalid_argument("Fusion bandwidths must be positive");
+    }
+    const double inv_t2 = 1.0 / (options.translation_bandwidth * options.translation_bandwidth);
+    const double inv_r2 = 1.0 / (options.rotation_bandwidth * options.rotation_bandwidth);
+    const size_t n = hypotheses.size();
+
+    auto source_weight = [&](int32_t source) {
+        if (source < 0 || size_t(source) >= options.source_weights.size()) {
+            return 1.0;
+        }
+        return std::clamp(options.source_weights[source], 0.0, 1.0);
+    };
+
+    std::vector<PoseParams> poses(n);
+    std::vector<double> mass(n);
+    std::map<int32_t, std::vector<size_t>> groups;
+    for (size_t i = 0; i < n; i++) {
+        const PoseHypothesis& h = hypotheses[i];
+        poses[i] = decompose(h.transform);
+        // Kernel mass; a tiny floor keeps zero-confidence hypotheses well defined
+        mass[i] = std::max(source_weight(h.source) * std::clamp(h.confidence, 0.0, 1.0), 1e-9);
+        groups[h.group].push_back(i);
+    }
+    std::vector<const std::vector<size_t>*> group_of(n);
+    for (const auto& entry : groups) {
+        for (size_t i : entry.second) {
+            group_of[i] = &entry.second;
+        }
+    }
+
+    // Mean-shift from every hypothesis towards its density mode
+    std::vector<PoseParams> modes(poses);
+    parallel_for(n, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            PoseParams x = poses[i];
+            for (int iteration = 0; iteration < options.max_iterations; iteration++) {
+                double total = 0.0;
+                double t[3] = {0.0, 0.0, 0.0};
+                double scale = 0.0;
+                double A[4][4] = {};
+                for (size_t j : *group_of[i]) {
+                    double d2 = pose_distance2(x, poses[j], inv_t2, inv_r2);
+                    if (d2 > KERNEL_CUTOFF2) {
+                        continue;
+                    }
+                    double k = mass[j] * std::exp(-0.5 * d2);
+                    total += k;
+                    scale += k * poses[j].scale;
+                    for (int d = 0; d < 3; d++) {
+                        t[d] += k * poses[j].t[d];
+                    }
+                    for (int a = 0; a < 4; a++) {
+                        for (int b = 0; b < 4; b++) {
+                            A[a][b] += k * poses[j].q[a] * poses[j].q[b];
+                        }
+                    }
+                }
+
+                PoseParams next;
+                for (int d = 0; d < 3; d++) {
+                    next.t[d] = t[d] / total;
+                }
+                next.scale = scale / total;
+                // Weighted quaternion mean (Markley et al. 2007), sign-invariant
+                top_eigenvector(A, next.q);
+
+                double shift2 = pose_distance2(x, next, inv_t2, inv_r2);
+                x = next;
+                if (shift2 < CONVERGED2) {
+                    break;
+                }
+            }
+            modes[i] = x;
+        }
+    }, 32);
+
+    // Merge converged modes, seeding clusters from the heaviest hypotheses
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return mass[a] > mass[b]; });
+
+    std::vector<size_t> cluster_of(n);
+    std::vector<size_t> representatives;
+    for (size_t i : order) {
+        size_t cluster = representatives.size();
+        for (size_t c = 0; c < representatives.size(); c++) {
+            size_t r = representatives[c];
+            if (hypotheses[r].group == hypotheses[i].group &&
+                pose_distance2(modes[r], modes[i], inv_t2, inv_r2) < MERGE_RADIUS2) {
+                cluster = c;
+                break;
+            }
+        }
+        if (cluster == representatives.size()) {
+            representatives.push_back(i);
+        }
+        cluster_of[i] = cluster;
+    }
+
+    // Weighted noisy-OR over each detector's best member confidence
+    std::vector<FusedPose> fused(representatives.size());
+    std::vector<std::map<int32_t, double>> best(representatives.size());
+    for (size_t i = 0; i < n; i++) {
+        double& value = best[cluster_of[i]][hypotheses[i].source];
+        value = std::max(value, std::clamp(hypotheses[i].confidence, 0.0, 1.0));
+        fused[cluster_of[i]].support++;
+    }
+    for (size_t c = 0; c < fused.size(); c++) {
+        size_t r = representatives[c];
+        compose(modes[r], fused[c].transform);
+        fused[c].group = hypotheses[r].group;
+        fused[c].representative = r;
+        double miss = 1.0;
+        for (const auto& entry : best[c]) {
+            miss *= 1.0 - source_weight(entry.first) * entry.second;
+        }
+        fused[c].confidence = 1.0 - miss;
+    }
+
+    std::vector<size_t> ranking(fused.size());
+    std::iota(ranking.begin(), ranking.end(), size_t(0));
+    std::stable_sort(ranking.begin(), ranking.end(),
+                     [&](size_t a, size_t b) { return fused[a].confidence > fused[b].confidence; });
+    std::vector<FusedPose> result;
+    std::vector<size_t> rank_of(fused.size());
+    for (size_t k = 0; k < ranking.size(); k++) {
+        rank_of[ranking[k]] = k;
+        result.push_back(fused[ranking[k]]);
+    }
+    if (assignment) {
+        assignment->resize(n);
+        for (size_t i = 0; i < n; i++) {
+            (*assignment)[i] = rank_of[cluster_of[i]];
+        }
+    }
+    return result;
+}
+
+}  // namespace meshmind
@@ -0,0 +1,55 @@
+/**
+ * MeshMind-AFID Native Engine: Ensemble Pose Fusion
+ *
+ * Fuses detections from several detectors (FPFH, MeshCNN, plugins) that
+ * describe the same template. Hypotheses of one group are clustered by
+ * mean-shift in SE(3) (Gaussian kernel on translation distance and rotation
+ * angle, quaternion averaging for the rotational mean); each cluster
+ * becomes one result whose confidence combines the detectors' best scores
+ * as a weighted noisy-OR, so agreement between detectors raises confidence
+ * while duplicates from one detector do not.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace meshmind {
+
+struct PoseHypothesis {
+    double transform[16];   /* 4x4 row-major, may include a uniform scale */
+    double confidence;      /* in [0, 1] */
+    int32_t group;          /* only hypotheses of the same group (template) are fused */
+    int32_t source;         /* index of the detector that produced it */
+};
+
+struct FusionOptions {
+    double translation_bandwidth = 0.05;   /* kernel width in model units */
+    double rotation_bandwidth = 0.35;      /* kernel width in radians (~20 degrees) */
+    int max_iterations = 30;
+    std::vector<double> source_weights;    /* per detector in [0, 1]; missing entries count as 1 */
+};
+
+struct FusedPose {
+    double transform[16];
+    double confidence;
+    int32_t group;
+    size_t representative;   /* highest weighted-confidence member */
+    size_t support;          /* number of fused hypotheses */
+};
+
+/**
+ * Cluster and fuse hypotheses.
+ * @param assignment Optional output: cluster index per hypothesis
+ * @return Fused poses ordered by descending confidence
+ * @throws std::invalid_argument for non-positive bandwidths
+ */
+std::vector<FusedPose> fuse_poses(
+    const std::vector<PoseHypothesis>& hypotheses,
+    const FusionOptions& options,
+    std::vector<size_t>* assignment = nullptr
+);
+
+}  // namespace meshmind
@@ -0,0 +1,150 @@
+/**
+ * MeshMind-AFID Native Engine: Mesher Input Writers
+ */
+
+#include "native/exporters.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+
+namespace meshmind {
+
+namespace {
+
+const char* SNAPPY_HEADER =
+    "/*--------------------------------*- C++ -*----------------------------------*\\\n"
+    "| =========                 |                                                 |\n"
+    "| \\\\      /  F ield         | OpenFOAM: The Open Source CFD Toolbox           |\n"
+    "|  \\\\    /   O peration     | Version:  v2312                                 |\n"
+    "|   \\\\  /    A nd           | Website:  www.openfoam.com                      |\n"
+    "|    \\\\/     M anipulation  |                                                 |\n"
+    "\\*---------------------------------------------------------------------------*/\n"
+    "FoamFile\n"
+    "{\n"
+    "    version     2.0;\n"
+    "    format      ascii;\n"
+    "    class       dictionary;\n"
+    "    object      snappyHexMeshDict;\n"
+    "}\n"
+    "\n"
+    "castellatedMesh true;\n"
+    "snap            true;\n"
+    "addLayers       false;\n"
+    "\n"
+    "geometry\n"
+    "{\n"
+    "}\n"
+    "\n"
+    "castellatedMeshControls\n"
+    "{\n"
+    "    maxLocalCells 1000000;\n"
+    "    maxGlobalCells 2000000;\n"
+    "    minRefinementCells 10;\n"
+    "    nCellsBetweenLevels 3;\n"
+    "\n"
+    "    resolveFeatureAngle 30;\n"
+    "\n";
+
+const char* SNAPPY_FOOTER =
+    "\n"
+    "    locationInMesh (0 0 0);\n"
+    "}\n";
+
+std::ofstream open_output(const std::string& path) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot open for writing: " + path);
+    }
+    return out;
+}
+
+}  // namespace
+
+std::string format_python_float(double value) {
+    if (std::isnan(value)) {
+        return "nan";
+    }
+    if (std::isinf(value)) {
+        return value > 0 ? "inf" : "-inf";
+    }
+
+    // Shortest round-trip digits, then Python's repr layout rule:
+    // positional for 1e-4 <= |x| < 1e16, scientific otherwise
+    char buffer[64];
+    auto sci = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::scientific);
+    std::string text(buffer, sci.ptr);
+    int exponent = std::atoi(text.c_str() + text.find('e') + 1);
+    if (value == 0.0 || (exponent >= -4 && exponent < 16)) {
+        auto fixed = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed);
+        text.assign(buffer, fixed.ptr);
+        if (text.find('.') == std::string::npos) {
+            text += ".0";
+        }
+    }
+    return text;
+}
+
+void write_snappy_dict(const std::string& path, const std::vector<RefinementRegion>& regions) {
+    std::string body = "refinementRegions\n{\n";
+    for (const RefinementRegion& reg : regions) {
+        // Same approximation as generate_snappy_dict: translate the local bounds
+        double global_min[3];
+        double global_max[3];
+        for (int d = 0; d < 3; d++) {
+            global_min[d] = reg.transform[d * 4 + 3] + reg.bounds[d];
+            global_max[d] = reg.transform[d * 4 + 3] + reg.bounds[d + 3];
+        }
+
+        body += "    " + reg.name + "\n";
+        body += "    {\n";
+        body += "        mode    " + reg.mode + ";\n";
+        body += "        levels  ((" + format_python_float(reg.level_size) + " " +
+                std::to_string(reg.level) + "));\n";
+        body += "        min     (" + format_python_float(global_min[0]) + " " +
+                format_python_float(global_min[1]) + " " + format_python_float(global_min[2]) + ");\n";
+        body += "        max     (" + format_python_float(global_max[0]) + " " +
+                format_python_float(global_max[1]) + " " + format_python_float(global_max[2]) + ");\n";
+        body += "    }\n";
+    }
+    body += "}\n";
+
+    std::ofstream out = open_output(path);
+    out << SNAPPY_HEADER << body << SNAPPY_FOOTER;
+    if (!out) {
+        throw std::runtime_error("Failed writing: " + path);
+    }
+}
+
+void write_ftetwild_sizing(const std::string& path, const std::vector<SizingSphere>& spheres) {
+    // Layout of json.dump(sizing_field, f, indent=2)
+    std::string text;
+    if (spheres.empty()) {
+        text = "[]";
+    } else {
+        text = "[\n";
+        for (size_t i = 0; i < spheres.size(); i++) {
+            const SizingSphere& s = spheres[i];
+            text += "  {\n";
+            text += "    \"center\": [\n";
+            for (int d = 0; d < 3; d++) {
+                text += "      " + format_python_float(s.center[d]) + (d < 2 ? ",\n" : "\n");
+            }
+            text += "    ],\n";
+            text += "    \"radius\": " + format_python_float(s.radius) + ",\n";
+            text += "    \"size\": " + format_python_float(s.size) + "\n";
+            text += (i + 1 < spheres.size()) ? "  },\n" : "  }\n";
+        }
+        text += "]";
+    }
+
+    std::ofstream out = open_output(path);
+    out << text;
+    if (!out) {
+        throw std::runtime_error("Failed writing: " + path);
+    }
+}
+
+}  // namespace meshmind
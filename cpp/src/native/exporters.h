@@ -0,0 +1,39 @@
+/**
+ * MeshMind-AFID Native Engine: Mesher Input Writers
+ *
+ * Byte-compatible counterparts of meshmind.cfd.snappy_interface.write_complete_dict
+ * and FTetWildGenerator.export_config.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace meshmind {
+
+struct RefinementRegion {
+    std::string name;
+    std::string mode = "inside";
+    double level_size = 0.01;   /* levels[0] */
+    int level = 3;              /* levels[1] */
+    double transform[16];       /* 4x4 row-major placement */
+    double bounds[6];           /* local [min_x, min_y, min_z, max_x, max_y, max_z] */
+};
+
+struct SizingSphere {
+    double center[3];
+    double radius;
+    double size;                /* target edge length */
+};
+
+/* Format a double the way Python's repr() does ("0.1", "1.0", "1e-05") */
+std::string format_python_float(double value);
+
+/* Write a snappyHexMeshDict with the given refinementRegions */
+void write_snappy_dict(const std::string& path, const std::vector<RefinementRegion>& regions);
+
+/* Write an fTetWild .sizing.json array of sizing spheres */
+void write_ftetwild_sizing(const std::string& path, const std::vector<SizingSphere>& spheres);
+
+}  // namespace meshmind
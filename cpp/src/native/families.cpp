@@ -0,0 +1,140 @@
+/**
+ * MeshMind-AFID Native Engine: Template Families
+ */
+
+#include "native/families.h"
+#include "native/descriptors.h"
+#include "native/parallel.h"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace meshmind {
+
+namespace {
+
+/* Surface area and area-weighted centroid of a mesh */
+double surface_centroid(const TriangleMesh& mesh, double centroid[3]) {
+    double area = 0.0;
+    centroid[0] = centroid[1] = centroid[2] = 0.0;
+    for (size_t f = 0; f < mesh.num_faces(); f++) {
+        const double* a = &mesh.vertices[3 * size_t(mesh.faces[3 * f])];
+        const double* b = &mesh.vertices[3 * size_t(mesh.faces[3 * f + 1])];
+        const double* c = &mesh.vertices[3 * size_t(mesh.faces[3 * f + 2])];
+        double u[3], v[3];
+        for (int d = 0; d < 3; d++) {
+            u[d] = b[d] - a[d];
+            v[d] = c[d] - a[d];
+        }
+        double nx = u[1] * v[2] - u[2] * v[1], ny = u[2] * v[0] - u[0] * v[2], nz = u[0] * v[1] - u[1] * v[0];
+        double face_area = 0.5 * std::sqrt(nx * nx + ny * ny + nz * nz);
+        for (int d = 0; d < 3; d++) {
+            centroid[d] += face_area * (a[d] + b[d] + c[d]) / 3.0;
+        }
+        area += face_area;
+    }
+    if (area > 0.0) {
+        for (int d = 0; d < 3; d++) {
+            centroid[d] /= area;
+        }
+    }
+    return area;
+}
+
+}  // namespace
+
+std::vector<double> descriptor_signature(const double* features, size_t count) {
+    std::vector<double> signature(FPFH_DIMS, 0.0);
+    for (size_t i = 0; i < count; i++) {
+        for (size_t b = 0; b < FPFH_DIMS; b++) {
+            signature[b] += features[i * FPFH_DIMS + b];
+        }
+    }
+    double sum = 0.0;
+    for (double value : signature) {
+        sum += value;
+    }
+    if (sum > 0.0) {
+        for (double& value : signature) {
+            value /= sum;
+        }
+    }
+    return signature;
+}
+
+double signature_distance(const std::vector<double>& a, const std::vector<double>& b) {
+    double distance = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        distance += std::fabs(a[i] - b[i]);
+    }
+    return 0.5 * distance;
+}
+
+TemplateFamilies cluster_templates(
+    const std::vector<std::vector<double>>& signatures,
+    const std::vector<int>& groups,
+    double max_distance
+) {
+    if (signatures.size() != groups.size()) {
+        throw std::invalid_argument("cluster_templates needs one group per signature");
+    }
+
+    TemplateFamilies result;
+    result.family.resize(signatures.size());
+    std::vector<size_t> leaders;
+    std::vector<std::vector<size_t>> members;
+    for (size_t i = 0; i < signatures.size(); i++) {
+        size_t family = leaders.size();
+        for (size_t f = 0; f < leaders.size(); f++) {
+            if (groups[leaders[f]] == groups[i] && signature_distance(signatures[leaders[f]], signatures[i]) <= max_distance) {
+                family = f;
+                break;
+            }
+        }
+        if (family == leaders.size()) {
+            leaders.push_back(i);
+            members.emplace_back();
+        }
+        members[family].push_back(i);
+        result.family[i] = uint32_t(family);
+    }
+
+    // Medoids, a family per work item: large families are the costly ones
+    result.representatives.resize(leaders.size());
+    parallel_for(leaders.size(), [&](size_t begin, size_t end) {
+        for (size_t f = begin; f < end; f++) {
+            const std::vector<size_t>& family = members[f];
+            double best = std::numeric_limits<double>::max();
+            for (size_t a : family) {
+                double total = 0.0;
+                for (size_t b : family) {
+                    total += signature_distance(signatures[a], signatures[b]);
+                }
+                if (total < best) {
+                    best = total;
+                    result.representatives[f] = uint32_t(a);
+                }
+            }
+        }
+    }, 1);
+    return result;
+}
+
+void member_alignment(const TriangleMesh& member, const TriangleMesh& representative, double transform[16]) {
+    double member_centroid[3], representative_centroid[3];
+    double member_area = surface_centroid(member, member_centroid);
+    double representative_area = surface_centroid(representative, representative_centroid);
+    double scale = member_area > 0.0 && representative_area > 0.0 ? std::sqrt(representative_area / member_area) : 1.0;
+
+    for (int i = 0; i < 16; i++) {
+        transform[i] = 0.0;
+    }
+    for (int d = 0; d < 3; d++) {
+        transform[4 * d + d] = scale;
+        transform[4 * d + 3] = representative_centroid[d] - scale * member_centroid[d];
+    }
+    transform[15] = 1.0;
+}
+
+}  // namespace meshmind
@@ -0,0 +1,53 @@
+/**
+ * MeshMind-AFID Native Engine: Template Families
+ *
+ * Libraries often hold many near-identical templates (scaled variants, the
+ * sizes of one part). Templates are grouped into families by the
+ * distribution of their FPFH descriptors, so that one representative per
+ * family is matched in full and the other members are only evaluated, from
+ * the representative's pose, when it is found.
+ */
+
+#pragma once
+
+#include "native/mesh.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace meshmind {
+
+/* Mean of a template's FPFH histograms [count * FPFH_DIMS], normalised to sum to 1 */
+std::vector<double> descriptor_signature(const double* features, size_t count);
+
+/* Total variation distance between two signatures, in [0, 1] */
+double signature_distance(const std::vector<double>& a, const std::vector<double>& b);
+
+struct TemplateFamilies {
+    std::vector<uint32_t> family;            /* family of each template */
+    std::vector<uint32_t> representatives;   /* template matched in full, per family */
+};
+
+/**
+ * Leader clustering of templates by signature: in order, each template
+ * joins the first family of its group (e.g. feature type) whose leader is
+ * within max_distance, or starts a new one. The representative of a family
+ * is its medoid, the member closest to all others.
+ */
+TemplateFamilies cluster_templates(
+    const std::vector<std::vector<double>>& signatures,
+    const std::vector<int>& groups,
+    double max_distance
+);
+
+/**
+ * Similarity (row-major 4x4) from a member's frame onto its family
+ * representative's, so that the representative's pose composed with it
+ * seeds the member. Members are expected to differ by position and scale
+ * only: the area-weighted surface centroids are matched and the scale is
+ * the square root of the surface area ratio.
+ */
+void member_alignment(const TriangleMesh& member, const TriangleMesh& representative, double transform[16]);
+
+}  // namespace meshmind
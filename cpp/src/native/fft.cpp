@@ -0,0 +1,150 @@
+/**
+ * MeshMind-AFID Native Engine: Fast Fourier Transform
+ */
+
+#include "native/fft.h"
+
+#include "native/parallel.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace meshmind {
+
+size_t fft_size(size_t n) {
+    for (size_t m = std::max<size_t>(n, 1);; m++) {
+        size_t r = m;
+        for (size_t p : {2, 3, 5}) {
+            while (r % p == 0) {
+                r /= p;
+            }
+        }
+        if (r == 1) {
+            return m;
+        }
+    }
+}
+
+FFTPlan::FFTPlan(size_t n) : n_(n) {
+    if (n == 0) {
+        throw std::invalid_argument("FFT length must be positive");
+    }
+    // Radix 2 first, then odd factors in increasing order
+    size_t remaining = n;
+    size_t p = 2;
+    while (remaining > 1) {
+        while (remaining % p != 0) {
+            p = (p == 2) ? 3 : p + 2;
+            if (p * p > remaining) {
+                p = remaining;
+            }
+        }
+        remaining /= p;
+        factors_.push_back(p);
+        factors_.push_back(remaining);
+    }
+    if (factors_.empty()) {
+        factors_ = {1, 1};
+    }
+
+    forward_.resize(n);
+    inverse_.resize(n);
+    const double pi = std::acos(-1.0);
+    for (size_t k = 0; k < n; k++) {
+        double angle = -2.0 * pi * double(k) / double(n);
+        forward_[k] = Complex(std::cos(angle), std::sin(angle));
+        inverse_[k] = std::conj(forward_[k]);
+    }
+}
+
+void FFTPlan::execute(const Complex* in, size_t stride, Complex* out, bool inverse) const {
+    work(out, in, 1, stride, factors_.data(), inverse ? inverse_.data() : forward_.data());
+}
+
+void FFTPlan::work(Complex* out, const Complex* in, size_t fstride, size_t stride,
+                   const size_t* factors, const Complex* twiddles) const {
+    const size_t p = factors[0];
+    const size_t m = factors[1];
+    if (m == 1) {
+        for (size_t q = 0; q < p; q++) {
+            out[q] = in[q * fstride * stride];
+        }
+    } else {
+        // Decimation in time: p interleaved sub-transforms of length m
+        for (size_t q = 0; q < p; q++) {
+            work(out + q * m, in + q * fstride * stride, fstride * p, stride, factors + 2, twiddles);
+        }
+    }
+    if (p == 1) {
+        return;
+    }
+
+    if (p == 2) {
+        for (size_t k = 0; k < m; k++) {
+            Complex t = out[k + m] * twiddles[k * fstride];
+            out[k + m] = out[k] - t;
+            out[k] += t;
+        }
+        return;
+    }
+
+    // Generic butterfly for odd radices
+    Complex scratch[64];
+    std::vector<Complex> heap;
+    Complex* values = scratch;
+    if (p > 64) {
+        heap.resize(p);
+        values = heap.data();
+    }
+    for (size_t u = 0; u < m; u++) {
+        for (size_t q = 0; q < p; q++) {
+            values[q] = out[u + q * m];
+        }
+        for (size_t q1 = 0; q1 < p; q1++) {
+            size_t k = u + q1 * m;
+            Complex sum = values[0];
+            size_t index = 0;
+            for (size_t q = 1; q < p; q++) {
+                index += fstride * k;
+                index %= n_;
+                sum += values[q] * twiddles[index];
+            }
+            out[k] = sum;
+        }
+    }
+}
+
+void fft3d(std::vector<Complex>& grid, const size_t dims[3], bool inverse) {
+    if (grid.size() != dims[0] * dims[1] * dims[2]) {
+        throw std::invalid_argument("Grid size does not match its dimensions");
+    }
+    const size_t strides[3] = {dims[1] * dims[2], dims[2], 1};
+
+    for (int axis = 0; axis < 3; axis++) {
+        const size_t n = dims[axis];
+        const size_t lines = grid.size() / n;
+        FFTPlan plan(n);
+        const int a = (axis + 1) % 3, b = (axis + 2) % 3;
+
+        parallel_for(lines, [&](size_t begin, size_t end) {
+            std::vector<Complex> line(n);
+            for (size_t l = begin; l < end; l++) {
+                // Line l runs along axis through cell (i_a, i_b) of the other two axes
+                size_t start = (l / dims[b]) * strides[a] + (l % dims[b]) * strides[b];
+                plan.execute(&grid[start], strides[axis], line.data(), inverse);
+                for (size_t i = 0; i < n; i++) {
+                    grid[start + i * strides[axis]] = line[i];
+                }
+            }
+        }, 64);
+    }
+
+    if (inverse) {
+        const double scale = 1.0 / double(grid.size());
+        for (Complex& value : grid) {
+            value *= scale;
+        }
+    }
+}
+
+}  // namespace meshmind
@@ -0,0 +1,52 @@
+/**
+ * MeshMind-AFID Native Engine: Fast Fourier Transform
+ *
+ * Mixed-radix Cooley-Tukey FFT (radix-2 butterflies, generic butterflies for
+ * odd factors) for any length, fastest for lengths with small prime factors
+ * (see fft_size). Used for cross-correlation of voxel grids.
+ */
+
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace meshmind {
+
+using Complex = std::complex<double>;
+
+/* Smallest n' >= n of the form 2^a * 3^b * 5^c */
+size_t fft_size(size_t n);
+
+/* Precomputed factors and twiddles for transforms of one length */
+class FFTPlan {
+public:
+    FFTPlan() = default;
+    explicit FFTPlan(size_t n);
+
+    size_t size() const { return n_; }
+
+    /**
+     * Transform n values read from in[0], in[stride], ... into out[0..n).
+     * in and out must not overlap. The inverse transform is unnormalised.
+     */
+    void execute(const Complex* in, size_t stride, Complex* out, bool inverse) const;
+
+private:
+    void work(Complex* out, const Complex* in, size_t fstride, size_t stride,
+              const size_t* factors, const Complex* twiddles) const;
+
+    size_t n_ = 0;
+    std::vector<size_t> factors_;   /* (radix, remaining length) pairs */
+    std::vector<Complex> forward_;  /* exp(-2 pi i k / n) */
+    std::vector<Complex> inverse_;  /* exp(+2 pi i k / n) */
+};
+
+/**
+ * In-place 3D transform of a row-major grid [dims[0]][dims[1]][dims[2]].
+ * The inverse transform is normalised by the number of cells.
+ */
+void fft3d(std::vector<Complex>& grid, const size_t dims[3], bool inverse);
+
+}  // namespace meshmind
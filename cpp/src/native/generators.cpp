@@ -0,0 +1,192 @@
+/**
+ * MeshMind-AFID Native Engine: Mesh Generators
+ */
+
+#include "native/generators.h"
+
+#include "native/parallel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+namespace meshmind {
+
+namespace {
+
+const double BASE_BOUNDS[6] = {-0.5, -0.5, -0.5, 0.5, 0.5, 0.5};
+const char* REGION_SUFFIXES[] = {"_ref", "_wake"};
+
+struct GeneratorRegistry {
+    std::mutex mutex;
+    std::map<std::string, GeneratorFactory> factories;
+
+    GeneratorRegistry() {
+        factories["snappyhexmesh"] = [] { return std::unique_ptr<MeshGenerator>(new SnappyHexMeshGenerator); };
+        factories["ftetwild"] = [] { return std::unique_ptr<MeshGenerator>(new FTetWildGenerator); };
+    }
+};
+
+GeneratorRegistry& registry() {
+    static GeneratorRegistry instance;
+    return instance;
+}
+
+}  // namespace
+
+void DetectionTable::clear() {
+    feature_types.clear();
+    instances.clear();
+    positions.clear();
+    transforms.clear();
+    confidences.clear();
+    radii.clear();
+    scales.clear();
+}
+
+std::string DetectionTable::feature_id(size_t row) const {
+    const std::string& name = feature_type_names.at(size_t(feature_types[row]));
+    return instances[row] < 0 ? name : name + "_" + std::to_string(instances[row]);
+}
+
+RegionRules RegionRules::defaults() {
+    RegionRules rules;
+    RegionRule wheel;
+    wheel.level_size = 0.005;
+    wheel.level = 4;
+    wheel.wake = true;
+    wheel.wake_offset[0] = -2.0;   // two diameters behind (-x is the wake direction)
+    wheel.wake_scale[0] = 3.0;
+    wheel.wake_scale[1] = 1.5;
+    wheel.wake_scale[2] = 1.2;
+    rules.rules["wheel"] = wheel;
+    return rules;
+}
+
+const RegionRule& RegionRules::find(const std::string& feature_id) const {
+    auto it = rules.find(feature_id);
+    return it != rules.end() ? it->second : default_rule;
+}
+
+std::string RegionTable::name(const DetectionTable& detections, size_t row) const {
+    const RegionRecord& record = records[row];
+    return detections.feature_id(size_t(record.det_index)) + REGION_SUFFIXES[record.kind];
+}
+
+RegionTable generate_regions(const DetectionTable& detections, const RegionRules& rules) {
+    RegionTable table;
+    table.records.reserve(detections.size());
+    for (size_t row = 0; row < detections.size(); row++) {
+        const RegionRule& rule = rules.find(detections.feature_id(row));
+        const double* m = &detections.transforms[16 * row];
+
+        // Each detection emits its primary region, directly followed by its wake
+        RegionRecord primary;
+        primary.det_index = int32_t(row);
+        primary.kind = REGION_PRIMARY;
+        std::copy(m, m + 16, primary.transform);
+        primary.level_size = rule.level_size;
+        primary.level = rule.level;
+        std::copy(BASE_BOUNDS, BASE_BOUNDS + 6, primary.bounds);
+        table.records.push_back(primary);
+
+        if (!rule.wake) {
+            continue;
+        }
+        RegionRecord wake = primary;
+        wake.kind = REGION_WAKE;
+        for (int i = 0; i < 3; i++) {
+            // Local offset rotated into the feature frame
+            wake.transform[4 * i + 3] += m[4 * i] * rule.wake_offset[0] +
+                                         m[4 * i + 1] * rule.wake_offset[1] +
+                                         m[4 * i + 2] * rule.wake_offset[2];
+            wake.bounds[i] = BASE_BOUNDS[i] * rule.wake_scale[i];
+            wake.bounds[i + 3] = BASE_BOUNDS[i + 3] * rule.wake_scale[i];
+        }
+        wake.level_size = rule.level_size * 2.0;
+        wake.level = std::max(1, rule.level - 1);
+        table.records.push_back(wake);
+    }
+    return table;
+}
+
+void SnappyHexMeshGenerator::export_config(const DetectionTable& detections, const RegionTable& regions,
+                                           const GeneratorParams&, const std::string& output_path) const {
+    std::vector<RefinementRegion> snappy_regions(regions.size());
+    for (size_t i = 0; i < regions.size(); i++) {
+        const RegionRecord& record = regions.records[i];
+        RefinementRegion& region = snappy_regions[i];
+        region.name = regions.name(detections, i);
+        region.level_size = record.level_size;
+        region.level = record.level;
+        std::memcpy(region.transform, record.transform, sizeof(region.transform));
+        std::memcpy(region.bounds, record.bounds, sizeof(region.bounds));
+    }
+    write_snappy_dict(output_path, snappy_regions);
+}
+
+std::vector<SizingSphere> FTetWildGenerator::sizing_field(const DetectionTable& detections,
+                                                          const GeneratorParams& params) {
+    std::vector<SizingSphere> spheres(detections.size());
+    for (size_t i = 0; i < detections.size(); i++) {
+        std::copy(&detections.positions[3 * i], &detections.positions[3 * i] + 3, spheres[i].center);
+        spheres[i].radius = detections.radii[i] > 0 ? detections.radii[i] : 0.5;
+        spheres[i].size = params.base_size * params.refinement_factor;
+    }
+    return spheres;
+}
+
+void FTetWildGenerator::export_config(const DetectionTable& detections, const RegionTable&,
+                                      const GeneratorParams& params, const std::string& output_path) const {
+    write_ftetwild_sizing(output_path, sizing_field(detections, params));
+}
+
+void register_generator(const std::string& name, GeneratorFactory factory) {
+    GeneratorRegistry& generators = registry();
+    std::lock_guard<std::mutex> lock(generators.mutex);
+    generators.factories[name] = std::move(factory);
+}
+
+std::unique_ptr<MeshGenerator> make_generator(const std::string& name) {
+    GeneratorRegistry& generators = registry();
+    std::lock_guard<std::mutex> lock(generators.mutex);
+    auto it = generators.factories.find(name);
+    if (it == generators.factories.end()) {
+        std::string available;
+        for (const auto& entry : generators.factories) {
+            available += (available.empty() ? "" : ", ") + entry.first;
+        }
+        throw std::invalid_argument("Mesh generator '" + name + "' not found. Available: " + available);
+    }
+    return it->second();
+}
+
+std::vector<std::string> list_generators() {
+    GeneratorRegistry& generators = registry();
+    std::lock_guard<std::mutex> lock(generators.mutex);
+    std::vector<std::string> names;
+    for (const auto& entry : generators.factories) {
+        names.push_back(entry.first);
+    }
+    return names;
+}
+
+void export_mesher_inputs(
+    const std::vector<const MeshGenerator*>& generators,
+    const std::vector<std::string>& output_paths,
+    const DetectionTable& detections,
+    const RegionTable& regions,
+    const GeneratorParams& params
+) {
+    if (generators.size() != output_paths.size()) {
+        throw std::invalid_argument("One output path is needed per mesh generator");
+    }
+    parallel_for(generators.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            generators[i]->export_config(detections, regions, params, output_paths[i]);
+        }
+    }, 1);
+}
+
+}  // namespace meshmind
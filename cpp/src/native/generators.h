@@ -0,0 +1,157 @@
+/**
+ * MeshMind-AFID Native Engine: Mesh Generators
+ *
+ * Native counterpart of meshmind.plugins.mesh_generators: backends turn one
+ * detection table (and the refinement regions derived from it, as
+ * RegionGenerator.generate_table does) into input files for an external
+ * mesher. Backends only read the tables, so several can export from the
+ * same detection concurrently.
+ */
+
+#pragma once
+
+#include "native/exporters.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace meshmind {
+
+/* Detections in the column layout of meshmind.core.recognition.detection_table.DetectionTable */
+struct DetectionTable {
+    std::vector<std::string> feature_type_names;
+    std::vector<int> feature_types;     /* [count] index into feature_type_names */
+    std::vector<int> instances;         /* [count] instance within the type, -1 if none */
+    std::vector<double> positions;      /* [count * 3] */
+    std::vector<double> transforms;     /* [count * 16] row-major */
+    std::vector<double> confidences;    /* [count] */
+    std::vector<double> radii;          /* [count], 0 if unknown */
+    std::vector<double> scales;         /* [count] */
+
+    size_t size() const { return confidences.size(); }
+    void clear();
+
+    /* "<type>_<instance>", or the type alone without an instance */
+    std::string feature_id(size_t row) const;
+};
+
+/* One RegionGenerator rule; rules are keyed by full feature ID */
+struct RegionRule {
+    double level_size = 0.01;   /* levels[0] */
+    int level = 3;              /* levels[1] */
+    bool wake = false;
+    double wake_offset[3] = {0.0, 0.0, 0.0};   /* in the feature frame */
+    double wake_scale[3] = {1.0, 1.0, 1.0};
+};
+
+struct RegionRules {
+    RegionRule default_rule;
+    std::map<std::string, RegionRule> rules;
+
+    /* RegionGenerator's built-in rules */
+    static RegionRules defaults();
+    const RegionRule& find(const std::string& feature_id) const;
+};
+
+enum RegionKind : int8_t {
+    REGION_PRIMARY = 0,
+    REGION_WAKE = 1,
+};
+
+/* One row of meshmind.core.refinement.RegionTable (REGION_DTYPE) */
+struct RegionRecord {
+    int32_t det_index;
+    RegionKind kind;
+    double transform[16];
+    double level_size;
+    int32_t level;
+    double bounds[6];   /* local [min_x, min_y, min_z, max_x, max_y, max_z] */
+};
+
+struct RegionTable {
+    std::vector<RegionRecord> records;
+
+    size_t size() const { return records.size(); }
+
+    /* "<feature_id>_ref" / "<feature_id>_wake" */
+    std::string name(const DetectionTable& detections, size_t row) const;
+};
+
+/* Same regions, in the same order, as RegionGenerator.generate_table */
+RegionTable generate_regions(const DetectionTable& detections, const RegionRules& rules = RegionRules::defaults());
+
+/* Global meshing parameters (MeshGeneratorPlugin global_params) */
+struct GeneratorParams {
+    double base_size = 0.1;
+    double refinement_factor = 0.2;
+};
+
+class MeshGenerator {
+public:
+    virtual ~MeshGenerator() = default;
+
+    virtual std::string name() const = 0;
+
+    /**
+     * Write the mesher's input file for these detections and regions.
+     * Must not modify shared state: exports for one detection may run concurrently.
+     * @throws std::runtime_error if the file cannot be written
+     */
+    virtual void export_config(
+        const DetectionTable& detections,
+        const RegionTable& regions,
+        const GeneratorParams& params,
+        const std::string& output_path
+    ) const = 0;
+};
+
+/* snappyHexMeshDict with one refinement region per RegionTable row */
+class SnappyHexMeshGenerator : public MeshGenerator {
+public:
+    std::string name() const override { return "snappyhexmesh"; }
+    void export_config(const DetectionTable& detections, const RegionTable& regions,
+                       const GeneratorParams& params, const std::string& output_path) const override;
+};
+
+/* fTetWild .sizing.json with one sizing sphere per detection */
+class FTetWildGenerator : public MeshGenerator {
+public:
+    std::string name() const override { return "ftetwild"; }
+    void export_config(const DetectionTable& detections, const RegionTable& regions,
+                       const GeneratorParams& params, const std::string& output_path) const override;
+
+    static std::vector<SizingSphere> sizing_field(const DetectionTable& detections, const GeneratorParams& params);
+};
+
+using GeneratorFactory = std::function<std::unique_ptr<MeshGenerator>()>;
+
+/* Register a backend under a name (replaces an existing one), as register_generator in Python */
+void register_generator(const std::string& name, GeneratorFactory factory);
+
+/**
+ * Create a registered backend ("snappyhexmesh" and "ftetwild" are built in).
+ * @throws std::invalid_argument for unknown names
+ */
+std::unique_ptr<MeshGenerator> make_generator(const std::string& name);
+
+std::vector<std::string> list_generators();
+
+/**
+ * Export inputs for several meshers from one detection, one thread per
+ * backend. Regions are generated once and shared.
+ * @throws the first backend error after all exports have finished
+ */
+void export_mesher_inputs(
+    const std::vector<const MeshGenerator*>& generators,
+    const std::vector<std::string>& output_paths,
+    const DetectionTable& detections,
+    const RegionTable& regions,
+    const GeneratorParams& params = GeneratorParams()
+);
+
+}  // namespace meshmind
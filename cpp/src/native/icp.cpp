@@ -0,0 +1,234 @@
+/**
+ * MeshMind-AFID Native Engine: ICP Refinement
+ */
+
+#include "native/icp.h"
+
+#include "native/parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace meshmind {
+
+namespace {
+
+struct Correspondence {
+    double source[3];   /* moved sample */
+    double target[3];   /* closest point on the target */
+    double normal[3];   /* residual direction */
+    double sq_distance;
+};
+
+void normalize(double* v) {
+    double length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    if (length > 0) {
+        v[0] /= length;
+        v[1] /= length;
+        v[2] /= length;
+    }
+}
+
+/* Closest target points of the moved samples, the worst (1 - trim) dropped */
+std::vector<Correspondence> correspond(const double* transform, const PointsView& samples, const BVH& target,
+                                       const ICPParams& params) {
+    const TriangleMesh& mesh = *target.mesh();
+    const double* m = transform;
+    const bool symmetric = params.symmetric && samples.normals != nullptr;
+    std::vector<Correspondence> matches;
+    matches.reserve(samples.size);
+    for (size_t i = 0; i < samples.size; i++) {
+        const double* p = samples.points + 3 * i;
+        Correspondence c;
+        for (int r = 0; r < 3; r++) {
+            c.source[r] = m[4 * r] * p[0] + m[4 * r + 1] * p[1] + m[4 * r + 2] * p[2] + m[4 * r + 3];
+        }
+        ClosestPoint closest = target.closest_point(c.source);
+        if (closest.face < 0) {
+            continue;
+        }
+        std::copy(closest.point, closest.point + 3, c.target);
+        c.sq_distance = closest.sq_distance;
+
+        const int32_t* face = &mesh.faces[3 * size_t(closest.face)];
+        const double* a = &mesh.vertices[3 * size_t(face[0])];
+        const double* b = &mesh.vertices[3 * size_t(face[1])];
+        const double* v = &mesh.vertices[3 * size_t(face[2])];
+        double e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        double e2[3] = {v[0] - a[0], v[1] - a[1], v[2] - a[2]};
+        double n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+        normalize(n);
+        if (symmetric) {
+            const double* np = samples.normals + 3 * i;
+            double moved[3];
+            for (int r = 0; r < 3; r++) {
+                moved[r] = m[4 * r] * np[0] + m[4 * r + 1] * np[1] + m[4 * r + 2] * np[2];
+            }
+            normalize(moved);
+            double sign = moved[0] * n[0] + moved[1] * n[1] + moved[2] * n[2] < 0 ? -1.0 : 1.0;
+            double sum[3] = {n[0] + sign * moved[0], n[1] + sign * moved[1], n[2] + sign * moved[2]};
+            if (sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2] > 1e-12) {
+                normalize(sum);
+                std::copy(sum, sum + 3, n);
+            }
+        }
+        std::copy(n, n + 3, c.normal);
+        matches.push_back(c);
+    }
+
+    size_t keep = std::max<size_t>(std::min<size_t>(matches.size(), 3), size_t(std::ceil(params.trim * double(matches.size()))));
+    if (keep < matches.size()) {
+        std::nth_element(matches.begin(), matches.begin() + std::ptrdiff_t(keep), matches.end(),
+                         [](const Correspondence& x, const Correspondence& y) { return x.sq_distance < y.sq_distance; });
+        matches.resize(keep);
+    }
+    return matches;
+}
+
+/* Solve the 6x6 system A x = b by Gaussian elimination with partial pivoting */
+bool solve6(double a[6][6], double b[6], double x[6]) {
+    for (int col = 0; col < 6; col++) {
+        int pivot = col;
+        for (int row = col + 1; row < 6; row++) {
+            if (std::fabs(a[row][col]) > std::fabs(a[pivot][col])) {
+                pivot = row;
+            }
+        }
+        if (!(std::fabs(a[pivot][col]) > 1e-300)) {
+            return false;
+        }
+        std::swap(a[pivot], a[col]);
+        std::swap(b[pivot], b[col]);
+        for (int row = col + 1; row < 6; row++) {
+            double f = a[row][col] / a[col][col];
+            for (int k = col; k < 6; k++) {
+                a[row][k] -= f * a[col][k];
+            }
+            b[row] -= f * b[col];
+        }
+    }
+    for (int row = 5; row >= 0; row--) {
+        double sum = b[row];
+        for (int k = row + 1; k < 6; k++) {
+            sum -= a[row][k] * x[k];
+        }
+        x[row] = sum / a[row][row];
+    }
+    return true;
+}
+
+/*
+ * One linearised point-to-plane step about the centroid c of the matched
+ * samples: minimise sum ((p - c) x n . w + n . t + (p - q) . n)^2 and apply
+ * the rotation exp(w) about c followed by t. Returns false at convergence.
+ */
+bool step(const std::vector<Correspondence>& matches, double* transform, double tolerance) {
+    double c[3] = {0, 0, 0};
+    for (const Correspondence& match : matches) {
+        for (int d = 0; d < 3; d++) {
+            c[d] += match.source[d] / double(matches.size());
+        }
+    }
+    double a[6][6] = {}, b[6] = {}, spread = 0.0;
+    for (const Correspondence& match : matches) {
+        const double* n = match.normal;
+        double p[3] = {match.source[0] - c[0], match.source[1] - c[1], match.source[2] - c[2]};
+        double j[6] = {p[1] * n[2] - p[2] * n[1], p[2] * n[0] - p[0] * n[2], p[0] * n[1] - p[1] * n[0], n[0], n[1], n[2]};
+        double r = (match.source[0] - match.target[0]) * n[0] + (match.source[1] - match.target[1]) * n[1] +
+                   (match.source[2] - match.target[2]) * n[2];
+        for (int row = 0; row < 6; row++) {
+            for (int col = 0; col < 6; col++) {
+                a[row][col] += j[row] * j[col];
+            }
+            b[row] -= j[row] * r;
+        }
+        spread += p[0] * p[0] + p[1] * p[1] + p[2] * p[2];
+    }
+    // Tiny damping keeps flat or symmetric patches (unconstrained directions) solvable
+    double trace = 0.0;
+    for (int k = 0; k < 6; k++) {
+        trace += a[k][k];
+    }
+    for (int k = 0; k < 6; k++) {
+        a[k][k] += 1e-9 * trace + 1e-300;
+    }
+    double x[6];
+    if (!solve6(a, b, x)) {
+        return false;
+    }
+
+    double angle = std::sqrt(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]);
+    double shift = std::sqrt(x[3] * x[3] + x[4] * x[4] + x[5] * x[5]);
+    double radius = std::sqrt(spread / double(matches.size()));
+
+    // Rodrigues rotation R = I + sin(a) K + (1 - cos(a)) K^2 for the unit axis
+    double rot[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+    if (angle > 0) {
+        double k[3] = {x[0] / angle, x[1] / angle, x[2] / angle};
+        double s = std::sin(angle), v = 1.0 - std::cos(angle);
+        rot[0] = 1 + v * (k[0] * k[0] - 1);  rot[1] = -s * k[2] + v * k[0] * k[1];  rot[2] = s * k[1] + v * k[0] * k[2];
+        rot[3] = s * k[2] + v * k[0] * k[1];  rot[4] = 1 + v * (k[1] * k[1] - 1);  rot[5] = -s * k[0] + v * k[1] * k[2];
+        rot[6] = -s * k[1] + v * k[0] * k[2];  rot[7] = s * k[0] + v * k[1] * k[2];  rot[8] = 1 + v * (k[2] * k[2] - 1);
+    }
+    double offset[3];
+    for (int r = 0; r < 3; r++) {
+        offset[r] = c[r] + x[3 + r] - (rot[3 * r] * c[0] + rot[3 * r + 1] * c[1] + rot[3 * r + 2] * c[2]);
+    }
+    double updated[16];
+    for (int r = 0; r < 3; r++) {
+        for (int col = 0; col < 4; col++) {
+            updated[4 * r + col] = rot[3 * r] * transform[col] + rot[3 * r + 1] * transform[4 + col] +
+                                   rot[3 * r + 2] * transform[8 + col] + (col == 3 ? offset[r] : 0.0);
+        }
+    }
+    std::copy(updated, updated + 12, transform);
+    return angle >= tolerance || shift >= tolerance * std::max(radius, 1e-300);
+}
+
+double trimmed_rms(const std::vector<Correspondence>& matches) {
+    double sum = 0.0;
+    for (const Correspondence& match : matches) {
+        sum += match.sq_distance;
+    }
+    return matches.empty() ? 0.0 : std::sqrt(sum / double(matches.size()));
+}
+
+}  // namespace
+
+ICPResult icp_refine(const ICPSource& source, const BVH& target, const ICPParams& params) {
+    if (!(params.trim > 0 && params.trim <= 1)) {
+        throw std::invalid_argument("ICP trim fraction must be in (0, 1]");
+    }
+    if (source.levels.empty()) {
+        throw std::invalid_argument("ICP needs at least one level of samples");
+    }
+    ICPResult result;
+    std::copy(source.transform, source.transform + 16, result.transform);
+    for (const PointsView& level : source.levels) {
+        for (size_t iteration = 0; iteration < params.iterations; iteration++) {
+            std::vector<Correspondence> matches = correspond(result.transform, level, target, params);
+            if (matches.size() < 3) {
+                break;
+            }
+            result.iterations++;
+            if (!step(matches, result.transform, params.tolerance)) {
+                break;
+            }
+        }
+    }
+    result.rms = trimmed_rms(correspond(result.transform, source.levels.back(), target, params));
+    return result;
+}
+
+std::vector<ICPResult> icp_refine(const std::vector<ICPSource>& sources, const BVH& target, const ICPParams& params) {
+    std::vector<ICPResult> results(sources.size());
+    parallel_for(sources.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            results[i] = icp_refine(sources[i], target, params);
+        }
+    }, 1);
+    return results;
+}
+
+}  // namespace meshmind
@@ -0,0 +1,50 @@
+/**
+ * MeshMind-AFID Native Engine: ICP Refinement
+ *
+ * Point-to-plane ICP of template samples against the target surface, run
+ * over the template's levels of detail from coarse to fine. Correspondences
+ * are exact closest points from the target BVH; the worst fraction of them
+ * is trimmed each iteration. The symmetric variant (Rusinkiewicz 2019)
+ * measures residuals along the sum of both normals, which converges in
+ * fewer iterations on curved surfaces. The pose's scale is kept.
+ */
+
+#pragma once
+
+#include "native/bvh.h"
+#include "native/mesh.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace meshmind {
+
+struct ICPParams {
+    size_t iterations = 0;      /* per level of detail; 0 skips refinement */
+    double trim = 0.9;          /* fraction of correspondences kept, (0, 1] */
+    bool symmetric = false;     /* residuals along source + target normals (needs source normals) */
+    double tolerance = 1e-6;    /* stop a level once the update is this small (radians, relative distance) */
+};
+
+struct ICPResult {
+    double transform[16];
+    double rms = 0.0;            /* trimmed RMS distance at the finest level */
+    size_t iterations = 0;       /* over all levels */
+};
+
+/* A pose to refine with the template's point sets, coarse to fine */
+struct ICPSource {
+    std::vector<PointsView> levels;
+    double transform[16];
+};
+
+/**
+ * Refine one pose.
+ * @throws std::invalid_argument for a trim outside (0, 1] or no levels
+ */
+ICPResult icp_refine(const ICPSource& source, const BVH& target, const ICPParams& params);
+
+/* Refine many poses, in parallel across poses */
+std::vector<ICPResult> icp_refine(const std::vector<ICPSource>& sources, const BVH& target, const ICPParams& params);
+
+}  // namespace meshmind
@@ -0,0 +1,186 @@
+/**
+ * MeshMind-AFID Native Engine: KD-Tree
+ */
+
+#include "native/kdtree.h"
+
+#include <algorithm>
+
+namespace meshmind {
+
+namespace {
+
+inline double squared_distance(const double* a, const double* b, size_t dim) {
+    double sum = 0.0;
+    for (size_t d = 0; d < dim; d++) {
+        double diff = a[d] - b[d];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+}  // namespace
+
+/* Bounded, sorted candidate list for k-nearest-neighbour queries */
+struct KDTree::KnnState {
+    size_t k;
+    size_t found = 0;
+    size_t* indices;
+    double* sq_distances;
+    double bound;
+
+    void offer(size_t index, double d2) {
+        if (d2 > bound) {
+            return;
+        }
+        size_t pos = found < k ? found++ : k - 1;
+        while (pos > 0 && sq_distances[pos - 1] > d2) {
+            sq_distances[pos] = sq_distances[pos - 1];
+            indices[pos] = indices[pos - 1];
+            pos--;
+        }
+        sq_distances[pos] = d2;
+        indices[pos] = index;
+        if (found == k) {
+            bound = sq_distances[k - 1];
+        }
+    }
+};
+
+KDTree::KDTree(const double* points, size_t count, size_t dim, size_t leaf_size)
+    : count_(count), dim_(dim), order_(count) {
+    for (size_t i = 0; i < count; i++) {
+        order_[i] = static_cast<uint32_t>(i);
+    }
+    data_.assign(points, points + count * dim);
+    if (count > 0) {
+        build(0, static_cast<uint32_t>(count), std::max<size_t>(leaf_size, 1));
+    }
+
+    // Store points in tree order so leaves are contiguous in memory
+    std::vector<double> ordered(count * dim);
+    for (size_t i = 0; i < count; i++) {
+        std::copy_n(points + size_t(order_[i]) * dim, dim, ordered.begin() + i * dim);
+    }
+    data_.swap(ordered);
+}
+
+int32_t KDTree::build(uint32_t begin, uint32_t end, size_t leaf_size) {
+    int32_t index = static_cast<int32_t>(nodes_.size());
+    nodes_.push_back(Node{0.0, 0, begin, end, -1, -1});
+    if (end - begin <= leaf_size) {
+        return index;
+    }
+
+    // Split along the axis of largest spread at the median
+    uint32_t axis = 0;
+    double best_spread = -1.0;
+    for (size_t d = 0; d < dim_; d++) {
+        double lo = data_[size_t(order_[begin]) * dim_ + d];
+        double hi = lo;
+        for (uint32_t i = begin + 1; i < end; i++) {
+            double value = data_[size_t(order_[i]) * dim_ + d];
+            lo = std::min(lo, value);
+            hi = std::max(hi, value);
+        }
+        if (hi - lo > best_spread) {
+            best_spread = hi - lo;
+            axis = static_cast<uint32_t>(d);
+        }
+    }
+    if (best_spread <= 0.0) {
+        return index;  // all points identical: keep as one leaf
+    }
+
+    uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(order_.begin() + begin, order_.begin() + mid, order_.begin() + end,
+                     [&](uint32_t a, uint32_t b) {
+                         return data_[size_t(a) * dim_ + axis] < data_[size_t(b) * dim_ + axis];
+                     });
+    double split = data_[size_t(order_[mid]) * dim_ + axis];
+
+    int32_t left = build(begin, mid, leaf_size);
+    int32_t right = build(mid, end, leaf_size);
+    nodes_[index].split = split;
+    nodes_[index].axis = axis;
+    nodes_[index].left = left;
+    nodes_[index].right = right;
+    return index;
+}
+
+void KDTree::knn_recurse(int32_t node_index, const double* query, KnnState& state) const {
+    const Node& node = nodes_[node_index];
+    if (node.left < 0) {
+        for (uint32_t i = node.begin; i < node.end; i++) {
+            state.offer(order_[i], squared_distance(query, &data_[size_t(i) * dim_], dim_));
+        }
+        return;
+    }
+
+    double diff = query[node.axis] - node.split;
+    int32_t near = diff < 0 ? node.left : node.right;
+    int32_t far = diff < 0 ? node.right : node.left;
+    knn_recurse(near, query, state);
+    if (diff * diff <= state.bound) {
+        knn_recurse(far, query, state);
+    }
+}
+
+size_t KDTree::knn(
+    const double* query,
+    size_t k,
+    size_t* indices,
+    double* sq_distances,
+    double max_sq_distance
+) const {
+    if (k == 0 || count_ == 0) {
+        return 0;
+    }
+    KnnState state{k, 0, indices, sq_distances, max_sq_distance};
+    knn_recurse(0, query, state);
+    return state.found;
+}
+
+void KDTree::radius_search(
+    const double* query,
+    double radius,
+    std::vector<size_t>& indices,
+    std::vector<double>* sq_distances
+) const {
+    indices.clear();
+    if (sq_distances) {
+        sq_distances->clear();
+    }
+    if (count_ == 0) {
+        return;
+    }
+
+    const double r2 = radius * radius;
+    int32_t stack[128];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = nodes_[stack[--top]];
+        if (node.left < 0) {
+            for (uint32_t i = node.begin; i < node.end; i++) {
+                double d2 = squared_distance(query, &data_[size_t(i) * dim_], dim_);
+                if (d2 <= r2) {
+                    indices.push_back(order_[i]);
+                    if (sq_distances) {
+                        sq_distances->push_back(d2);
+                    }
+                }
+            }
+            continue;
+        }
+        double diff = query[node.axis] - node.split;
+        if (diff <= radius) {
+            stack[top++] = node.left;
+        }
+        if (diff >= -radius) {
+            stack[top++] = node.right;
+        }
+    }
+}
+
+}  // namespace meshmind
@@ -0,0 +1,70 @@
+/**
+ * MeshMind-AFID Native Engine: KD-Tree
+ *
+ * Exact nearest-neighbour index over points of any dimension. Used for
+ * 3D neighbourhoods (normals, FPFH) and for 33D descriptor matching.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace meshmind {
+
+class KDTree {
+public:
+    KDTree() = default;
+
+    /* Builds the tree over a copy of points [count * dim] */
+    KDTree(const double* points, size_t count, size_t dim, size_t leaf_size = 16);
+
+    size_t size() const { return count_; }
+    size_t dim() const { return dim_; }
+
+    /**
+     * Find up to k nearest neighbours with squared distance <= max_sq_distance.
+     * Results are sorted by distance; indices refer to the input order.
+     * @return number of neighbours written
+     */
+    size_t knn(
+        const double* query,
+        size_t k,
+        size_t* indices,
+        double* sq_distances,
+        double max_sq_distance = std::numeric_limits<double>::infinity()
+    ) const;
+
+    /* All neighbours within radius (unsorted) */
+    void radius_search(
+        const double* query,
+        double radius,
+        std::vector<size_t>& indices,
+        std::vector<double>* sq_distances = nullptr
+    ) const;
+
+private:
+    struct Node {
+        double split;
+        uint32_t axis;
+        uint32_t begin;
+        uint32_t end;
+        int32_t left;   /* -1 for leaves */
+        int32_t right;
+    };
+
+    int32_t build(uint32_t begin, uint32_t end, size_t leaf_size);
+
+    struct KnnState;
+    void knn_recurse(int32_t node, const double* query, KnnState& state) const;
+
+    size_t count_ = 0;
+    size_t dim_ = 0;
+    std::vector<double> data_;      /* points in tree order */
+    std::vector<uint32_t> order_;   /* tree position -> input index */
+    std::vector<Node> nodes_;
+};
+
+}  // namespace meshmind
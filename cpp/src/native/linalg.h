@@ -0,0 +1,95 @@
+/**
+ * MeshMind-AFID Native Engine: Small Dense Linear Algebra
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+namespace meshmind {
+
+/**
+ * Eigen-decomposition of a symmetric N x N matrix by cyclic Jacobi rotations.
+ * @param a Row-major matrix; destroyed (diagonal holds eigenvalues on return)
+ * @param eigenvalues Output, ascending
+ * @param eigenvectors Output, row-major; column i belongs to eigenvalues[i]
+ */
+template <size_t N>
+void symmetric_eigen(double (&a)[N][N], double (&eigenvalues)[N], double (&eigenvectors)[N][N]) {
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < N; j++) {
+            eigenvectors[i][j] = (i == j) ? 1.0 : 0.0;
+        }
+    }
+
+    for (int sweep = 0; sweep < 50; sweep++) {
+        double off = 0.0;
+        for (size_t p = 0; p < N; p++) {
+            for (size_t q = p + 1; q < N; q++) {
+                off += a[p][q] * a[p][q];
+            }
+        }
+        if (off < 1e-30) {
+            break;
+        }
+
+        for (size_t p = 0; p < N; p++) {
+            for (size_t q = p + 1; q < N; q++) {
+                if (std::fabs(a[p][q]) < 1e-300) {
+                    continue;
+                }
+                double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                double t = (theta >= 0 ? 1.0 : -1.0) /
+                           (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                double c = 1.0 / std::sqrt(t * t + 1.0);
+                double s = t * c;
+
+                for (size_t k = 0; k < N; k++) {
+                    double akp = a[k][p];
+                    double akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for (size_t k = 0; k < N; k++) {
+                    double apk = a[p][k];
+                    double aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+                for (size_t k = 0; k < N; k++) {
+                    double vkp = eigenvectors[k][p];
+                    double vkq = eigenvectors[k][q];
+                    eigenvectors[k][p] = c * vkp - s * vkq;
+                    eigenvectors[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < N; i++) {
+        eigenvalues[i] = a[i][i];
+    }
+
+    // Sort ascending (selection sort; N is tiny)
+    for (size_t i = 0; i < N; i++) {
+        size_t best = i;
+        for (size_t j = i + 1; j < N; j++) {
+            if (eigenvalues[j] < eigenvalues[best]) {
+                best = j;
+            }
+        }
+        if (best != i) {
+            double tmp = eigenvalues[i];
+            eigenvalues[i] = eigenvalues[best];
+            eigenvalues[best] = tmp;
+            for (size_t k = 0; k < N; k++) {
+                double v = eigenvectors[k][i];
+                eigenvectors[k][i] = eigenvectors[k][best];
+                eigenvectors[k][best] = v;
+            }
+        }
+    }
+}
+
+}  // namespace meshmind
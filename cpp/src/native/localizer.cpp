@@ -0,0 +1,227 @@
+/**
+ * MeshMind-AFID Native Engine: FFT Localisation
+ */
+
+#include "native/localizer.h"
+
+#include "native/parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace meshmind {
+
+namespace {
+
+/* Surface samples per voxel face area; enough to hit every voxel the surface crosses */
+const double SAMPLES_PER_VOXEL = 4.0;
+const size_t MAX_SAMPLES = size_t(1) << 22;
+/* Empty voxels around the target so dilation and peaks do not wrap */
+const size_t PADDING = 2;
+
+void bounds(const TriangleMesh& mesh, double* lo, double* hi) {
+    for (int d = 0; d < 3; d++) {
+        lo[d] = std::numeric_limits<double>::infinity();
+        hi[d] = -std::numeric_limits<double>::infinity();
+    }
+    for (size_t i = 0; i < mesh.num_vertices(); i++) {
+        for (int d = 0; d < 3; d++) {
+            lo[d] = std::min(lo[d], mesh.vertices[3 * i + d]);
+            hi[d] = std::max(hi[d], mesh.vertices[3 * i + d]);
+        }
+    }
+}
+
+double surface_area(const TriangleMesh& mesh) {
+    double area = 0.0;
+    for (size_t t = 0; t < mesh.num_faces(); t++) {
+        const double* a = &mesh.vertices[3 * size_t(mesh.faces[3 * t])];
+        const double* b = &mesh.vertices[3 * size_t(mesh.faces[3 * t + 1])];
+        const double* c = &mesh.vertices[3 * size_t(mesh.faces[3 * t + 2])];
+        double e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        double e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+        double n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+        area += 0.5 * std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    }
+    return area;
+}
+
+/* Mark the voxels crossed by the surface; grid cell (i, j, k) covers origin + [i, i+1) * voxel */
+size_t voxelise(const TriangleMesh& mesh, const double* origin, double voxel, const size_t* dims,
+                std::vector<Complex>& grid) {
+    double samples = SAMPLES_PER_VOXEL * surface_area(mesh) / (voxel * voxel);
+    size_t count = std::min(MAX_SAMPLES, std::max<size_t>(size_t(samples), 1));
+    PointSet points = sample_surface(mesh, count, 0);
+
+    size_t occupied = 0;
+    auto mark = [&](size_t cell) {
+        if (grid[cell].real() == 0.0) {
+            grid[cell] = 1.0;
+            occupied++;
+        }
+    };
+    for (size_t i = 0; i < points.size(); i++) {
+        size_t cell[3];
+        for (int d = 0; d < 3; d++) {
+            double c = std::floor((points.points[3 * i + d] - origin[d]) / voxel);
+            cell[d] = size_t(std::min(std::max(c, 0.0), double(dims[d] - 1)));
+        }
+        mark((cell[0] * dims[1] + cell[1]) * dims[2] + cell[2]);
+    }
+    // Vertices too, so small templates are not missed between samples
+    for (size_t v = 0; v < mesh.num_vertices(); v++) {
+        size_t cell[3];
+        for (int d = 0; d < 3; d++) {
+            double c = std::floor((mesh.vertices[3 * v + d] - origin[d]) / voxel);
+            cell[d] = size_t(std::min(std::max(c, 0.0), double(dims[d] - 1)));
+        }
+        mark((cell[0] * dims[1] + cell[1]) * dims[2] + cell[2]);
+    }
+    return occupied;
+}
+
+/*
+ * Give empty voxels next to the surface (26-neighbourhood) half weight, so
+ * placements off by a voxel still score while the exact one stays the peak
+ */
+void dilate(std::vector<Complex>& grid, const size_t* dims) {
+    std::vector<Complex> source = grid;
+    parallel_for(dims[0], [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            for (size_t j = 0; j < dims[1]; j++) {
+                for (size_t k = 0; k < dims[2]; k++) {
+                    bool hit = false;
+                    for (size_t a = i ? i - 1 : 0; !hit && a <= std::min(i + 1, dims[0] - 1); a++) {
+                        for (size_t b = j ? j - 1 : 0; !hit && b <= std::min(j + 1, dims[1] - 1); b++) {
+                            for (size_t c = k ? k - 1 : 0; !hit && c <= std::min(k + 1, dims[2] - 1); c++) {
+                                hit = source[(a * dims[1] + b) * dims[2] + c].real() != 0.0;
+                            }
+                        }
+                    }
+                    size_t cell = (i * dims[1] + j) * dims[2] + k;
+                    grid[cell] = source[cell].real() != 0.0 ? 1.0 : hit ? 0.5 : 0.0;
+                }
+            }
+        }
+    }, 4);
+}
+
+}  // namespace
+
+FFTLocalizer::FFTLocalizer(const TriangleMesh& target, double voxel_size) {
+    if (target.num_faces() == 0) {
+        throw std::invalid_argument("Cannot localise in a target without faces");
+    }
+    double lo[3], hi[3];
+    bounds(target, lo, hi);
+    double extent = std::max({hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]});
+    voxel_size_ = voxel_size > 0 ? voxel_size : extent / 96.0;
+    if (!(voxel_size_ > 0)) {
+        throw std::invalid_argument("Cannot localise in a degenerate target");
+    }
+
+    for (int d = 0; d < 3; d++) {
+        origin_[d] = lo[d] - double(PADDING) * voxel_size_;
+        occupied_[d] = size_t(std::floor((hi[d] - lo[d]) / voxel_size_)) + 1 + 2 * PADDING;
+        dims_[d] = fft_size(occupied_[d]);
+    }
+    spectrum_.assign(dims_[0] * dims_[1] * dims_[2], 0.0);
+    voxelise(target, origin_, voxel_size_, dims_, spectrum_);
+    dilate(spectrum_, dims_);
+    fft3d(spectrum_, dims_, false);
+}
+
+std::vector<TranslationPeak> FFTLocalizer::locate(const TriangleMesh& template_mesh, size_t max_peaks,
+                                                  double min_score) const {
+    std::vector<TranslationPeak> peaks;
+    if (template_mesh.num_faces() == 0 || max_peaks == 0) {
+        return peaks;
+    }
+    double lo[3], hi[3];
+    bounds(template_mesh, lo, hi);
+    size_t extent[3], shifts[3];
+    for (int d = 0; d < 3; d++) {
+        extent[d] = size_t(std::floor((hi[d] - lo[d]) / voxel_size_)) + 1;
+        if (extent[d] > occupied_[d]) {
+            return peaks;
+        }
+        shifts[d] = occupied_[d] - extent[d] + 1;   // placements fully inside the target grid
+    }
+
+    // Correlation c[s] = sum_x template[x] * target[x + s] = IFFT(conj(FFT(template)) * FFT(target))
+    std::vector<Complex> grid(spectrum_.size(), 0.0);
+    double template_voxels = double(voxelise(template_mesh, lo, voxel_size_, dims_, grid));
+    fft3d(grid, dims_, false);
+    for (size_t i = 0; i < grid.size(); i++) {
+        grid[i] = std::conj(grid[i]) * spectrum_[i];
+    }
+    fft3d(grid, dims_, true);
+
+    auto score = [&](size_t i, size_t j, size_t k) {
+        return grid[(i * dims_[1] + j) * dims_[2] + k].real() / template_voxels;
+    };
+
+    // Local maxima above min_score, strongest first
+    struct Candidate {
+        double score;
+        size_t cell[3];
+    };
+    std::vector<Candidate> candidates;
+    for (size_t i = 0; i < shifts[0]; i++) {
+        for (size_t j = 0; j < shifts[1]; j++) {
+            for (size_t k = 0; k < shifts[2]; k++) {
+                double value = score(i, j, k);
+                if (value < min_score) {
+                    continue;
+                }
+                bool maximum = true;
+                for (size_t a = i ? i - 1 : 0; maximum && a <= std::min(i + 1, shifts[0] - 1); a++) {
+                    for (size_t b = j ? j - 1 : 0; maximum && b <= std::min(j + 1, shifts[1] - 1); b++) {
+                        for (size_t c = k ? k - 1 : 0; maximum && c <= std::min(k + 1, shifts[2] - 1); c++) {
+                            maximum = score(a, b, c) <= value;
+                        }
+                    }
+                }
+                if (maximum) {
+                    candidates.push_back({value, {i, j, k}});
+                }
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.score > b.score;
+    });
+
+    // Non-maximum suppression: instances cannot overlap by more than half the template
+    double separation = 0.5 * double(std::max({extent[0], extent[1], extent[2]}));
+    std::vector<const Candidate*> kept;
+    for (const Candidate& candidate : candidates) {
+        bool suppressed = false;
+        for (const Candidate* other : kept) {
+            double d2 = 0.0;
+            for (int d = 0; d < 3; d++) {
+                double delta = double(candidate.cell[d]) - double(other->cell[d]);
+                d2 += delta * delta;
+            }
+            suppressed = suppressed || d2 < separation * separation;
+        }
+        if (suppressed) {
+            continue;
+        }
+        kept.push_back(&candidate);
+        TranslationPeak peak;
+        for (int d = 0; d < 3; d++) {
+            peak.translation[d] = origin_[d] + double(candidate.cell[d]) * voxel_size_ - lo[d];
+        }
+        peak.score = std::min(candidate.score, 1.0);
+        peaks.push_back(peak);
+        if (peaks.size() == max_peaks) {
+            break;
+        }
+    }
+    return peaks;
+}
+
+}  // namespace meshmind
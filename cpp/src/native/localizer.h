@@ -0,0 +1,49 @@
+/**
+ * MeshMind-AFID Native Engine: FFT Localisation
+ *
+ * Coarse translational search for bulky features (wheels, fans): target and
+ * template surfaces are voxelised into occupancy grids and all translations
+ * of the template are scored at once by FFT cross-correlation. The best
+ * translations seed descriptor matching around them.
+ */
+
+#pragma once
+
+#include "native/fft.h"
+#include "native/mesh.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace meshmind {
+
+struct TranslationPeak {
+    double translation[3];   /* template coordinates -> target coordinates */
+    double score;            /* fraction of template surface voxels on the target surface (1 = all) */
+};
+
+class FFTLocalizer {
+public:
+    /* voxel_size <= 0 uses 1/96 of the target's largest extent */
+    explicit FFTLocalizer(const TriangleMesh& target, double voxel_size = 0.0);
+
+    double voxel_size() const { return voxel_size_; }
+    const size_t* dims() const { return dims_; }
+
+    /**
+     * Best translations of the template, strongest first. Peaks closer than
+     * half the template's largest extent to a stronger one are suppressed.
+     * The template must fit inside the target's bounding box.
+     */
+    std::vector<TranslationPeak> locate(const TriangleMesh& template_mesh, size_t max_peaks = 4,
+                                        double min_score = 0.3) const;
+
+private:
+    double origin_[3];
+    double voxel_size_;
+    size_t occupied_[3];   /* extent of the voxelised target within the grid */
+    size_t dims_[3];       /* FFT grid */
+    std::vector<Complex> spectrum_;
+};
+
+}  // namespace meshmind
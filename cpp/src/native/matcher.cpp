@@ -0,0 +1,282 @@
+/**
+ * MeshMind-AFID Native Engine: Template Matching
+ */
+
+#include "native/matcher.h"
+
+#include "native/descriptors.h"
+#include "native/morton.h"
+#include "native/parallel.h"
+#include "native/registration.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace meshmind {
+
+namespace {
+
+/* Bounding box diagonal of a point set; the scale of automatic thresholds */
+double diagonal(const std::vector<double>& points) {
+    double lo[3] = {HUGE_VAL, HUGE_VAL, HUGE_VAL}, hi[3] = {-HUGE_VAL, -HUGE_VAL, -HUGE_VAL};
+    for (size_t i = 0; i < points.size() / 3; i++) {
+        for (int d = 0; d < 3; d++) {
+            lo[d] = std::min(lo[d], points[3 * i + d]);
+            hi[d] = std::max(hi[d], points[3 * i + d]);
+        }
+    }
+    return std::sqrt((hi[0] - lo[0]) * (hi[0] - lo[0]) + (hi[1] - lo[1]) * (hi[1] - lo[1]) +
+                     (hi[2] - lo[2]) * (hi[2] - lo[2]));
+}
+
+/* Nearest target descriptor for each query descriptor; returns the mean distance */
+double nearest_descriptors(
+    const KDTree& index,
+    const std::vector<double>& queries,
+    std::vector<size_t>& matches
+) {
+    const size_t count = queries.size() / FPFH_DIMS;
+    matches.assign(count, 0);
+    std::vector<double> distances(count, 0.0);
+
+    parallel_for(count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            double d2 = 0.0;
+            index.knn(&queries[i * FPFH_DIMS], 1, &matches[i], &d2);
+            distances[i] = std::sqrt(d2);
+        }
+    }, 64);
+
+    double sum = 0.0;
+    for (double d : distances) {
+        sum += d;
+    }
+    return count > 0 ? sum / double(count) : 0.0;
+}
+
+}  // namespace
+
+PreparedTemplate::PreparedTemplate(TriangleMesh mesh, const MatcherParams& params)
+    : mesh_(std::move(mesh)), params_(params) {}
+
+const TemplateLevel& PreparedTemplate::level(size_t level) const {
+    if (level >= NUM_LEVELS) {
+        throw std::out_of_range("Template level of detail out of range");
+    }
+    std::call_once(computed_[level], [&]() {
+        auto lod = std::make_shared<TemplateLevel>();
+        if (level + 1 < NUM_LEVELS) {
+            lod->points = sample_surface(mesh_, level == 0 ? params_.lod_points : params_.coarse_points, params_.seed);
+        } else {
+            lod->points.points = mesh_.vertices;
+            morton_sort(lod->points);
+            lod->points.normals = estimate_normals(lod->points.points.data(), lod->points.size(),
+                                                   params_.radius_normal);
+        }
+        lod->features = compute_fpfh(lod->points.view(), params_.radius_feature);
+        levels_[level] = std::move(lod);
+        ready_[level] = true;
+    });
+    return *levels_[level];
+}
+
+bool PreparedTemplate::computed(size_t level) const {
+    return level < NUM_LEVELS && ready_[level];
+}
+
+void PreparedTemplate::restore(size_t level, TemplateLevel data) {
+    if (level >= NUM_LEVELS) {
+        throw std::out_of_range("Template level of detail out of range");
+    }
+    if (data.features.size() != data.points.size() * FPFH_DIMS ||
+        (!data.points.normals.empty() && data.points.normals.size() != data.points.points.size())) {
+        throw std::invalid_argument("Template level has mismatched points, normals and descriptors");
+    }
+    install(level, std::make_shared<const TemplateLevel>(std::move(data)));
+}
+
+std::shared_ptr<PreparedTemplate> PreparedTemplate::with_coarse_points(size_t coarse_points) const {
+    MatcherParams params = params_;
+    params.coarse_points = coarse_points;
+    auto resampled = std::make_shared<PreparedTemplate>(mesh_, params);
+    for (size_t level = 0; level < NUM_LEVELS; level++) {
+        if (level != 1 && computed(level)) {
+            resampled->install(level, levels_[level]);
+        }
+    }
+    return resampled;
+}
+
+void PreparedTemplate::install(size_t level, std::shared_ptr<const TemplateLevel> data) {
+    std::call_once(computed_[level], [&]() {
+        levels_[level] = std::move(data);
+        ready_[level] = true;
+    });
+}
+
+TemplateMatcher::TemplateMatcher(const TriangleMesh& target, const MatcherParams& params)
+    : TemplateMatcher(sample_surface(target, params.coarse_points, params.seed), params) {}
+
+TemplateMatcher::TemplateMatcher(const PointSet& samples, const MatcherParams& params)
+    : params_(params),
+      coarse_points_(samples.points) {
+    features_ = compute_fpfh(samples.view(), params.radius_feature);
+    feature_index_ = KDTree(features_.data(), size(), FPFH_DIMS);
+}
+
+TemplateMatcher::TemplateMatcher(
+    std::vector<double> coarse_points,
+    std::vector<double> features,
+    const MatcherParams& params
+)
+    : params_(params),
+      coarse_points_(std::move(coarse_points)),
+      features_(std::move(features)) {
+    if (features_.size() != size() * FPFH_DIMS) {
+        throw std::invalid_argument("Target index has mismatched samples and descriptors");
+    }
+    params_.coarse_points = size();
+    feature_index_ = KDTree(features_.data(), size(), FPFH_DIMS);
+}
+
+MatchResult TemplateMatcher::match(const TriangleMesh& template_mesh) const {
+    return match(PreparedTemplate(template_mesh, params_));
+}
+
+TemplateDetection TemplateMatcher::detect(const TriangleMesh& template_mesh) const {
+    return detect(PreparedTemplate(template_mesh, params_));
+}
+
+LevelMatch TemplateMatcher::match_level(const PreparedTemplate& tmpl, size_t level) const {
+    LevelMatch result;
+    result.feature_distance = nearest_descriptors(feature_index_, tmpl.level(level).features, result.matches);
+    return result;
+}
+
+MatchResult TemplateMatcher::match(const PreparedTemplate& tmpl) const {
+    MatchResult result;
+
+    // Step 1: coarse matching on surface samples
+    LevelMatch coarse = match_level(tmpl, 1);
+    result.template_samples = tmpl.level(1).points;
+    result.coarse_feature_distance = coarse.feature_distance;
+    result.coarse_matches = std::move(coarse.matches);
+
+    // Step 2: fine matching of all template vertices against the coarse target, reported in vertex order
+    LevelMatch fine = match_level(tmpl, 2);
+    const std::vector<uint32_t>& order = tmpl.level(2).points.order;
+    result.mean_feature_distance = fine.feature_distance;
+    result.matches.resize(fine.matches.size());
+    for (size_t k = 0; k < order.size(); k++) {
+        result.matches[order[k]] = fine.matches[k];
+    }
+
+    result.confidence = 1.0 / (1.0 + result.mean_feature_distance);
+    return result;
+}
+
+TemplateDetection TemplateMatcher::detect(const PreparedTemplate& tmpl) const {
+    return detect(tmpl, RansacParams());
+}
+
+std::vector<double> TemplateMatcher::matched_points(const MatchResult& match_info) const {
+    const size_t count = match_info.template_samples.size();
+    std::vector<double> target_points(count * 3);
+    for (size_t i = 0; i < count; i++) {
+        for (int d = 0; d < 3; d++) {
+            target_points[3 * i + d] = coarse_points_[3 * match_info.coarse_matches[i] + d];
+        }
+    }
+    return target_points;
+}
+
+TemplateDetection TemplateMatcher::detect(const PreparedTemplate& tmpl, const RobustParams& robust) const {
+    MatchResult match_info = match(tmpl);
+    const size_t count = match_info.template_samples.size();
+    if (count < 3) {
+        return detect(tmpl);
+    }
+
+    TemplateDetection detection;
+    detection.confidence = match_info.confidence;
+    detection.mean_feature_distance = match_info.mean_feature_distance;
+
+    const std::vector<double>& samples = match_info.template_samples.points;
+    std::vector<double> target_points = matched_points(match_info);
+    RobustParams params = robust;
+    if (!(params.noise_bound > 0)) {
+        double size = diagonal(samples);
+        params.noise_bound = size > 0 ? 0.025 * size : 0.5;
+    }
+    RobustPose pose = robust_registration(samples.data(), target_points.data(), count, params);
+    std::copy(pose.pose.transform, pose.pose.transform + 16, detection.transform);
+    detection.alignment_cost = pose.pose.cost;
+    return detection;
+}
+
+TemplateDetection TemplateMatcher::detect(const PreparedTemplate& tmpl, const RansacParams& ransac) const {
+    MatchResult match_info = match(tmpl);
+
+    TemplateDetection detection;
+    detection.confidence = match_info.confidence;
+    detection.mean_feature_distance = match_info.mean_feature_distance;
+
+    const size_t count = match_info.template_samples.size();
+    std::vector<double> target_points = matched_points(match_info);
+
+    const std::vector<double>& samples = match_info.template_samples.points;
+    if (ransac.iterations > 0 && count >= 3) {
+        RansacParams params = ransac;
+        if (!(params.inlier_threshold > 0)) {
+            double size = diagonal(samples);
+            params.inlier_threshold = size > 0 ? 0.05 * size : 1.0;
+        }
+        RansacPose pose = ransac_procrustes(samples.data(), target_points.data(), count, params);
+        std::copy(pose.pose.transform, pose.pose.transform + 16, detection.transform);
+        detection.alignment_cost = pose.pose.cost;
+        return detection;
+    }
+
+    try {
+        Pose pose = procrustes(samples.data(), target_points.data(), count);
+        std::copy(pose.transform, pose.transform + 16, detection.transform);
+        detection.alignment_cost = pose.cost;
+    } catch (const std::invalid_argument&) {
+        // Too few points: fall back to a centroid shift, as the Python detector does
+        double shift[3] = {0, 0, 0};
+        for (size_t i = 0; i < count; i++) {
+            for (int d = 0; d < 3; d++) {
+                shift[d] += target_points[3 * i + d] - samples[3 * i + d];
+            }
+        }
+        for (int k = 0; k < 16; k++) {
+            detection.transform[k] = (k % 5 == 0) ? 1.0 : 0.0;
+        }
+        for (int d = 0; d < 3; d++) {
+            detection.transform[d * 4 + 3] = count > 0 ? shift[d] / double(count) : 0.0;
+        }
+        detection.alignment_cost = 1.0;
+    }
+    return detection;
+}
+
+std::vector<bool> promote_candidates(
+    const std::vector<double>& distances,
+    const std::vector<int>& groups,
+    double margin
+) {
+    std::unordered_map<int, double> best;
+    for (size_t i = 0; i < distances.size(); i++) {
+        auto it = best.emplace(groups[i], distances[i]).first;
+        it->second = std::min(it->second, distances[i]);
+    }
+    std::vector<bool> promoted(distances.size());
+    for (size_t i = 0; i < distances.size(); i++) {
+        promoted[i] = distances[i] <= best[groups[i]] * (1.0 + margin);
+    }
+    return promoted;
+}
+
+}  // namespace meshmind
@@ -0,0 +1,173 @@
+/**
+ * MeshMind-AFID Native Engine: Template Matching
+ *
+ * Native counterpart of meshmind.core.matcher.TemplateMatcher and
+ * meshmind.core.recognition.fpfh_matcher.FPFHFeatureDetector: the target is
+ * prepared once (coarse surface samples + FPFH + descriptor index) and each
+ * template is matched against it.
+ */
+
+#pragma once
+
+#include "native/kdtree.h"
+#include "native/mesh.h"
+#include "native/registration.h"
+#include "native/robust.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace meshmind {
+
+struct MatcherParams {
+    size_t lod_points = 64;        /* template samples at the lowest level of detail */
+    size_t coarse_points = 500;
+    double radius_normal = 0.1;
+    double radius_feature = 0.25;
+    uint64_t seed = 0;
+};
+
+/* Template points and their descriptors at one level of detail */
+struct TemplateLevel {
+    PointSet points;
+    std::vector<double> features;   /* [size * FPFH_DIMS] */
+};
+
+/**
+ * A template with its levels of detail, each computed on first use:
+ *   0: lod_points surface samples
+ *   1: coarse_points surface samples (used for pose estimation)
+ *   2: all vertices with estimated normals
+ * Points of every level are in Morton order (see PointSet::order).
+ * Levels do not depend on the target, so a prepared template can be
+ * reused across targets. Levels may be requested from several threads.
+ */
+class PreparedTemplate {
+public:
+    static constexpr size_t NUM_LEVELS = 3;
+
+    explicit PreparedTemplate(TriangleMesh mesh, const MatcherParams& params = MatcherParams());
+
+    const TriangleMesh& mesh() const { return mesh_; }
+    const MatcherParams& params() const { return params_; }
+    const TemplateLevel& level(size_t level) const;
+
+    /* Whether a level has been computed (or restored) yet */
+    bool computed(size_t level) const;
+
+    /* Install a level computed earlier, e.g. read from a snapshot; ignored if already computed */
+    void restore(size_t level, TemplateLevel data);
+
+    /*
+     * The same template with another number of coarse samples. Levels 0 and
+     * 2 do not depend on it and are shared with this template if computed.
+     */
+    std::shared_ptr<PreparedTemplate> with_coarse_points(size_t coarse_points) const;
+
+private:
+    void install(size_t level, std::shared_ptr<const TemplateLevel> data);
+
+    TriangleMesh mesh_;
+    MatcherParams params_;
+    mutable std::once_flag computed_[NUM_LEVELS];
+    mutable std::atomic<bool> ready_[NUM_LEVELS] = {};
+    mutable std::shared_ptr<const TemplateLevel> levels_[NUM_LEVELS];
+};
+
+/* Nearest target sample for each point of one template level, in the level's point order */
+struct LevelMatch {
+    double feature_distance = 0.0;   /* mean descriptor distance */
+    std::vector<size_t> matches;
+};
+
+struct MatchResult {
+    double confidence = 0.0;               /* 1 / (1 + mean_feature_distance) */
+    double mean_feature_distance = 0.0;    /* all template vertices vs. target index */
+    double coarse_feature_distance = 0.0;  /* coarse template samples vs. target index */
+    std::vector<size_t> matches;           /* nearest target sample per template vertex */
+
+    PointSet template_samples;             /* coarse template samples */
+    std::vector<size_t> coarse_matches;    /* nearest target sample per template sample */
+};
+
+/* One template located in the target, as produced by FPFHFeatureDetector */
+struct TemplateDetection {
+    double transform[16];
+    double confidence;
+    double mean_feature_distance;
+    double alignment_cost;
+};
+
+class TemplateMatcher {
+public:
+    explicit TemplateMatcher(const TriangleMesh& target, const MatcherParams& params = MatcherParams());
+
+    /* Prepare from given target samples, e.g. restricted to a search region */
+    explicit TemplateMatcher(const PointSet& samples, const MatcherParams& params = MatcherParams());
+
+    /* Rebuild from a stored index (coarse samples + descriptors), e.g. from a snapshot */
+    TemplateMatcher(
+        std::vector<double> coarse_points,
+        std::vector<double> features,
+        const MatcherParams& params = MatcherParams()
+    );
+
+    MatchResult match(const TriangleMesh& template_mesh) const;
+
+    /* Match and estimate the template pose by Procrustes on descriptor correspondences */
+    TemplateDetection detect(const TriangleMesh& template_mesh) const;
+
+    /* Match one level of detail, e.g. to reject a template before its full-resolution match */
+    LevelMatch match_level(const PreparedTemplate& tmpl, size_t level) const;
+
+    MatchResult match(const PreparedTemplate& tmpl) const;
+    TemplateDetection detect(const PreparedTemplate& tmpl) const;
+
+    /**
+     * Detect with the pose estimated by RANSAC over the coarse descriptor
+     * correspondences (see ransac_procrustes) instead of Procrustes on all of
+     * them. A threshold <= 0 uses 5% of the template's bounding box diagonal;
+     * zero iterations is plain detect().
+     */
+    TemplateDetection detect(const PreparedTemplate& tmpl, const RansacParams& ransac) const;
+
+    /**
+     * Detect with the pose from max-clique registration (see
+     * robust_registration), for correspondence sets too contaminated for
+     * RANSAC to sample an all-inlier hypothesis. A noise bound <= 0 uses
+     * 2.5% of the template's bounding box diagonal.
+     */
+    TemplateDetection detect(const PreparedTemplate& tmpl, const RobustParams& robust) const;
+
+    const MatcherParams& params() const { return params_; }
+    size_t size() const { return coarse_points_.size() / 3; }
+    const std::vector<double>& coarse_points() const { return coarse_points_; }
+    const std::vector<double>& features() const { return features_; }
+    const KDTree& feature_index() const { return feature_index_; }
+
+private:
+    /* Coarse target points matched to each template sample [count * 3] */
+    std::vector<double> matched_points(const MatchResult& match_info) const;
+
+    MatcherParams params_;
+    std::vector<double> coarse_points_;   /* [size * 3] */
+    std::vector<double> features_;        /* [size * FPFH_DIMS] */
+    KDTree feature_index_;
+};
+
+/**
+ * Early rejection between levels of detail: of the candidates with the
+ * given distances at one level, keep those within (1 + margin) of the best
+ * distance in their group (e.g. feature type).
+ */
+std::vector<bool> promote_candidates(
+    const std::vector<double>& distances,
+    const std::vector<int>& groups,
+    double margin
+);
+
+}  // namespace meshmind
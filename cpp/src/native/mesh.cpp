@@ -0,0 +1,387 @@
+/**
+ * MeshMind-AFID Native Engine: Mesh Loading and Sampling
+ */
+
+#include "native/mesh.h"
+#include "native/morton.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace meshmind {
+
+namespace {
+
+struct VertexKey {
+    double x, y, z;
+    bool operator==(const VertexKey& other) const {
+        return x == other.x && y == other.y && z == other.z;
+    }
+};
+
+struct VertexKeyHash {
+    size_t operator()(const VertexKey& key) const {
+        uint64_t bits[3];
+        std::memcpy(&bits[0], &key.x, sizeof(double));
+        std::memcpy(&bits[1], &key.y, sizeof(double));
+        std::memcpy(&bits[2], &key.z, sizeof(double));
+        uint64_t h = bits[0] * 0x9E3779B97F4A7C15ULL;
+        h ^= bits[1] + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+        h ^= bits[2] + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+        return static_cast<size_t>(h);
+    }
+};
+
+/* Builds an indexed mesh from triangle soup, merging identical vertices */
+class SoupBuilder {
+public:
+    void add_triangle(const double* a, const double* b, const double* c) {
+        mesh.faces.push_back(vertex_index(a));
+        mesh.faces.push_back(vertex_index(b));
+        mesh.faces.push_back(vertex_index(c));
+    }
+
+    TriangleMesh mesh;
+
+private:
+    int32_t vertex_index(const double* p) {
+        VertexKey key{p[0], p[1], p[2]};
+        auto it = lookup.find(key);
+        if (it != lookup.end()) {
+            return it->second;
+        }
+        int32_t index = static_cast<int32_t>(mesh.num_vertices());
+        mesh.vertices.insert(mesh.vertices.end(), p, p + 3);
+        lookup.emplace(key, index);
+        return index;
+    }
+
+    std::unordered_map<VertexKey, int32_t, VertexKeyHash> lookup;
+};
+
+TriangleMesh load_binary_stl(const std::string& data, const std::string& path) {
+    uint32_t count = 0;
+    std::memcpy(&count, data.data() + 80, sizeof(count));
+    if (data.size() < 84 + size_t(count) * 50) {
+        throw std::runtime_error("Truncated binary STL: " + path);
+    }
+
+    SoupBuilder builder;
+    const char* record = data.data() + 84;
+    for (uint32_t t = 0; t < count; t++, record += 50) {
+        float coords[9];
+        std::memcpy(coords, record + 12, sizeof(coords));  // skip facet normal
+        double tri[9];
+        for (int i = 0; i < 9; i++) {
+            tri[i] = coords[i];
+        }
+        builder.add_triangle(tri, tri + 3, tri + 6);
+    }
+    return std::move(builder.mesh);
+}
+
+TriangleMesh load_ascii_stl(const std::string& data, const std::string& path) {
+    SoupBuilder builder;
+    std::istringstream in(data);
+    std::string token;
+    double tri[9];
+    int corner = 0;
+    int32_t part = -1;
+    while (in >> token) {
+        if (token == "solid") {
+            part++;
+        } else if (token == "vertex") {
+            if (corner == 3 ||
+                !(in >> tri[corner * 3] >> tri[corner * 3 + 1] >> tri[corner * 3 + 2])) {
+                throw std::runtime_error("Malformed ASCII STL: " + path);
+            }
+            corner++;
+        } else if (token == "endloop") {
+            if (corner != 3) {
+                throw std::runtime_error("Non-triangular facet in ASCII STL: " + path);
+            }
+            builder.add_triangle(tri, tri + 3, tri + 6);
+            builder.mesh.parts.push_back(std::max(part, 0));
+            corner = 0;
+        }
+    }
+    if (part <= 0) {
+        builder.mesh.parts.clear();
+    }
+    return std::move(builder.mesh);
+}
+
+TriangleMesh load_obj(const std::string& data, const std::string& path) {
+    TriangleMesh mesh;
+    std::istringstream in(data);
+    std::string line;
+    std::vector<int32_t> polygon;
+    std::unordered_map<std::string, int32_t> groups;
+    std::string group;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string tag;
+        fields >> tag;
+        if (tag == "g" || tag == "o") {
+            std::getline(fields >> std::ws, group);
+        } else if (tag == "v") {
+            double p[3];
+            if (!(fields >> p[0] >> p[1] >> p[2])) {
+                throw std::runtime_error("Malformed OBJ vertex: " + path);
+            }
+            mesh.vertices.insert(mesh.vertices.end(), p, p + 3);
+        } else if (tag == "f") {
+            polygon.clear();
+            std::string corner;
+            while (fields >> corner) {
+                // "v", "v/vt", "v//vn" or "v/vt/vn"; negative indices are relative
+                long index = std::stol(corner.substr(0, corner.find('/')));
+                index = index < 0 ? static_cast<long>(mesh.num_vertices()) + index : index - 1;
+                if (index < 0 || index >= static_cast<long>(mesh.num_vertices())) {
+                    throw std::runtime_error("OBJ face index out of range: " + path);
+                }
+                polygon.push_back(static_cast<int32_t>(index));
+            }
+            int32_t part = groups.emplace(group, int32_t(groups.size())).first->second;
+            // Fan triangulation of polygons
+            for (size_t i = 1; i + 1 < polygon.size(); i++) {
+                mesh.faces.push_back(polygon[0]);
+                mesh.faces.push_back(polygon[i]);
+                mesh.faces.push_back(polygon[i + 1]);
+                mesh.parts.push_back(part);
+            }
+        }
+    }
+    if (groups.size() <= 1) {
+        mesh.parts.clear();
+    }
+    return mesh;
+}
+
+/* Whitespace-separated numbers with '#' comments, as used by OFF files */
+class Tokenizer {
+public:
+    Tokenizer(const char* begin, const char* end) : cursor(begin), end(end) {}
+
+    bool next(double& value) {
+        skip();
+        if (cursor == end) {
+            return false;
+        }
+        char* stop = nullptr;
+        value = std::strtod(cursor, &stop);
+        if (stop == cursor) {
+            return false;
+        }
+        cursor = stop;
+        return true;
+    }
+
+    bool next(long& value) {
+        double number;
+        if (!next(number) || number != std::floor(number)) {
+            return false;
+        }
+        value = static_cast<long>(number);
+        return true;
+    }
+
+    /* Discard the rest of the current line */
+    void skip_line() {
+        while (cursor != end && *cursor++ != '\n') {
+        }
+    }
+
+private:
+    void skip() {
+        while (cursor != end) {
+            if (std::isspace(static_cast<unsigned char>(*cursor))) {
+                cursor++;
+            } else if (*cursor == '#') {
+                while (cursor != end && *cursor != '\n') {
+                    cursor++;
+                }
+            } else {
+                break;
+            }
+        }
+    }
+
+    const char* cursor;
+    const char* end;
+};
+
+TriangleMesh load_off(const std::string& data, const std::string& path) {
+    // Header "OFF"; some exporters (e.g. ModelNet) write the counts on the same line ("OFF490 518 0")
+    size_t start = data.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos || data.compare(start, 3, "OFF") != 0) {
+        throw std::runtime_error("Not an OFF file: " + path);
+    }
+    Tokenizer tokens(data.data() + start + 3, data.data() + data.size());
+
+    long num_vertices = 0, num_faces = 0, num_edges = 0;
+    if (!tokens.next(num_vertices) || !tokens.next(num_faces) || !tokens.next(num_edges) ||
+        num_vertices < 0 || num_faces < 0) {
+        throw std::runtime_error("Malformed OFF header: " + path);
+    }
+
+    TriangleMesh mesh;
+    mesh.vertices.resize(size_t(num_vertices) * 3);
+    for (double& coordinate : mesh.vertices) {
+        if (!tokens.next(coordinate)) {
+            throw std::runtime_error("Malformed OFF vertex: " + path);
+        }
+    }
+
+    mesh.faces.reserve(size_t(num_faces) * 3);
+    std::vector<int32_t> polygon;
+    for (long f = 0; f < num_faces; f++) {
+        long corners = 0;
+        if (!tokens.next(corners) || corners < 0) {
+            throw std::runtime_error("Malformed OFF face: " + path);
+        }
+        polygon.resize(size_t(corners));
+        for (auto& index : polygon) {
+            long value = 0;
+            if (!tokens.next(value) || value < 0 || value >= num_vertices) {
+                throw std::runtime_error("OFF face index out of range: " + path);
+            }
+            index = static_cast<int32_t>(value);
+        }
+        // Optional per-face colours follow on the same line
+        tokens.skip_line();
+        for (size_t i = 1; i + 1 < polygon.size(); i++) {
+            mesh.faces.push_back(polygon[0]);
+            mesh.faces.push_back(polygon[i]);
+            mesh.faces.push_back(polygon[i + 1]);
+        }
+    }
+    return mesh;
+}
+
+/* face_ids == nullptr samples all faces */
+PointSet sample_faces(const TriangleMesh& mesh, const int32_t* face_ids, size_t num_faces,
+                      size_t count, uint64_t seed) {
+    if (num_faces == 0) {
+        throw std::runtime_error("Cannot sample a mesh without faces");
+    }
+
+    const double* v = mesh.vertices.data();
+    const int32_t* f = mesh.faces.data();
+
+    std::vector<double> cumulative_area(num_faces);
+    std::vector<double> face_normals(num_faces * 3);
+    double total = 0.0;
+    for (size_t t = 0; t < num_faces; t++) {
+        size_t face = face_ids ? size_t(face_ids[t]) : t;
+        const double* a = v + 3 * f[3 * face];
+        const double* b = v + 3 * f[3 * face + 1];
+        const double* c = v + 3 * f[3 * face + 2];
+        double e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        double e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+        double n[3] = {e1[1] * e2[2] - e1[2] * e2[1],
+                       e1[2] * e2[0] - e1[0] * e2[2],
+                       e1[0] * e2[1] - e1[1] * e2[0]};
+        double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        total += 0.5 * length;
+        cumulative_area[t] = total;
+        if (length > 0) {
+            for (int k = 0; k < 3; k++) {
+                face_normals[3 * t + k] = n[k] / length;
+            }
+        }
+    }
+    if (total <= 0) {
+        throw std::runtime_error("Cannot sample a mesh with zero surface area");
+    }
+
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    PointSet samples;
+    samples.points.resize(count * 3);
+    samples.normals.resize(count * 3);
+    for (size_t i = 0; i < count; i++) {
+        double target = uniform(rng) * total;
+        size_t t = std::upper_bound(cumulative_area.begin(), cumulative_area.end(), target) -
+                   cumulative_area.begin();
+        t = std::min(t, num_faces - 1);
+
+        double r1 = uniform(rng);
+        double r2 = uniform(rng);
+        if (r1 + r2 > 1.0) {
+            r1 = 1.0 - r1;
+            r2 = 1.0 - r2;
+        }
+
+        size_t face = face_ids ? size_t(face_ids[t]) : t;
+        const double* a = v + 3 * f[3 * face];
+        const double* b = v + 3 * f[3 * face + 1];
+        const double* c = v + 3 * f[3 * face + 2];
+        for (int k = 0; k < 3; k++) {
+            samples.points[3 * i + k] = a[k] + r1 * (b[k] - a[k]) + r2 * (c[k] - a[k]);
+            samples.normals[3 * i + k] = face_normals[3 * t + k];
+        }
+    }
+    morton_sort(samples);
+    return samples;
+}
+
+}  // namespace
+
+TriangleMesh load_mesh(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open mesh file: " + path);
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    std::string ext = std::filesystem::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+    if (ext == ".obj") {
+        return load_obj(data, path);
+    }
+    if (ext == ".off") {
+        return load_off(data, path);
+    }
+    if (ext != ".stl") {
+        throw std::runtime_error("Unsupported mesh format: " + path);
+    }
+
+    // Binary STL files can also start with "solid", so check the size first
+    if (data.size() >= 84) {
+        uint32_t count = 0;
+        std::memcpy(&count, data.data() + 80, sizeof(count));
+        if (data.size() == 84 + size_t(count) * 50) {
+            return load_binary_stl(data, path);
+        }
+    }
+    if (data.compare(0, 5, "solid") == 0) {
+        return load_ascii_stl(data, path);
+    }
+    if (data.size() >= 84) {
+        return load_binary_stl(data, path);
+    }
+    throw std::runtime_error("Not an STL file: " + path);
+}
+
+PointSet sample_surface(const TriangleMesh& mesh, size_t count, uint64_t seed) {
+    return sample_faces(mesh, nullptr, mesh.num_faces(), count, seed);
+}
+
+PointSet sample_surface(const TriangleMesh& mesh, const std::vector<int32_t>& faces, size_t count, uint64_t seed) {
+    return sample_faces(mesh, faces.data(), faces.size(), count, seed);
+}
+
+}  // namespace meshmind
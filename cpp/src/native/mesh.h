@@ -0,0 +1,64 @@
+/**
+ * MeshMind-AFID Native Engine: Mesh Data
+ *
+ * Plain triangle meshes and point sets. Coordinates are stored as
+ * interleaved XYZ doubles (N x 3, row-major) so they can be shared with
+ * NumPy arrays without copying.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace meshmind {
+
+struct TriangleMesh {
+    std::vector<double> vertices;   /* [num_vertices * 3] */
+    std::vector<int32_t> faces;     /* [num_faces * 3] vertex indices */
+    std::vector<int32_t> parts;     /* [num_faces] part ID per face, or empty for single-part meshes */
+
+    size_t num_vertices() const { return vertices.size() / 3; }
+    size_t num_faces() const { return faces.size() / 3; }
+};
+
+/* Non-owning view of N points (and optional per-point normals) */
+struct PointsView {
+    const double* points = nullptr;   /* [size * 3] */
+    const double* normals = nullptr;  /* [size * 3] or nullptr */
+    size_t size = 0;
+};
+
+/* Owned point samples with normals */
+struct PointSet {
+    std::vector<double> points;   /* [size * 3] */
+    std::vector<double> normals;  /* [size * 3] */
+    std::vector<uint32_t> order;  /* input index of each point if reordered (see morton_sort), else empty */
+
+    size_t size() const { return points.size() / 3; }
+    PointsView view() const {
+        return PointsView{points.data(), normals.empty() ? nullptr : normals.data(), size()};
+    }
+};
+
+/**
+ * Load an STL (ASCII or binary), OBJ or OFF file. Duplicate STL vertices are
+ * merged so the result is an indexed mesh. Parts are numbered in file order:
+ * one per "solid" of an ASCII STL and per distinct OBJ group ("g"/"o").
+ * @throws std::runtime_error on unreadable or malformed files
+ */
+TriangleMesh load_mesh(const std::string& path);
+
+/**
+ * Area-weighted uniform sampling of the mesh surface.
+ * Normals are the (unit) normals of the sampled faces. Samples are stored
+ * in Morton order (see morton_sort); order holds their draw index.
+ */
+PointSet sample_surface(const TriangleMesh& mesh, size_t count, uint64_t seed);
+
+/* Area-weighted sampling restricted to the given faces */
+PointSet sample_surface(const TriangleMesh& mesh, const std::vector<int32_t>& faces, size_t count, uint64_t seed);
+
+}  // namespace meshmind
@@ -0,0 +1,280 @@
+/**
+ * MeshMind-AFID Native Engine: MeshCNN Feature Extractor
+ */
+
+#include "native/meshcnn.h"
+
+#include "native/binary_io.h"
+#include "native/meshcnn_kernels_impl.h"
+#include "native/parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace meshmind {
+
+namespace {
+
+const char WEIGHTS_MAGIC[4] = {'M', 'M', 'N', 'N'};
+const uint32_t WEIGHTS_VERSION = 2;      /* version 1 has no input_scale */
+
+/* Vertices per work item */
+constexpr size_t CHUNK_ROWS = 256;
+
+void quantize_activations(const float* in, size_t count, float inv_scale, uint8_t* out) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = quantize_activation(in[i], inv_scale);
+    }
+}
+
+}  // namespace
+
+const MeshCNNKernels& meshcnn_kernels_baseline() {
+    static const MeshCNNKernels kernels = kernel_table("baseline");
+    return kernels;
+}
+
+const MeshCNNKernels& meshcnn_kernels() {
+    static const MeshCNNKernels& kernels = []() -> const MeshCNNKernels& {
+#if defined(MESHMIND_CPU_DISPATCH)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512vnni") && __builtin_cpu_supports("avx512vl")) {
+            return meshcnn_kernels_avx512vnni();
+        }
+#if defined(MESHMIND_CPU_DISPATCH_AVXVNNI)
+        if (__builtin_cpu_supports("avxvnni")) {
+            return meshcnn_kernels_avxvnni();
+        }
+#endif
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return meshcnn_kernels_avx2();
+        }
+#endif
+        return meshcnn_kernels_baseline();
+    }();
+    return kernels;
+}
+
+std::vector<MeshCNNLayer> read_meshcnn_weights(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open MeshCNN weights: " + path);
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    const size_t header = sizeof(WEIGHTS_MAGIC) + sizeof(uint32_t);
+    if (data.size() < header + sizeof(uint64_t) ||
+        std::memcmp(data.data(), WEIGHTS_MAGIC, sizeof(WEIGHTS_MAGIC)) != 0) {
+        throw std::runtime_error("Not a MeshCNN weights file: " + path);
+    }
+    uint32_t version = 0;
+    std::memcpy(&version, data.data() + sizeof(WEIGHTS_MAGIC), sizeof(version));
+    if (version < 1 || version > WEIGHTS_VERSION) {
+        throw std::runtime_error("Unsupported MeshCNN weights version: " + std::to_string(version));
+    }
+
+    const char* payload = data.data() + header;
+    size_t payload_size = data.size() - header - sizeof(uint64_t);
+    uint64_t checksum = 0;
+    std::memcpy(&checksum, payload + payload_size, sizeof(checksum));
+    if (checksum != fnv1a(payload, payload_size)) {
+        throw std::runtime_error("MeshCNN weights checksum mismatch: " + path);
+    }
+
+    BinaryReader reader(payload, payload_size, "MeshCNN weights file");
+    std::vector<MeshCNNLayer> layers(reader.read<uint32_t>());
+    for (auto& layer : layers) {
+        layer.in_dim = reader.read<uint32_t>();
+        layer.out_dim = reader.read<uint32_t>();
+        layer.eps = reader.read<float>();
+        if (version >= 2) {
+            layer.input_scale = reader.read<float>();
+        }
+        layer.weight = reader.read_array<float>(layer.out_dim * layer.in_dim);
+        layer.bias = reader.read_array<float>(layer.out_dim);
+        layer.gamma = reader.read_array<float>(layer.out_dim);
+        layer.beta = reader.read_array<float>(layer.out_dim);
+        layer.running_mean = reader.read_array<float>(layer.out_dim);
+        layer.running_var = reader.read_array<float>(layer.out_dim);
+    }
+    if (!reader.at_end()) {
+        throw std::runtime_error("Trailing data in MeshCNN weights file: " + path);
+    }
+    return layers;
+}
+
+MeshCNNExtractor::MeshCNNExtractor(const std::vector<MeshCNNLayer>& layers) {
+    if (layers.empty() || layers.front().in_dim != 3) {
+        throw std::invalid_argument("MeshCNN must take xyz vertex positions as input");
+    }
+
+    size_t in_dim = 3;
+    for (const auto& layer : layers) {
+        if (layer.in_dim != in_dim || layer.out_dim == 0 ||
+            layer.weight.size() != layer.out_dim * layer.in_dim || layer.bias.size() != layer.out_dim ||
+            layer.gamma.size() != layer.out_dim || layer.beta.size() != layer.out_dim ||
+            layer.running_mean.size() != layer.out_dim || layer.running_var.size() != layer.out_dim) {
+            throw std::invalid_argument("MeshCNN layer dimensions do not chain");
+        }
+
+        // Eval-mode BatchNorm: y = (x - mean) * gamma / sqrt(var + eps) + beta
+        FusedLayer fused;
+        fused.in_dim = layer.in_dim;
+        fused.out_dim = layer.out_dim;
+        fused.weights.resize(layer.in_dim * layer.out_dim);
+        fused.bias.resize(layer.out_dim);
+        for (size_t o = 0; o < layer.out_dim; o++) {
+            float scale = layer.gamma[o] / std::sqrt(layer.running_var[o] + layer.eps);
+            for (size_t k = 0; k < layer.in_dim; k++) {
+                fused.weights[k * layer.out_dim + o] = layer.weight[o * layer.in_dim + k] * scale;
+            }
+            fused.bias[o] = (layer.bias[o] - layer.running_mean[o]) * scale + layer.beta[o];
+        }
+        
+        if (layer.input_scale > 0.0f) {
+            if (layer.in_dim % 4 != 0 || layer.out_dim % 8 != 0) {
+                throw std::invalid_argument("INT8 MeshCNN layers need in_dim % 4 == 0 and out_dim % 8 == 0");
+            }
+            // Symmetric per-output-channel weight scales over the folded weights
+            fused.input_scale = layer.input_scale;
+            fused.qweights.resize(layer.in_dim * layer.out_dim);
+            fused.dequant.resize(layer.out_dim);
+            for (size_t o = 0; o < layer.out_dim; o++) {
+                float max_abs = 0.0f;
+                for (size_t k = 0; k < layer.in_dim; k++) {
+                    max_abs = std::max(max_abs, std::abs(fused.weights[k * layer.out_dim + o]));
+                }
+                float weight_scale = max_abs > 0.0f ? max_abs / 127.0f : 1.0f;
+                for (size_t k = 0; k < layer.in_dim; k++) {
+                    float q = std::nearbyint(fused.weights[k * layer.out_dim + o] / weight_scale);
+                    fused.qweights[(k / 4) * layer.out_dim * 4 + o * 4 + k % 4] =
+                        static_cast<int8_t>(std::max(-127.0f, std::min(127.0f, q)));
+                }
+                fused.dequant[o] = layer.input_scale * weight_scale;
+            }
+        }
+        layers_.push_back(std::move(fused));
+        in_dim = layer.out_dim;
+    }
+}
+
+bool MeshCNNExtractor::quantized() const {
+    return std::any_of(layers_.begin(), layers_.end(),
+                       [](const FusedLayer& layer) { return layer.input_scale > 0.0f; });
+}
+
+void MeshCNNExtractor::extract_chunk(const double* vertices, size_t begin, size_t end, float* pooled) const {
+    // Pad to whole tiles by repeating the last vertex; duplicates do not change a max pool
+    size_t count = end - begin;
+    size_t rows = (count + MESHCNN_TILE_ROWS - 1) / MESHCNN_TILE_ROWS * MESHCNN_TILE_ROWS;
+
+    size_t width = 3;
+    for (const auto& layer : layers_) {
+        width = std::max(width, layer.out_dim);
+    }
+    std::vector<float> a(rows * width);
+    std::vector<float> b(rows * width);
+
+    for (size_t r = 0; r < rows; r++) {
+        const double* v = vertices + 3 * (begin + std::min(r, count - 1));
+        a[3 * r] = float(v[0]);
+        a[3 * r + 1] = float(v[1]);
+        a[3 * r + 2] = float(v[2]);
+    }
+
+    // INT8 layers read qa; a layer followed by an INT8 layer requantises its output directly
+    std::vector<uint8_t> qa, qb;
+    if (quantized()) {
+        qa.resize(rows * width);
+        qb.resize(rows * width);
+    }
+    bool in_quantized = false;
+
+    const MeshCNNKernels& kernels = meshcnn_kernels();
+    for (size_t l = 0; l < layers_.size(); l++) {
+        const FusedLayer& layer = layers_[l];
+        bool last = l + 1 == layers_.size();
+        float next_scale = last ? 0.0f : layers_[l + 1].input_scale;
+
+        if (layer.input_scale <= 0.0f) {
+            if (last) {
+                kernels.dense_relu_pool(a.data(), rows, layer.in_dim, layer.weights.data(), layer.bias.data(),
+                                        layer.out_dim, pooled);
+                break;
+            }
+            kernels.dense_relu(a.data(), rows, layer.in_dim, layer.weights.data(), layer.bias.data(),
+                               layer.out_dim, b.data());
+            std::swap(a, b);
+            in_quantized = false;
+            continue;
+        }
+
+        if (!in_quantized) {
+            quantize_activations(a.data(), rows * layer.in_dim, 1.0f / layer.input_scale, qa.data());
+        }
+        const int8_t* w = layer.qweights.data();
+        if (last) {
+            kernels.dense_relu_int8[int(Int8Output::Pool)](qa.data(), rows, layer.in_dim, w, layer.dequant.data(),
+                                                           layer.bias.data(), layer.out_dim, pooled, nullptr, 0.0f);
+        } else if (next_scale > 0.0f) {
+            kernels.dense_relu_int8[int(Int8Output::Quantized)](qa.data(), rows, layer.in_dim, w, layer.dequant.data(),
+                                                                layer.bias.data(), layer.out_dim, nullptr, qb.data(),
+                                                                1.0f / next_scale);
+            std::swap(qa, qb);
+            in_quantized = true;
+        } else {
+            kernels.dense_relu_int8[int(Int8Output::Float)](qa.data(), rows, layer.in_dim, w, layer.dequant.data(),
+                                                            layer.bias.data(), layer.out_dim, b.data(), nullptr, 0.0f);
+            std::swap(a, b);
+            in_quantized = false;
+        }
+    }
+}
+
+void MeshCNNExtractor::extract(const double* vertices, size_t count, float* features) const {
+    std::vector<float> result = extract_batch({PointsView{vertices, nullptr, count}});
+    std::copy(result.begin(), result.end(), features);
+}
+
+std::vector<float> MeshCNNExtractor::extract_batch(const std::vector<PointsView>& meshes) const {
+    const size_t dim = feature_dim();
+
+    // Work items are (mesh, vertex chunk) pairs so that small and large meshes share the threads
+    struct Item {
+        size_t mesh;
+        size_t begin;
+        size_t end;
+    };
+    std::vector<Item> items;
+    for (size_t m = 0; m < meshes.size(); m++) {
+        for (size_t begin = 0; begin < meshes[m].size; begin += CHUNK_ROWS) {
+            items.push_back({m, begin, std::min(meshes[m].size, begin + CHUNK_ROWS)});
+        }
+    }
+
+    // ReLU outputs are non-negative, so 0 is the identity of the max pool
+    std::vector<float> partial(items.size() * dim, 0.0f);
+    parallel_for(items.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const Item& item = items[i];
+            extract_chunk(meshes[item.mesh].points, item.begin, item.end, &partial[i * dim]);
+        }
+    }, 1);
+
+    std::vector<float> features(meshes.size() * dim, 0.0f);
+    for (size_t i = 0; i < items.size(); i++) {
+        float* out = &features[items[i].mesh * dim];
+        const float* in = &partial[i * dim];
+        for (size_t d = 0; d < dim; d++) {
+            out[d] = std::max(out[d], in[d]);
+        }
+    }
+    return features;
+}
+
+}  // namespace meshmind
@@ -0,0 +1,103 @@
+/**
+ * MeshMind-AFID Native Engine: MeshCNN Feature Extractor
+ *
+ * CPU inference for SimplifiedMeshCNN.extract_features (eval mode):
+ *   3 x [Linear -> BatchNorm -> ReLU] per vertex, then global max pooling.
+ * BatchNorm is folded into the linear layers at load time; the last layer
+ * is fused with the max pool so its activations are never stored.
+ *
+ * INT8 post-training quantisation: layers with a calibrated input scale
+ * (scripts/calibrate_meshcnn.py) run on 7-bit unsigned activations and
+ * signed 8-bit weights with one scale per output channel, accumulated in
+ * int32. The 7-bit range keeps the AVX2 pairwise multiply-add exact, so
+ * every kernel (AVX-VNNI / AVX512-VNNI vpdpbusd, AVX2, NEON sdot, plain
+ * C++) produces identical accumulators. The x86 kernels are picked at run
+ * time (native/meshcnn_kernels.h).
+ *
+ * Weights file (little-endian, written by meshmind.ml.models.meshcnn.export_native_weights):
+ *   char[4]  magic "MMNN"
+ *   uint32   format version
+ *   uint32   layer count
+ *   per layer: uint32 in_dim, uint32 out_dim, float32 eps,
+ *              float32 input_scale (version 2 only; 0 = float layer),
+ *              float32 weight[out_dim * in_dim] (PyTorch [out][in] order),
+ *              float32 bias, gamma, beta, running_mean, running_var [out_dim each]
+ *   uint64   FNV-1a checksum of everything after the magic and version
+ */
+
+#pragma once
+
+#include "native/mesh.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace meshmind {
+
+/* One Linear + BatchNorm1d pair as stored by PyTorch */
+struct MeshCNNLayer {
+    size_t in_dim = 0;
+    size_t out_dim = 0;
+    float eps = 1e-5f;
+    float input_scale = 0.0f;         /* activation quantisation step, 0 = float */
+    std::vector<float> weight;        /* [out_dim * in_dim] */
+    std::vector<float> bias;
+    std::vector<float> gamma;
+    std::vector<float> beta;
+    std::vector<float> running_mean;
+    std::vector<float> running_var;
+};
+
+/* @throws std::runtime_error for unreadable, corrupt or unsupported files */
+std::vector<MeshCNNLayer> read_meshcnn_weights(const std::string& path);
+
+class MeshCNNExtractor {
+public:
+    /* @throws std::invalid_argument if layer dimensions do not chain or the input is not xyz */
+    explicit MeshCNNExtractor(const std::vector<MeshCNNLayer>& layers);
+
+    static MeshCNNExtractor load(const std::string& path) {
+        return MeshCNNExtractor(read_meshcnn_weights(path));
+    }
+
+    size_t feature_dim() const { return layers_.back().out_dim; }
+
+    /* True if any layer runs in INT8 */
+    bool quantized() const;
+
+    /**
+     * Global feature vector of one vertex set.
+     * @param vertices Vertex positions [count * 3]
+     * @param features Output [feature_dim()]
+     */
+    void extract(const double* vertices, size_t count, float* features) const;
+
+    /**
+     * Feature vectors of several vertex sets, evaluated as one parallel batch.
+     * @return [meshes.size() * feature_dim()]
+     */
+    std::vector<float> extract_batch(const std::vector<PointsView>& meshes) const;
+
+private:
+    /* Linear layer with BatchNorm folded in, weights transposed to [in_dim][out_dim] */
+    struct FusedLayer {
+        size_t in_dim;
+        size_t out_dim;
+        std::vector<float> weights;
+        std::vector<float> bias;
+        
+        /* INT8 layers: weights packed [in_dim / 4][out_dim][4], dequant = input_scale * weight scale */
+        float input_scale = 0.0f;
+        std::vector<int8_t> qweights;
+        std::vector<float> dequant;
+    };
+
+    /* Max over the vertices [begin, end) of the last layer's activations */
+    void extract_chunk(const double* vertices, size_t begin, size_t end, float* pooled) const;
+
+    std::vector<FusedLayer> layers_;
+};
+
+}  // namespace meshmind
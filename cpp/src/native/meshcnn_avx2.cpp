@@ -0,0 +1,21 @@
+/**
+ * MeshMind-AFID Native Engine: MeshCNN Kernels for AVX2/FMA
+ *
+ * Built with -mavx2 -mfma;
+ * selected at run time by meshcnn_kernels().
+ */
+
+#include "native/meshcnn_kernels_impl.h"
+
+#if !(defined(__AVX2__) && defined(__FMA__))
+#error "meshcnn_avx2.cpp must be built with -mavx2 -mfma"
+#endif
+
+namespace meshmind {
+
+const MeshCNNKernels& meshcnn_kernels_avx2() {
+    static const MeshCNNKernels kernels = kernel_table("avx2");
+    return kernels;
+}
+
+}  // namespace meshmind
@@ -0,0 +1,21 @@
+/**
+ * MeshMind-AFID Native Engine: MeshCNN Kernels for AVX512-VNNI
+ *
+ * Built with -mavx2 -mfma -mavx512vnni -mavx512vl;
+ * selected at run time by meshcnn_kernels().
+ */
+
+#include "native/meshcnn_kernels_impl.h"
+
+#if !(defined(__AVX512VNNI__) && defined(__AVX512VL__) && defined(__FMA__))
+#error "meshcnn_avx512vnni.cpp must be built with -mavx2 -mfma -mavx512vnni -mavx512vl"
+#endif
+
+namespace meshmind {
+
+const MeshCNNKernels& meshcnn_kernels_avx512vnni() {
+    static const MeshCNNKernels kernels = kernel_table("avx512vnni");
+    return kernels;
+}
+
+}  // namespace meshmind
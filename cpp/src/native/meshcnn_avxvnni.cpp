@@ -0,0 +1,21 @@
+/**
+ * MeshMind-AFID Native Engine: MeshCNN Kernels for AVX-VNNI
+ *
+ * Built with -mavx2 -mfma -mavxvnni;
+ * selected at run time by meshcnn_kernels().
+ */
+
+#include "native/meshcnn_kernels_impl.h"
+
+#if !(defined(__AVXVNNI__) && defined(__FMA__))
+#error "meshcnn_avxvnni.cpp must be built with -mavx2 -mfma -mavxvnni"
+#endif
+
+namespace meshmind {
+
+const MeshCNNKernels& meshcnn_kernels_avxvnni() {
+    static const MeshCNNKernels kernels = kernel_table("avxvnni");
+    return kernels;
+}
+
+}  // namespace meshmind
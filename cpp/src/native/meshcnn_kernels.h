@@ -0,0 +1,61 @@
+/**
+ * MeshMind-AFID Native Engine: MeshCNN Kernel Dispatch
+ *
+ * The dense layers of MeshCNNExtractor are compiled once for the build's
+ * baseline (meshcnn.cpp) and, on x86-64 with GCC or Clang, once more per
+ * instruction set in meshcnn_avx2.cpp, meshcnn_avxvnni.cpp and
+ * meshcnn_avx512vnni.cpp, each built with its own -m flags. The extractor
+ * picks the widest table the CPU supports at run time, so a portable build
+ * still gets the AVX2 and VNNI kernels.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace meshmind {
+
+/* Vertices per register tile; kernels take a multiple of this many rows */
+constexpr size_t MESHCNN_TILE_ROWS = 4;
+
+enum class Int8Output {
+    Float,       /* float activations for a float layer */
+    Quantized,   /* 7-bit activations for the next INT8 layer */
+    Pool,        /* max-reduced into out_float[out_dim] */
+};
+
+struct MeshCNNKernels {
+    const char* isa;
+
+    /**
+     * out = relu(in * W + b) with W stored [in_dim][out_dim]. The pooled
+     * variant max-reduces the activations into out[out_dim] instead.
+     */
+    void (*dense_relu)(const float* in, size_t rows, size_t in_dim, const float* w, const float* b,
+                       size_t out_dim, float* out);
+    void (*dense_relu_pool)(const float* in, size_t rows, size_t in_dim, const float* w, const float* b,
+                            size_t out_dim, float* out);
+
+    /**
+     * INT8 counterpart on 7-bit activations, indexed by Int8Output. W is packed
+     * [in_dim / 4][out_dim][4]; in_dim % 4 == 0 and out_dim % 8 == 0.
+     */
+    void (*dense_relu_int8[3])(const uint8_t* in, size_t rows, size_t in_dim, const int8_t* w,
+                               const float* dequant, const float* b, size_t out_dim,
+                               float* out_float, uint8_t* out_quantized, float out_inv_scale);
+};
+
+/* Baseline kernels, compiled with the build's own flags */
+const MeshCNNKernels& meshcnn_kernels_baseline();
+
+#if defined(MESHMIND_CPU_DISPATCH)
+const MeshCNNKernels& meshcnn_kernels_avx2();
+const MeshCNNKernels& meshcnn_kernels_avxvnni();
+const MeshCNNKernels& meshcnn_kernels_avx512vnni();
+#endif
+
+/* Widest kernels the running CPU supports, selected once */
+const MeshCNNKernels& meshcnn_kernels();
+
+}  // namespace meshmind
@@ -0,0 +1,271 @@
+/**
+ * MeshMind-AFID Native Engine: MeshCNN Kernels
+ *
+ * Included by one translation unit per instruction set (see
+ * meshcnn_kernels.h); the kernels use whatever the including unit is
+ * compiled for. Everything here has internal linkage, so the copies built
+ * with different -m flags never stand in for each other at link time; for
+ * the same reason the kernels avoid inline library templates like std::max.
+ */
+
+#pragma once
+
+#include "native/meshcnn_kernels.h"
+
+#include <cstring>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define MESHMIND_MESHCNN_AVX2 1
+#endif
+
+#if defined(__AVX512VNNI__) && defined(__AVX512VL__)
+#include <immintrin.h>
+#define MESHMIND_INT8_DPBUSD(acc, a, w) _mm256_dpbusd_epi32(acc, a, w)
+#elif defined(__AVXVNNI__)
+#include <immintrin.h>
+#define MESHMIND_INT8_DPBUSD(acc, a, w) _mm256_dpbusd_avx_epi32(acc, a, w)
+#elif defined(__AVX2__)
+#include <immintrin.h>
+/* Exact for 7-bit activations: pairwise products stay below the int16 saturation limit */
+#define MESHMIND_INT8_DPBUSD(acc, a, w) \
+    _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_maddubs_epi16(a, w), _mm256_set1_epi16(1)))
+#elif defined(__ARM_FEATURE_DOTPROD)
+#include <arm_neon.h>
+#define MESHMIND_INT8_SDOT 1
+#endif
+
+namespace meshmind {
+
+namespace {
+
+/* Quantised activations are 7-bit: [0, 127] */
+constexpr float ACTIVATION_MAX = 127.0f;
+
+inline float max_float(float a, float b) { return a < b ? b : a; }
+inline float min_float(float a, float b) { return b < a ? b : a; }
+
+/**
+ * out = relu(in * W + b) for a multiple of MESHCNN_TILE_ROWS rows, with W stored
+ * [in_dim][out_dim]. With Pool, the activations are max-reduced into
+ * out[out_dim] instead of being stored.
+ */
+template <bool Pool>
+void dense_relu(
+    const float* in,
+    size_t rows,
+    size_t in_dim,
+    const float* w,
+    const float* b,
+    size_t out_dim,
+    float* out
+) {
+    for (size_t r = 0; r < rows; r += MESHCNN_TILE_ROWS) {
+        const float* x[MESHCNN_TILE_ROWS];
+        for (size_t i = 0; i < MESHCNN_TILE_ROWS; i++) {
+            x[i] = in + (r + i) * in_dim;
+        }
+
+        size_t o = 0;
+#ifdef MESHMIND_MESHCNN_AVX2
+        const __m256 zero = _mm256_setzero_ps();
+        for (; o + 8 <= out_dim; o += 8) {
+            __m256 acc[MESHCNN_TILE_ROWS];
+            for (size_t i = 0; i < MESHCNN_TILE_ROWS; i++) {
+                acc[i] = _mm256_loadu_ps(b + o);
+            }
+            for (size_t k = 0; k < in_dim; k++) {
+                __m256 wk = _mm256_loadu_ps(w + k * out_dim + o);
+                for (size_t i = 0; i < MESHCNN_TILE_ROWS; i++) {
+                    acc[i] = _mm256_fmadd_ps(_mm256_set1_ps(x[i][k]), wk, acc[i]);
+                }
+            }
+            if (Pool) {
+                __m256 m = _mm256_loadu_ps(out + o);
+                for (size_t i = 0; i < MESHCNN_TILE_ROWS; i++) {
+                    m = _mm256_max_ps(m, acc[i]);
+                }
+                _mm256_storeu_ps(out + o, _mm256_max_ps(m, zero));
+            } else {
+                for (size_t i = 0; i < MESHCNN_TILE_ROWS; i++) {
+                    _mm256_storeu_ps(out + (r + i) * out_dim + o, _mm256_max_ps(acc[i], zero));
+                }
+            }
+        }
+#else
+        // Same blocking in plain C++; the fixed-size inner loops auto-vectorise
+        for (; o + 8 <= out_dim; o += 8) {
+            float acc[MESHCNN_TILE_ROWS][8];
+            for (size_t i = 0; i < MESHCNN_TILE_ROWS; i++) {
+                for (size_t j = 0; j < 8; j++) {
+                    acc[i][j] = b[o + j];
+                }
+            }
+            for (size_t k = 0; k < in_dim; k++) {
+                const float* wk = w + k * out_dim + o;
+                for (size_t i = 0; i < MESHCNN_TILE_ROWS; i++) {
+                    float xv = x[i][k];
+                    for (size_t j = 0; j < 8; j++) {
+                        acc[i][j] += xv * wk[j];
+                    }
+                }
+            }
+            for (size_t i = 0; i < MESHCNN_TILE_ROWS; i++) {
+                for (size_t j = 0; j < 8; j++) {
+                    float v = max_float(acc[i][j], 0.0f);
+                    if (Pool) {
+                        out[o + j] = max_float(out[o + j], v);
+                    } else {
+                        out[(r + i) * out_dim + o + j] = v;
+                    }
+                }
+            }
+        }
+#endif
+        for (; o < out_dim; o++) {
+            for (size_t i = 0; i < MESHCNN_TILE_ROWS; i++) {
+                float acc = b[o];
+                for (size_t k = 0; k < in_dim; k++) {
+                    acc += x[i][k] * w[k * out_dim + o];
+                }
+                float v = max_float(acc, 0.0f);
+                if (Pool) {
+                    out[o] = max_float(out[o], v);
+                } else {
+                    out[(r + i) * out_dim + o] = v;
+                }
+            }
+        }
+    }
+}
+
+inline uint8_t quantize_activation(float value, float inv_scale) {
+    // value >= 0 (ReLU output); round half up and clamp to 7 bits
+    return static_cast<uint8_t>(min_float(value * inv_scale + 0.5f, ACTIVATION_MAX));
+}
+
+/**
+ * acc[i][j] = sum_k x[i][k] * w[k][j] for MESHCNN_TILE_ROWS rows and 8 output
+ * channels, with w packed [in_dim / 4][out_dim][4] and already offset to
+ * the first channel of the block.
+ */
+inline void dot_block_int8(
+    const uint8_t* const* x,
+    const int8_t* w,
+    size_t in_dim,
+    size_t out_dim,
+    int32_t acc[MESHCNN_TILE_ROWS][8]
+) {
+#if defined(MESHMIND_INT8_DPBUSD)
+    __m256i sum[MESHCNN_TILE_ROWS];
+    for (size_t i = 0; i < MESHCNN_TILE_ROWS; i++) {
+        sum[i] = _mm256_setzero_si256();
+    }
+    for (size_t k = 0; k < in_dim; k += 4) {
+        __m256i wk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + k * out_dim));
+        for (size_t i = 0; i < MESHCNN_TILE_ROWS; i++) {
+            int32_t xk;
+            std::memcpy(&xk, x[i] + k, sizeof(xk));
+            sum[i] = MESHMIND_INT8_DPBUSD(sum[i], _mm256_set1_epi32(xk), wk);
+        }
+    }
+    for (size_t i = 0; i < MESHCNN_TILE_ROWS; i++) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc[i]), sum[i]);
+    }
+#elif defined(MESHMIND_INT8_SDOT)
+    int32x4_t lo[MESHCNN_TILE_ROWS], hi[MESHCNN_TILE_ROWS];
+    for (size_t i = 0; i < MESHCNN_TILE_ROWS; i++) {
+        lo[i] = vdupq_n_s32(0);
+        hi[i] = vdupq_n_s32(0);
+    }
+    for (size_t k = 0; k < in_dim; k += 4) {
+        int8x16_t w_lo = vld1q_s8(w + k * out_dim);
+        int8x16_t w_hi = vld1q_s8(w + k * out_dim + 16);
+        for (size_t i = 0; i < MESHCNN_TILE_ROWS; i++) {
+            int32_t xk;
+            std::memcpy(&xk, x[i] + k, sizeof(xk));
+            int8x16_t xv = vreinterpretq_s8_s32(vdupq_n_s32(xk));
+            lo[i] = vdotq_s32(lo[i], w_lo, xv);
+            hi[i] = vdotq_s32(hi[i], w_hi, xv);
+        }
+    }
+    for (size_t i = 0; i < MESHCNN_TILE_ROWS; i++) {
+        vst1q_s32(acc[i], lo[i]);
+        vst1q_s32(acc[i] + 4, hi[i]);
+    }
+#else
+    for (size_t i = 0; i < MESHCNN_TILE_ROWS; i++) {
+        for (size_t j = 0; j < 8; j++) {
+            acc[i][j] = 0;
+        }
+    }
+    for (size_t k = 0; k < in_dim; k += 4) {
+        const int8_t* wk = w + k * out_dim;
+        for (size_t i = 0; i < MESHCNN_TILE_ROWS; i++) {
+            for (size_t j = 0; j < 8; j++) {
+                for (size_t t = 0; t < 4; t++) {
+                    acc[i][j] += int32_t(x[i][k + t]) * int32_t(wk[4 * j + t]);
+                }
+            }
+        }
+    }
+#endif
+}
+
+/* INT8 counterpart of dense_relu; in_dim % 4 == 0 and out_dim % 8 == 0 */
+template <Int8Output Output>
+void dense_relu_int8(
+    const uint8_t* in,
+    size_t rows,
+    size_t in_dim,
+    const int8_t* w,
+    const float* dequant,
+    const float* b,
+    size_t out_dim,
+    float* out_float,
+    uint8_t* out_quantized,
+    float out_inv_scale
+) {
+    for (size_t r = 0; r < rows; r += MESHCNN_TILE_ROWS) {
+        const uint8_t* x[MESHCNN_TILE_ROWS];
+        for (size_t i = 0; i < MESHCNN_TILE_ROWS; i++) {
+            x[i] = in + (r + i) * in_dim;
+        }
+
+        for (size_t o = 0; o < out_dim; o += 8) {
+            int32_t acc[MESHCNN_TILE_ROWS][8];
+            dot_block_int8(x, w + 4 * o, in_dim, out_dim, acc);
+
+            for (size_t i = 0; i < MESHCNN_TILE_ROWS; i++) {
+                for (size_t j = 0; j < 8; j++) {
+                    float v = max_float(float(acc[i][j]) * dequant[o + j] + b[o + j], 0.0f);
+                    if (Output == Int8Output::Pool) {
+                        out_float[o + j] = max_float(out_float[o + j], v);
+                    } else if (Output == Int8Output::Float) {
+                        out_float[(r + i) * out_dim + o + j] = v;
+                    } else {
+                        out_quantized[(r + i) * out_dim + o + j] = quantize_activation(v, out_inv_scale);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* Kernel table of the including unit's instruction set */
+MeshCNNKernels kernel_table(const char* isa) {
+    return {
+        isa,
+        dense_relu<false>,
+        dense_relu<true>,
+        {
+            dense_relu_int8<Int8Output::Float>,
+            dense_relu_int8<Int8Output::Quantized>,
+            dense_relu_int8<Int8Output::Pool>,
+        },
+    };
+}
+
+}  // namespace
+
+}  // namespace meshmind
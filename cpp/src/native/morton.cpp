@@ -0,0 +1,59 @@
+/**
+ * MeshMind-AFID Native Engine: Spatial Ordering
+ */
+
+#include "native/morton.h"
+#include "native/parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace meshmind {
+
+std::vector<uint32_t> morton_order(const double* points, size_t count) {
+    double lo[3] = {HUGE_VAL, HUGE_VAL, HUGE_VAL}, hi[3] = {-HUGE_VAL, -HUGE_VAL, -HUGE_VAL};
+    for (size_t i = 0; i < count; i++) {
+        for (int d = 0; d < 3; d++) {
+            lo[d] = std::min(lo[d], points[3 * i + d]);
+            hi[d] = std::max(hi[d], points[3 * i + d]);
+        }
+    }
+
+    // One cell size for all axes, so that the order follows Euclidean distance
+    const double cells = double((1u << 21) - 1);
+    double extent = std::max({hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]});
+    double scale = extent > 0.0 ? cells / extent : 0.0;
+
+    std::vector<std::pair<uint64_t, uint32_t>> keys(count);
+    parallel_for(count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            uint32_t cell[3];
+            for (int d = 0; d < 3; d++) {
+                cell[d] = uint32_t(std::min(cells, std::max(0.0, (points[3 * i + d] - lo[d]) * scale)));
+            }
+            keys[i] = {morton_code(cell[0], cell[1], cell[2]), uint32_t(i)};
+        }
+    }, 4096);
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<uint32_t> order(count);
+    for (size_t k = 0; k < count; k++) {
+        order[k] = keys[k].second;
+    }
+    return order;
+}
+
+void morton_sort(PointSet& set) {
+    std::vector<uint32_t> order = morton_order(set.points.data(), set.size());
+    set.points = permute_rows(set.points, order, 3);
+    if (!set.normals.empty()) {
+        set.normals = permute_rows(set.normals, order, 3);
+    }
+    if (!set.order.empty()) {
+        order = permute_rows(set.order, order, 1);
+    }
+    set.order = std::move(order);
+}
+
+}  // namespace meshmind
@@ -0,0 +1,59 @@
+/**
+ * MeshMind-AFID Native Engine: Spatial Ordering
+ *
+ * Surface samples are drawn in random order, so neighbourhood kernels
+ * (normals, FPFH, closest points) jumped all over memory. Point sets are
+ * stored in Morton (Z-order) instead: points are quantised to a 2^21 grid
+ * over their bounding box and sorted by the interleaved bits of their
+ * coordinates, which keeps points that are close in space close in memory.
+ */
+
+#pragma once
+
+#include "native/mesh.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace meshmind {
+
+/* Spread the low 21 bits of v so that two zero bits follow each one */
+inline uint64_t spread_bits(uint64_t v) {
+    v &= 0x1FFFFF;
+    v = (v | v << 32) & 0x1F00000000FFFFULL;
+    v = (v | v << 16) & 0x1F0000FF0000FFULL;
+    v = (v | v << 8) & 0x100F00F00F00F00FULL;
+    v = (v | v << 4) & 0x10C30C30C30C30C3ULL;
+    v = (v | v << 2) & 0x1249249249249249ULL;
+    return v;
+}
+
+/* Morton code of grid cell (x, y, z), 21 bits per axis */
+inline uint64_t morton_code(uint32_t x, uint32_t y, uint32_t z) {
+    return spread_bits(x) | spread_bits(y) << 1 | spread_bits(z) << 2;
+}
+
+/* Permutation of points [count * 3] into Morton order: order[k] is the k-th point */
+std::vector<uint32_t> morton_order(const double* points, size_t count);
+
+/* Rows [count * stride] rearranged so that row k is the old row order[k] */
+template <typename T>
+std::vector<T> permute_rows(const std::vector<T>& data, const std::vector<uint32_t>& order, size_t stride) {
+    std::vector<T> result(data.size());
+    for (size_t k = 0; k < order.size(); k++) {
+        for (size_t d = 0; d < stride; d++) {
+            result[k * stride + d] = data[size_t(order[k]) * stride + d];
+        }
+    }
+    return result;
+}
+
+/**
+ * Store a point set in Morton order, normals alongside. set.order keeps
+ * the original index of each point (composed with any earlier order), so
+ * per-point results can be reported in input order.
+ */
+void morton_sort(PointSet& set);
+
+}  // namespace meshmind
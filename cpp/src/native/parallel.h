@@ -0,0 +1,65 @@
+/**
+ * MeshMind-AFID Native Engine: Parallel Loops
+ *
+ * Minimal fork-join helper over std::thread. Kernels call it with an
+ * index range; small ranges run inline to avoid thread start-up costs.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace meshmind {
+
+/* Number of worker threads used by parallel_for (at least 1) */
+inline size_t hardware_threads() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+/**
+ * Call body(begin, end) on disjoint chunks covering [0, count).
+ * Exceptions thrown by a chunk are rethrown on the calling thread.
+ */
+template <typename Body>
+void parallel_for(size_t count, Body body, size_t min_chunk = 256) {
+    size_t threads = std::min(hardware_threads(), (count + min_chunk - 1) / std::max<size_t>(min_chunk, 1));
+    if (threads <= 1) {
+        if (count > 0) {
+            body(size_t(0), count);
+        }
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors(threads);
+    size_t chunk = (count + threads - 1) / threads;
+    for (size_t t = 0; t < threads; t++) {
+        size_t begin = t * chunk;
+        size_t end = std::min(count, begin + chunk);
+        if (begin >= end) {
+            break;
+        }
+        workers.emplace_back([&, t, begin, end]() {
+            try {
+                body(begin, end);
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+}  // namespace meshmind
@@ -0,0 +1,202 @@
+/**
+ * MeshMind-AFID Native Engine: Case Pipeline
+ */
+
+#include "native/pipeline.h"
+
+#include "native/parallel.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+#endif
+
+namespace meshmind {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+#if defined(_WIN32)
+using ProcessId = int;
+
+ProcessId spawn(const MesherJob&, std::string& error) {
+    error = "External meshers are not supported on this platform";
+    return -1;
+}
+#else
+using ProcessId = pid_t;
+
+/* Start the job in its own process group so that a timeout can kill the whole tree */
+ProcessId spawn(const MesherJob& job, std::string& error) {
+    if (job.argv.empty()) {
+        error = "Empty mesher command";
+        return -1;
+    }
+    std::vector<char*> argv;
+    for (const auto& arg : job.argv) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    const char* log = job.log_path.empty() ? "/dev/null" : job.log_path.c_str();
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, log, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attributes, 0);
+
+    pid_t pid = -1;
+    int status = posix_spawnp(&pid, argv[0], &actions, &attributes, argv.data(), environ);
+    posix_spawnattr_destroy(&attributes);
+    posix_spawn_file_actions_destroy(&actions);
+    if (status != 0) {
+        error = "Cannot start " + job.argv[0] + ": " + std::strerror(status);
+        return -1;
+    }
+    return pid;
+}
+#endif
+
+struct QueuedJob {
+    size_t index;
+    MesherJob job;
+    Clock::time_point submitted;
+};
+
+struct RunningJob {
+    size_t index;
+    ProcessId pid;
+    int cpus;
+    double timeout_seconds;
+    Clock::time_point started;
+};
+
+}  // namespace
+
+PipelineExecutor::PipelineExecutor(int cpu_budget)
+    : cpu_budget_(cpu_budget > 0 ? cpu_budget : int(hardware_threads())) {}
+
+std::vector<JobResult> PipelineExecutor::run(
+    size_t count,
+    const std::function<bool(size_t, MesherJob&)>& prepare
+) const {
+    std::vector<JobResult> results(count);
+    std::mutex mutex;
+    std::condition_variable submitted;
+    std::deque<QueuedJob> queue;
+    bool closed = false;
+
+    // Launches queued jobs within the budget and reaps finished ones
+    std::thread scheduler([&]() {
+        std::vector<RunningJob> running;
+        int used = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            while (!queue.empty()) {
+                int cpus = std::max(queue.front().job.cpus, 1);
+                if (!running.empty() && used + cpus > cpu_budget_) {
+                    break;
+                }
+                QueuedJob next = std::move(queue.front());
+                queue.pop_front();
+                JobResult& result = results[next.index];
+                result.queue_seconds = seconds_since(next.submitted);
+                ProcessId pid = spawn(next.job, result.error);
+                if (pid < 0) {
+                    continue;
+                }
+                result.launched = true;
+                running.push_back({next.index, pid, cpus, next.job.timeout_seconds, Clock::now()});
+                used += cpus;
+            }
+            if (closed && queue.empty() && running.empty()) {
+                break;
+            }
+            if (running.empty()) {
+                submitted.wait(lock, [&]() { return closed || !queue.empty(); });
+                continue;
+            }
+            submitted.wait_for(lock, std::chrono::milliseconds(5));
+
+#if !defined(_WIN32)
+            for (size_t i = 0; i < running.size();) {
+                RunningJob& job = running[i];
+                JobResult& result = results[job.index];
+                int status = 0;
+                pid_t done = waitpid(job.pid, &status, WNOHANG);
+                if (done == 0 && job.timeout_seconds > 0 && seconds_since(job.started) > job.timeout_seconds) {
+                    kill(-job.pid, SIGKILL);
+                    done = waitpid(job.pid, &status, 0);
+                    result.timed_out = true;
+                }
+                if (done == 0) {
+                    i++;
+                    continue;
+                }
+                result.run_seconds = seconds_since(job.started);
+                if (done < 0) {
+                    result.error = std::string("waitpid failed: ") + std::strerror(errno);
+                } else if (WIFEXITED(status) && !result.timed_out) {
+                    result.exit_code = WEXITSTATUS(status);
+                } else if (!result.timed_out) {
+                    result.error = "Terminated by signal " + std::to_string(WTERMSIG(status));
+                }
+                used -= job.cpus;
+                running.erase(running.begin() + std::ptrdiff_t(i));
+            }
+#endif
+        }
+    });
+
+    // Prepare the next case while earlier ones are being meshed
+    std::exception_ptr error;
+    try {
+        for (size_t i = 0; i < count; i++) {
+            MesherJob job;
+            if (!prepare(i, job)) {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back({i, std::move(job), Clock::now()});
+            submitted.notify_one();
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+    }
+    submitted.notify_one();
+    scheduler.join();
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return results;
+}
+
+}  // namespace meshmind
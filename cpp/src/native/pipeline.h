@@ -0,0 +1,57 @@
+/**
+ * MeshMind-AFID Native Engine: Case Pipeline
+ *
+ * Runs a sequence of cases in two overlapping stages: a prepare step on the
+ * calling thread (detection and mesher input export) and an external mesher
+ * process per case. While case N is being meshed, case N+1 is already being
+ * prepared; mesher processes run concurrently as long as their CPU counts
+ * fit into the budget.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace meshmind {
+
+/* An external mesher invocation */
+struct MesherJob {
+    std::vector<std::string> argv;   /* program and arguments; the program is looked up in PATH */
+    std::string log_path;            /* stdout and stderr, empty to discard */
+    int cpus = 1;                    /* CPUs the process is expected to use */
+    double timeout_seconds = 0.0;    /* 0 for no limit; the process group is killed on timeout */
+};
+
+struct JobResult {
+    bool launched = false;
+    int exit_code = -1;              /* exit status, or -1 if not launched, killed or failed to start */
+    bool timed_out = false;
+    std::string error;
+    double queue_seconds = 0.0;      /* from submission until the CPU budget allowed a start */
+    double run_seconds = 0.0;
+};
+
+class PipelineExecutor {
+public:
+    /* cpu_budget <= 0 uses all hardware threads */
+    explicit PipelineExecutor(int cpu_budget = 0);
+
+    int cpu_budget() const { return cpu_budget_; }
+
+    /**
+     * For each case i in order, call prepare(i, job) on the calling thread;
+     * when it returns true the job is queued and started as soon as the
+     * budget allows (a job larger than the budget runs alone). Returns
+     * once all processes have finished.
+     * @throws whatever prepare throws, after running jobs have finished
+     */
+    std::vector<JobResult> run(size_t count, const std::function<bool(size_t, MesherJob&)>& prepare) const;
+
+private:
+    int cpu_budget_;
+};
+
+}  // namespace meshmind
@@ -0,0 +1,136 @@
+/**
+ * MeshMind-AFID Native Engine: Query Planner
+ */
+
+#include "native/planner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace meshmind {
+
+namespace {
+
+/*
+ * Relative costs per template sample: surface sampling, normals and FPFH
+ * over the neighbourhood, and the nearest-descriptor query, against one
+ * residual evaluation for a pose hypothesis.
+ */
+const double DESCRIBE_COST = 200.0;
+const double QUERY_COST = 50.0;
+
+double triangle_area(const TriangleMesh& mesh, size_t face) {
+    const int32_t* f = &mesh.faces[3 * face];
+    const double* a = &mesh.vertices[3 * size_t(f[0])];
+    const double* b = &mesh.vertices[3 * size_t(f[1])];
+    const double* c = &mesh.vertices[3 * size_t(f[2])];
+    double e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    double e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    double n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+    return 0.5 * std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+}
+
+template <typename Faces>
+SurfaceStats stats_of(const TriangleMesh& mesh, size_t count, Faces face_at) {
+    SurfaceStats stats;
+    double lo[3] = {HUGE_VAL, HUGE_VAL, HUGE_VAL}, hi[3] = {-HUGE_VAL, -HUGE_VAL, -HUGE_VAL};
+    for (size_t k = 0; k < count; k++) {
+        size_t face = face_at(k);
+        stats.area += triangle_area(mesh, face);
+        for (int v = 0; v < 3; v++) {
+            const double* p = &mesh.vertices[3 * size_t(mesh.faces[3 * face + size_t(v)])];
+            for (int d = 0; d < 3; d++) {
+                lo[d] = std::min(lo[d], p[d]);
+                hi[d] = std::max(hi[d], p[d]);
+            }
+        }
+    }
+    stats.faces = count;
+    if (count > 0) {
+        stats.diagonal = std::sqrt((hi[0] - lo[0]) * (hi[0] - lo[0]) + (hi[1] - lo[1]) * (hi[1] - lo[1]) +
+                                   (hi[2] - lo[2]) * (hi[2] - lo[2]));
+    }
+    return stats;
+}
+
+/* RANSAC hypotheses for the given success probability with 3-point samples */
+double ransac_iterations(double inlier_ratio, double confidence) {
+    double all_inliers = inlier_ratio * inlier_ratio * inlier_ratio;
+    if (all_inliers >= 1.0) {
+        return 1.0;
+    }
+    if (all_inliers <= 0.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return std::ceil(std::log(1.0 - confidence) / std::log1p(-all_inliers));
+}
+
+}  // namespace
+
+SurfaceStats surface_stats(const TriangleMesh& mesh) {
+    return stats_of(mesh, mesh.num_faces(), [](size_t k) { return k; });
+}
+
+SurfaceStats surface_stats(const TriangleMesh& mesh, const std::vector<int32_t>& faces) {
+    return stats_of(mesh, faces.size(), [&](size_t k) { return size_t(faces[k]); });
+}
+
+QueryPlan plan_query(const SurfaceStats& tmpl, const SurfaceStats& region, size_t instances,
+                     const PlannerParams& params) {
+    // A template sample's nearest descriptor is correct with a probability that
+    // grows with the share of the searched surface its instances make up
+    double share = region.area > 0 ? double(std::max<size_t>(instances, 1)) * tmpl.area / region.area : 1.0;
+    double ratio = std::min(0.95, std::max(1e-4, params.distinctiveness * share));
+
+    QueryPlan best;
+    best.inlier_ratio = ratio;
+    best.cost = std::numeric_limits<double>::infinity();
+    best.feasible = false;
+    QueryPlan fallback = best;
+
+    for (size_t points = params.min_points; points <= params.max_points; points = points * 3 / 2) {
+        double n = double(points);
+        double common = n * (DESCRIBE_COST + QUERY_COST * std::log2(std::max(2.0, n)));
+        bool enough = ratio * n >= double(params.min_inliers);
+
+        // Least squares tolerates few outliers; RANSAC needs few enough hypotheses;
+        // the clique search needs its inliers among the correspondences it keeps
+        double clique_n = std::min(n, double(params.max_clique_points));
+        double iterations = ransac_iterations(ratio, params.confidence);
+        struct Option {
+            PoseStrategy strategy;
+            double cost;
+            bool feasible;
+        } options[] = {
+            {PoseStrategy::PROCRUSTES, common + n, enough && ratio >= 0.5},
+            {PoseStrategy::RANSAC, common + iterations * n,
+             enough && iterations <= double(params.max_ransac_iterations)},
+            {PoseStrategy::MAX_CLIQUE, common + clique_n * clique_n * (1.0 + std::log2(clique_n)),
+             ratio * clique_n >= double(params.min_inliers)},
+        };
+        for (const Option& option : options) {
+            QueryPlan plan;
+            plan.strategy = option.strategy;
+            plan.coarse_points = points;
+            plan.ransac_iterations = option.strategy == PoseStrategy::RANSAC && std::isfinite(iterations)
+                ? size_t(iterations) : 0;
+            plan.inlier_ratio = ratio;
+            plan.cost = option.cost;
+            plan.feasible = option.feasible;
+            if (option.feasible && option.cost < best.cost) {
+                best = plan;
+            }
+        }
+        // Without a feasible option, the clique search over the most samples it keeps has the best odds
+        if (points <= params.max_clique_points) {
+            fallback = {PoseStrategy::MAX_CLIQUE, points, 0, ratio, options[2].cost, false};
+        }
+        if (points * 3 / 2 == points) {
+            break;
+        }
+    }
+    return best.feasible ? best : fallback;
+}
+
+}  // namespace meshmind
@@ -0,0 +1,67 @@
+/**
+ * MeshMind-AFID Native Engine: Query Planner
+ *
+ * Picks how each template is matched from template and target statistics
+ * instead of one global setting. The expected fraction of correct descriptor
+ * correspondences follows from how much of the searched surface the
+ * template's instances cover; each pose strategy then has a cost and a
+ * condition under which it is expected to succeed at that rate, and the
+ * planner takes the cheapest expected-to-succeed combination of strategy
+ * and number of template samples.
+ */
+
+#pragma once
+
+#include "native/mesh.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace meshmind {
+
+enum class PoseStrategy {
+    PROCRUSTES = 0,   /* least squares on all correspondences */
+    RANSAC = 1,       /* ransac_procrustes */
+    MAX_CLIQUE = 2,   /* robust_registration */
+};
+
+struct SurfaceStats {
+    double area = 0.0;
+    double diagonal = 0.0;   /* bounding box */
+    size_t faces = 0;
+};
+
+/* Statistics of the whole mesh, or of the given faces */
+SurfaceStats surface_stats(const TriangleMesh& mesh);
+SurfaceStats surface_stats(const TriangleMesh& mesh, const std::vector<int32_t>& faces);
+
+struct PlannerParams {
+    double confidence = 0.99;            /* success probability RANSAC is sized for */
+    double distinctiveness = 4.0;        /* how much likelier than chance a descriptor match is correct */
+    size_t min_inliers = 12;             /* expected correct correspondences a plan needs */
+    size_t min_points = 200;             /* range of template samples considered */
+    size_t max_points = 2000;
+    size_t max_ransac_iterations = 100000;
+    size_t max_clique_points = 1000;     /* RobustParams::max_correspondences */
+};
+
+struct QueryPlan {
+    PoseStrategy strategy = PoseStrategy::PROCRUSTES;
+    size_t coarse_points = 500;          /* template samples for pose estimation */
+    size_t ransac_iterations = 0;        /* for RANSAC */
+    double inlier_ratio = 1.0;           /* expected fraction of correct correspondences */
+    double cost = 0.0;                   /* estimated operations, in closest-point residual units */
+    bool feasible = true;                /* false: no strategy is expected to succeed; the most robust was taken */
+};
+
+/**
+ * Plan the matching of one template.
+ * @param tmpl Template surface
+ * @param region Target surface searched for the template
+ * @param instances Expected instances of the template in the region
+ */
+QueryPlan plan_query(const SurfaceStats& tmpl, const SurfaceStats& region, size_t instances,
+                     const PlannerParams& params = PlannerParams());
+
+}  // namespace meshmind
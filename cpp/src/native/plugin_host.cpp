@@ -0,0 +1,217 @@
+/**
+ * MeshMind-AFID Native Engine: Detector Plugin Host
+ */
+
+#include "native/plugin_host.h"
+
+#include "native/descriptors.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace meshmind {
+
+static_assert(sizeof(BVHNode) == sizeof(MeshMindBVHNode), "BVHNode must match MeshMindBVHNode");
+static_assert(offsetof(BVHNode, offset) == offsetof(MeshMindBVHNode, offset) &&
+              offsetof(BVHNode, count) == offsetof(MeshMindBVHNode, count),
+              "BVHNode must match MeshMindBVHNode");
+
+namespace {
+
+/* Oldest descriptor layout of this ABI version: everything up to detect */
+const size_t MIN_PLUGIN_STRUCT_SIZE = offsetof(MeshMindDetectorPlugin, detect) + sizeof(MeshMindDetectorPlugin::detect);
+
+void* open_library(const std::string& path) {
+#if defined(_WIN32)
+    return static_cast<void*>(LoadLibraryA(path.c_str()));
+#else
+    return dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+#endif
+}
+
+void* find_symbol(void* library, const char* name) {
+#if defined(_WIN32)
+    return reinterpret_cast<void*>(GetProcAddress(static_cast<HMODULE>(library), name));
+#else
+    return dlsym(library, name);
+#endif
+}
+
+void close_library(void* library) {
+#if defined(_WIN32)
+    FreeLibrary(static_cast<HMODULE>(library));
+#else
+    dlclose(library);
+#endif
+}
+
+std::string library_error() {
+#if defined(_WIN32)
+    return "error " + std::to_string(GetLastError());
+#else
+    const char* message = dlerror();
+    return message ? message : "unknown error";
+#endif
+}
+
+}  // namespace
+
+PluginTarget::PluginTarget(const TriangleMesh& mesh, const TemplateMatcher& index, const BVH& bvh)
+    : index_(index), bvh_(bvh) {
+    size_t n = index.size();
+    const std::vector<double>& points = index.coarse_points();
+    point_index_ = KDTree(points.data(), n, 3);
+
+    // The matcher keeps only positions; samples lie on the surface, so the
+    // closest face gives back the normal they were sampled with
+    normals_.assign(n * 3, 0.0);
+    for (size_t i = 0; i < n; i++) {
+        ClosestPoint closest = bvh_.closest_point(&points[3 * i]);
+        if (closest.face < 0) {
+            continue;
+        }
+        const int32_t* face = &mesh.faces[3 * size_t(closest.face)];
+        const double* a = &mesh.vertices[3 * size_t(face[0])];
+        const double* b = &mesh.vertices[3 * size_t(face[1])];
+        const double* c = &mesh.vertices[3 * size_t(face[2])];
+        double u[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        double v[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+        double* normal = &normals_[3 * i];
+        normal[0] = u[1] * v[2] - u[2] * v[1];
+        normal[1] = u[2] * v[0] - u[0] * v[2];
+        normal[2] = u[0] * v[1] - u[1] * v[0];
+        double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (length > 0.0) {
+            for (int d = 0; d < 3; d++) {
+                normal[d] /= length;
+            }
+        }
+    }
+
+    view_ = MeshMindTargetView();
+    view_.struct_size = sizeof(MeshMindTargetView);
+    view_.vertices = mesh.vertices.data();
+    view_.faces = mesh.faces.data();
+    view_.num_vertices = mesh.num_vertices();
+    view_.num_faces = mesh.num_faces();
+    view_.points = points.data();
+    view_.normals = normals_.data();
+    view_.num_points = n;
+    view_.descriptors = index.features().data();
+    view_.descriptor_dims = FPFH_DIMS;
+    view_.bvh_nodes = reinterpret_cast<const MeshMindBVHNode*>(bvh_.nodes().data());
+    view_.bvh_triangles = bvh_.triangles().data();
+    view_.num_bvh_nodes = bvh_.nodes().size();
+    view_.context = this;
+    view_.closest_point = &PluginTarget::query_closest_point;
+    view_.nearest_points = &PluginTarget::query_nearest_points;
+    view_.nearest_descriptors = &PluginTarget::query_nearest_descriptors;
+}
+
+int64_t PluginTarget::query_closest_point(const void* context, const double* query, double max_distance,
+                                          double* point, double* distance) {
+    const PluginTarget& target = *static_cast<const PluginTarget*>(context);
+    double max_sq_distance = std::isfinite(max_distance) ? max_distance * max_distance : max_distance;
+    ClosestPoint closest = target.bvh_.closest_point(query, max_sq_distance);
+    if (closest.face >= 0) {
+        if (point) {
+            std::copy(closest.point, closest.point + 3, point);
+        }
+        if (distance) {
+            *distance = std::sqrt(closest.sq_distance);
+        }
+    }
+    return closest.face;
+}
+
+size_t PluginTarget::query_nearest_points(const void* context, const double* query, size_t k,
+                                          size_t* indices, double* sq_distances) {
+    const PluginTarget& target = *static_cast<const PluginTarget*>(context);
+    return target.point_index_.knn(query, k, indices, sq_distances);
+}
+
+size_t PluginTarget::query_nearest_descriptors(const void* context, const double* descriptor, size_t k,
+                                               size_t* indices, double* sq_distances) {
+    const PluginTarget& target = *static_cast<const PluginTarget*>(context);
+    return target.index_.feature_index().knn(descriptor, k, indices, sq_distances);
+}
+
+NativePlugin::NativePlugin(const std::string& path, const std::string& config) : path_(path) {
+    library_ = open_library(path);
+    if (!library_) {
+        throw std::runtime_error("Cannot load plugin " + path + ": " + library_error());
+    }
+
+    auto entry = reinterpret_cast<MeshMindPluginEntry>(find_symbol(library_, MESHMIND_PLUGIN_ENTRY_SYMBOL));
+    const MeshMindDetectorPlugin* plugin = entry ? entry() : nullptr;
+    std::string error;
+    if (!entry) {
+        error = std::string("missing ") + MESHMIND_PLUGIN_ENTRY_SYMBOL;
+    } else if (!plugin) {
+        error = "entry point returned no plugin";
+    } else if (plugin->abi_version != MESHMIND_PLUGIN_ABI_VERSION) {
+        error = "ABI version " + std::to_string(plugin->abi_version) + ", expected " +
+                std::to_string(MESHMIND_PLUGIN_ABI_VERSION);
+    } else if (plugin->struct_size < MIN_PLUGIN_STRUCT_SIZE) {
+        error = "incomplete plugin descriptor";
+    } else {
+        // Descriptors grow by appending fields: copy only those the plugin was built with
+        std::memcpy(&plugin_, plugin, std::min<size_t>(plugin->struct_size, sizeof(plugin_)));
+        if (!plugin_.detect || !plugin_.name) {
+            error = "incomplete plugin descriptor";
+        } else if (plugin_.create && !(instance_ = plugin_.create(config.empty() ? nullptr : config.c_str()))) {
+            error = "create() failed";
+        }
+    }
+    if (!error.empty()) {
+        close_library(library_);
+        throw std::runtime_error("Invalid plugin " + path + ": " + error);
+    }
+    name_ = plugin_.name;
+}
+
+NativePlugin::~NativePlugin() {
+    if (instance_ && plugin_.destroy) {
+        plugin_.destroy(instance_);
+    }
+    close_library(library_);
+}
+
+std::vector<MeshMindPluginDetection> NativePlugin::detect(
+    const PluginTarget& target,
+    const TriangleMesh& template_mesh,
+    const std::string& template_path,
+    const std::string& feature_id,
+    int max_detections
+) const {
+    MeshMindTemplateView tmpl = MeshMindTemplateView();
+    tmpl.struct_size = sizeof(MeshMindTemplateView);
+    tmpl.path = template_path.c_str();
+    tmpl.feature_id = feature_id.c_str();
+    tmpl.vertices = template_mesh.vertices.data();
+    tmpl.faces = template_mesh.faces.data();
+    tmpl.num_vertices = template_mesh.num_vertices();
+    tmpl.num_faces = template_mesh.num_faces();
+
+    std::vector<MeshMindPluginDetection> detections(size_t(std::max(max_detections, 0)));
+    std::lock_guard<std::mutex> lock(mutex_);
+    int count = plugin_.detect(instance_, &target.view(), &tmpl, detections.data(), max_detections);
+    if (count < 0) {
+        const char* message = plugin_.get_error ? plugin_.get_error(instance_) : nullptr;
+        throw std::runtime_error("Plugin " + name_ + " failed on " + template_path +
+                                 (message ? std::string(": ") + message : std::string()));
+    }
+    detections.resize(std::min<size_t>(size_t(count), detections.size()));
+    return detections;
+}
+
+}  // namespace meshmind
@@ -0,0 +1,87 @@
+/**
+ * MeshMind-AFID Native Engine: Detector Plugin Host
+ *
+ * Loads native detector plugins (include/meshmind/plugin.h) and exposes a
+ * prepared target to them without copying: the mesh, the matcher's surface
+ * samples and descriptors, and the target's triangle BVH.
+ */
+
+#pragma once
+
+#include "meshmind/plugin.h"
+#include "native/bvh.h"
+#include "native/kdtree.h"
+#include "native/matcher.h"
+#include "native/mesh.h"
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace meshmind {
+
+/* Target as seen by plugins; mesh, index and bvh (built over mesh) must outlive it */
+class PluginTarget {
+public:
+    PluginTarget(const TriangleMesh& mesh, const TemplateMatcher& index, const BVH& bvh);
+    PluginTarget(const PluginTarget&) = delete;
+    PluginTarget& operator=(const PluginTarget&) = delete;
+
+    const MeshMindTargetView& view() const { return view_; }
+    const BVH& bvh() const { return bvh_; }
+
+private:
+    /* MeshMindTargetView callbacks; context is the PluginTarget */
+    static int64_t query_closest_point(const void* context, const double* query, double max_distance,
+                                       double* point, double* distance);
+    static size_t query_nearest_points(const void* context, const double* query, size_t k,
+                                       size_t* indices, double* sq_distances);
+    static size_t query_nearest_descriptors(const void* context, const double* descriptor, size_t k,
+                                            size_t* indices, double* sq_distances);
+
+    const TemplateMatcher& index_;
+    const BVH& bvh_;
+    KDTree point_index_;
+    std::vector<double> normals_;   /* face normals at the matcher's samples */
+    MeshMindTargetView view_;
+};
+
+/* A loaded plugin library and one instance of its detector */
+class NativePlugin {
+public:
+    /**
+     * @param path Shared library exporting meshmind_detector_plugin
+     * @param config Passed to the plugin's create()
+     * @throws std::runtime_error if the library cannot be loaded or is incompatible
+     */
+    explicit NativePlugin(const std::string& path, const std::string& config = std::string());
+    ~NativePlugin();
+    NativePlugin(const NativePlugin&) = delete;
+    NativePlugin& operator=(const NativePlugin&) = delete;
+
+    const std::string& name() const { return name_; }
+    const std::string& path() const { return path_; }
+
+    /**
+     * Run the plugin on one template. Calls on one plugin are serialised.
+     * @throws std::runtime_error if the plugin reports an error
+     */
+    std::vector<MeshMindPluginDetection> detect(
+        const PluginTarget& target,
+        const TriangleMesh& template_mesh,
+        const std::string& template_path,
+        const std::string& feature_id,
+        int max_detections = 64
+    ) const;
+
+private:
+    std::string path_;
+    std::string name_;
+    void* library_ = nullptr;
+    MeshMindDetectorPlugin plugin_ = {};   /* fields the plugin's descriptor lacks stay null */
+    void* instance_ = nullptr;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace meshmind
@@ -0,0 +1,203 @@
+/**
+ * MeshMind-AFID Native Engine: Search Regions
+ */
+
+#include "native/region.h"
+#include "native/morton.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace meshmind {
+
+namespace {
+
+/* Rounds of rejection sampling before giving up on filling all samples */
+const int MAX_SAMPLE_ROUNDS = 8;
+
+bool overlaps(const double* box, const double* lo, const double* hi) {
+    for (int d = 0; d < 3; d++) {
+        if (hi[d] < box[d] || lo[d] > box[d + 3]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+void append_bytes(std::string& out, const T* values, size_t count) {
+    out.append(reinterpret_cast<const char*>(values), count * sizeof(T));
+}
+
+}  // namespace
+
+std::string SearchRegion::key() const {
+    std::string key;
+    uint64_t sizes[2] = {boxes.size(), parts.size()};
+    append_bytes(key, sizes, 2);
+    append_bytes(key, boxes.data(), boxes.size());
+    std::vector<int32_t> sorted(parts);
+    std::sort(sorted.begin(), sorted.end());
+    append_bytes(key, sorted.data(), sorted.size());
+    if (has_band()) {
+        double band[3] = {double(up_axis), height_min, height_max};
+        append_bytes(key, band, 3);
+    }
+    return key;
+}
+
+RegionBounds::RegionBounds(const BVH& bvh, const SearchRegion& region) {
+    if (region.up_axis < 0 || region.up_axis > 2) {
+        throw std::invalid_argument("Search region up axis must be 0, 1 or 2");
+    }
+    if (region.boxes.size() % 6 != 0) {
+        throw std::invalid_argument("Search region boxes must have 6 values each");
+    }
+    if (bvh.nodes().empty()) {
+        return;
+    }
+    const BVHNode& root = bvh.nodes()[0];
+    if (region.boxes.empty()) {
+        boxes_.assign(root.bounds_min, root.bounds_min + 3);
+        boxes_.insert(boxes_.end(), root.bounds_max, root.bounds_max + 3);
+    } else {
+        boxes_ = region.boxes;
+    }
+    if (!region.has_band()) {
+        return;
+    }
+
+    // Clip every box to the slab between the band heights
+    int axis = region.up_axis;
+    double ground = root.bounds_min[axis];
+    double height = root.bounds_max[axis] - ground;
+    double lo = ground + region.height_min * height;
+    double hi = ground + region.height_max * height;
+    std::vector<double> clipped;
+    for (size_t b = 0; b < boxes_.size(); b += 6) {
+        double box[6];
+        std::memcpy(box, &boxes_[b], sizeof(box));
+        box[axis] = std::max(box[axis], lo);
+        box[axis + 3] = std::min(box[axis + 3], hi);
+        if (box[axis] <= box[axis + 3]) {
+            clipped.insert(clipped.end(), box, box + 6);
+        }
+    }
+    boxes_ = std::move(clipped);
+}
+
+bool RegionBounds::contains(const double* point) const {
+    for (size_t b = 0; b < boxes_.size(); b += 6) {
+        const double* box = &boxes_[b];
+        if (point[0] >= box[0] && point[0] <= box[3] &&
+            point[1] >= box[1] && point[1] <= box[4] &&
+            point[2] >= box[2] && point[2] <= box[5]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<int32_t> region_faces(const BVH& bvh, const SearchRegion& region) {
+    RegionBounds bounds(bvh, region);
+    const TriangleMesh* mesh = bvh.mesh();
+    std::vector<int32_t> faces;
+    if (!mesh || bounds.boxes().empty()) {
+        return faces;
+    }
+
+    std::vector<char> selected(mesh->num_faces(), 0);
+    auto in_parts = [&](int32_t face) {
+        if (region.parts.empty()) {
+            return true;
+        }
+        int32_t part = mesh->parts.empty() ? 0 : mesh->parts[size_t(face)];
+        return std::find(region.parts.begin(), region.parts.end(), part) != region.parts.end();
+    };
+
+    const std::vector<BVHNode>& nodes = bvh.nodes();
+    std::vector<int32_t> stack;
+    for (size_t b = 0; b < bounds.boxes().size(); b += 6) {
+        const double* box = &bounds.boxes()[b];
+        stack.assign(1, 0);
+        while (!stack.empty()) {
+            const BVHNode& node = nodes[size_t(stack.back())];
+            int32_t index = stack.back();
+            stack.pop_back();
+            if (!overlaps(box, node.bounds_min, node.bounds_max)) {
+                continue;
+            }
+            if (node.count == 0) {
+                stack.push_back(node.offset);
+                stack.push_back(index + 1);
+                continue;
+            }
+            for (int32_t i = node.offset; i < node.offset + node.count; i++) {
+                int32_t face = bvh.triangles()[size_t(i)];
+                if (selected[size_t(face)] || !in_parts(face)) {
+                    continue;
+                }
+                double lo[3], hi[3];
+                for (int d = 0; d < 3; d++) {
+                    lo[d] = std::numeric_limits<double>::infinity();
+                    hi[d] = -std::numeric_limits<double>::infinity();
+                }
+                for (int corner = 0; corner < 3; corner++) {
+                    const double* v = &mesh->vertices[3 * size_t(mesh->faces[3 * size_t(face) + corner])];
+                    for (int d = 0; d < 3; d++) {
+                        lo[d] = std::min(lo[d], v[d]);
+                        hi[d] = std::max(hi[d], v[d]);
+                    }
+                }
+                selected[size_t(face)] = overlaps(box, lo, hi);
+            }
+        }
+    }
+
+    for (size_t f = 0; f < selected.size(); f++) {
+        if (selected[f]) {
+            faces.push_back(int32_t(f));
+        }
+    }
+    return faces;
+}
+
+PointSet sample_region(const BVH& bvh, const SearchRegion& region, size_t count, uint64_t seed) {
+    std::vector<int32_t> faces = region_faces(bvh, region);
+    if (faces.empty()) {
+        throw std::runtime_error("Search region contains no target surface");
+    }
+    if (region.boxes.empty() && !region.has_band()) {
+        return sample_surface(*bvh.mesh(), faces, count, seed);
+    }
+
+    // Draws are accepted in draw order, not in the Morton order they are stored
+    // in: a Morton prefix of the last round would only cover part of the region
+    RegionBounds bounds(bvh, region);
+    PointSet samples;
+    std::vector<size_t> by_draw;
+    for (int round = 0; round < MAX_SAMPLE_ROUNDS && samples.size() < count; round++) {
+        PointSet drawn = sample_surface(*bvh.mesh(), faces, count, seed + uint64_t(round));
+        by_draw.resize(drawn.size());
+        for (size_t k = 0; k < drawn.size(); k++) {
+            by_draw[drawn.order[k]] = k;
+        }
+        for (size_t j = 0; j < drawn.size() && samples.size() < count; j++) {
+            size_t i = by_draw[j];
+            const double* p = &drawn.points[3 * i];
+            if (bounds.contains(p)) {
+                samples.points.insert(samples.points.end(), p, p + 3);
+                samples.normals.insert(samples.normals.end(), &drawn.normals[3 * i], &drawn.normals[3 * i] + 3);
+            }
+        }
+    }
+    if (samples.size() == 0) {
+        throw std::runtime_error("Search region contains no target surface");
+    }
+    morton_sort(samples);
+    return samples;
+}
+
+}  // namespace meshmind
@@ -0,0 +1,62 @@
+/**
+ * MeshMind-AFID Native Engine: Search Regions
+ *
+ * Spatial constraints on where a template family is searched for in the
+ * target: axis-aligned boxes, mesh parts and a height band above the
+ * ground plane. Only the target surface inside the region is sampled and
+ * described, so excluded areas never reach the descriptor stage.
+ */
+
+#pragma once
+
+#include "native/bvh.h"
+#include "native/mesh.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace meshmind {
+
+struct SearchRegion {
+    std::vector<double> boxes;    /* [num_boxes * 6] min xyz, max xyz; empty for the whole target */
+    std::vector<int32_t> parts;   /* TriangleMesh::parts IDs (0 for single-part meshes); empty for all */
+    int up_axis = 2;
+    /* Band along up_axis as fractions of the target height above its lowest point; off if max <= min */
+    double height_min = 0.0;
+    double height_max = 0.0;
+
+    bool has_band() const { return height_max > height_min; }
+    bool unrestricted() const { return boxes.empty() && parts.empty() && !has_band(); }
+
+    /* Identifies regions that select the same surface, for sharing prepared indexes */
+    std::string key() const;
+};
+
+/* Boxes and height band resolved against a target: a point is inside if it is in any box */
+class RegionBounds {
+public:
+    RegionBounds(const BVH& bvh, const SearchRegion& region);
+
+    const std::vector<double>& boxes() const { return boxes_; }
+    bool contains(const double* point) const;
+
+private:
+    std::vector<double> boxes_;   /* [n * 6] */
+};
+
+/**
+ * Faces of the BVH's mesh that overlap the region, found by descending only
+ * into nodes whose bounds intersect one of its boxes.
+ */
+std::vector<int32_t> region_faces(const BVH& bvh, const SearchRegion& region);
+
+/**
+ * Area-weighted samples of the target surface inside the region. Faces that
+ * straddle a box boundary are sampled too, but points outside are rejected.
+ * @throws std::runtime_error if the region contains no target surface
+ */
+PointSet sample_region(const BVH& bvh, const SearchRegion& region, size_t count, uint64_t seed);
+
+}  // namespace meshmind
@@ -0,0 +1,445 @@
+/**
+ * MeshMind-AFID Native Engine: Rigid / Similarity Registration
+ */
+
+#include "native/registration.h"
+
+#include "native/linalg.h"
+#include "native/parallel.h"
+#include "native/simd.h"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace meshmind {
+
+namespace {
+
+using simd::LANES;
+using simd::Vec;
+
+/* Enough for the 4x4 Horn matrix to converge to double precision */
+const int JACOBI_SWEEPS = 6;
+
+/* Hypotheses per RANSAC work item; fixed so every instruction set draws the same sets */
+const size_t RANSAC_BLOCK = 64;
+
+/* One Jacobi rotation zeroing a[p][q] in every lane; lanes where it is already zero are left alone */
+inline void jacobi_rotate(Vec (&a)[4][4], Vec (&v)[4][4], int p, int q) {
+    const Vec zero = simd::broadcast(0.0), one = simd::broadcast(1.0);
+    simd::Mask active = simd::less(simd::broadcast(1e-300), simd::abs(a[p][q]));
+    Vec apq = simd::select(active, a[p][q], one);
+    Vec theta = (a[q][q] - a[p][p]) / (simd::broadcast(2.0) * apq);
+    Vec sign = simd::select(simd::less(theta, zero), -one, one);
+    Vec t = sign / (simd::abs(theta) + simd::sqrt(simd::fmadd(theta, theta, one)));
+    t = simd::select(active, t, zero);
+    Vec c = one / simd::sqrt(simd::fmadd(t, t, one));
+    Vec s = t * c;
+    for (int k = 0; k < 4; k++) {
+        Vec akp = a[k][p], akq = a[k][q];
+        a[k][p] = c * akp - s * akq;
+        a[k][q] = s * akp + c * akq;
+    }
+    for (int k = 0; k < 4; k++) {
+        Vec apk = a[p][k], aqk = a[q][k];
+        a[p][k] = c * apk - s * aqk;
+        a[q][k] = s * apk + c * aqk;
+    }
+    for (int k = 0; k < 4; k++) {
+        Vec vkp = v[k][p], vkq = v[k][q];
+        v[k][p] = c * vkp - s * vkq;
+        v[k][q] = s * vkp + c * vkq;
+    }
+}
+
+/*
+ * Horn's solution for LANES 3-point sets: source[i][d] and target[i][d]
+ * hold coordinate d of point i in every lane. Writes the top three rows of
+ * each transform, m[r * 4 + c].
+ */
+void solve_lanes(const Vec (&source)[3][3], const Vec (&target)[3][3], bool with_scale, Vec (&m)[12]) {
+    const Vec zero = simd::broadcast(0.0), one = simd::broadcast(1.0), third = simd::broadcast(1.0 / 3.0);
+    Vec mu_s[3], mu_t[3], s[3][3], t[3][3];
+    for (int d = 0; d < 3; d++) {
+        mu_s[d] = (source[0][d] + source[1][d] + source[2][d]) * third;
+        mu_t[d] = (target[0][d] + target[1][d] + target[2][d]) * third;
+        for (int i = 0; i < 3; i++) {
+            s[i][d] = source[i][d] - mu_s[d];
+            t[i][d] = target[i][d] - mu_t[d];
+        }
+    }
+    Vec S[3][3], source_var = zero;
+    for (int a = 0; a < 3; a++) {
+        for (int b = 0; b < 3; b++) {
+            S[a][b] = simd::fmadd(s[0][a], t[0][b], simd::fmadd(s[1][a], t[1][b], s[2][a] * t[2][b]));
+        }
+        source_var = simd::fmadd(s[0][a], s[0][a], simd::fmadd(s[1][a], s[1][a], simd::fmadd(s[2][a], s[2][a], source_var)));
+    }
+
+    Vec a[4][4] = {
+        {S[0][0] + S[1][1] + S[2][2], S[1][2] - S[2][1], S[2][0] - S[0][2], S[0][1] - S[1][0]},
+        {S[1][2] - S[2][1], S[0][0] - S[1][1] - S[2][2], S[0][1] + S[1][0], S[2][0] + S[0][2]},
+        {S[2][0] - S[0][2], S[0][1] + S[1][0], S[1][1] - S[0][0] - S[2][2], S[1][2] + S[2][1]},
+        {S[0][1] - S[1][0], S[2][0] + S[0][2], S[1][2] + S[2][1], S[2][2] - S[0][0] - S[1][1]},
+    };
+    Vec v[4][4];
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            v[i][j] = i == j ? one : zero;
+        }
+    }
+    for (int sweep = 0; sweep < JACOBI_SWEEPS; sweep++) {
+        for (int p = 0; p < 4; p++) {
+            for (int q = p + 1; q < 4; q++) {
+                jacobi_rotate(a, v, p, q);
+            }
+        }
+    }
+
+    // Eigenvector of the largest eigenvalue, per lane
+    Vec best = a[0][0], q[4] = {v[0][0], v[1][0], v[2][0], v[3][0]};
+    for (int k = 1; k < 4; k++) {
+        simd::Mask larger = simd::less(best, a[k][k]);
+        best = simd::select(larger, a[k][k], best);
+        for (int i = 0; i < 4; i++) {
+            q[i] = simd::select(larger, v[i][k], q[i]);
+        }
+    }
+    const Vec two = simd::broadcast(2.0);
+    Vec qw = q[0], qx = q[1], qy = q[2], qz = q[3];
+    Vec R[3][3] = {
+        {qw * qw + qx * qx - qy * qy - qz * qz, two * (qx * qy - qw * qz), two * (qx * qz + qw * qy)},
+        {two * (qx * qy + qw * qz), qw * qw - qx * qx + qy * qy - qz * qz, two * (qy * qz - qw * qx)},
+        {two * (qx * qz - qw * qy), two * (qy * qz + qw * qx), qw * qw - qx * qx - qy * qy + qz * qz},
+    };
+
+    Vec scale = one;
+    if (with_scale) {
+        Vec numerator = zero;
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 3; c++) {
+                numerator = simd::fmadd(R[r][c], S[c][r], numerator);
+            }
+        }
+        simd::Mask spread = simd::less(zero, source_var);
+        scale = simd::select(spread, numerator / simd::select(spread, source_var, one), one);
+    }
+    for (int r = 0; r < 3; r++) {
+        Vec translation = mu_t[r];
+        for (int c = 0; c < 3; c++) {
+            m[r * 4 + c] = scale * R[r][c];
+            translation = translation - m[r * 4 + c] * mu_s[c];
+        }
+        m[r * 4 + 3] = translation;
+    }
+}
+
+/* Correspondences within sqrt(threshold2) under each lane's transform */
+Vec inliers_lanes(const Vec (&m)[12], const double* source, const double* target, size_t count, double threshold2) {
+    const Vec limit = simd::broadcast(threshold2), one = simd::broadcast(1.0), zero = simd::broadcast(0.0);
+    Vec inliers = zero;
+    for (size_t i = 0; i < count; i++) {
+        Vec x = simd::broadcast(source[3 * i]), y = simd::broadcast(source[3 * i + 1]), z = simd::broadcast(source[3 * i + 2]);
+        Vec d2 = zero;
+        for (int r = 0; r < 3; r++) {
+            Vec mapped = simd::fmadd(m[r * 4], x, simd::fmadd(m[r * 4 + 1], y, simd::fmadd(m[r * 4 + 2], z, m[r * 4 + 3])));
+            Vec diff = mapped - simd::broadcast(target[3 * i + r]);
+            d2 = simd::fmadd(diff, diff, d2);
+        }
+        inliers = inliers + simd::select(simd::less(d2, limit), one, zero);
+    }
+    return inliers;
+}
+
+/* Gather LANES sets (the last one repeated to fill a partial block) into lanes */
+void gather_sets(const double* source, const double* target, const uint32_t* sets, size_t count,
+                 Vec (&s)[3][3], Vec (&t)[3][3]) {
+    alignas(64) double buffer[18][LANES];
+    for (size_t l = 0; l < LANES; l++) {
+        const uint32_t* set = sets + 3 * std::min(l, count - 1);
+        for (int i = 0; i < 3; i++) {
+            for (int d = 0; d < 3; d++) {
+                buffer[i * 3 + d][l] = source[3 * size_t(set[i]) + d];
+                buffer[9 + i * 3 + d][l] = target[3 * size_t(set[i]) + d];
+            }
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        for (int d = 0; d < 3; d++) {
+            s[i][d] = simd::load(buffer[i * 3 + d]);
+            t[i][d] = simd::load(buffer[9 + i * 3 + d]);
+        }
+    }
+}
+
+void store_transforms(const Vec (&m)[12], size_t count, double* transforms) {
+    alignas(64) double lanes[12][LANES];
+    for (int k = 0; k < 12; k++) {
+        simd::store(lanes[k], m[k]);
+    }
+    for (size_t l = 0; l < count; l++) {
+        double* out = transforms + 16 * l;
+        for (int k = 0; k < 12; k++) {
+            out[k] = lanes[k][l];
+        }
+        out[12] = out[13] = out[14] = 0.0;
+        out[15] = 1.0;
+    }
+}
+
+}  // namespace
+
+Pose procrustes(
+    const double* source,
+    const double* target,
+    size_t count,
+    bool with_scale,
+    const double* weights
+) {
+    if (count < 3) {
+        throw std::invalid_argument("Procrustes needs at least 3 correspondences");
+    }
+
+    double total_weight = 0.0;
+    double mu_s[3] = {0, 0, 0};
+    double mu_t[3] = {0, 0, 0};
+    for (size_t i = 0; i < count; i++) {
+        double w = weights ? weights[i] : 1.0;
+        total_weight += w;
+        for (int d = 0; d < 3; d++) {
+            mu_s[d] += w * source[3 * i + d];
+            mu_t[d] += w * target[3 * i + d];
+        }
+    }
+    if (total_weight <= 0.0) {
+        throw std::invalid_argument("Procrustes weights sum to zero");
+    }
+    for (int d = 0; d < 3; d++) {
+        mu_s[d] /= total_weight;
+        mu_t[d] /= total_weight;
+    }
+
+    // Cross-covariance S[a][b] = sum w * s_a * t_b of centred points
+    double S[3][3] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+    double source_var = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        double w = weights ? weights[i] : 1.0;
+        double s[3], t[3];
+        for (int d = 0; d < 3; d++) {
+            s[d] = source[3 * i + d] - mu_s[d];
+            t[d] = target[3 * i + d] - mu_t[d];
+        }
+        for (int a = 0; a < 3; a++) {
+            for (int b = 0; b < 3; b++) {
+                S[a][b] += w * s[a] * t[b];
+            }
+        }
+        source_var += w * (s[0] * s[0] + s[1] * s[1] + s[2] * s[2]);
+    }
+
+    // Horn (1987): the optimal rotation is the top eigenvector of N
+    double N[4][4] = {
+        {S[0][0] + S[1][1] + S[2][2], S[1][2] - S[2][1], S[2][0] - S[0][2], S[0][1] - S[1][0]},
+        {S[1][2] - S[2][1], S[0][0] - S[1][1] - S[2][2], S[0][1] + S[1][0], S[2][0] + S[0][2]},
+        {S[2][0] - S[0][2], S[0][1] + S[1][0], -S[0][0] + S[1][1] - S[2][2], S[1][2] + S[2][1]},
+        {S[0][1] - S[1][0], S[2][0] + S[0][2], S[1][2] + S[2][1], -S[0][0] - S[1][1] + S[2][2]},
+    };
+    double eigenvalues[4];
+    double eigenvectors[4][4];
+    symmetric_eigen<4>(N, eigenvalues, eigenvectors);
+    double qw = eigenvectors[0][3];
+    double qx = eigenvectors[1][3];
+    double qy = eigenvectors[2][3];
+    double qz = eigenvectors[3][3];
+
+    double R[3][3] = {
+        {qw * qw + qx * qx - qy * qy - qz * qz, 2 * (qx * qy - qw * qz), 2 * (qx * qz + qw * qy)},
+        {2 * (qx * qy + qw * qz), qw * qw - qx * qx + qy * qy - qz * qz, 2 * (qy * qz - qw * qx)},
+        {2 * (qx * qz - qw * qy), 2 * (qy * qz + qw * qx), qw * qw - qx * qx - qy * qy + qz * qz},
+    };
+
+    double scale = 1.0;
+    if (with_scale && source_var > 0.0) {
+        // sum w * t . (R s) == trace(R S)
+        double numerator = 0.0;
+        for (int a = 0; a < 3; a++) {
+            for (int b = 0; b < 3; b++) {
+                numerator += R[b][a] * S[a][b];
+            }
+        }
+        scale = numerator / source_var;
+    }
+
+    Pose pose;
+    for (int r = 0; r < 3; r++) {
+        double translation = mu_t[r];
+        for (int c = 0; c < 3; c++) {
+            pose.transform[r * 4 + c] = scale * R[r][c];
+            translation -= scale * R[r][c] * mu_s[c];
+        }
+        pose.transform[r * 4 + 3] = translation;
+    }
+    pose.transform[12] = pose.transform[13] = pose.transform[14] = 0.0;
+    pose.transform[15] = 1.0;
+
+    double cost = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        double w = weights ? weights[i] : 1.0;
+        const double* s = source + 3 * i;
+        for (int r = 0; r < 3; r++) {
+            double mapped = pose.transform[r * 4] * s[0] + pose.transform[r * 4 + 1] * s[1] +
+                            pose.transform[r * 4 + 2] * s[2] + pose.transform[r * 4 + 3];
+            double diff = mapped - target[3 * i + r];
+            cost += w * diff * diff;
+        }
+    }
+    pose.cost = cost / total_weight;
+    return pose;
+}
+
+void procrustes_batch(
+    const double* source,
+    const double* target,
+    const uint32_t* sets,
+    size_t num_sets,
+    double* transforms,
+    bool with_scale
+) {
+    size_t blocks = (num_sets + LANES - 1) / LANES;
+    parallel_for(blocks, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; b++) {
+            size_t lanes = std::min(LANES, num_sets - b * LANES);
+            Vec s[3][3], t[3][3], m[12];
+            gather_sets(source, target, sets + 3 * b * LANES, lanes, s, t);
+            solve_lanes(s, t, with_scale, m);
+            store_transforms(m, lanes, transforms + 16 * b * LANES);
+        }
+    }, 64);
+}
+
+void count_inliers(
+    const double* transforms,
+    size_t num_transforms,
+    const double* source,
+    const double* target,
+    size_t count,
+    double threshold,
+    uint32_t* inliers
+) {
+    size_t blocks = (num_transforms + LANES - 1) / LANES;
+    parallel_for(blocks, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; b++) {
+            size_t lanes = std::min(LANES, num_transforms - b * LANES);
+            alignas(64) double buffer[12][LANES];
+            for (size_t l = 0; l < LANES; l++) {
+                const double* m = transforms + 16 * (b * LANES + std::min(l, lanes - 1));
+                for (int k = 0; k < 12; k++) {
+                    buffer[k][l] = m[k];
+                }
+            }
+            Vec m[12];
+            for (int k = 0; k < 12; k++) {
+                m[k] = simd::load(buffer[k]);
+            }
+            alignas(64) double counts[LANES];
+            simd::store(counts, inliers_lanes(m, source, target, count, threshold * threshold));
+            for (size_t l = 0; l < lanes; l++) {
+                inliers[b * LANES + l] = uint32_t(counts[l]);
+            }
+        }
+    }, 1);
+}
+
+RansacPose ransac_procrustes(const double* source, const double* target, size_t count, const RansacParams& params) {
+    if (count < 3) {
+        throw std::invalid_argument("RANSAC needs at least 3 correspondences");
+    }
+    if (!(params.inlier_threshold > 0)) {
+        throw std::invalid_argument("RANSAC needs a positive inlier threshold");
+    }
+    const double threshold2 = params.inlier_threshold * params.inlier_threshold;
+
+    // Best hypothesis per block: each block draws its sets from its own seeded stream
+    struct Best {
+        double inliers = -1.0;
+        double transform[16];
+    };
+    const size_t iterations = std::max<size_t>(params.iterations, 1);
+    size_t blocks = (iterations + RANSAC_BLOCK - 1) / RANSAC_BLOCK;
+    std::vector<Best> best(blocks);
+    parallel_for(blocks, [&](size_t begin, size_t end) {
+        std::vector<uint32_t> sets(3 * RANSAC_BLOCK);
+        for (size_t b = begin; b < end; b++) {
+            // The last block stops at the requested count
+            size_t hypotheses = std::min(RANSAC_BLOCK, iterations - b * RANSAC_BLOCK);
+            std::mt19937_64 rng(params.seed + 0x9E3779B97F4A7C15ULL * (b + 1));
+            std::uniform_int_distribution<uint32_t> pick(0, uint32_t(count - 1));
+            for (size_t h = 0; h < hypotheses; h++) {
+                uint32_t* set = &sets[3 * h];
+                set[0] = pick(rng);
+                do { set[1] = pick(rng); } while (set[1] == set[0]);
+                do { set[2] = pick(rng); } while (set[2] == set[0] || set[2] == set[1]);
+            }
+            for (size_t h = 0; h < hypotheses; h += LANES) {
+                size_t lanes = std::min(LANES, hypotheses - h);
+                Vec s[3][3], t[3][3], m[12];
+                gather_sets(source, target, &sets[3 * h], lanes, s, t);
+                solve_lanes(s, t, params.with_scale, m);
+                alignas(64) double counts[LANES];
+                simd::store(counts, inliers_lanes(m, source, target, count, threshold2));
+                size_t lane = size_t(std::max_element(counts, counts + lanes) - counts);
+                if (counts[lane] > best[b].inliers) {
+                    best[b].inliers = counts[lane];
+                    double transforms[16 * LANES];
+                    store_transforms(m, LANES, transforms);
+                    std::copy(transforms + 16 * lane, transforms + 16 * (lane + 1), best[b].transform);
+                }
+            }
+        }
+    }, 1);
+    const Best& winner = *std::max_element(best.begin(), best.end(), [](const Best& a, const Best& b) {
+        return a.inliers < b.inliers;
+    });
+
+    // Refit on the inliers of the best hypothesis
+    std::vector<double> mapped(3 * count), inlier_source, inlier_target;
+    transform_points(winner.transform, source, count, mapped.data());
+    for (size_t i = 0; i < count; i++) {
+        double d2 = 0.0;
+        for (int d = 0; d < 3; d++) {
+            d2 += (mapped[3 * i + d] - target[3 * i + d]) * (mapped[3 * i + d] - target[3 * i + d]);
+        }
+        if (d2 < threshold2) {
+            inlier_source.insert(inlier_source.end(), source + 3 * i, source + 3 * i + 3);
+            inlier_target.insert(inlier_target.end(), target + 3 * i, target + 3 * i + 3);
+        }
+    }
+    RansacPose result;
+    result.inliers = inlier_source.size() / 3;
+    if (result.inliers >= 3) {
+        result.pose = procrustes(inlier_source.data(), inlier_target.data(), result.inliers, params.with_scale);
+    } else {
+        std::copy(winner.transform, winner.transform + 16, result.pose.transform);
+        result.pose.cost = 0.0;
+        for (size_t i = 0; i < 3 * count; i++) {
+            result.pose.cost += (mapped[i] - target[i]) * (mapped[i] - target[i]) / double(count);
+        }
+    }
+    return result;
+}
+
+void transform_points(const double* transform, const double* points, size_t count, double* out) {
+    const double* m = transform;
+    for (size_t i = 0; i < count; i++) {
+        double x = points[3 * i];
+        double y = points[3 * i + 1];
+        double z = points[3 * i + 2];
+        out[3 * i] = m[0] * x + m[1] * y + m[2] * z + m[3];
+        out[3 * i + 1] = m[4] * x + m[5] * y + m[6] * z + m[7];
+        out[3 * i + 2] = m[8] * x + m[9] * y + m[10] * z + m[11];
+    }
+}
+
+}  // namespace meshmind
@@ -0,0 +1,92 @@
+/**
+ * MeshMind-AFID Native Engine: Rigid / Similarity Registration
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace meshmind {
+
+struct Pose {
+    double transform[16];   /* 4x4 row-major, maps source onto target */
+    double cost;            /* mean squared residual after alignment */
+};
+
+/**
+ * Least-squares alignment of corresponding point sets (Horn's closed-form
+ * quaternion solution), optionally with a uniform scale as in
+ * trimesh.registration.procrustes. The rotation is always proper.
+ * @param source Source points [count * 3]
+ * @param target Corresponding target points [count * 3]
+ * @param weights Optional per-correspondence weights [count]
+ * @throws std::invalid_argument for fewer than 3 correspondences
+ */
+Pose procrustes(
+    const double* source,
+    const double* target,
+    size_t count,
+    bool with_scale = true,
+    const double* weights = nullptr
+);
+
+/**
+ * Poses of many 3-point correspondence sets at once, e.g. RANSAC
+ * hypotheses: Horn's solution as in procrustes(), with the sets spread
+ * across SIMD lanes (see simd.h) and a fixed number of Jacobi sweeps so
+ * that all lanes run the same instructions. Degenerate (collinear) sets
+ * give arbitrary but finite transforms.
+ * @param sets Correspondence indices, 3 per set [num_sets * 3]
+ * @param transforms Output row-major 4x4 transforms [num_sets * 16]
+ */
+void procrustes_batch(
+    const double* source,
+    const double* target,
+    const uint32_t* sets,
+    size_t num_sets,
+    double* transforms,
+    bool with_scale = true
+);
+
+/**
+ * For each transform, the number of correspondences it maps to within
+ * threshold of their target, scored in SIMD lanes across transforms.
+ * @param inliers Output [num_transforms]
+ */
+void count_inliers(
+    const double* transforms,
+    size_t num_transforms,
+    const double* source,
+    const double* target,
+    size_t count,
+    double threshold,
+    uint32_t* inliers
+);
+
+struct RansacParams {
+    size_t iterations = 0;          /* 3-point hypotheses; 0 disables RANSAC where it is optional */
+    double inlier_threshold = 0.0;  /* target units; <= 0 lets the caller pick one */
+    bool with_scale = true;
+    uint64_t seed = 0;
+};
+
+struct RansacPose {
+    Pose pose;
+    size_t inliers;   /* correspondences within the threshold under the best hypothesis */
+};
+
+/**
+ * RANSAC over 3-point hypotheses, solved and scored in batches
+ * (procrustes_batch, count_inliers) on all threads. The hypothesis with the
+ * most inliers is refitted by procrustes() on its inliers. Exactly
+ * max(iterations, 1) hypotheses are drawn; which ones depends on the seed
+ * only, not on the number of threads or the SIMD width.
+ * @throws std::invalid_argument for fewer than 3 correspondences or a non-positive threshold
+ */
+RansacPose ransac_procrustes(const double* source, const double* target, size_t count, const RansacParams& params);
+
+/* Apply a row-major 4x4 transform to count points (in place allowed) */
+void transform_points(const double* transform, const double* points, size_t count, double* out);
+
+}  // namespace meshmind
@@ -0,0 +1,434 @@
+/**
+ * MeshMind-AFID Native Engine: Outlier-Robust Registration
+ */
+
+#include "native/robust.h"
+
+#include "native/parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+
+namespace meshmind {
+
+namespace {
+
+/* Graduated non-convexity: annealing factor and iteration cap */
+const double GNC_FACTOR = 1.4;
+const int GNC_MAX_ITERATIONS = 100;
+
+inline size_t popcount(const uint64_t* bits, size_t words) {
+    size_t count = 0;
+    for (size_t w = 0; w < words; w++) {
+        count += size_t(__builtin_popcountll(bits[w]));
+    }
+    return count;
+}
+
+double distance(const double* a, const double* b) {
+    return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]) + (a[2] - b[2]) * (a[2] - b[2]));
+}
+
+/* Shared state of the clique search; best_size is read without the lock for pruning */
+struct CliqueSearch {
+    const ConsistencyGraph& graph;
+    std::atomic<size_t> best_size{0};
+    std::mutex mutex;
+    std::vector<uint32_t> best;
+
+    explicit CliqueSearch(const ConsistencyGraph& g) : graph(g) {}
+
+    void offer(const std::vector<uint32_t>& clique) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (clique.size() > best.size()) {
+            best = clique;
+            best_size = clique.size();
+        }
+    }
+
+    /* Branch and bound over candidates: colour them greedily, expand in reverse colour order */
+    void expand(std::vector<uint32_t>& clique, std::vector<uint64_t> candidates) {
+        const size_t words = graph.words;
+        std::vector<uint32_t> order;
+        std::vector<size_t> colours;
+        std::vector<uint64_t> uncoloured = candidates, available(words);
+        for (size_t colour = 1; popcount(uncoloured.data(), words) > 0; colour++) {
+            available = uncoloured;
+            for (size_t w = 0; w < words; w++) {
+                while (available[w]) {
+                    size_t v = w * 64 + size_t(__builtin_ctzll(available[w]));
+                    available[w] &= available[w] - 1;
+                    uncoloured[w] &= ~(uint64_t(1) << (v % 64));
+                    const uint64_t* row = &graph.adjacency[v * words];
+                    for (size_t x = w; x < words; x++) {
+                        available[x] &= ~row[x];
+                    }
+                    order.push_back(uint32_t(v));
+                    colours.push_back(colour);
+                }
+            }
+        }
+
+        for (size_t k = order.size(); k-- > 0;) {
+            if (clique.size() + colours[k] <= best_size.load(std::memory_order_relaxed)) {
+                return;
+            }
+            uint32_t v = order[k];
+            const uint64_t* row = &graph.adjacency[size_t(v) * words];
+            std::vector<uint64_t> next(words);
+            bool empty = true;
+            for (size_t w = 0; w < words; w++) {
+                next[w] = candidates[w] & row[w];
+                empty = empty && next[w] == 0;
+            }
+            clique.push_back(v);
+            if (empty) {
+                if (clique.size() > best_size.load(std::memory_order_relaxed)) {
+                    offer(clique);
+                }
+            } else {
+                expand(clique, std::move(next));
+            }
+            clique.pop_back();
+            candidates[v / 64] &= ~(uint64_t(1) << (v % 64));
+        }
+    }
+};
+
+using Interval = std::pair<double, double>;
+
+/* Deepest point of a set of closed intervals: the overlap interval and its depth */
+std::pair<Interval, size_t> deepest(const std::vector<Interval>& intervals) {
+    std::vector<std::pair<double, int>> events;
+    events.reserve(2 * intervals.size());
+    for (const Interval& interval : intervals) {
+        events.emplace_back(interval.first, 1);
+        events.emplace_back(interval.second, -1);
+    }
+    // Openings sort before closings at equal positions
+    std::sort(events.begin(), events.end(), [](const std::pair<double, int>& a, const std::pair<double, int>& b) {
+        return a.first < b.first || (a.first == b.first && a.second > b.second);
+    });
+    int depth = 0, best_depth = 0;
+    Interval best(1.0, 1.0);
+    for (size_t e = 0; e < events.size(); e++) {
+        depth += events[e].second;
+        if (events[e].second > 0 && depth > best_depth) {
+            best_depth = depth;
+            best = Interval(events[e].first, events[e + 1].first);
+        }
+    }
+    return {best, size_t(best_depth)};
+}
+
+/*
+ * Scale by adaptive voting in two levels. Every pair admits the scales in
+ * [(dt - 2e) / ds, (dt + 2e) / ds]; a single vote over all pairs is swamped
+ * by outlier pairs at high outlier rates, so each correspondence first
+ * finds its own most consistent scale among its pairs, and the scale is
+ * the one most correspondences agree on.
+ */
+double vote_scale(const double* source, const double* target, size_t count, double noise_bound) {
+    std::vector<Interval> peaks(count);
+    std::vector<size_t> depths(count, 0);
+    parallel_for(count, [&](size_t begin, size_t end) {
+        std::vector<Interval> intervals;
+        for (size_t i = begin; i < end; i++) {
+            intervals.clear();
+            for (size_t j = 0; j < count; j++) {
+                double ds = distance(source + 3 * i, source + 3 * j);
+                if (j == i || ds <= 2.0 * noise_bound) {
+                    continue;
+                }
+                double dt = distance(target + 3 * i, target + 3 * j);
+                intervals.emplace_back(std::max(0.0, dt - 2.0 * noise_bound) / ds, (dt + 2.0 * noise_bound) / ds);
+            }
+            if (!intervals.empty()) {
+                std::pair<Interval, size_t> peak = deepest(intervals);
+                peaks[i] = peak.first;
+                depths[i] = peak.second;
+            }
+        }
+    }, 16);
+
+    std::vector<Interval> votes;
+    for (size_t i = 0; i < count; i++) {
+        if (depths[i] > 0) {
+            votes.push_back(peaks[i]);
+        }
+    }
+    if (votes.empty()) {
+        return 1.0;
+    }
+    Interval best = deepest(votes).first;
+    return 0.5 * (best.first + best.second);
+}
+
+ConsistencyGraph consistency_graph(const double* source, const double* target, size_t count,
+                                   double scale, double noise_bound) {
+    ConsistencyGraph graph;
+    graph.size = count;
+    graph.words = (count + 63) / 64;
+    graph.adjacency.assign(count * graph.words, 0);
+    parallel_for(count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            uint64_t* row = &graph.adjacency[i * graph.words];
+            for (size_t j = 0; j < count; j++) {
+                if (j == i) {
+                    continue;
+                }
+                double ds = distance(source + 3 * i, source + 3 * j);
+                double dt = distance(target + 3 * i, target + 3 * j);
+                if (std::fabs(dt - scale * ds) <= 2.0 * noise_bound) {
+                    row[j / 64] |= uint64_t(1) << (j % 64);
+                }
+            }
+        }
+    }, 32);
+    return graph;
+}
+
+/*
+ * Truncated least squares pose on the clique by graduated non-convexity
+ * (Yang et al. 2020): weighted Horn solves while the surrogate cost is
+ * annealed towards TLS. Weights end up (nearly) binary.
+ */
+Pose solve_tls(const std::vector<double>& source, const std::vector<double>& target, double noise_bound,
+               std::vector<double>& weights) {
+    const size_t count = source.size() / 3;
+    const double bound2 = noise_bound * noise_bound;
+    weights.assign(count, 1.0);
+    Pose pose = procrustes(source.data(), target.data(), count, false);
+
+    std::vector<double> residuals(count), mapped(3 * count);
+    auto residuals2 = [&]() {
+        transform_points(pose.transform, source.data(), count, mapped.data());
+        double max_r2 = 0.0;
+        for (size_t i = 0; i < count; i++) {
+            double r2 = 0.0;
+            for (int d = 0; d < 3; d++) {
+                r2 += (mapped[3 * i + d] - target[3 * i + d]) * (mapped[3 * i + d] - target[3 * i + d]);
+            }
+            residuals[i] = r2;
+            max_r2 = std::max(max_r2, r2);
+        }
+        return max_r2;
+    };
+
+    double max_r2 = residuals2();
+    if (max_r2 <= bound2) {
+        return pose;
+    }
+    double mu = bound2 / std::max(2.0 * max_r2 - bound2, 1e-300);
+    for (int iteration = 0; iteration < GNC_MAX_ITERATIONS; iteration++) {
+        bool binary = true;
+        double total = 0.0;
+        for (size_t i = 0; i < count; i++) {
+            double r2 = residuals[i];
+            if (r2 <= mu / (mu + 1.0) * bound2) {
+                weights[i] = 1.0;
+            } else if (r2 >= (mu + 1.0) / mu * bound2) {
+                weights[i] = 0.0;
+            } else {
+                weights[i] = noise_bound * std::sqrt(mu * (mu + 1.0) / r2) - mu;
+                binary = false;
+            }
+            total += weights[i];
+        }
+        if (total <= 0.0) {
+            break;
+        }
+        try {
+            pose = procrustes(source.data(), target.data(), count, false, weights.data());
+        } catch (const std::invalid_argument&) {
+            break;
+        }
+        residuals2();
+        if (binary) {
+            break;
+        }
+        mu *= GNC_FACTOR;
+    }
+    return pose;
+}
+
+}  // namespace
+
+std::vector<uint32_t> max_clique(const ConsistencyGraph& graph) {
+    const size_t n = graph.size, words = graph.words;
+    if (n == 0) {
+        return {};
+    }
+
+    // Degeneracy order by repeatedly removing a vertex of minimum degree (bucket queue)
+    std::vector<size_t> degree(n), core(n), order, position(n);
+    size_t max_degree = 0;
+    for (size_t v = 0; v < n; v++) {
+        degree[v] = popcount(&graph.adjacency[v * words], words);
+        max_degree = std::max(max_degree, degree[v]);
+    }
+    std::vector<std::vector<uint32_t>> buckets(max_degree + 1);
+    for (size_t v = 0; v < n; v++) {
+        buckets[degree[v]].push_back(uint32_t(v));
+    }
+    std::vector<bool> removed(n, false);
+    size_t current = 0;
+    for (size_t d = 0; d <= max_degree;) {
+        if (buckets[d].empty()) {
+            d++;
+            continue;
+        }
+        uint32_t v = buckets[d].back();
+        buckets[d].pop_back();
+        if (removed[v] || degree[v] != d) {
+            continue;
+        }
+        removed[v] = true;
+        current = std::max(current, d);
+        core[v] = current;
+        position[v] = order.size();
+        order.push_back(v);
+        const uint64_t* row = &graph.adjacency[size_t(v) * words];
+        for (size_t w = 0; w < words; w++) {
+            for (uint64_t bits = row[w]; bits; bits &= bits - 1) {
+                size_t u = w * 64 + size_t(__builtin_ctzll(bits));
+                if (!removed[u]) {
+                    degree[u]--;
+                    buckets[degree[u]].push_back(uint32_t(u));
+                }
+            }
+        }
+        d = d > 0 ? d - 1 : 0;
+    }
+
+    // Greedy start from the densest end of the order gives an early bound
+    CliqueSearch search(graph);
+    {
+        std::vector<uint32_t> clique;
+        for (size_t k = n; k-- > 0;) {
+            uint32_t v = uint32_t(order[k]);
+            bool fits = std::all_of(clique.begin(), clique.end(), [&](uint32_t u) { return graph.connected(u, v); });
+            if (fits) {
+                clique.push_back(v);
+            }
+        }
+        search.offer(clique);
+    }
+
+    // One subproblem per vertex: the clique contains it and otherwise only later vertices
+    parallel_for(n, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; k++) {
+            uint32_t v = uint32_t(order[n - 1 - k]);
+            if (core[v] + 1 <= search.best_size.load(std::memory_order_relaxed)) {
+                continue;
+            }
+            std::vector<uint64_t> candidates(words, 0);
+            const uint64_t* row = &graph.adjacency[size_t(v) * words];
+            for (size_t w = 0; w < words; w++) {
+                for (uint64_t bits = row[w]; bits; bits &= bits - 1) {
+                    size_t u = w * 64 + size_t(__builtin_ctzll(bits));
+                    if (position[u] > position[v] && core[u] + 1 > search.best_size.load(std::memory_order_relaxed)) {
+                        candidates[w] |= uint64_t(1) << (u % 64);
+                    }
+                }
+            }
+            std::vector<uint32_t> clique{v};
+            if (popcount(candidates.data(), words) + 1 <= search.best_size.load(std::memory_order_relaxed)) {
+                continue;
+            }
+            search.expand(clique, std::move(candidates));
+        }
+    }, 8);
+
+    std::vector<uint32_t> best = search.best;
+    std::sort(best.begin(), best.end());
+    return best;
+}
+
+RobustPose robust_registration(const double* source, const double* target, size_t count, const RobustParams& params) {
+    if (count < 3) {
+        throw std::invalid_argument("Robust registration needs at least 3 correspondences");
+    }
+    if (!(params.noise_bound > 0)) {
+        throw std::invalid_argument("Robust registration needs a positive noise bound");
+    }
+
+    // Even subsample of oversized inputs keeps the graph and the clique search bounded
+    std::vector<uint32_t> selected;
+    size_t limit = std::max<size_t>(params.max_correspondences, 3);
+    for (size_t k = 0; k < std::min(count, limit); k++) {
+        selected.push_back(uint32_t(count <= limit ? k : k * count / limit));
+    }
+    const size_t n = selected.size();
+    std::vector<double> src(3 * n), tgt(3 * n);
+    for (size_t k = 0; k < n; k++) {
+        std::copy(source + 3 * size_t(selected[k]), source + 3 * size_t(selected[k]) + 3, &src[3 * k]);
+        std::copy(target + 3 * size_t(selected[k]), target + 3 * size_t(selected[k]) + 3, &tgt[3 * k]);
+    }
+
+    RobustPose result;
+    result.scale = params.with_scale ? vote_scale(src.data(), tgt.data(), n, params.noise_bound) : 1.0;
+    ConsistencyGraph graph = consistency_graph(src.data(), tgt.data(), n, result.scale, params.noise_bound);
+    std::vector<uint32_t> clique = max_clique(graph);
+    result.clique_size = clique.size();
+
+    if (clique.size() < 3) {
+        // Nothing consistent beyond a pair: fall back to all correspondences
+        clique.resize(n);
+        for (size_t k = 0; k < n; k++) {
+            clique[k] = uint32_t(k);
+        }
+    }
+
+    // Refine the scale on the clique, then solve rotation and translation on the scaled source
+    if (params.with_scale) {
+        std::vector<double> ratios;
+        for (size_t a = 0; a < clique.size(); a++) {
+            for (size_t b = a + 1; b < clique.size(); b++) {
+                double ds = distance(&src[3 * clique[a]], &src[3 * clique[b]]);
+                if (ds > 2.0 * params.noise_bound) {
+                    ratios.push_back(distance(&tgt[3 * clique[a]], &tgt[3 * clique[b]]) / ds);
+                }
+            }
+        }
+        if (!ratios.empty()) {
+            std::nth_element(ratios.begin(), ratios.begin() + std::ptrdiff_t(ratios.size() / 2), ratios.end());
+            result.scale = ratios[ratios.size() / 2];
+        }
+    }
+    std::vector<double> scaled(3 * clique.size()), matched(3 * clique.size());
+    for (size_t k = 0; k < clique.size(); k++) {
+        for (int d = 0; d < 3; d++) {
+            scaled[3 * k + d] = result.scale * src[3 * clique[k] + d];
+            matched[3 * k + d] = tgt[3 * clique[k] + d];
+        }
+    }
+    std::vector<double> weights;
+    Pose rigid = solve_tls(scaled, matched, params.noise_bound, weights);
+
+    result.pose = rigid;
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) {
+            result.pose.transform[4 * r + c] *= result.scale;
+        }
+    }
+    double cost = 0.0;
+    std::vector<double> mapped(3 * clique.size());
+    transform_points(rigid.transform, scaled.data(), clique.size(), mapped.data());
+    for (size_t k = 0; k < clique.size(); k++) {
+        if (weights[k] < 0.5) {
+            continue;
+        }
+        result.inliers.push_back(selected[clique[k]]);
+        for (int d = 0; d < 3; d++) {
+            cost += (mapped[3 * k + d] - matched[3 * k + d]) * (mapped[3 * k + d] - matched[3 * k + d]);
+        }
+    }
+    result.pose.cost = result.inliers.empty() ? rigid.cost : cost / double(result.inliers.size());
+    return result;
+}
+
+}  // namespace meshmind
@@ -0,0 +1,59 @@
+/**
+ * MeshMind-AFID Native Engine: Outlier-Robust Registration
+ *
+ * TEASER-style registration for correspondence sets with very high outlier
+ * rates. Pairs of correspondences are checked for consistency of their
+ * distances (translation- and rotation-invariant), the largest mutually
+ * consistent set is found as the maximum clique of that graph, and the pose
+ * is solved on the clique with a truncated least squares cost by graduated
+ * non-convexity. Runtime is bounded by the number of correspondences, not
+ * by the outlier rate.
+ */
+
+#pragma once
+
+#include "native/registration.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace meshmind {
+
+struct RobustParams {
+    double noise_bound = 0.0;           /* max inlier residual in target units; <= 0 lets the caller pick one */
+    bool with_scale = true;             /* estimate a uniform scale by adaptive voting */
+    size_t max_correspondences = 1000;  /* larger inputs are subsampled evenly */
+};
+
+struct RobustPose {
+    Pose pose;
+    double scale = 1.0;
+    size_t clique_size = 0;                  /* maximum clique of the consistency graph */
+    std::vector<uint32_t> inliers;           /* correspondences kept by the truncated least squares solve */
+};
+
+/* Consistency graph as adjacency bitsets: row i has bit j set if i and j are consistent */
+struct ConsistencyGraph {
+    size_t size = 0;
+    size_t words = 0;                        /* 64-bit words per row */
+    std::vector<uint64_t> adjacency;         /* [size * words] */
+
+    bool connected(size_t i, size_t j) const { return (adjacency[i * words + j / 64] >> (j % 64)) & 1u; }
+};
+
+/**
+ * An exact maximum clique, found in parallel: vertices are processed in
+ * degeneracy order and each subproblem is a branch and bound over bitsets
+ * with a greedy colouring bound. With several maximum cliques any one of
+ * them may be returned.
+ */
+std::vector<uint32_t> max_clique(const ConsistencyGraph& graph);
+
+/**
+ * Robust pose of source onto target from putative correspondences.
+ * @throws std::invalid_argument for fewer than 3 correspondences or a non-positive noise bound
+ */
+RobustPose robust_registration(const double* source, const double* target, size_t count, const RobustParams& params);
+
+}  // namespace meshmind
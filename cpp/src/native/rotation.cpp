@@ -0,0 +1,247 @@
+/**
+ * MeshMind-AFID Native Engine: Spherical Harmonic Rotation Search
+ */
+
+#include "native/rotation.h"
+
+#include "native/parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace meshmind {
+
+namespace {
+
+const int MAX_BANDWIDTH = 16;
+
+/*
+ * Conjugated spherical harmonics of every point direction, summed per
+ * radial shell: the coefficients of the point set as a sum of delta
+ * functions on each shell. Layout [shell][l^2 + l + m].
+ */
+std::vector<Complex> expand(const double* points, size_t count, const double* center, double radius,
+                            int shells, int bandwidth) {
+    const size_t per_shell = size_t(bandwidth * bandwidth);
+    std::vector<Complex> coefficients(size_t(shells) * per_shell);
+    std::vector<double> legendre(per_shell);
+
+    for (size_t i = 0; i < count; i++) {
+        double v[3] = {points[3 * i] - center[0], points[3 * i + 1] - center[1], points[3 * i + 2] - center[2]};
+        double r = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        if (r > radius || r < 1e-12 * radius) {
+            continue;
+        }
+        int shell = std::min(shells - 1, int(r / radius * shells));
+        double x = v[2] / r;
+        double s = std::sqrt(std::max(0.0, 1.0 - x * x));
+        double phi = std::atan2(v[1], v[0]);
+
+        // Orthonormal associated Legendre functions (Condon-Shortley phase) for m >= 0
+        double pmm = 1.0 / std::sqrt(4.0 * M_PI);
+        for (int m = 0; m < bandwidth; m++) {
+            if (m > 0) {
+                pmm *= -std::sqrt((2.0 * m + 1.0) / (2.0 * m)) * s;
+            }
+            legendre[size_t(m * m + 2 * m)] = pmm;
+            if (m + 1 < bandwidth) {
+                double next = x * std::sqrt(2.0 * m + 3.0) * pmm;
+                legendre[size_t((m + 1) * (m + 1) + (m + 1) + m)] = next;
+                double prev = pmm;
+                for (int l = m + 2; l < bandwidth; l++) {
+                    double a = std::sqrt((4.0 * l * l - 1.0) / double(l * l - m * m));
+                    double b = std::sqrt((double((l - 1) * (l - 1)) - m * m) / (4.0 * (l - 1) * (l - 1) - 1.0));
+                    double value = a * (x * next - b * prev);
+                    legendre[size_t(l * l + l + m)] = value;
+                    prev = next;
+                    next = value;
+                }
+            }
+        }
+
+        Complex* out = &coefficients[size_t(shell) * per_shell];
+        for (int m = 0; m < bandwidth; m++) {
+            // conj(Y_lm) and conj(Y_l,-m) = (-1)^m Y_lm
+            Complex phase = std::polar(1.0, -m * phi);
+            double sign = (m % 2) ? -1.0 : 1.0;
+            for (int l = std::max(m, 1); l < bandwidth; l++) {
+                double p = legendre[size_t(l * l + l + m)];
+                out[l * l + l + m] += p * phase;
+                if (m > 0) {
+                    out[l * l + l - m] += sign * p * std::conj(phase);
+                }
+            }
+        }
+    }
+    return coefficients;
+}
+
+double norm(const std::vector<Complex>& coefficients) {
+    double sum = 0.0;
+    for (const Complex& c : coefficients) {
+        sum += std::norm(c);
+    }
+    return std::sqrt(sum);
+}
+
+/* Wigner small-d d^l_{m'm}(beta) by the explicit sum; exact enough for l < 16 */
+double wigner_d(int l, int mp, int m, double beta, const std::vector<double>& factorial) {
+    double c = std::cos(0.5 * beta), s = std::sin(0.5 * beta);
+    double prefactor = std::sqrt(factorial[size_t(l + mp)] * factorial[size_t(l - mp)] *
+                                 factorial[size_t(l + m)] * factorial[size_t(l - m)]);
+    double sum = 0.0;
+    for (int k = std::max(0, m - mp); k <= std::min(l + m, l - mp); k++) {
+        double term = std::pow(c, 2 * l + m - mp - 2 * k) * std::pow(s, mp - m + 2 * k) /
+                      (factorial[size_t(l + m - k)] * factorial[size_t(k)] *
+                       factorial[size_t(mp - m + k)] * factorial[size_t(l - mp - k)]);
+        sum += ((mp - m + k) % 2) ? -term : term;
+    }
+    return prefactor * sum;
+}
+
+/* R = Rz(alpha) Ry(beta) Rz(gamma) */
+void euler_zyz(double alpha, double beta, double gamma, double* r) {
+    double ca = std::cos(alpha), sa = std::sin(alpha);
+    double cb = std::cos(beta), sb = std::sin(beta);
+    double cg = std::cos(gamma), sg = std::sin(gamma);
+    r[0] = ca * cb * cg - sa * sg;  r[1] = -ca * cb * sg - sa * cg;  r[2] = ca * sb;
+    r[3] = sa * cb * cg + ca * sg;  r[4] = -sa * cb * sg + ca * cg;  r[5] = sa * sb;
+    r[6] = -sb * cg;                r[7] = sb * sg;                  r[8] = cb;
+}
+
+/* Rotation angle between two rotation matrices */
+double rotation_distance(const double* a, const double* b) {
+    double trace = 0.0;
+    for (int k = 0; k < 9; k++) {
+        trace += a[k] * b[k];
+    }
+    return std::acos(std::max(-1.0, std::min(1.0, 0.5 * (trace - 1.0))));
+}
+
+}  // namespace
+
+RotationSearch::RotationSearch(const double* points, size_t count, const double center[3], double radius,
+                               const RotationParams& params)
+    : params_(params), radius_(radius) {
+    if (params.bandwidth < 1 || params.bandwidth > MAX_BANDWIDTH) {
+        throw std::invalid_argument("Rotation search bandwidth must be between 1 and 16");
+    }
+    if (!(radius > 0) || params.shells < 1) {
+        throw std::invalid_argument("Rotation search needs a positive radius and at least one shell");
+    }
+    const int bandwidth = params.bandwidth;
+    template_ = expand(points, count, center, radius, params.shells, bandwidth);
+    template_norm_ = norm(template_);
+
+    // All m' and m of a degree must map to distinct grid frequencies
+    angles_ = fft_size(std::max(params.angle_samples, size_t(2 * bandwidth)));
+    tilts_ = std::max<size_t>(angles_ / 2, 1);
+    plan_ = FFTPlan(angles_);
+
+    std::vector<double> factorial(size_t(2 * bandwidth + 1), 1.0);
+    for (size_t k = 1; k < factorial.size(); k++) {
+        factorial[k] = factorial[k - 1] * double(k);
+    }
+    size_t per_tilt = 0;
+    for (int l = 1; l < bandwidth; l++) {
+        per_tilt += size_t((2 * l + 1) * (2 * l + 1));
+    }
+    wigner_.resize(tilts_ * per_tilt);
+    for (size_t t = 0; t < tilts_; t++) {
+        double beta = M_PI * (2.0 * double(t) + 1.0) / (2.0 * double(tilts_));
+        double* d = &wigner_[t * per_tilt];
+        for (int l = 1; l < bandwidth; l++) {
+            for (int mp = -l; mp <= l; mp++) {
+                for (int m = -l; m <= l; m++) {
+                    *d++ = wigner_d(l, mp, m, beta, factorial);
+                }
+            }
+        }
+    }
+}
+
+std::vector<RotationCandidate> RotationSearch::search(const double* points, size_t count, const double center[3],
+                                                      size_t max_rotations) const {
+    const int bandwidth = params_.bandwidth;
+    const size_t per_shell = size_t(bandwidth * bandwidth);
+    std::vector<Complex> target = expand(points, count, center, radius_, params_.shells, bandwidth);
+    double scale = norm(target) * template_norm_;
+    if (!(scale > 0) || max_rotations == 0) {
+        return {};
+    }
+
+    // Cross terms f_lm' conj(g_lm) summed over shells, in Wigner table order
+    const size_t per_tilt = wigner_.size() / tilts_;
+    std::vector<Complex> cross(per_tilt);
+    Complex* c = cross.data();
+    for (int l = 1; l < bandwidth; l++) {
+        for (int mp = -l; mp <= l; mp++) {
+            for (int m = -l; m <= l; m++) {
+                Complex sum = 0.0;
+                for (int s = 0; s < params_.shells; s++) {
+                    const size_t base = size_t(s) * per_shell;
+                    sum += target[base + size_t(l * l + l + mp)] * std::conj(template_[base + size_t(l * l + l + m)]);
+                }
+                *c++ = sum;
+            }
+        }
+    }
+
+    // C(alpha, beta, gamma) = sum_{m', m} S_{m'm}(beta) e^{i m' alpha} e^{i m gamma}: a 2D inverse FFT per tilt
+    const size_t n = angles_;
+    std::vector<double> correlation(tilts_ * n * n);
+    parallel_for(tilts_, [&](size_t begin, size_t end) {
+        std::vector<Complex> grid(n * n), line(n), column(n * n);
+        for (size_t t = begin; t < end; t++) {
+            std::fill(grid.begin(), grid.end(), Complex(0.0));
+            const double* d = &wigner_[t * per_tilt];
+            const Complex* x = cross.data();
+            for (int l = 1; l < bandwidth; l++) {
+                for (int mp = -l; mp <= l; mp++) {
+                    Complex* row = &grid[(size_t(mp + int(n)) % n) * n];
+                    for (int m = -l; m <= l; m++) {
+                        row[size_t(m + int(n)) % n] += *x++ * *d++;
+                    }
+                }
+            }
+            for (size_t r = 0; r < n; r++) {
+                plan_.execute(&grid[r * n], 1, line.data(), true);
+                std::copy(line.begin(), line.end(), &column[r * n]);
+            }
+            for (size_t k = 0; k < n; k++) {
+                plan_.execute(&column[k], n, line.data(), true);
+                for (size_t a = 0; a < n; a++) {
+                    correlation[(t * n + a) * n + k] = line[a].real() / scale;
+                }
+            }
+        }
+    }, 1);
+
+    std::vector<size_t> order(correlation.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return correlation[a] > correlation[b]; });
+
+    std::vector<RotationCandidate> candidates;
+    for (size_t cell : order) {
+        size_t t = cell / (n * n), a = (cell / n) % n, g = cell % n;
+        RotationCandidate candidate;
+        euler_zyz(2.0 * M_PI * double(a) / double(n), M_PI * (2.0 * double(t) + 1.0) / (2.0 * double(tilts_)),
+                  2.0 * M_PI * double(g) / double(n), candidate.rotation);
+        candidate.score = correlation[cell];
+        bool separated = true;
+        for (const auto& kept : candidates) {
+            separated = separated && rotation_distance(kept.rotation, candidate.rotation) >= params_.min_separation;
+        }
+        if (separated) {
+            candidates.push_back(candidate);
+            if (candidates.size() == max_rotations) {
+                break;
+            }
+        }
+    }
+    return candidates;
+}
+
+}  // namespace meshmind
@@ -0,0 +1,64 @@
+/**
+ * MeshMind-AFID Native Engine: Spherical Harmonic Rotation Search
+ *
+ * Orientation of a template without point correspondences: the template and
+ * a target patch around a localised position are expanded in spherical
+ * harmonics on concentric shells, and their correlation over all rotations
+ * is evaluated at once with an SO(3) Fourier transform (FFT over the two
+ * ZYZ Euler angles about z, direct sum over the tilt). The best rotations
+ * are returned for pose refinement.
+ */
+
+#pragma once
+
+#include "native/fft.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace meshmind {
+
+struct RotationParams {
+    int bandwidth = 8;              /* harmonic degrees 1 .. bandwidth - 1 (1 .. 16) */
+    int shells = 4;                 /* radial shells of equal width */
+    size_t angle_samples = 32;      /* grid size over 2 pi for the two z angles; the tilt gets half */
+    double min_separation = 0.35;   /* radians between returned rotations */
+};
+
+struct RotationCandidate {
+    double rotation[9];   /* row-major, rotates the template about its center onto the target */
+    double score;         /* normalised correlation in [-1, 1] */
+};
+
+class RotationSearch {
+public:
+    /**
+     * Expand the template points inside radius of center (typically all of
+     * them, around the centroid).
+     * @throws std::invalid_argument for a bandwidth outside 1 .. 16 or a non-positive radius
+     */
+    RotationSearch(const double* points, size_t count, const double center[3], double radius,
+                   const RotationParams& params = RotationParams());
+
+    double radius() const { return radius_; }
+
+    /**
+     * Best rotations of the template onto the target points inside radius of
+     * center, strongest first. Candidates closer than min_separation to a
+     * stronger one are suppressed.
+     */
+    std::vector<RotationCandidate> search(const double* points, size_t count, const double center[3],
+                                          size_t max_rotations = 4) const;
+
+private:
+    RotationParams params_;
+    double radius_;
+    size_t angles_;                    /* grid size for the two z angles */
+    size_t tilts_;                     /* grid size for the tilt */
+    std::vector<Complex> template_;    /* [shells * bandwidth^2] coefficients, (l, m) at l^2 + l + m */
+    double template_norm_;
+    std::vector<double> wigner_;       /* d^l_{m'm}(beta) per tilt sample, degrees 1 .. bandwidth - 1 */
+    FFTPlan plan_;
+};
+
+}  // namespace meshmind
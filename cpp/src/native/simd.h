@@ -0,0 +1,221 @@
+/**
+ * MeshMind-AFID Native Engine: SIMD Lanes
+ *
+ * A few double-precision vector operations over the widest registers the
+ * target architecture offers (AVX-512, AVX2/FMA, NEON, SSE2), with a portable
+ * fallback. Kernels
+ * written against these operate on LANES independent problems at once.
+ * Single precision has the arithmetic subset in VecF, FLOAT_LANES wide.
+ * The instruction set is selected at compile time. Everything sits in an
+ * inline namespace named after it, so units built with extra -m flags for
+ * run-time dispatch (transform_avx2.cpp, ...) get their own symbols instead
+ * of sharing inline functions with the baseline build.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define MESHMIND_SIMD_AVX512 1
+#define MESHMIND_SIMD_NAMESPACE avx512
+#elif defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define MESHMIND_SIMD_AVX2 1
+#define MESHMIND_SIMD_NAMESPACE avx2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MESHMIND_SIMD_NEON 1
+#define MESHMIND_SIMD_NAMESPACE neon
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MESHMIND_SIMD_SSE2 1
+#define MESHMIND_SIMD_NAMESPACE sse2
+#else
+#define MESHMIND_SIMD_NAMESPACE portable
+#endif
+
+namespace meshmind {
+namespace simd {
+inline namespace MESHMIND_SIMD_NAMESPACE {
+
+#if defined(MESHMIND_SIMD_AVX512)
+
+constexpr size_t LANES = 8;
+struct Vec { __m512d v; };
+struct Mask { __mmask8 m; };
+
+inline Vec load(const double* p) { return {_mm512_loadu_pd(p)}; }
+inline void store(double* p, Vec a) { _mm512_storeu_pd(p, a.v); }
+inline Vec broadcast(double x) { return {_mm512_set1_pd(x)}; }
+inline Vec operator+(Vec a, Vec b) { return {_mm512_add_pd(a.v, b.v)}; }
+inline Vec operator-(Vec a, Vec b) { return {_mm512_sub_pd(a.v, b.v)}; }
+inline Vec operator*(Vec a, Vec b) { return {_mm512_mul_pd(a.v, b.v)}; }
+inline Vec operator/(Vec a, Vec b) { return {_mm512_div_pd(a.v, b.v)}; }
+inline Vec fmadd(Vec a, Vec b, Vec c) { return {_mm512_fmadd_pd(a.v, b.v, c.v)}; }
+inline Vec sqrt(Vec a) { return {_mm512_sqrt_pd(a.v)}; }
+inline Vec abs(Vec a) { return {_mm512_abs_pd(a.v)}; }
+inline Mask less(Vec a, Vec b) { return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ)}; }
+inline Vec select(Mask m, Vec a, Vec b) { return {_mm512_mask_blend_pd(m.m, b.v, a.v)}; }
+
+constexpr size_t FLOAT_LANES = 16;
+struct VecF { __m512 v; };
+
+inline VecF load(const float* p) { return {_mm512_loadu_ps(p)}; }
+inline void store(float* p, VecF a) { _mm512_storeu_ps(p, a.v); }
+inline VecF broadcast(float x) { return {_mm512_set1_ps(x)}; }
+inline VecF operator+(VecF a, VecF b) { return {_mm512_add_ps(a.v, b.v)}; }
+inline VecF operator-(VecF a, VecF b) { return {_mm512_sub_ps(a.v, b.v)}; }
+inline VecF operator*(VecF a, VecF b) { return {_mm512_mul_ps(a.v, b.v)}; }
+inline VecF fmadd(VecF a, VecF b, VecF c) { return {_mm512_fmadd_ps(a.v, b.v, c.v)}; }
+
+#elif defined(MESHMIND_SIMD_AVX2)
+
+constexpr size_t LANES = 4;
+struct Vec { __m256d v; };
+struct Mask { __m256d m; };
+
+inline Vec load(const double* p) { return {_mm256_loadu_pd(p)}; }
+inline void store(double* p, Vec a) { _mm256_storeu_pd(p, a.v); }
+inline Vec broadcast(double x) { return {_mm256_set1_pd(x)}; }
+inline Vec operator+(Vec a, Vec b) { return {_mm256_add_pd(a.v, b.v)}; }
+inline Vec operator-(Vec a, Vec b) { return {_mm256_sub_pd(a.v, b.v)}; }
+inline Vec operator*(Vec a, Vec b) { return {_mm256_mul_pd(a.v, b.v)}; }
+inline Vec operator/(Vec a, Vec b) { return {_mm256_div_pd(a.v, b.v)}; }
+inline Vec fmadd(Vec a, Vec b, Vec c) { return {_mm256_fmadd_pd(a.v, b.v, c.v)}; }
+inline Vec sqrt(Vec a) { return {_mm256_sqrt_pd(a.v)}; }
+inline Vec abs(Vec a) { return {_mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v)}; }
+inline Mask less(Vec a, Vec b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ)}; }
+inline Vec select(Mask m, Vec a, Vec b) { return {_mm256_blendv_pd(b.v, a.v, m.m)}; }
+
+constexpr size_t FLOAT_LANES = 8;
+struct VecF { __m256 v; };
+
+inline VecF load(const float* p) { return {_mm256_loadu_ps(p)}; }
+inline void store(float* p, VecF a) { _mm256_storeu_ps(p, a.v); }
+inline VecF broadcast(float x) { return {_mm256_set1_ps(x)}; }
+inline VecF operator+(VecF a, VecF b) { return {_mm256_add_ps(a.v, b.v)}; }
+inline VecF operator-(VecF a, VecF b) { return {_mm256_sub_ps(a.v, b.v)}; }
+inline VecF operator*(VecF a, VecF b) { return {_mm256_mul_ps(a.v, b.v)}; }
+inline VecF fmadd(VecF a, VecF b, VecF c) { return {_mm256_fmadd_ps(a.v, b.v, c.v)}; }
+
+#elif defined(MESHMIND_SIMD_NEON)
+
+constexpr size_t LANES = 2;
+struct Vec { float64x2_t v; };
+struct Mask { uint64x2_t m; };
+
+inline Vec load(const double* p) { return {vld1q_f64(p)}; }
+inline void store(double* p, Vec a) { vst1q_f64(p, a.v); }
+inline Vec broadcast(double x) { return {vdupq_n_f64(x)}; }
+inline Vec operator+(Vec a, Vec b) { return {vaddq_f64(a.v, b.v)}; }
+inline Vec operator-(Vec a, Vec b) { return {vsubq_f64(a.v, b.v)}; }
+inline Vec operator*(Vec a, Vec b) { return {vmulq_f64(a.v, b.v)}; }
+inline Vec operator/(Vec a, Vec b) { return {vdivq_f64(a.v, b.v)}; }
+inline Vec fmadd(Vec a, Vec b, Vec c) { return {vfmaq_f64(c.v, a.v, b.v)}; }
+inline Vec sqrt(Vec a) { return {vsqrtq_f64(a.v)}; }
+inline Vec abs(Vec a) { return {vabsq_f64(a.v)}; }
+inline Mask less(Vec a, Vec b) { return {vcltq_f64(a.v, b.v)}; }
+inline Vec select(Mask m, Vec a, Vec b) { return {vbslq_f64(m.m, a.v, b.v)}; }
+
+constexpr size_t FLOAT_LANES = 4;
+struct VecF { float32x4_t v; };
+
+inline VecF load(const float* p) { return {vld1q_f32(p)}; }
+inline void store(float* p, VecF a) { vst1q_f32(p, a.v); }
+inline VecF broadcast(float x) { return {vdupq_n_f32(x)}; }
+inline VecF operator+(VecF a, VecF b) { return {vaddq_f32(a.v, b.v)}; }
+inline VecF operator-(VecF a, VecF b) { return {vsubq_f32(a.v, b.v)}; }
+inline VecF operator*(VecF a, VecF b) { return {vmulq_f32(a.v, b.v)}; }
+inline VecF fmadd(VecF a, VecF b, VecF c) { return {vfmaq_f32(c.v, a.v, b.v)}; }
+
+#elif defined(MESHMIND_SIMD_SSE2)
+
+/* Baseline x86-64: no FMA or blend instructions */
+constexpr size_t LANES = 2;
+struct Vec { __m128d v; };
+struct Mask { __m128d m; };
+
+inline Vec load(const double* p) { return {_mm_loadu_pd(p)}; }
+inline void store(double* p, Vec a) { _mm_storeu_pd(p, a.v); }
+inline Vec broadcast(double x) { return {_mm_set1_pd(x)}; }
+inline Vec operator+(Vec a, Vec b) { return {_mm_add_pd(a.v, b.v)}; }
+inline Vec operator-(Vec a, Vec b) { return {_mm_sub_pd(a.v, b.v)}; }
+inline Vec operator*(Vec a, Vec b) { return {_mm_mul_pd(a.v, b.v)}; }
+inline Vec operator/(Vec a, Vec b) { return {_mm_div_pd(a.v, b.v)}; }
+inline Vec fmadd(Vec a, Vec b, Vec c) { return {_mm_add_pd(_mm_mul_pd(a.v, b.v), c.v)}; }
+inline Vec sqrt(Vec a) { return {_mm_sqrt_pd(a.v)}; }
+inline Vec abs(Vec a) { return {_mm_andnot_pd(_mm_set1_pd(-0.0), a.v)}; }
+inline Mask less(Vec a, Vec b) { return {_mm_cmplt_pd(a.v, b.v)}; }
+inline Vec select(Mask m, Vec a, Vec b) { return {_mm_or_pd(_mm_and_pd(m.m, a.v), _mm_andnot_pd(m.m, b.v))}; }
+
+constexpr size_t FLOAT_LANES = 4;
+struct VecF { __m128 v; };
+
+inline VecF load(const float* p) { return {_mm_loadu_ps(p)}; }
+inline void store(float* p, VecF a) { _mm_storeu_ps(p, a.v); }
+inline VecF broadcast(float x) { return {_mm_set1_ps(x)}; }
+inline VecF operator+(VecF a, VecF b) { return {_mm_add_ps(a.v, b.v)}; }
+inline VecF operator-(VecF a, VecF b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline VecF operator*(VecF a, VecF b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline VecF fmadd(VecF a, VecF b, VecF c) { return {_mm_add_ps(_mm_mul_ps(a.v, b.v), c.v)}; }
+
+#else
+
+/* Portable fallback for other architectures; fixed-size loops the compiler may vectorise */
+constexpr size_t LANES = 4;
+struct Vec { double v[LANES]; };
+struct Mask { bool m[LANES]; };
+
+#define MESHMIND_SIMD_LANEWISE(expr) \
+    Vec r;                           \
+    for (size_t i = 0; i < LANES; i++) { r.v[i] = (expr); } \
+    return r
+
+inline Vec load(const double* p) { MESHMIND_SIMD_LANEWISE(p[i]); }
+inline void store(double* p, Vec a) { for (size_t i = 0; i < LANES; i++) { p[i] = a.v[i]; } }
+inline Vec broadcast(double x) { MESHMIND_SIMD_LANEWISE(x); }
+inline Vec operator+(Vec a, Vec b) { MESHMIND_SIMD_LANEWISE(a.v[i] + b.v[i]); }
+inline Vec operator-(Vec a, Vec b) { MESHMIND_SIMD_LANEWISE(a.v[i] - b.v[i]); }
+inline Vec operator*(Vec a, Vec b) { MESHMIND_SIMD_LANEWISE(a.v[i] * b.v[i]); }
+inline Vec operator/(Vec a, Vec b) { MESHMIND_SIMD_LANEWISE(a.v[i] / b.v[i]); }
+inline Vec fmadd(Vec a, Vec b, Vec c) { MESHMIND_SIMD_LANEWISE(a.v[i] * b.v[i] + c.v[i]); }
+inline Vec sqrt(Vec a) { MESHMIND_SIMD_LANEWISE(std::sqrt(a.v[i])); }
+inline Vec abs(Vec a) { MESHMIND_SIMD_LANEWISE(std::fabs(a.v[i])); }
+inline Vec select(Mask m, Vec a, Vec b) { MESHMIND_SIMD_LANEWISE(m.m[i] ? a.v[i] : b.v[i]); }
+inline Mask less(Vec a, Vec b) {
+    Mask r;
+    for (size_t i = 0; i < LANES; i++) {
+        r.m[i] = a.v[i] < b.v[i];
+    }
+    return r;
+}
+
+constexpr size_t FLOAT_LANES = 8;
+struct VecF { float v[FLOAT_LANES]; };
+
+#define MESHMIND_SIMD_LANEWISE_F(expr) \
+    VecF r;                            \
+    for (size_t i = 0; i < FLOAT_LANES; i++) { r.v[i] = (expr); } \
+    return r
+
+inline VecF load(const float* p) { MESHMIND_SIMD_LANEWISE_F(p[i]); }
+inline void store(float* p, VecF a) { for (size_t i = 0; i < FLOAT_LANES; i++) { p[i] = a.v[i]; } }
+inline VecF broadcast(float x) { MESHMIND_SIMD_LANEWISE_F(x); }
+inline VecF operator+(VecF a, VecF b) { MESHMIND_SIMD_LANEWISE_F(a.v[i] + b.v[i]); }
+inline VecF operator-(VecF a, VecF b) { MESHMIND_SIMD_LANEWISE_F(a.v[i] - b.v[i]); }
+inline VecF operator*(VecF a, VecF b) { MESHMIND_SIMD_LANEWISE_F(a.v[i] * b.v[i]); }
+inline VecF fmadd(VecF a, VecF b, VecF c) { MESHMIND_SIMD_LANEWISE_F(a.v[i] * b.v[i] + c.v[i]); }
+
+#undef MESHMIND_SIMD_LANEWISE
+#undef MESHMIND_SIMD_LANEWISE_F
+
+#endif
+
+inline Vec operator-(Vec a) { return broadcast(0.0) - a; }
+
+}  // namespace MESHMIND_SIMD_NAMESPACE
+}  // namespace simd
+}  // namespace meshmind
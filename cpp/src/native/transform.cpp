@@ -0,0 +1,123 @@
+/**
+ * MeshMind-AFID Native Engine: Batched Transforms
+ */
+
+#include "native/transform.h"
+#include "native/parallel.h"
+#include "native/transform_kernels_impl.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace meshmind {
+
+namespace {
+
+// Points per block: the block's columns stay in L1 while every pose passes over them
+constexpr size_t BLOCK = 1024;
+
+const TransformLaneKernels<double>& lane_kernels(const double*) { return transform_kernels().f64; }
+const TransformLaneKernels<float>& lane_kernels(const float*) { return transform_kernels().f32; }
+
+/*
+ * Few points, many poses: the matrix entries are transposed into one column
+ * per entry so that a vector holds the same entry of `lanes` poses.
+ */
+template <typename T>
+void transform_poses(const TransformLaneKernels<T>& kernels, const double* transforms, size_t poses,
+                     bool translate, const T* x, const T* y, const T* z, size_t count, T* out_x, T* out_y,
+                     T* out_z) {
+    const size_t W = kernels.lanes;
+    std::vector<T> entries(12 * poses);
+    for (size_t p = 0; p < poses; p++) {
+        for (size_t e = 0; e < 12; e++) {
+            entries[e * poses + p] = (e % 4 == 3 && !translate) ? T(0) : T(transforms[16 * p + e]);
+        }
+    }
+
+    parallel_for((poses + W - 1) / W, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; block++) {
+            size_t p0 = block * W;
+            if (p0 + W <= poses) {
+                kernels.poses(entries.data(), poses, p0, x, y, z, count, out_x, out_y, out_z);
+                continue;
+            }
+            for (size_t p = p0; p < poses; p++) {
+                kernels.points(transforms + 16 * p, translate, x, y, z, 0, count, out_x + p * count,
+                               out_y + p * count, out_z + p * count);
+            }
+        }
+    }, std::max<size_t>(1, 4096 / (W * std::max<size_t>(count, 1))));
+}
+
+template <typename T>
+void transform_batch_impl(const double* transforms, size_t poses, const T* x, const T* y, const T* z, size_t count,
+                          T* out_x, T* out_y, T* out_z, bool translate) {
+    if (poses == 0 || count == 0) {
+        return;
+    }
+    const TransformLaneKernels<T>& kernels = lane_kernels(x);
+    if (count < kernels.lanes && poses >= kernels.lanes) {
+        transform_poses(kernels, transforms, poses, translate, x, y, z, count, out_x, out_y, out_z);
+        return;
+    }
+
+    size_t blocks = (count + BLOCK - 1) / BLOCK;
+    parallel_for(blocks * poses, [&](size_t begin, size_t end) {
+        // Work items are ordered block-major, so a chunk reuses each block across poses
+        for (size_t item = begin; item < end; item++) {
+            size_t block = item / poses, p = item % poses;
+            size_t first = block * BLOCK, last = std::min(count, first + BLOCK);
+            kernels.points(transforms + 16 * p, translate, x, y, z, first, last, out_x + p * count,
+                           out_y + p * count, out_z + p * count);
+        }
+    }, std::max<size_t>(1, 16384 / BLOCK));
+}
+
+}  // namespace
+
+const TransformKernels& transform_kernels_baseline() {
+    static const TransformKernels kernels = kernel_table("baseline");
+    return kernels;
+}
+
+const TransformKernels& transform_kernels() {
+    static const TransformKernels& kernels = []() -> const TransformKernels& {
+#if defined(MESHMIND_CPU_DISPATCH)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return transform_kernels_avx512();
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return transform_kernels_avx2();
+        }
+#endif
+        return transform_kernels_baseline();
+    }();
+    return kernels;
+}
+
+PointColumns point_columns(const double* points, size_t count) {
+    PointColumns columns;
+    columns.x.resize(count);
+    columns.y.resize(count);
+    columns.z.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        columns.x[i] = points[3 * i];
+        columns.y[i] = points[3 * i + 1];
+        columns.z[i] = points[3 * i + 2];
+    }
+    return columns;
+}
+
+void transform_batch(const double* transforms, size_t poses, const double* x, const double* y, const double* z,
+                     size_t count, double* out_x, double* out_y, double* out_z, bool translate) {
+    transform_batch_impl(transforms, poses, x, y, z, count, out_x, out_y, out_z, translate);
+}
+
+void transform_batch(const double* transforms, size_t poses, const float* x, const float* y, const float* z,
+                     size_t count, float* out_x, float* out_y, float* out_z, bool translate) {
+    transform_batch_impl(transforms, poses, x, y, z, count, out_x, out_y, out_z, translate);
+}
+
+}  // namespace meshmind
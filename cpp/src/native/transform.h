@@ -0,0 +1,37 @@
+/**
+ * MeshMind-AFID Native Engine: Batched Transforms
+ *
+ * Orientation search, verification and region generation apply many poses
+ * to the same points. These kernels apply poses [poses * 16] (row-major
+ * 4x4) to points stored as separate x, y, z columns, writing one column
+ * block per pose, in float or double. SIMD lanes run across points, or
+ * across poses when there are fewer points than lanes (one offset placed
+ * by every detection, say).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace meshmind {
+
+/* Points [count * 3] split into x, y and z columns */
+struct PointColumns {
+    std::vector<double> x, y, z;
+
+    size_t size() const { return x.size(); }
+};
+
+PointColumns point_columns(const double* points, size_t count);
+
+/**
+ * out_x[p * count + i] (and y, z) is point i under pose p. With translate
+ * false, only the linear part applies, as for direction vectors.
+ */
+void transform_batch(const double* transforms, size_t poses, const double* x, const double* y, const double* z,
+                     size_t count, double* out_x, double* out_y, double* out_z, bool translate = true);
+void transform_batch(const double* transforms, size_t poses, const float* x, const float* y, const float* z,
+                     size_t count, float* out_x, float* out_y, float* out_z, bool translate = true);
+
+}  // namespace meshmind
@@ -0,0 +1,21 @@
+/**
+ * MeshMind-AFID Native Engine: Transform Kernels for AVX2/FMA
+ *
+ * Built with -mavx2 -mfma;
+ * selected at run time by transform_kernels().
+ */
+
+#include "native/transform_kernels_impl.h"
+
+#if !(defined(__AVX2__) && defined(__FMA__))
+#error "transform_avx2.cpp must be built with -mavx2 -mfma"
+#endif
+
+namespace meshmind {
+
+const TransformKernels& transform_kernels_avx2() {
+    static const TransformKernels kernels = kernel_table("avx2");
+    return kernels;
+}
+
+}  // namespace meshmind
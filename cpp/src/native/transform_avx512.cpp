@@ -0,0 +1,21 @@
+/**
+ * MeshMind-AFID Native Engine: Transform Kernels for AVX-512
+ *
+ * Built with -mavx512f;
+ * selected at run time by transform_kernels().
+ */
+
+#include "native/transform_kernels_impl.h"
+
+#if !defined(__AVX512F__)
+#error "transform_avx512.cpp must be built with -mavx512f"
+#endif
+
+namespace meshmind {
+
+const TransformKernels& transform_kernels_avx512() {
+    static const TransformKernels kernels = kernel_table("avx512");
+    return kernels;
+}
+
+}  // namespace meshmind
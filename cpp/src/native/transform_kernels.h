@@ -0,0 +1,51 @@
+/**
+ * MeshMind-AFID Native Engine: Transform Kernel Dispatch
+ *
+ * The inner loops of transform_batch are compiled once for the build's
+ * baseline (transform.cpp) and, on x86-64 with GCC or Clang, once more in
+ * transform_avx2.cpp and transform_avx512.cpp with their own -m flags.
+ * transform_batch blocks and threads the work itself and picks the widest
+ * table the CPU supports at run time.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace meshmind {
+
+template <typename T>
+struct TransformLaneKernels {
+    size_t lanes;
+
+    /* Points [begin, end) of the x, y, z columns moved by one row-major 4x4 pose */
+    void (*points)(const double* transform, bool translate, const T* x, const T* y, const T* z, size_t begin,
+                   size_t end, T* out_x, T* out_y, T* out_z);
+
+    /**
+     * All count points moved by the `lanes` poses starting at `first`. entries
+     * holds the 12 upper matrix entries transposed, entries[e * poses + p],
+     * with the translation already zeroed for vectors.
+     */
+    void (*poses)(const T* entries, size_t poses, size_t first, const T* x, const T* y, const T* z, size_t count,
+                  T* out_x, T* out_y, T* out_z);
+};
+
+struct TransformKernels {
+    const char* isa;
+    TransformLaneKernels<double> f64;
+    TransformLaneKernels<float> f32;
+};
+
+/* Baseline kernels, compiled with the build's own flags */
+const TransformKernels& transform_kernels_baseline();
+
+#if defined(MESHMIND_CPU_DISPATCH)
+const TransformKernels& transform_kernels_avx2();
+const TransformKernels& transform_kernels_avx512();
+#endif
+
+/* Widest kernels the running CPU supports, selected once */
+const TransformKernels& transform_kernels();
+
+}  // namespace meshmind
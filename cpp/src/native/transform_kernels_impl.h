@@ -0,0 +1,94 @@
+/**
+ * MeshMind-AFID Native Engine: Transform Kernels
+ *
+ * Included by one translation unit per instruction set (see
+ * transform_kernels.h); the lanes are those of simd.h for the including
+ * unit's flags. The kernels have internal linkage and call no inline
+ * library templates, so no copy stands in for another at link time.
+ */
+
+#pragma once
+
+#include "native/transform_kernels.h"
+#include "native/simd.h"
+
+namespace meshmind {
+
+namespace {
+
+template <typename T>
+struct Lanes;
+
+template <>
+struct Lanes<double> {
+    using Vec = simd::Vec;
+    static constexpr size_t width = simd::LANES;
+};
+
+template <>
+struct Lanes<float> {
+    using Vec = simd::VecF;
+    static constexpr size_t width = simd::FLOAT_LANES;
+};
+
+template <typename T>
+void transform_points_simd(const double* m, bool translate, const T* x, const T* y, const T* z, size_t begin,
+                           size_t end, T* out_x, T* out_y, T* out_z) {
+    using Vec = typename Lanes<T>::Vec;
+    constexpr size_t W = Lanes<T>::width;
+    const T r[12] = {T(m[0]), T(m[1]), T(m[2]),  T(translate ? m[3] : 0.0),
+                     T(m[4]), T(m[5]), T(m[6]),  T(translate ? m[7] : 0.0),
+                     T(m[8]), T(m[9]), T(m[10]), T(translate ? m[11] : 0.0)};
+    Vec v[12];
+    for (int e = 0; e < 12; e++) {
+        v[e] = simd::broadcast(r[e]);
+    }
+    size_t i = begin;
+    for (; i + W <= end; i += W) {
+        Vec px = simd::load(x + i), py = simd::load(y + i), pz = simd::load(z + i);
+        simd::store(out_x + i, simd::fmadd(v[0], px, simd::fmadd(v[1], py, simd::fmadd(v[2], pz, v[3]))));
+        simd::store(out_y + i, simd::fmadd(v[4], px, simd::fmadd(v[5], py, simd::fmadd(v[6], pz, v[7]))));
+        simd::store(out_z + i, simd::fmadd(v[8], px, simd::fmadd(v[9], py, simd::fmadd(v[10], pz, v[11]))));
+    }
+    for (; i < end; i++) {
+        out_x[i] = r[0] * x[i] + r[1] * y[i] + r[2] * z[i] + r[3];
+        out_y[i] = r[4] * x[i] + r[5] * y[i] + r[6] * z[i] + r[7];
+        out_z[i] = r[8] * x[i] + r[9] * y[i] + r[10] * z[i] + r[11];
+    }
+}
+
+/* A vector holds the same matrix entry of W poses; each point is broadcast against them */
+template <typename T>
+void transform_poses_simd(const T* entries, size_t poses, size_t first, const T* x, const T* y, const T* z,
+                          size_t count, T* out_x, T* out_y, T* out_z) {
+    using Vec = typename Lanes<T>::Vec;
+    constexpr size_t W = Lanes<T>::width;
+    T lane_x[W], lane_y[W], lane_z[W];
+    Vec v[12];
+    for (size_t e = 0; e < 12; e++) {
+        v[e] = simd::load(entries + e * poses + first);
+    }
+    for (size_t i = 0; i < count; i++) {
+        Vec px = simd::broadcast(x[i]), py = simd::broadcast(y[i]), pz = simd::broadcast(z[i]);
+        simd::store(lane_x, simd::fmadd(v[0], px, simd::fmadd(v[1], py, simd::fmadd(v[2], pz, v[3]))));
+        simd::store(lane_y, simd::fmadd(v[4], px, simd::fmadd(v[5], py, simd::fmadd(v[6], pz, v[7]))));
+        simd::store(lane_z, simd::fmadd(v[8], px, simd::fmadd(v[9], py, simd::fmadd(v[10], pz, v[11]))));
+        for (size_t l = 0; l < W; l++) {
+            out_x[(first + l) * count + i] = lane_x[l];
+            out_y[(first + l) * count + i] = lane_y[l];
+            out_z[(first + l) * count + i] = lane_z[l];
+        }
+    }
+}
+
+TransformKernels kernel_table(const char* isa) {
+    return {
+        isa,
+        {Lanes<double>::width, transform_points_simd<double>, transform_poses_simd<double>},
+        {Lanes<float>::width, transform_points_simd<float>, transform_poses_simd<float>},
+    };
+}
+
+}  // namespace
+
+}  // namespace meshmind
@@ -0,0 +1,67 @@
+/**
+ * MeshMind-AFID Native Engine: Pose Verification
+ */
+
+#include "native/verify.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace meshmind {
+
+namespace {
+
+/* Samples looked up between early rejection checks */
+const size_t CHECK_INTERVAL = 32;
+
+}  // namespace
+
+Verification verify_pose(
+    const double* transform,
+    const double* samples,
+    size_t count,
+    const BVH& target,
+    const VerifyParams& params
+) {
+    if (!(params.inlier_distance > 0)) {
+        throw std::invalid_argument("Pose verification needs a positive inlier distance");
+    }
+    Verification result;
+    if (count == 0) {
+        result.rejected = params.min_coverage > 0;
+        return result;
+    }
+
+    // Lookups are bounded by the inlier distance, so misses prune most of the BVH
+    const double bound2 = params.inlier_distance * params.inlier_distance;
+    const double* m = transform;
+    size_t inliers = 0;
+    double sum2 = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        const double* p = samples + 3 * i;
+        double moved[3];
+        for (int r = 0; r < 3; r++) {
+            moved[r] = m[4 * r] * p[0] + m[4 * r + 1] * p[1] + m[4 * r + 2] * p[2] + m[4 * r + 3];
+        }
+        ClosestPoint closest = target.closest_point(moved, bound2);
+        if (closest.face >= 0 && closest.sq_distance <= bound2) {
+            inliers++;
+            sum2 += closest.sq_distance;
+        }
+        result.checked = i + 1;
+
+        if (result.checked % CHECK_INTERVAL == 0 &&
+            double(inliers + count - result.checked) < params.min_coverage * double(count)) {
+            result.rejected = true;
+            break;
+        }
+    }
+
+    result.coverage = result.rejected ? double(inliers + count - result.checked) / double(count)
+                                      : double(inliers) / double(count);
+    result.rms = inliers > 0 ? std::sqrt(sum2 / double(inliers)) : 0.0;
+    result.rejected = result.rejected || result.coverage < params.min_coverage;
+    return result;
+}
+
+}  // namespace meshmind
@@ -0,0 +1,50 @@
+/**
+ * MeshMind-AFID Native Engine: Pose Verification
+ *
+ * Geometric score of a template pose: template surface samples are moved by
+ * the pose and looked up in the target BVH. The fraction within an inlier
+ * distance of the target surface (coverage) and their RMS distance say how
+ * well the template actually sits on the target, unlike descriptor
+ * distances. Scoring stops as soon as the coverage can no longer reach the
+ * required minimum.
+ */
+
+#pragma once
+
+#include "native/bvh.h"
+
+#include <cstddef>
+
+namespace meshmind {
+
+struct VerifyParams {
+    double inlier_distance = 0.0;   /* in target units */
+    double min_coverage = 0.0;      /* stop once coverage cannot reach this */
+};
+
+struct Verification {
+    double coverage = 0.0;   /* fraction of samples within inlier_distance [0,1] */
+    double rms = 0.0;        /* RMS distance of the inlier samples */
+    size_t checked = 0;      /* samples looked up before finishing or stopping */
+    bool rejected = false;   /* stopped early: coverage is an upper bound below min_coverage */
+};
+
+/**
+ * Verify a pose of samples against the target surface. Early rejection
+ * counts every unchecked sample as an inlier, so it never rejects a pose
+ * that could still reach min_coverage; the sample order only decides how
+ * soon it stops. Samples from sample_surface are in Morton order, which
+ * groups misses together; in draw order (see PointSet::order) they are
+ * spread evenly.
+ * @param transform Row-major 4x4 pose mapping samples into the target
+ * @throws std::invalid_argument for a non-positive inlier distance
+ */
+Verification verify_pose(
+    const double* transform,
+    const double* samples,
+    size_t count,
+    const BVH& target,
+    const VerifyParams& params
+);
+
+}  // namespace meshmind
@@ -0,0 +1,425 @@
+/**
+ * MeshMind-AFID Native Engine: Vocabulary Tree
+ */
+
+#include "native/vocab.h"
+#include "native/binary_io.h"
+#include "native/parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace meshmind {
+
+namespace {
+
+const char PACK_MAGIC[4] = {'M', 'M', 'V', 'T'};
+const uint32_t PACK_VERSION = 1;
+
+double squared_distance(const double* a, const double* b, size_t dims) {
+    double sum = 0.0;
+    for (size_t d = 0; d < dims; d++) {
+        double diff = a[d] - b[d];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+/*
+ * k-means on the descriptors selected by indices, seeded by k-means++.
+ * Returns the centroids [k * dims] and the cluster of each selected point.
+ */
+std::vector<double> kmeans(const double* descriptors, size_t dims, const std::vector<uint32_t>& indices,
+                           size_t k, size_t iterations, uint64_t seed, std::vector<uint32_t>& assignment) {
+    const size_t n = indices.size();
+    std::mt19937_64 rng(seed);
+    std::vector<double> centroids(k * dims);
+    std::vector<double> nearest(n, std::numeric_limits<double>::max());
+
+    size_t first = std::uniform_int_distribution<size_t>(0, n - 1)(rng);
+    std::copy_n(descriptors + size_t(indices[first]) * dims, dims, centroids.begin());
+    for (size_t c = 1; c < k; c++) {
+        const double* previous = &centroids[(c - 1) * dims];
+        double total = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            nearest[i] = std::min(nearest[i], squared_distance(descriptors + size_t(indices[i]) * dims, previous, dims));
+            total += nearest[i];
+        }
+        size_t pick = 0;
+        if (total > 0.0) {
+            double r = std::uniform_real_distribution<double>(0.0, total)(rng);
+            while (pick + 1 < n && r >= nearest[pick]) {
+                r -= nearest[pick++];
+            }
+        }
+        std::copy_n(descriptors + size_t(indices[pick]) * dims, dims, centroids.begin() + std::ptrdiff_t(c * dims));
+    }
+
+    assignment.assign(n, 0);
+    for (size_t iteration = 0; iteration < iterations; iteration++) {
+        parallel_for(n, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                const double* x = descriptors + size_t(indices[i]) * dims;
+                double best = std::numeric_limits<double>::max();
+                for (size_t c = 0; c < k; c++) {
+                    double d = squared_distance(x, &centroids[c * dims], dims);
+                    if (d < best) {
+                        best = d;
+                        assignment[i] = uint32_t(c);
+                    }
+                }
+            }
+        }, 512);
+
+        // Empty clusters keep their previous centroid
+        std::vector<double> sums(k * dims, 0.0);
+        std::vector<size_t> counts(k, 0);
+        for (size_t i = 0; i < n; i++) {
+            const double* x = descriptors + size_t(indices[i]) * dims;
+            double* sum = &sums[assignment[i] * dims];
+            for (size_t d = 0; d < dims; d++) {
+                sum[d] += x[d];
+            }
+            counts[assignment[i]]++;
+        }
+        for (size_t c = 0; c < k; c++) {
+            if (counts[c] > 0) {
+                for (size_t d = 0; d < dims; d++) {
+                    centroids[c * dims + d] = sums[c * dims + d] / double(counts[c]);
+                }
+            }
+        }
+    }
+    return centroids;
+}
+
+}  // namespace
+
+VocabularyTree::VocabularyTree(const double* descriptors, size_t count, size_t dims, const VocabularyParams& params)
+    : dims_(dims), branching_(params.branching), depth_(params.depth) {
+    if (count == 0 || dims == 0) {
+        throw std::invalid_argument("Vocabulary tree needs descriptors to train on");
+    }
+    if (params.branching < 2) {
+        throw std::invalid_argument("Vocabulary tree branching must be at least 2");
+    }
+
+    // Breadth-first, so that the children of a node are contiguous
+    struct Pending {
+        uint32_t node;
+        size_t level;
+        std::vector<uint32_t> indices;
+    };
+    std::deque<Pending> pending;
+    Pending root{0, 0, std::vector<uint32_t>(count)};
+    for (size_t i = 0; i < count; i++) {
+        root.indices[i] = uint32_t(i);
+    }
+    nodes_.emplace_back();
+    centroids_.assign(dims, 0.0);
+    for (size_t i = 0; i < count; i++) {
+        for (size_t d = 0; d < dims; d++) {
+            centroids_[d] += descriptors[i * dims + d] / double(count);
+        }
+    }
+    pending.push_back(std::move(root));
+
+    while (!pending.empty()) {
+        Pending item = std::move(pending.front());
+        pending.pop_front();
+        if (item.level >= depth_ || item.indices.size() <= branching_) {
+            continue;
+        }
+
+        std::vector<uint32_t> assignment;
+        std::vector<double> centroids = kmeans(descriptors, dims, item.indices, branching_, params.iterations,
+                                               params.seed + 0x9E3779B97F4A7C15ULL * (item.node + 1), assignment);
+        std::vector<std::vector<uint32_t>> clusters(branching_);
+        for (size_t i = 0; i < item.indices.size(); i++) {
+            clusters[assignment[i]].push_back(item.indices[i]);
+        }
+        size_t non_empty = 0;
+        for (const auto& cluster : clusters) {
+            non_empty += cluster.empty() ? 0 : 1;
+        }
+        if (non_empty < 2) {
+            continue;   // identical descriptors: nothing left to split
+        }
+
+        nodes_[item.node].first_child = uint32_t(nodes_.size());
+        nodes_[item.node].child_count = uint32_t(non_empty);
+        for (size_t c = 0; c < branching_; c++) {
+            if (clusters[c].empty()) {
+                continue;
+            }
+            uint32_t child = uint32_t(nodes_.size());
+            nodes_.emplace_back();
+            centroids_.insert(centroids_.end(), centroids.begin() + std::ptrdiff_t(c * dims),
+                              centroids.begin() + std::ptrdiff_t((c + 1) * dims));
+            pending.push_back(Pending{child, item.level + 1, std::move(clusters[c])});
+        }
+    }
+    assign_words();
+}
+
+VocabularyTree::VocabularyTree(VocabularyTree&& other) noexcept {
+    *this = std::move(other);
+}
+
+VocabularyTree& VocabularyTree::operator=(VocabularyTree&& other) noexcept {
+    if (this != &other) {
+        dims_ = other.dims_;
+        branching_ = other.branching_;
+        depth_ = other.depth_;
+        words_ = other.words_;
+        nodes_ = std::move(other.nodes_);
+        centroids_ = std::move(other.centroids_);
+        labels_ = std::move(other.labels_);
+        histograms_ = std::move(other.histograms_);
+        weights_stale_ = true;
+    }
+    return *this;
+}
+
+void VocabularyTree::assign_words() {
+    words_ = 0;
+    for (auto& node : nodes_) {
+        if (node.child_count == 0) {
+            node.word = uint32_t(words_++);
+        }
+    }
+}
+
+uint32_t VocabularyTree::quantise(const double* descriptor) const {
+    const Node* node = &nodes_[0];
+    while (node->child_count > 0) {
+        uint32_t best_child = node->first_child;
+        double best = std::numeric_limits<double>::max();
+        for (uint32_t c = node->first_child; c < node->first_child + node->child_count; c++) {
+            double d = squared_distance(descriptor, &centroids_[size_t(c) * dims_], dims_);
+            if (d < best) {
+                best = d;
+                best_child = c;
+            }
+        }
+        node = &nodes_[best_child];
+    }
+    return node->word;
+}
+
+VocabularyTree::Histogram VocabularyTree::histogram(const double* descriptors, size_t count) const {
+    std::vector<uint32_t> words(count);
+    parallel_for(count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            words[i] = quantise(descriptors + i * dims_);
+        }
+    });
+    std::sort(words.begin(), words.end());
+
+    Histogram result;
+    for (uint32_t word : words) {
+        if (!result.empty() && result.back().first == word) {
+            result.back().second++;
+        } else {
+            result.emplace_back(word, 1);
+        }
+    }
+    return result;
+}
+
+uint32_t VocabularyTree::add_document(std::string label, const double* descriptors, size_t count) {
+    Histogram words = histogram(descriptors, count);
+    std::lock_guard<std::mutex> lock(weights_mutex_);
+    labels_.push_back(std::move(label));
+    histograms_.push_back(std::move(words));
+    weights_stale_ = true;
+    return uint32_t(labels_.size() - 1);
+}
+
+/*
+ * idf = log(1 + N / n_w) for N documents of which n_w contain the word, so
+ * a word found in every template still counts a little; document vectors
+ * are tf * idf normalised to unit length. Caller holds weights_mutex_.
+ */
+void VocabularyTree::update_weights() const {
+    const size_t documents = labels_.size();
+    std::vector<size_t> frequency(words_, 0);
+    for (const auto& words : histograms_) {
+        for (const auto& entry : words) {
+            frequency[entry.first]++;
+        }
+    }
+    idf_.assign(words_, 0.0);
+    for (size_t w = 0; w < words_; w++) {
+        if (frequency[w] > 0) {
+            idf_[w] = std::log1p(double(documents) / double(frequency[w]));
+        }
+    }
+
+    inverted_.assign(words_, {});
+    for (size_t doc = 0; doc < documents; doc++) {
+        double norm = 0.0;
+        for (const auto& entry : histograms_[doc]) {
+            double weight = entry.second * idf_[entry.first];
+            norm += weight * weight;
+        }
+        norm = norm > 0.0 ? 1.0 / std::sqrt(norm) : 0.0;
+        for (const auto& entry : histograms_[doc]) {
+            inverted_[entry.first].emplace_back(uint32_t(doc), entry.second * idf_[entry.first] * norm);
+        }
+    }
+    weights_stale_ = false;
+}
+
+std::vector<Retrieval> VocabularyTree::query(const double* descriptors, size_t count, size_t top_k) const {
+    Histogram words = histogram(descriptors, count);
+
+    std::lock_guard<std::mutex> lock(weights_mutex_);
+    if (weights_stale_) {
+        update_weights();
+    }
+
+    // Only the inverted lists of the query's words are visited
+    std::vector<double> scores(labels_.size(), 0.0);
+    double norm = 0.0;
+    for (const auto& entry : words) {
+        double weight = entry.second * idf_[entry.first];
+        norm += weight * weight;
+        for (const auto& posting : inverted_[entry.first]) {
+            scores[posting.first] += weight * posting.second;
+        }
+    }
+    norm = norm > 0.0 ? 1.0 / std::sqrt(norm) : 0.0;
+
+    std::vector<Retrieval> ranked(labels_.size());
+    for (size_t doc = 0; doc < labels_.size(); doc++) {
+        ranked[doc] = Retrieval{uint32_t(doc), scores[doc] * norm};
+    }
+    size_t keep = std::min(top_k, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + std::ptrdiff_t(keep), ranked.end(),
+                      [](const Retrieval& a, const Retrieval& b) {
+                          return a.score != b.score ? a.score > b.score : a.document < b.document;
+                      });
+    ranked.resize(keep);
+    return ranked;
+}
+
+std::string VocabularyTree::serialise() const {
+    BinaryWriter payload;
+    payload.put(uint32_t(dims_));
+    payload.put(uint32_t(branching_));
+    payload.put(uint32_t(depth_));
+    payload.put(uint32_t(nodes_.size()));
+    for (size_t i = 0; i < nodes_.size(); i++) {
+        payload.put(nodes_[i].first_child);
+        payload.put(nodes_[i].child_count);
+        for (size_t d = 0; d < dims_; d++) {
+            payload.put(centroids_[i * dims_ + d]);
+        }
+    }
+    payload.put(uint32_t(labels_.size()));
+    for (size_t doc = 0; doc < labels_.size(); doc++) {
+        payload.put_string(labels_[doc]);
+        payload.put(uint32_t(histograms_[doc].size()));
+        for (const auto& entry : histograms_[doc]) {
+            payload.put(entry.first);
+            payload.put(entry.second);
+        }
+    }
+
+    uint64_t checksum = fnv1a(payload.buffer.data(), payload.buffer.size());
+    std::string data(PACK_MAGIC, sizeof(PACK_MAGIC));
+    data.append(reinterpret_cast<const char*>(&PACK_VERSION), sizeof(PACK_VERSION));
+    data.append(payload.buffer);
+    data.append(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+    return data;
+}
+
+void VocabularyTree::save(const std::string& path) const {
+    std::string data = serialise();
+    std::ofstream out(path, std::ios::binary);
+    out.write(data.data(), std::streamsize(data.size()));
+    if (!out) {
+        throw std::runtime_error("Cannot write template pack: " + path);
+    }
+}
+
+VocabularyTree VocabularyTree::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open template pack: " + path);
+    }
+    return deserialise(std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>()), path);
+}
+
+VocabularyTree VocabularyTree::deserialise(const std::string& data, const std::string& path) {
+    const size_t header = sizeof(PACK_MAGIC) + sizeof(uint32_t);
+    if (data.size() < header + sizeof(uint64_t) ||
+        std::memcmp(data.data(), PACK_MAGIC, sizeof(PACK_MAGIC)) != 0) {
+        throw std::runtime_error("Not a template pack: " + path);
+    }
+    uint32_t version = 0;
+    std::memcpy(&version, data.data() + sizeof(PACK_MAGIC), sizeof(version));
+    if (version != PACK_VERSION) {
+        throw std::runtime_error("Unsupported template pack version: " + std::to_string(version));
+    }
+
+    const char* payload = data.data() + header;
+    size_t payload_size = data.size() - header - sizeof(uint64_t);
+    uint64_t checksum = 0;
+    std::memcpy(&checksum, payload + payload_size, sizeof(checksum));
+    if (checksum != fnv1a(payload, payload_size)) {
+        throw std::runtime_error("Template pack checksum mismatch: " + path);
+    }
+
+    BinaryReader reader(payload, payload_size, "Template pack");
+    VocabularyTree tree;
+    tree.dims_ = reader.read<uint32_t>();
+    tree.branching_ = reader.read<uint32_t>();
+    tree.depth_ = reader.read<uint32_t>();
+    tree.nodes_.resize(reader.read<uint32_t>());
+    if (tree.nodes_.empty() || tree.dims_ == 0) {
+        throw std::runtime_error("Template pack has no vocabulary: " + path);
+    }
+    tree.centroids_.resize(tree.nodes_.size() * tree.dims_);
+    for (size_t i = 0; i < tree.nodes_.size(); i++) {
+        Node& node = tree.nodes_[i];
+        node.first_child = reader.read<uint32_t>();
+        node.child_count = reader.read<uint32_t>();
+        if (node.child_count > 0 && (node.first_child <= i || node.first_child > tree.nodes_.size() ||
+                                     node.child_count > tree.nodes_.size() - node.first_child)) {
+            throw std::runtime_error("Template pack has an invalid tree: " + path);
+        }
+        for (size_t d = 0; d < tree.dims_; d++) {
+            tree.centroids_[i * tree.dims_ + d] = reader.read<double>();
+        }
+    }
+    tree.assign_words();
+
+    size_t documents = reader.read<uint32_t>();
+    for (size_t doc = 0; doc < documents; doc++) {
+        tree.labels_.push_back(reader.read_string());
+        Histogram words(reader.read<uint32_t>());
+        for (auto& entry : words) {
+            entry.first = reader.read<uint32_t>();
+            entry.second = reader.read<uint32_t>();
+            if (entry.first >= tree.words_) {
+                throw std::runtime_error("Template pack has an invalid word: " + path);
+            }
+        }
+        tree.histograms_.push_back(std::move(words));
+    }
+    if (!reader.at_end()) {
+        throw std::runtime_error("Trailing data in template pack: " + path);
+    }
+    return tree;
+}
+
+}  // namespace meshmind
@@ -0,0 +1,117 @@
+/**
+ * MeshMind-AFID Native Engine: Vocabulary Tree
+ *
+ * Template retrieval by descriptor words: FPFH descriptors are quantised by
+ * a tree of hierarchical k-means clusters (each leaf is a visual word),
+ * each template is stored as a histogram of its words in an inverted file,
+ * and a target patch is scored against all templates at once by the cosine
+ * of their TF-IDF vectors. Only the best K templates then need the full
+ * descriptor match.
+ *
+ * Template pack (little-endian):
+ *   char[4]  magic "MMVT"
+ *   uint32   format version
+ *   uint32   descriptor dims, branching, depth
+ *   uint32   node count
+ *   per node (parents before children, siblings contiguous):
+ *            uint32 first_child, uint32 child_count (0 = word), float64 centroid[dims]
+ *   uint32   document count
+ *   per document: uint32 label length, char label[], uint32 entries,
+ *                 (uint32 word, uint32 count)[entries]
+ *   uint64   FNV-1a checksum of everything after the magic and version
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace meshmind {
+
+struct VocabularyParams {
+    size_t branching = 8;      /* clusters per k-means */
+    size_t depth = 4;          /* k-means levels; up to branching^depth words */
+    size_t iterations = 10;    /* Lloyd iterations per k-means */
+    uint64_t seed = 0;
+};
+
+/* A document (template) and its similarity to a query, in [0, 1] */
+struct Retrieval {
+    uint32_t document;
+    double score;
+};
+
+class VocabularyTree {
+public:
+    VocabularyTree() = default;
+
+    /**
+     * Train the tree on descriptors [count * dims].
+     * @throws std::invalid_argument for no descriptors or branching < 2
+     */
+    VocabularyTree(const double* descriptors, size_t count, size_t dims,
+                   const VocabularyParams& params = VocabularyParams());
+
+    VocabularyTree(VocabularyTree&& other) noexcept;
+    VocabularyTree& operator=(VocabularyTree&& other) noexcept;
+
+    /* @throws std::runtime_error if the file is missing, corrupt or of another version */
+    static VocabularyTree load(const std::string& path);
+    void save(const std::string& path) const;
+
+    /* The template pack file as bytes, e.g. for embedding in a detector snapshot; path names it in errors */
+    std::string serialise() const;
+    static VocabularyTree deserialise(const std::string& data, const std::string& path);
+
+    size_t dims() const { return dims_; }
+    size_t words() const { return words_; }
+    size_t documents() const { return labels_.size(); }
+    const std::string& label(size_t document) const { return labels_[document]; }
+
+    /* Leaf word of one descriptor [dims] */
+    uint32_t quantise(const double* descriptor) const;
+
+    /* Index the descriptors [count * dims] of a document; returns its id */
+    uint32_t add_document(std::string label, const double* descriptors, size_t count);
+
+    /**
+     * The top_k documents most similar to descriptors [count * dims],
+     * best first. Safe to call from several threads.
+     */
+    std::vector<Retrieval> query(const double* descriptors, size_t count, size_t top_k) const;
+
+private:
+    struct Node {
+        uint32_t first_child = 0;
+        uint32_t child_count = 0;    /* 0 for a word */
+        uint32_t word = 0;
+    };
+
+    /* (word, count) pairs sorted by word */
+    using Histogram = std::vector<std::pair<uint32_t, uint32_t>>;
+
+    Histogram histogram(const double* descriptors, size_t count) const;
+    void assign_words();
+    void update_weights() const;
+
+    size_t dims_ = 0;
+    size_t branching_ = 0;
+    size_t depth_ = 0;
+    size_t words_ = 0;
+    std::vector<Node> nodes_;
+    std::vector<double> centroids_;            /* [nodes * dims] */
+    std::vector<std::string> labels_;
+    std::vector<Histogram> histograms_;        /* per document */
+
+    /* Inverted file and TF-IDF weights, rebuilt on the first query after add_document */
+    mutable std::mutex weights_mutex_;
+    mutable bool weights_stale_ = true;
+    mutable std::vector<double> idf_;                                        /* per word */
+    mutable std::vector<std::vector<std::pair<uint32_t, double>>> inverted_;  /* word -> (document, weight) */
+};
+
+}  // namespace meshmind
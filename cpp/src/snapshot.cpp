@@ -0,0 +1,369 @@
+/**
+ * MeshMind-AFID Detector Snapshots
+ *
+ * File layout (host byte order):
+ *   char[4]  magic "MMSN"
+ *   uint32   format version
+ *   ...      payload (see write_payload)
+ *   uint64   FNV-1a checksum of the payload
+ */
+
+#include "snapshot.h"
+
+#include "native/binary_io.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace meshmind {
+
+namespace {
+
+const char SNAPSHOT_MAGIC[4] = {'M', 'M', 'S', 'N'};
+const uint32_t SNAPSHOT_VERSION = 3;   /* 2 adds template levels and the checkpoint path, 3 the settings */
+
+void write_settings(const SnapshotSettings& settings, BinaryWriter& out) {
+    out.put(static_cast<uint32_t>(settings.search_regions.size()));
+    for (const auto& region : settings.search_regions) {
+        out.put_string(region.feature_id);
+        out.put(static_cast<uint32_t>(region.boxes.size() / 6));
+        out.put_array(region.boxes);
+        out.put(static_cast<uint32_t>(region.parts.size()));
+        out.put_array(region.parts);
+        out.put(region.up_axis);
+        out.put(region.height_min);
+        out.put(region.height_max);
+    }
+    out.put(static_cast<uint32_t>(settings.localisations.size()));
+    for (const auto& localisation : settings.localisations) {
+        out.put_string(localisation.feature_id);
+        out.put(localisation.max_peaks);
+        out.put(localisation.voxel_size);
+    }
+
+    out.put(settings.lod_margin);
+    out.put(settings.ransac_iterations);
+    out.put(settings.ransac_inlier_threshold);
+    out.put(static_cast<uint8_t>(settings.max_clique ? 1 : 0));
+    out.put(settings.noise_bound);
+    out.put(static_cast<uint8_t>(settings.planner ? 1 : 0));
+    out.put(static_cast<uint32_t>(settings.expected_instances.size()));
+    for (const auto& expected : settings.expected_instances) {
+        out.put_string(expected.first);
+        out.put(expected.second);
+    }
+    out.put(settings.icp_iterations);
+    out.put(static_cast<uint8_t>(settings.icp_symmetric ? 1 : 0));
+    out.put(settings.verify_tolerance);
+    out.put(settings.min_confidence);
+    out.put(settings.family_distance);
+    out.put(settings.family_confidence);
+    out.put(settings.retrieval_top_k);
+    out.put_string(settings.template_pack);
+}
+
+void write_payload(const DetectorSnapshot& snapshot, BinaryWriter& out) {
+    out.put_string(snapshot.target_path);
+    out.put(snapshot.target_size);
+    out.put(snapshot.target_mtime);
+
+    out.put(snapshot.index_points);
+    out.put(snapshot.index_dims);
+    out.put_array(snapshot.index_vertices.data(), snapshot.index_vertices.size());
+    out.put_array(snapshot.index_features.data(), snapshot.index_features.size());
+
+    out.put(snapshot.checkpoint_interval);
+    out.put_string(snapshot.checkpoint_path);
+    out.put(snapshot.level_dims);
+    write_settings(snapshot.settings, out);
+
+    out.put(static_cast<uint32_t>(snapshot.templates.size()));
+    for (const auto& tmpl : snapshot.templates) {
+        out.put_string(tmpl.path);
+        out.put_string(tmpl.feature_id);
+        out.put(static_cast<uint8_t>(tmpl.completed ? 1 : 0));
+        out.put(static_cast<uint32_t>(tmpl.results.size()));
+        for (const auto& result : tmpl.results) {
+            out.put_array(result.transform, 16);
+            out.put(result.confidence);
+            out.put(result.radius);
+        }
+
+        out.put(tmpl.lod_points);
+        out.put(tmpl.coarse_points);
+        out.put(tmpl.radius_normal);
+        out.put(tmpl.radius_feature);
+        out.put(tmpl.seed);
+        out.put(static_cast<uint32_t>(tmpl.levels.size()));
+        for (const auto& level : tmpl.levels) {
+            out.put(level.level);
+            out.put(static_cast<uint32_t>(level.points.size() / 3));
+            out.put(static_cast<uint8_t>(level.normals.empty() ? 0 : 1));
+            out.put(static_cast<uint8_t>(level.order.empty() ? 0 : 1));
+            out.put_array(level.points);
+            out.put_array(level.normals);
+            out.put_array(level.order);
+            out.put_array(level.features);
+        }
+    }
+}
+
+bool read_level(BinaryReader& in, uint32_t dims, SnapshotLevel& level) {
+    uint32_t count = 0;
+    uint8_t has_normals = 0, has_order = 0;
+    return in.get(level.level) &&
+           in.get(count) &&
+           in.get(has_normals) &&
+           in.get(has_order) &&
+           in.get_array(level.points, size_t(count) * 3) &&
+           in.get_array(level.normals, has_normals ? size_t(count) * 3 : 0) &&
+           in.get_array(level.order, has_order ? size_t(count) : 0) &&
+           in.get_array(level.features, size_t(count) * dims);
+}
+
+bool read_settings(BinaryReader& in, SnapshotSettings& settings) {
+    uint32_t num_regions = 0;
+    if (!in.get(num_regions)) {
+        return false;
+    }
+    for (uint32_t r = 0; r < num_regions; r++) {
+        SnapshotRegion region;
+        uint32_t num_boxes = 0, num_parts = 0;
+        if (!in.get_string(region.feature_id) ||
+            !in.get(num_boxes) ||
+            !in.get_array(region.boxes, size_t(num_boxes) * 6) ||
+            !in.get(num_parts) ||
+            !in.get_array(region.parts, num_parts) ||
+            !in.get(region.up_axis) ||
+            !in.get(region.height_min) ||
+            !in.get(region.height_max)) {
+            return false;
+        }
+        settings.search_regions.push_back(std::move(region));
+    }
+
+    uint32_t num_localisations = 0;
+    if (!in.get(num_localisations)) {
+        return false;
+    }
+    for (uint32_t l = 0; l < num_localisations; l++) {
+        SnapshotLocalisation localisation;
+        if (!in.get_string(localisation.feature_id) ||
+            !in.get(localisation.max_peaks) ||
+            !in.get(localisation.voxel_size)) {
+            return false;
+        }
+        settings.localisations.push_back(std::move(localisation));
+    }
+
+    uint8_t max_clique = 0, planner = 0, icp_symmetric = 0;
+    uint32_t num_expected = 0;
+    if (!in.get(settings.lod_margin) ||
+        !in.get(settings.ransac_iterations) ||
+        !in.get(settings.ransac_inlier_threshold) ||
+        !in.get(max_clique) ||
+        !in.get(settings.noise_bound) ||
+        !in.get(planner) ||
+        !in.get(num_expected)) {
+        return false;
+    }
+    for (uint32_t e = 0; e < num_expected; e++) {
+        std::pair<std::string, int32_t> expected;
+        if (!in.get_string(expected.first) || !in.get(expected.second)) {
+            return false;
+        }
+        settings.expected_instances.push_back(std::move(expected));
+    }
+    if (!in.get(settings.icp_iterations) ||
+        !in.get(icp_symmetric) ||
+        !in.get(settings.verify_tolerance) ||
+        !in.get(settings.min_confidence) ||
+        !in.get(settings.family_distance) ||
+        !in.get(settings.family_confidence) ||
+        !in.get(settings.retrieval_top_k) ||
+        !in.get_string(settings.template_pack)) {
+        return false;
+    }
+    settings.max_clique = max_clique != 0;
+    settings.planner = planner != 0;
+    settings.icp_symmetric = icp_symmetric != 0;
+    return true;
+}
+
+bool read_payload(BinaryReader& in, uint32_t version, DetectorSnapshot& snapshot) {
+    if (!in.get_string(snapshot.target_path) ||
+        !in.get(snapshot.target_size) ||
+        !in.get(snapshot.target_mtime) ||
+        !in.get(snapshot.index_points) ||
+        !in.get(snapshot.index_dims)) {
+        return false;
+    }
+
+    size_t num_points = snapshot.index_points;
+    if (!in.get_array(snapshot.index_vertices, num_points * 3) ||
+        !in.get_array(snapshot.index_features, num_points * snapshot.index_dims)) {
+        return false;
+    }
+
+    if (!in.get(snapshot.checkpoint_interval)) {
+        return false;
+    }
+    if (version >= 2 && (!in.get_string(snapshot.checkpoint_path) || !in.get(snapshot.level_dims))) {
+        return false;
+    }
+    snapshot.has_settings = version >= 3;
+    if (snapshot.has_settings && !read_settings(in, snapshot.settings)) {
+        return false;
+    }
+
+    uint32_t num_templates = 0;
+    if (!in.get(num_templates)) {
+        return false;
+    }
+
+    snapshot.templates.clear();
+    for (uint32_t t = 0; t < num_templates; t++) {
+        SnapshotTemplate tmpl;
+        uint8_t completed = 0;
+        uint32_t num_results = 0;
+        if (!in.get_string(tmpl.path) ||
+            !in.get_string(tmpl.feature_id) ||
+            !in.get(completed) ||
+            !in.get(num_results)) {
+            return false;
+        }
+        tmpl.completed = completed != 0;
+
+        for (uint32_t r = 0; r < num_results; r++) {
+            SnapshotResult result;
+            std::vector<double> transform;
+            if (!in.get_array(transform, 16) ||
+                !in.get(result.confidence) ||
+                !in.get(result.radius)) {
+                return false;
+            }
+            std::memcpy(result.transform, transform.data(), sizeof(result.transform));
+            tmpl.results.push_back(result);
+        }
+
+        uint32_t num_levels = 0;
+        if (version >= 2 &&
+            (!in.get(tmpl.lod_points) ||
+             !in.get(tmpl.coarse_points) ||
+             !in.get(tmpl.radius_normal) ||
+             !in.get(tmpl.radius_feature) ||
+             !in.get(tmpl.seed) ||
+             !in.get(num_levels))) {
+            return false;
+        }
+        for (uint32_t l = 0; l < num_levels; l++) {
+            SnapshotLevel level;
+            if (!read_level(in, snapshot.level_dims, level)) {
+                return false;
+            }
+            tmpl.levels.push_back(std::move(level));
+        }
+        snapshot.templates.push_back(std::move(tmpl));
+    }
+
+    return in.at_end();
+}
+
+}  // namespace
+
+bool fingerprint_target(DetectorSnapshot& snapshot) {
+    std::error_code ec;
+    auto size = fs::file_size(snapshot.target_path, ec);
+    if (ec) {
+        return false;
+    }
+    auto mtime = fs::last_write_time(snapshot.target_path, ec);
+    if (ec) {
+        return false;
+    }
+    snapshot.target_size = static_cast<uint64_t>(size);
+    snapshot.target_mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+    return true;
+}
+
+std::string write_snapshot(const DetectorSnapshot& snapshot, const std::string& path) {
+    BinaryWriter payload;
+    write_payload(snapshot, payload);
+    uint64_t checksum = fnv1a(payload.buffer.data(), payload.buffer.size());
+
+    std::string tmp_path = path + ".tmp";
+    FILE* file = std::fopen(tmp_path.c_str(), "wb");
+    if (!file) {
+        return "Cannot open snapshot for writing: " + tmp_path;
+    }
+
+    bool ok = std::fwrite(SNAPSHOT_MAGIC, 1, sizeof(SNAPSHOT_MAGIC), file) == sizeof(SNAPSHOT_MAGIC) &&
+              std::fwrite(&SNAPSHOT_VERSION, sizeof(SNAPSHOT_VERSION), 1, file) == 1 &&
+              std::fwrite(payload.buffer.data(), 1, payload.buffer.size(), file) == payload.buffer.size() &&
+              std::fwrite(&checksum, sizeof(checksum), 1, file) == 1 &&
+              std::fflush(file) == 0;
+#ifndef _WIN32
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    ok = (std::fclose(file) == 0) && ok;
+
+    if (!ok) {
+        std::remove(tmp_path.c_str());
+        return "Failed to write snapshot: " + tmp_path;
+    }
+
+    std::error_code ec;
+    fs::rename(tmp_path, path, ec);
+    if (ec) {
+        std::remove(tmp_path.c_str());
+        return "Failed to move snapshot into place: " + ec.message();
+    }
+    return "";
+}
+
+std::string read_snapshot(const std::string& path, DetectorSnapshot& snapshot) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return "Cannot open snapshot: " + path;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    const size_t header_size = sizeof(SNAPSHOT_MAGIC) + sizeof(uint32_t);
+    const size_t trailer_size = sizeof(uint64_t);
+    if (data.size() < header_size + trailer_size ||
+        std::memcmp(data.data(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        return "Not a MeshMind snapshot: " + path;
+    }
+
+    uint32_t version = 0;
+    std::memcpy(&version, data.data() + sizeof(SNAPSHOT_MAGIC), sizeof(version));
+    if (version == 0 || version > SNAPSHOT_VERSION) {
+        return "Unsupported snapshot version " + std::to_string(version);
+    }
+
+    const char* payload = data.data() + header_size;
+    size_t payload_size = data.size() - header_size - trailer_size;
+    uint64_t checksum = 0;
+    std::memcpy(&checksum, payload + payload_size, sizeof(checksum));
+    if (checksum != fnv1a(payload, payload_size)) {
+        return "Snapshot checksum mismatch (file corrupted): " + path;
+    }
+
+    BinaryReader reader(payload, payload_size, "Snapshot");
+    if (!read_payload(reader, version, snapshot)) {
+        return "Malformed snapshot payload: " + path;
+    }
+    return "";
+}
+
+}  // namespace meshmind
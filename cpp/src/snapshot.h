@@ -0,0 +1,133 @@
+/**
+ * MeshMind-AFID Detector Snapshots
+ *
+ * Compact binary serialisation of detector state so that long detection
+ * runs can be resumed after the process is killed (e.g. spot-node preemption).
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace meshmind {
+
+/* Per-template detection result as stored in a snapshot */
+struct SnapshotResult {
+    double transform[16];      /* 4x4 transform matrix (row-major) */
+    double confidence;
+    double radius;
+};
+
+/* One prepared level of detail of a template (see PreparedTemplate) */
+struct SnapshotLevel {
+    uint32_t level = 0;
+    std::vector<double> points;     /* [size * 3] */
+    std::vector<double> normals;    /* [size * 3] or empty */
+    std::vector<uint32_t> order;    /* [size] or empty */
+    std::vector<double> features;   /* [size * dims] */
+};
+
+/* A template added to the detector, its preparation and its progress */
+struct SnapshotTemplate {
+    std::string path;
+    std::string feature_id;
+    bool completed = false;
+    std::vector<SnapshotResult> results;
+
+    /* Sampling parameters of the prepared levels (MatcherParams) */
+    uint64_t lod_points = 0;
+    uint64_t coarse_points = 0;
+    double radius_normal = 0.0;
+    double radius_feature = 0.0;
+    uint64_t seed = 0;
+    std::vector<SnapshotLevel> levels;   /* empty if the template was never prepared */
+};
+
+/* A feature type's search region (see MeshMindSearchRegion) */
+struct SnapshotRegion {
+    std::string feature_id;
+    std::vector<double> boxes;     /* [num_boxes * 6] */
+    std::vector<int32_t> parts;
+    int32_t up_axis = 2;
+    double height_min = 0.0;
+    double height_max = 0.0;
+};
+
+/* A feature type's FFT localisation */
+struct SnapshotLocalisation {
+    std::string feature_id;
+    int32_t max_peaks = 0;
+    double voxel_size = 0.0;
+};
+
+/* Detection settings, as set through the meshmind_set_* calls */
+struct SnapshotSettings {
+    std::vector<SnapshotRegion> search_regions;
+    std::vector<SnapshotLocalisation> localisations;
+    double lod_margin = -1.0;
+    uint64_t ransac_iterations = 0;
+    double ransac_inlier_threshold = 0.0;
+    bool max_clique = false;
+    double noise_bound = 0.0;
+    bool planner = false;
+    std::vector<std::pair<std::string, int32_t>> expected_instances;   /* by feature_id */
+    uint64_t icp_iterations = 0;
+    bool icp_symmetric = false;
+    double verify_tolerance = 0.02;
+    double min_confidence = 0.0;
+    double family_distance = -1.0;
+    double family_confidence = 0.5;
+    uint64_t retrieval_top_k = 0;
+    std::string template_pack;   /* template pack file contents; empty if none is loaded */
+};
+
+/* Everything needed to resume a detector where it stopped */
+struct DetectorSnapshot {
+    /* Target geometry and a fingerprint to detect edits between runs */
+    std::string target_path;
+    uint64_t target_size = 0;
+    int64_t target_mtime = 0;
+
+    /* Prepared target index: coarse samples (N x 3) and descriptors (N x D) */
+    uint32_t index_points = 0;
+    uint32_t index_dims = 0;
+    std::vector<double> index_vertices;
+    std::vector<double> index_features;
+
+    /* Parameters */
+    std::string checkpoint_path;
+    double checkpoint_interval = 0.0;
+
+    /* Descriptor size of the template levels */
+    uint32_t level_dims = 0;
+
+    /* Settings the completed templates were detected with; absent before format version 3 */
+    bool has_settings = false;
+    SnapshotSettings settings;
+
+    std::vector<SnapshotTemplate> templates;
+};
+
+/**
+ * Fill target_size/target_mtime from the file at target_path.
+ * @return false if the file cannot be stat'ed
+ */
+bool fingerprint_target(DetectorSnapshot& snapshot);
+
+/**
+ * Write a snapshot atomically: the data goes to "<path>.tmp", is flushed to
+ * disk and then renamed over <path>, so a reader never sees a partial file.
+ * @return empty string on success, otherwise an error message
+ */
+std::string write_snapshot(const DetectorSnapshot& snapshot, const std::string& path);
+
+/**
+ * Read and validate (magic, version, checksum) a snapshot file.
+ * @return empty string on success, otherwise an error message
+ */
+std::string read_snapshot(const std::string& path, DetectorSnapshot& snapshot);
+
+}  // namespace meshmind
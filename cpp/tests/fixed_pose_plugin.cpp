@@ -0,0 +1,87 @@
+/**
+ * MeshMind C API Tests: Fixed-Pose Plugin
+ *
+ * Reports one detection at the position given as its configuration
+ * ("x y z"), with confidence 1 and, as radius, the distance to the farthest
+ * sample of the target view, so tests can tell which surface it was shown.
+ * An optional fourth value n makes the n-th detect call fail, to interrupt
+ * a detection run. Its descriptor stops after detect (no get_error), the
+ * smallest one the host accepts.
+ */
+
+#include <meshmind/plugin.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+struct FixedPose {
+    double position[3] = {0.0, 0.0, 0.0};
+    int failing_call = 0;   /* 1-based; 0 never fails */
+    int calls = 0;
+};
+
+void* create(const char* config) {
+    FixedPose* pose = new FixedPose;
+    if (config && std::sscanf(config, "%lf %lf %lf %d", &pose->position[0], &pose->position[1], &pose->position[2],
+                              &pose->failing_call) < 3) {
+        delete pose;
+        return nullptr;
+    }
+    return pose;
+}
+
+void destroy(void* instance) {
+    delete static_cast<FixedPose*>(instance);
+}
+
+int detect(void* instance, const MeshMindTargetView* target, const MeshMindTemplateView*,
+           MeshMindPluginDetection* detections, int max_detections) {
+    FixedPose& pose = *static_cast<FixedPose*>(instance);
+    if (++pose.calls == pose.failing_call) {
+        return MESHMIND_PLUGIN_ERROR;
+    }
+    if (max_detections < 1) {
+        return 0;
+    }
+
+    double farthest = 0.0;
+    for (size_t i = 0; i < target->num_points; i++) {
+        double r2 = 0.0;
+        for (int d = 0; d < 3; d++) {
+            double delta = target->points[3 * i + d] - pose.position[d];
+            r2 += delta * delta;
+        }
+        farthest = std::fmax(farthest, std::sqrt(r2));
+    }
+
+    MeshMindPluginDetection& detection = detections[0];
+    std::memset(&detection, 0, sizeof(detection));
+    for (int d = 0; d < 3; d++) {
+        detection.transform[4 * d + d] = 1.0;
+        detection.transform[4 * d + 3] = pose.position[d];
+    }
+    detection.transform[15] = 1.0;
+    detection.confidence = 1.0;
+    detection.radius = farthest;
+    return 1;
+}
+
+const MeshMindDetectorPlugin plugin = {
+    MESHMIND_PLUGIN_ABI_VERSION,
+    offsetof(MeshMindDetectorPlugin, get_error),
+    "fixed_pose",
+    create,
+    destroy,
+    detect,
+    nullptr,
+};
+
+}  // namespace
+
+MESHMIND_PLUGIN_EXPORT const MeshMindDetectorPlugin* meshmind_detector_plugin(void) {
+    return &plugin;
+}
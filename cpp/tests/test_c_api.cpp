@@ -0,0 +1,565 @@
+/**
+ * MeshMind C API Tests
+ *
+ * Each test runs in its own process (test_c_api <name>), since a detector
+ * embeds the Python interpreter and it cannot be started twice. The
+ * automotive templates double as small targets.
+ */
+
+#include <meshmind/core.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static int failures = 0;
+
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            failures++;                                                               \
+        }                                                                             \
+    } while (0)
+
+static std::string asset(const char* name) {
+    return std::string(MESHMIND_TEMPLATE_DIR) + "/" + name;
+}
+
+static std::string read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+/* Detector with the 18" wheel as target and two templates */
+static MeshMindDetector create_wheel_detector() {
+    MeshMindDetector detector = meshmind_create_detector();
+    CHECK(detector != nullptr);
+    if (detector) {
+        CHECK(meshmind_load_target(detector, asset("wheel_18inch.stl").c_str()) == MESHMIND_SUCCESS);
+        CHECK(meshmind_add_template(detector, asset("wheel_18inch.stl").c_str(), "wheel") == MESHMIND_SUCCESS);
+        CHECK(meshmind_add_template(detector, asset("mirror_compact.stl").c_str(), "mirror") == MESHMIND_SUCCESS);
+    }
+    return detector;
+}
+
+/* Number of results of a feature type */
+static int count_results(const MeshMindResults& results, const char* feature_type) {
+    int count = 0;
+    for (int i = 0; i < results.count; i++) {
+        count += std::strcmp(results.feature_type_names[results.feature_types[i]], feature_type) == 0 ? 1 : 0;
+    }
+    return count;
+}
+
+// Saving a restored snapshot gives the same file: template levels and checkpoint settings survive
+static void test_snapshot_round_trip() {
+    MeshMindDetector detector = create_wheel_detector();
+    if (!detector) {
+        return;
+    }
+    MeshMindResults results;
+    int count = meshmind_detect_results(detector, &results);
+    CHECK(count > 0);
+    
+    const std::string first = "c_api_snapshot_first.mmsnap", second = "c_api_snapshot_second.mmsnap";
+    const std::string checkpoint = "c_api_snapshot_checkpoint.mmsnap";
+    CHECK(meshmind_set_checkpoint(detector, checkpoint.c_str(), 30.0) == MESHMIND_SUCCESS);
+    CHECK(meshmind_save_snapshot(detector, first.c_str()) == MESHMIND_SUCCESS);
+    
+    CHECK(meshmind_set_checkpoint(detector, nullptr, 0.0) == MESHMIND_SUCCESS);
+    CHECK(meshmind_load_snapshot(detector, first.c_str()) == MESHMIND_SUCCESS);
+    CHECK(meshmind_save_snapshot(detector, second.c_str()) == MESHMIND_SUCCESS);
+    CHECK(!read_file(first).empty() && read_file(first) == read_file(second));
+    CHECK(meshmind_get_results(detector, &results) == count);
+    
+    // All templates completed: detection only publishes the restored results and checkpoints
+    fs::remove(checkpoint);
+    CHECK(meshmind_detect_results(detector, &results) == count);
+    CHECK(fs::exists(checkpoint));
+    
+    meshmind_destroy_detector(detector);
+    fs::remove(first);
+    fs::remove(second);
+    fs::remove(checkpoint);
+}
+
+// A run interrupted after a checkpoint resumes with its own settings and keeps the completed results
+static void test_snapshot_resume() {
+    MeshMindDetector detector = create_wheel_detector();
+    if (!detector) {
+        return;
+    }
+    const std::string hub = "c_api_resume_hub.stl";
+    fs::copy_file(asset("wheel_18inch.stl"), hub, fs::copy_options::overwrite_existing);
+    CHECK(meshmind_add_template(detector, hub.c_str(), "hub") == MESHMIND_SUCCESS);
+    
+    // The mirror fails verification without a plugin call, so the plugin's second call is the hub's
+    const double box[6] = {-1.0, -1.0, -1.0, 1.0, 1.0, 1.0};
+    MeshMindSearchRegion region;
+    memset(&region, 0, sizeof(region));
+    region.boxes = box;
+    region.num_boxes = 1;
+    region.up_axis = 2;
+    CHECK(meshmind_set_search_region(detector, "hub", &region) == MESHMIND_SUCCESS);
+    CHECK(meshmind_set_verification(detector, 0.02, 0.5) == MESHMIND_SUCCESS);
+    CHECK(meshmind_set_icp(detector, 4, 0) == MESHMIND_SUCCESS);
+    CHECK(meshmind_set_expected_instances(detector, "wheel", 1) == MESHMIND_SUCCESS);
+    CHECK(meshmind_build_template_pack(detector, nullptr, 4, 2) == MESHMIND_SUCCESS);
+    CHECK(meshmind_set_template_retrieval(detector, 2) == MESHMIND_SUCCESS);
+    CHECK(meshmind_load_plugin(detector, MESHMIND_FIXED_POSE_PLUGIN, "0 0 0 2") >= 0);
+    
+    const std::string checkpoint = "c_api_resume_checkpoint.mmsnap", interrupted = "c_api_resume_interrupted.mmsnap";
+    const std::string resaved = "c_api_resume_resaved.mmsnap";
+    CHECK(meshmind_set_checkpoint(detector, checkpoint.c_str(), 0.0) == MESHMIND_SUCCESS);
+    MeshMindResults results;
+    CHECK(meshmind_detect_results(detector, &results) == MESHMIND_ERROR_DETECT);
+    CHECK(fs::exists(checkpoint));
+    fs::copy_file(checkpoint, interrupted, fs::copy_options::overwrite_existing);
+    
+    // Loading replaces the settings changed since, without discarding the restored results
+    CHECK(meshmind_set_verification(detector, 0.02, 0.0) == MESHMIND_SUCCESS);
+    CHECK(meshmind_set_icp(detector, 0, 0) == MESHMIND_SUCCESS);
+    CHECK(meshmind_set_template_retrieval(detector, 0) == MESHMIND_SUCCESS);
+    CHECK(meshmind_set_planner(detector, 1) == MESHMIND_SUCCESS);
+    CHECK(meshmind_load_snapshot(detector, interrupted.c_str()) == MESHMIND_SUCCESS);
+    CHECK(meshmind_save_snapshot(detector, resaved.c_str()) == MESHMIND_SUCCESS);
+    CHECK(!read_file(interrupted).empty() && read_file(interrupted) == read_file(resaved));
+    
+    int restored = meshmind_get_results(detector, &results);
+    CHECK(restored > 0 && count_results(results, "wheel") == restored);
+    std::vector<double> transforms(results.transforms, results.transforms + 16 * std::max(restored, 0));
+    std::vector<double> confidences(results.confidences, results.confidences + std::max(restored, 0));
+    
+    // Only the hub is matched; the wheel keeps its results and the mirror stays rejected
+    int count = meshmind_detect_results(detector, &results);
+    CHECK(count > restored);
+    CHECK(count_results(results, "hub") > 0 && count_results(results, "mirror") == 0);
+    for (int r = 0; r < restored; r++) {
+        bool kept = false;
+        for (int i = 0; i < count; i++) {
+            kept = kept || (results.confidences[i] == confidences[r] &&
+                            std::memcmp(&results.transforms[16 * i], &transforms[16 * r], 16 * sizeof(double)) == 0);
+        }
+        CHECK(kept);
+    }
+    
+    // A snapshot that fails to load leaves the detector as it was
+    CHECK(meshmind_save_snapshot(detector, resaved.c_str()) == MESHMIND_SUCCESS);
+    fs::remove(hub);
+    CHECK(meshmind_load_snapshot(detector, resaved.c_str()) == MESHMIND_ERROR_SNAPSHOT);
+    CHECK(meshmind_get_results(detector, &results) == count);
+    CHECK(meshmind_detect_results(detector, &results) == count);
+    
+    meshmind_destroy_detector(detector);
+    fs::remove(checkpoint);
+    fs::remove(interrupted);
+    fs::remove(resaved);
+}
+
+// SoA views agree with each other and with the per-detection structs
+static void test_soa_results() {
+    MeshMindDetector detector = create_wheel_detector();
+    if (!detector) {
+        return;
+    }
+    MeshMindResults results;
+    int count = meshmind_detect_results(detector, &results);
+    CHECK(count > 0 && results.count == count);
+    CHECK(results.num_feature_types == 2);
+    
+    for (int i = 0; i < count; i++) {
+        CHECK(results.feature_types[i] >= 0 && results.feature_types[i] < results.num_feature_types);
+        CHECK(std::strcmp(results.feature_type_names[results.feature_types[i]],
+                          meshmind_feature_type_name(detector, results.feature_types[i])) == 0);
+        CHECK(i == 0 || results.confidences[i] <= results.confidences[i - 1]);
+        const double* m = &results.transforms[16 * i];
+        for (int d = 0; d < 3; d++) {
+            CHECK(results.positions[3 * i + d] == m[4 * d + 3]);
+        }
+        double det = m[0] * (m[5] * m[10] - m[6] * m[9]) - m[1] * (m[4] * m[10] - m[6] * m[8]) +
+                     m[2] * (m[4] * m[9] - m[5] * m[8]);
+        CHECK(std::fabs(results.scales[i] - std::cbrt(std::fabs(det))) < 1e-12);
+    }
+    
+    // Fixed-size structs hold the same detections, truncated to max_results
+    MeshMindDetection detections[8];
+    CHECK(meshmind_detect(detector, detections, 8) == (count < 8 ? count : 8));
+    CHECK(meshmind_get_results(detector, &results) == count);
+    for (int i = 0; i < count && i < 8; i++) {
+        std::string feature_id = results.feature_type_names[results.feature_types[i]];
+        if (results.instances[i] >= 0) {
+            feature_id += "_" + std::to_string(results.instances[i]);
+        }
+        CHECK(feature_id == detections[i].feature_id);
+        CHECK(std::memcmp(detections[i].transform, &results.transforms[16 * i], sizeof(detections[i].transform)) == 0);
+        CHECK(detections[i].confidence == results.confidences[i]);
+    }
+    CHECK(meshmind_detect(detector, detections, 1) == 1);
+    
+    meshmind_destroy_detector(detector);
+}
+
+// The detector stays busy until meshmind_wait collects the job, then holds its results
+static void test_async_detect() {
+    MeshMindDetector detector = create_wheel_detector();
+    if (!detector) {
+        return;
+    }
+    MeshMindResults results;
+    CHECK(meshmind_wait(detector, 0.0) == MESHMIND_ERROR_INVALID_PARAM);
+    CHECK(meshmind_detect_async(detector) == MESHMIND_SUCCESS);
+    CHECK(meshmind_detect_async(detector) == MESHMIND_ERROR_BUSY);
+    CHECK(meshmind_get_results(detector, &results) == MESHMIND_ERROR_BUSY);
+    CHECK(meshmind_load_target(detector, asset("mirror_compact.stl").c_str()) == MESHMIND_ERROR_BUSY);
+    CHECK(meshmind_feature_type_name(detector, 0) == nullptr);
+    
+    int status = meshmind_wait(detector, 0.0);
+    CHECK(status == MESHMIND_PENDING || status == MESHMIND_SUCCESS);
+    CHECK(meshmind_wait(detector, -1.0) == MESHMIND_SUCCESS);
+    CHECK(meshmind_wait(detector, -1.0) == MESHMIND_ERROR_INVALID_PARAM);
+    
+    int count = meshmind_get_results(detector, &results);
+    CHECK(count > 0);
+    std::vector<double> transforms(results.transforms, results.transforms + 16 * count);
+    
+    // Synchronous detection on a fresh target finds the same poses
+    CHECK(meshmind_load_target(detector, asset("wheel_18inch.stl").c_str()) == MESHMIND_SUCCESS);
+    CHECK(meshmind_detect_results(detector, &results) == count);
+    CHECK(count > 0 && std::memcmp(results.transforms, transforms.data(), transforms.size() * sizeof(double)) == 0);
+    
+    meshmind_destroy_detector(detector);
+}
+
+// Changing a setting after detection makes the next detection match the templates again
+static void test_settings_reset() {
+    MeshMindDetector detector = create_wheel_detector();
+    if (!detector) {
+        return;
+    }
+    MeshMindResults results;
+    MeshMindTemplatePlan plan;
+    int count = meshmind_detect_results(detector, &results);
+    CHECK(count == 2);
+    CHECK(meshmind_get_template_plan(detector, 0, &plan) == MESHMIND_SUCCESS && !plan.planned);
+    
+    // The mirror only covers part of the wheel
+    CHECK(meshmind_set_verification(detector, 0.02, 0.5) == MESHMIND_SUCCESS);
+    CHECK(meshmind_detect_results(detector, &results) == 1);
+    CHECK(std::strcmp(results.feature_type_names[results.feature_types[0]], "wheel") == 0);
+    CHECK(meshmind_set_verification(detector, 0.02, 0.0) == MESHMIND_SUCCESS);
+    CHECK(meshmind_detect_results(detector, &results) == count);
+    
+    CHECK(meshmind_set_planner(detector, 1) == MESHMIND_SUCCESS);
+    CHECK(meshmind_detect_results(detector, &results) == count);
+    CHECK(meshmind_get_template_plan(detector, 0, &plan) == MESHMIND_SUCCESS && plan.planned);
+    
+    meshmind_destroy_detector(detector);
+}
+
+// Early rejection is opt-in and keeps the best template of a feature type, also when the planner re-samples
+static void test_lod_rejection() {
+    MeshMindDetector detector = create_wheel_detector();
+    if (!detector) {
+        return;
+    }
+    CHECK(meshmind_add_template(detector, asset("mirror_compact.stl").c_str(), "wheel") == MESHMIND_SUCCESS);
+    MeshMindResults results;
+    CHECK(meshmind_detect_results(detector, &results) > 0);
+    CHECK(count_results(results, "wheel") == 2);
+    
+    CHECK(meshmind_set_lod_margin(detector, 0.0) == MESHMIND_SUCCESS);
+    CHECK(meshmind_load_target(detector, asset("wheel_18inch.stl").c_str()) == MESHMIND_SUCCESS);
+    CHECK(meshmind_detect_results(detector, &results) > 0);
+    CHECK(count_results(results, "wheel") == 1 && count_results(results, "mirror") == 1);
+    
+    MeshMindTemplatePlan plan;
+    CHECK(meshmind_set_planner(detector, 1) == MESHMIND_SUCCESS);
+    CHECK(meshmind_load_target(detector, asset("wheel_18inch.stl").c_str()) == MESHMIND_SUCCESS);
+    CHECK(meshmind_detect_results(detector, &results) > 0);
+    CHECK(count_results(results, "wheel") == 1 && count_results(results, "mirror") == 1);
+    CHECK(meshmind_get_template_plan(detector, 0, &plan) == MESHMIND_SUCCESS && plan.coarse_points != 500);
+    
+    // Back to the fixed settings and full matching of every template
+    CHECK(meshmind_set_planner(detector, 0) == MESHMIND_SUCCESS);
+    CHECK(meshmind_set_lod_margin(detector, -1.0) == MESHMIND_SUCCESS);
+    CHECK(meshmind_load_target(detector, asset("wheel_18inch.stl").c_str()) == MESHMIND_SUCCESS);
+    CHECK(meshmind_detect_results(detector, &results) > 0);
+    CHECK(count_results(results, "wheel") == 2);
+    CHECK(meshmind_get_template_plan(detector, 0, &plan) == MESHMIND_SUCCESS && plan.coarse_points == 500);
+    
+    meshmind_destroy_detector(detector);
+}
+
+// Retrieval narrows the templates of a search region; templates without one are all matched
+static void test_template_retrieval() {
+    MeshMindDetector detector = create_wheel_detector();
+    if (!detector) {
+        return;
+    }
+    CHECK(meshmind_add_template(detector, asset("mirror_compact.stl").c_str(), "wheel") == MESHMIND_SUCCESS);
+    CHECK(meshmind_build_template_pack(detector, nullptr, 4, 2) == MESHMIND_SUCCESS);
+    CHECK(meshmind_set_template_retrieval(detector, 1) == MESHMIND_SUCCESS);
+    MeshMindResults results;
+    CHECK(meshmind_detect_results(detector, &results) > 0);
+    CHECK(count_results(results, "wheel") == 2 && count_results(results, "mirror") == 1);
+    
+    // Both wheel templates compete for the same region; the mirror keeps the whole target
+    const double box[6] = {-0.4, -0.4, -0.2, 0.4, 0.4, 0.2};
+    MeshMindSearchRegion region;
+    memset(&region, 0, sizeof(region));
+    region.boxes = box;
+    region.num_boxes = 1;
+    region.up_axis = 2;
+    CHECK(meshmind_set_search_region(detector, "wheel", &region) == MESHMIND_SUCCESS);
+    CHECK(meshmind_detect_results(detector, &results) > 0);
+    CHECK(count_results(results, "wheel") == 1 && count_results(results, "mirror") == 1);
+    
+    meshmind_destroy_detector(detector);
+}
+
+// Pack labels are normalised paths: a linked library finds its documents, a moved one none
+static void test_template_pack_paths() {
+    MeshMindDetector detector = meshmind_create_detector();
+    CHECK(detector != nullptr);
+    if (!detector) {
+        return;
+    }
+    fs::create_directories("c_api_pack_lib");
+    fs::create_directories("c_api_pack_moved");
+    fs::copy_file(asset("wheel_18inch.stl"), "c_api_pack_lib/wheel_18inch.stl", fs::copy_options::overwrite_existing);
+    fs::copy_file(asset("wheel_18inch.stl"), "c_api_pack_moved/wheel_18inch.stl", fs::copy_options::overwrite_existing);
+    fs::remove("c_api_pack_link");
+    fs::create_directory_symlink("c_api_pack_lib", "c_api_pack_link");
+    
+    // The snapshot without templates lets one detector start over with another template list
+    const std::string empty = "c_api_pack_empty.mmsnap", pack = "c_api_pack.mmvt";
+    CHECK(meshmind_load_target(detector, asset("wheel_18inch.stl").c_str()) == MESHMIND_SUCCESS);
+    CHECK(meshmind_save_snapshot(detector, empty.c_str()) == MESHMIND_SUCCESS);
+    CHECK(meshmind_add_template(detector, "c_api_pack_lib/wheel_18inch.stl", "wheel") == MESHMIND_SUCCESS);
+    CHECK(meshmind_build_template_pack(detector, pack.c_str(), 4, 2) == MESHMIND_SUCCESS);
+    
+    CHECK(meshmind_load_snapshot(detector, empty.c_str()) == MESHMIND_SUCCESS);
+    CHECK(meshmind_add_template(detector, "c_api_pack_link/./wheel_18inch.stl", "wheel") == MESHMIND_SUCCESS);
+    CHECK(meshmind_load_template_pack(detector, pack.c_str()) == MESHMIND_SUCCESS);
+    
+    CHECK(meshmind_load_snapshot(detector, empty.c_str()) == MESHMIND_SUCCESS);
+    CHECK(meshmind_add_template(detector, "c_api_pack_moved/wheel_18inch.stl", "wheel") == MESHMIND_SUCCESS);
+    CHECK(meshmind_load_template_pack(detector, pack.c_str()) == MESHMIND_ERROR_LOAD);
+    CHECK(std::strstr(meshmind_get_error(detector), "none of the added templates") != nullptr);
+    
+    // Partly covered: loaded, and the error names the templates that are always matched
+    CHECK(meshmind_add_template(detector, "c_api_pack_link/wheel_18inch.stl", "wheel") == MESHMIND_SUCCESS);
+    CHECK(meshmind_load_template_pack(detector, pack.c_str()) == MESHMIND_SUCCESS);
+    CHECK(std::strstr(meshmind_get_error(detector), "1 of 2 templates") != nullptr);
+    
+    meshmind_destroy_detector(detector);
+    fs::remove(empty);
+    fs::remove(pack);
+    fs::remove("c_api_pack_link");
+    fs::remove_all("c_api_pack_lib");
+    fs::remove_all("c_api_pack_moved");
+}
+
+// Family members are seeded with the representative's pose scaled to their own size
+static void test_template_families() {
+    MeshMindDetector detector = meshmind_create_detector();
+    CHECK(detector != nullptr);
+    if (!detector) {
+        return;
+    }
+    CHECK(meshmind_load_target(detector, asset("wheel_18inch.stl").c_str()) == MESHMIND_SUCCESS);
+    for (const char* wheel : {"wheel_18inch.stl", "wheel_20inch.stl", "wheel_16inch.stl"}) {
+        CHECK(meshmind_add_template(detector, asset(wheel).c_str(), "wheel") == MESHMIND_SUCCESS);
+    }
+    CHECK(meshmind_set_template_families(detector, 0.08, 0.5) == MESHMIND_SUCCESS);
+    MeshMindResults results;
+    CHECK(meshmind_detect_results(detector, &results) == 3);
+    
+    // The 20" and 16" wheels fit the 18" target at about 18/20 and 18/16 of their size
+    int shrunk = 0, grown = 0;
+    for (int i = 0; i < results.count; i++) {
+        CHECK(results.confidences[i] > 0.9);
+        shrunk += results.scales[i] > 0.85 && results.scales[i] < 0.95 ? 1 : 0;
+        grown += results.scales[i] > 1.05 && results.scales[i] < 1.15 ? 1 : 0;
+    }
+    CHECK(shrunk == 1 && grown == 1);
+    
+    meshmind_destroy_detector(detector);
+}
+
+// One export call writes the same files as the single-generator exports
+static void test_mesher_inputs() {
+    MeshMindDetector detector = create_wheel_detector();
+    if (!detector) {
+        return;
+    }
+    MeshMindResults results;
+    CHECK(meshmind_detect_results(detector, &results) > 0);
+    
+    const std::string snappy = "c_api_mesher_snappyHexMeshDict", sizing = "c_api_mesher.sizing.json";
+    const std::string single_snappy = "c_api_single_snappyHexMeshDict", single_sizing = "c_api_single.sizing.json";
+    const char* generators[] = {"snappyhexmesh", "ftetwild"};
+    const char* paths[] = {snappy.c_str(), sizing.c_str()};
+    CHECK(meshmind_export_mesher_inputs(detector, generators, paths, 2) == MESHMIND_SUCCESS);
+    CHECK(meshmind_export_snappy_dict(detector, single_snappy.c_str()) == MESHMIND_SUCCESS);
+    CHECK(meshmind_export_ftetwild_sizing(detector, single_sizing.c_str()) == MESHMIND_SUCCESS);
+    CHECK(!read_file(snappy).empty() && read_file(snappy) == read_file(single_snappy));
+    CHECK(!read_file(sizing).empty() && read_file(sizing) == read_file(single_sizing));
+    
+    const char* unknown[] = {"gmsh"};
+    CHECK(meshmind_export_mesher_inputs(detector, unknown, paths, 1) == MESHMIND_ERROR_INVALID_PARAM);
+    
+    meshmind_destroy_detector(detector);
+    for (const std::string& path : {snappy, sizing, single_snappy, single_sizing}) {
+        fs::remove(path);
+    }
+}
+
+// Every case is detected, exported and meshed; failing and hanging meshers are reported per case
+static void test_pipeline() {
+    MeshMindDetector detector = create_wheel_detector();
+    if (!detector) {
+        return;
+    }
+    const std::string wheel = asset("wheel_18inch.stl"), mirror = asset("mirror_compact.stl");
+    const MeshMindCase cases[] = {
+        {wheel.c_str(), "c_api_pipeline/wheel"},
+        {mirror.c_str(), "c_api_pipeline/mirror"},
+        {"c_api_pipeline/missing.stl", "c_api_pipeline/missing"},
+    };
+    MeshMindPipelineOptions options;
+    memset(&options, 0, sizeof(options));
+    options.generator = "ftetwild";
+    options.command = "test -s \"$2\" && test -f \"$1\" && echo meshed > \"$3/mesh.msh\"";
+    options.cpus_per_case = 1;
+    options.cpu_budget = 2;
+    
+    MeshMindCaseResult results[3];
+    CHECK(meshmind_run_pipeline(detector, cases, 3, &options, results) == 2);
+    for (int i = 0; i < 2; i++) {
+        std::string case_dir = cases[i].case_dir;
+        CHECK(results[i].status == MESHMIND_SUCCESS && results[i].detections > 0);
+        CHECK(results[i].exit_code == 0 && !results[i].timed_out);
+        CHECK(results[i].detect_seconds > 0.0 && results[i].mesh_seconds > 0.0);
+        CHECK(read_file(case_dir + "/mesh.msh") == "meshed\n");
+        CHECK(fs::exists(case_dir + "/sizing.json") && fs::exists(case_dir + "/mesher.log"));
+    }
+    CHECK(results[2].status == MESHMIND_ERROR_LOAD && results[2].exit_code == -1);
+    
+    // Exit codes are passed through; meshers running past the timeout are killed
+    options.command = "exit 3";
+    CHECK(meshmind_run_pipeline(detector, cases, 1, &options, results) == 0);
+    CHECK(results[0].status == MESHMIND_SUCCESS && results[0].exit_code == 3);
+    options.command = "sleep 30";
+    options.timeout_seconds = 0.5;
+    CHECK(meshmind_run_pipeline(detector, cases, 1, &options, results) == 0);
+    CHECK(results[0].timed_out && results[0].exit_code == -1 && results[0].mesh_seconds < 10.0);
+    
+    meshmind_destroy_detector(detector);
+    fs::remove_all("c_api_pipeline");
+}
+
+/* Index of the first result of a feature type at position, or -1 */
+static int find_result(const MeshMindResults& results, const char* feature_type, const double* position) {
+    for (int i = 0; i < results.count; i++) {
+        const double* p = &results.positions[3 * i];
+        if (std::strcmp(results.feature_type_names[results.feature_types[i]], feature_type) == 0 &&
+            std::fabs(p[0] - position[0]) + std::fabs(p[1] - position[1]) + std::fabs(p[2] - position[2]) < 1e-9) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Plugins load, run on every template and only see the template's search region
+static void test_plugins() {
+    MeshMindDetector detector = create_wheel_detector();
+    if (!detector) {
+        return;
+    }
+#ifdef MESHMIND_SURFACE_FIT_PLUGIN
+    int surface_fit = meshmind_load_plugin(detector, MESHMIND_SURFACE_FIT_PLUGIN, "tolerance=0.01");
+    CHECK(surface_fit >= 0);
+    CHECK(surface_fit >= 0 && std::strcmp(meshmind_plugin_name(detector, surface_fit), "surface_fit") == 0);
+#endif
+    // Smallest accepted descriptor: no get_error
+    int fixed = meshmind_load_plugin(detector, MESHMIND_FIXED_POSE_PLUGIN, "0.3 0.3 0");
+    CHECK(fixed >= 0);
+    CHECK(fixed >= 0 && std::strcmp(meshmind_plugin_name(detector, fixed), "fixed_pose") == 0);
+    CHECK(meshmind_load_plugin(detector, MESHMIND_FIXED_POSE_PLUGIN, "not a position") == MESHMIND_ERROR_LOAD);
+    CHECK(meshmind_detect_async(detector) == MESHMIND_SUCCESS);
+    CHECK(meshmind_plugin_name(detector, fixed) == nullptr);
+    CHECK(meshmind_wait(detector, -1.0) == MESHMIND_SUCCESS);
+    
+    const double position[3] = {0.3, 0.3, 0.0};
+    MeshMindResults results;
+    CHECK(meshmind_detect_results(detector, &results) > 0);
+    int i = find_result(results, "wheel", position);
+    CHECK(i >= 0 && results.confidences[i] == 1.0 && results.radii[i] > 0.6);
+    
+    // The plugin sees only the samples in the box around its pose
+    const double near_box[6] = {0.1, 0.1, -0.2, 0.36, 0.36, 0.2};
+    MeshMindSearchRegion region;
+    memset(&region, 0, sizeof(region));
+    region.boxes = near_box;
+    region.num_boxes = 1;
+    region.up_axis = 2;
+    CHECK(meshmind_set_search_region(detector, "wheel", &region) == MESHMIND_SUCCESS);
+    CHECK(meshmind_detect_results(detector, &results) > 0);
+    i = find_result(results, "wheel", position);
+    CHECK(i >= 0 && results.radii[i] > 0.0 && results.radii[i] < 0.4);
+    
+    // Detections outside the region are dropped; other feature types are unaffected
+    const double far_box[6] = {-0.36, -0.36, -0.2, 0.0, 0.0, 0.2};
+    region.boxes = far_box;
+    CHECK(meshmind_set_search_region(detector, "wheel", &region) == MESHMIND_SUCCESS);
+    CHECK(meshmind_detect_results(detector, &results) > 0);
+    CHECK(find_result(results, "wheel", position) < 0);
+    CHECK(find_result(results, "mirror", position) >= 0);
+    
+    meshmind_destroy_detector(detector);
+}
+
+struct TestCase {
+    const char* name;
+    void (*run)();
+};
+
+static const TestCase TESTS[] = {
+    {"snapshot_round_trip", test_snapshot_round_trip},
+    {"snapshot_resume", test_snapshot_resume},
+    {"soa_results", test_soa_results},
+    {"async_detect", test_async_detect},
+    {"settings_reset", test_settings_reset},
+    {"lod_rejection", test_lod_rejection},
+    {"template_retrieval", test_template_retrieval},
+    {"template_pack_paths", test_template_pack_paths},
+    {"template_families", test_template_families},
+    {"mesher_inputs", test_mesher_inputs},
+    {"pipeline", test_pipeline},
+    {"plugins", test_plugins},
+};
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: %s <test>\n", argv[0]);
+        return 2;
+    }
+    for (const TestCase& test : TESTS) {
+        if (std::strcmp(test.name, argv[1]) == 0) {
+            test.run();
+            return failures == 0 ? 0 : 1;
+        }
+    }
+    std::fprintf(stderr, "unknown test: %s\n", argv[1]);
+    return 2;
+}
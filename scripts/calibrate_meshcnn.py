@@ -0,0 +1,67 @@
+"""
+INT8 calibration for the native MeshCNN feature extractor.
+
+Runs the float feature layers over ModelNet meshes (see
+meshmind.datasets.modelnet) to pick per-layer activation scales, then
+writes a quantised .mmnn file. Weights get per-channel scales when the
+native engine loads the file.
+
+Usage:
+    python scripts/calibrate_meshcnn.py [input.mmnn|input.pth] [output.mmnn] [meshes_per_category]
+"""
+import sys
+from pathlib import Path
+
+import numpy as np
+
+# Add src to path
+sys.path.insert(0, str(Path(__file__).parent.parent / 'src'))
+
+from meshmind.datasets.modelnet import ModelNet40Dataset
+from meshmind.ml.models.meshcnn import (
+    calibrate_input_scales, export_native_weights, load_native_weights
+)
+
+def load_calibration_vertices(per_category=10):
+    """Normalised vertices of the first meshes of each ModelNet training category."""
+    dataset = ModelNet40Dataset(use_modelnet10=True)
+    dataset.download()
+
+    vertex_sets = []
+    for category in dataset.get_categories():
+        for path in dataset.get_category_files(category, "train")[:per_category]:
+            try:
+                mesh = dataset.load_mesh(path)
+            except Exception as e:
+                print(f"Skipping {path}: {e}")
+                continue
+            # Same normalisation as scripts/train_meshcnn.py
+            vertices = mesh.vertices - mesh.vertices.mean(axis=0)
+            vertices /= np.abs(vertices).max() + 1e-8
+            vertex_sets.append(vertices)
+    return vertex_sets
+
+def main():
+    input_path = sys.argv[1] if len(sys.argv) > 1 else "assets/models/meshcnn_weights.mmnn"
+    output_path = sys.argv[2] if len(sys.argv) > 2 else str(
+        Path(input_path).with_name(Path(input_path).stem + "_int8.mmnn"))
+    per_category = int(sys.argv[3]) if len(sys.argv) > 3 else 10
+
+    if input_path.endswith(".pth"):
+        import torch
+        state_dict, eps = torch.load(input_path, map_location='cpu'), 1e-5
+    else:
+        state_dict, eps, _ = load_native_weights(input_path)
+
+    vertex_sets = load_calibration_vertices(per_category)
+    if not vertex_sets:
+        print("Error: No calibration meshes found")
+        return
+
+    scales = calibrate_input_scales(state_dict, vertex_sets, eps=eps)
+    export_native_weights(state_dict, output_path, eps=eps, input_scales=scales)
+    print(f"Calibrated on {len(vertex_sets)} meshes, input scales: {scales}")
+    print(f"Wrote INT8 weights to {output_path}")
+
+if __name__ == "__main__":
+    main()
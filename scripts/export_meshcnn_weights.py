@@ -0,0 +1,29 @@
+"""
+Export trained MeshCNN weights for the native inference engine.
+
+Converts assets/models/meshcnn_weights.pth (PyTorch state dict) into the
+binary .mmnn format so that feature extraction runs without PyTorch.
+
+Usage:
+    python scripts/export_meshcnn_weights.py [input.pth] [output.mmnn]
+"""
+import sys
+from pathlib import Path
+
+import torch
+
+# Add src to path
+sys.path.insert(0, str(Path(__file__).parent.parent / 'src'))
+
+from meshmind.ml.models.meshcnn import export_native_weights
+
+def main():
+    input_path = sys.argv[1] if len(sys.argv) > 1 else "assets/models/meshcnn_weights.pth"
+    output_path = sys.argv[2] if len(sys.argv) > 2 else str(Path(input_path).with_suffix(".mmnn"))
+    
+    state_dict = torch.load(input_path, map_location='cpu')
+    export_native_weights(state_dict, output_path)
+    print(f"Exported feature layers from {input_path} to {output_path}")
+
+if __name__ == "__main__":
+    main()
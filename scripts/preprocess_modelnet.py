@@ -0,0 +1,34 @@
+"""
+Preprocess ModelNet into memory-mapped MeshCNN training shards.
+
+Each OFF mesh is loaded and sampled once (natively when meshmind._native
+is available); scripts/train_meshcnn.py then trains from the shards.
+
+Usage:
+    python scripts/preprocess_modelnet.py [output_dir] [points_per_sample] [samples_per_shard]
+"""
+import sys
+import time
+from pathlib import Path
+
+# Add src to path
+sys.path.insert(0, str(Path(__file__).parent.parent / 'src'))
+
+from meshmind.datasets.modelnet import ModelNet40Dataset
+
+def main():
+    output_dir = sys.argv[1] if len(sys.argv) > 1 else None
+    points_per_sample = int(sys.argv[2]) if len(sys.argv) > 2 else 1024
+    samples_per_shard = int(sys.argv[3]) if len(sys.argv) > 3 else 1024
+
+    dataset = ModelNet40Dataset(use_modelnet10=True)
+    dataset.download()
+
+    start = time.time()
+    indices = dataset.preprocess(output_dir, points_per_sample, samples_per_shard)
+    for split, index in indices.items():
+        print(f"✓ {split}: {index}")
+    print(f"Preprocessed in {time.time() - start:.1f}s")
+
+if __name__ == "__main__":
+    main()
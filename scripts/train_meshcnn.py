@@ -1,6 +1,11 @@
 """
 Training script for MeshCNN on mesh classification.
-Uses existing templates as training data for quick demonstration.
+Uses existing templates as training data for quick demonstration, or a
+preprocessed shard cache (scripts/preprocess_modelnet.py) read by
+multi-worker DataLoader processes.
+
+Usage:
+    python scripts/train_meshcnn.py [cache_dir] [num_workers]
 """
 import torch
 import torch.nn as nn
@@ -15,6 +20,7 @@ sys.path.insert(0, str(Path(__file__).parent.parent / 'src'))
 
 from meshmind.ml.models.meshcnn import create_meshcnn, TORCH_AVAILABLE
 from meshmind.io.stl_handler import load_stl
+from meshmind.datasets.shards import ShardedMeshDataset
 import numpy as np
 
 def load_training_data():
@@ -74,7 +80,23 @@ def load_training_data():
     
     return data, labels
 
-def train_meshcnn(epochs=50, lr=0.001):
+def load_cached_data(cache_dir, num_workers=4):
+    """
+    Memory-mapped samples from a shard cache. Returns a DataLoader yielding
+    (points, normals, label) per mesh, and the number of classes.
+    """
+    dataset = ShardedMeshDataset(cache_dir, "train")
+    loader = torch.utils.data.DataLoader(
+        dataset,
+        batch_size=None,  # the model takes one mesh at a time
+        shuffle=True,
+        num_workers=num_workers,
+        persistent_workers=num_workers > 0,
+        prefetch_factor=64 if num_workers > 0 else None,
+    )
+    return loader, len(dataset.categories)
+
+def train_meshcnn(epochs=50, lr=0.001, cache_dir=None, num_workers=4):
     """Train MeshCNN on template dataset."""
     print("=" * 70)
     print("MeshMind-AFID: Training MeshCNN")
@@ -86,7 +108,15 @@ def train_meshcnn(epochs=50, lr=0.001):
     
     # Load data
     print("\n[1/5] Loading training data...")
-    data, labels = load_training_data()
+    if cache_dir:
+        loader, num_classes = load_cached_data(cache_dir, num_workers)
+        labels = loader.dataset.labels
+        data = loader.dataset
+        epoch_samples = lambda: ((points, label) for points, _, label in loader)
+    else:
+        data, labels = load_training_data()
+        epoch_samples = lambda: ((data[idx], labels[idx]) for idx in torch.randperm(len(data)).tolist())
+        num_classes = len(set(labels))
     
     if len(data) == 0:
         print("Error: No training data found. Run template generation first:")
@@ -94,7 +124,6 @@ def train_meshcnn(epochs=50, lr=0.001):
         print("  python3 examples/02_custom_templates.py")
         return
     
-    num_classes = len(set(labels))
     print(f"Loaded {len(data)} meshes, {num_classes} classes")
     print(f"Class distribution: {dict(zip(*np.unique(labels, return_counts=True)))}")
     
@@ -122,12 +151,10 @@ def train_meshcnn(epochs=50, lr=0.001):
         correct = 0
         total = 0
         
-        # Shuffle data
-        indices = torch.randperm(len(data))
-        
-        for idx in indices:
-            vertices = data[idx].to(device)
-            label = torch.tensor([labels[idx]], dtype=torch.long).to(device)
+        # Shuffled samples
+        for vertices, target in epoch_samples():
+            vertices = torch.as_tensor(vertices).to(device)
+            label = torch.tensor([int(target)], dtype=torch.long).to(device)
             
             # Forward pass
             optimizer.zero_grad()
@@ -165,11 +192,10 @@ def train_meshcnn(epochs=50, lr=0.001):
     model.eval()
     correct = 0
     with torch.no_grad():
-        for idx in range(len(data)):
-            vertices = data[idx].to(device)
-            outputs = model(vertices)
+        for vertices, target in epoch_samples():
+            outputs = model(torch.as_tensor(vertices).to(device))
             _, predicted = outputs.max(0)
-            if predicted == labels[idx]:
+            if predicted == int(target):
                 correct += 1
     
     test_acc = 100.0 * correct / len(data)
@@ -186,4 +212,6 @@ def train_meshcnn(epochs=50, lr=0.001):
     return model, weights_path
 
 if __name__ == "__main__":
-    train_meshcnn(epochs=50, lr=0.001)
+    cache_dir = sys.argv[1] if len(sys.argv) > 1 else None
+    num_workers = int(sys.argv[2]) if len(sys.argv) > 2 else 4
+    train_meshcnn(epochs=50, lr=0.001, cache_dir=cache_dir, num_workers=num_workers)
@@ -42,6 +42,8 @@ setup(
     package_data={
         'meshmind': [
             'templates/snappyhexmesh/*.yml',
+            '_native*.so',
+            '_native*.pyd',
         ],
     },
     
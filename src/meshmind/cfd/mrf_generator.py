@@ -8,6 +8,10 @@ Automatically generates OpenFOAM MRF zones for rotating geometries
 import numpy as np
 from typing import Dict, List, Optional, Tuple
 from ..core.recognition.base_detector import DetectionResult
+from ..core.recognition.detection_table import DetectionTable
+
+# Column of the feature rotation holding the rotation axis, per feature type
+ROTATION_AXIS_COLUMN = {"wheel": 1, "fan": 0, "turbine": 2}
 
 
 def detect_rotation_axis(detection: DetectionResult, feature_type: str = "wheel") -> np.ndarray:
@@ -54,6 +58,111 @@ def detect_rotation_axis(detection: DetectionResult, feature_type: str = "wheel"
     return axis
 
 
+def detect_rotation_axes(transforms: np.ndarray, feature_type: str = "wheel") -> np.ndarray:
+    """
+    Vectorised detect_rotation_axis for a stack of transforms.
+    
+    Args:
+        transforms: Feature transforms (N, 4, 4)
+        feature_type: Type of rotating feature
+        
+    Returns:
+        axes: Unit rotation axes (N, 3)
+    """
+    column = ROTATION_AXIS_COLUMN.get(feature_type)
+    if column is None:
+        return np.tile(np.array([0, 0, 1]), (len(transforms), 1))
+    axes = transforms[:, :3, column]
+    # Batched dot products give bit-identical norms to np.linalg.norm on each axis
+    norms = np.sqrt(np.matmul(axes[:, None, :], axes[:, :, None]))[:, 0, 0]
+    return axes / norms[:, None]
+
+
+def create_mrf_zones(
+    detections: DetectionTable,
+    rows: np.ndarray,
+    feature_type: str = "wheel",
+    omega: Optional[float] = None,
+    radius_scale: float = 1.2,
+    height_scale: float = 1.1,
+    non_rotating_patches: Optional[List[str]] = None
+) -> List[Dict]:
+    """
+    Vectorised create_mrf_zone for the given rows of a DetectionTable.
+    
+    Origins, axes and zone dimensions are computed column-wise; each returned
+    zone equals create_mrf_zone() for that row and carries its cellZone
+    definition under "_cellZone", as AutoMesher stores it.
+    
+    Args:
+        detections: Detection table
+        rows: Row indices to generate zones for (all of one feature type)
+        feature_type: Type of rotating feature (wheel, fan, turbine)
+        omega, radius_scale, height_scale, non_rotating_patches: As create_mrf_zone
+        
+    Returns:
+        mrf_zones: One MRF zone dictionary per row
+    """
+    rows = np.asarray(rows, dtype=np.int64)
+    transforms = detections.transforms[rows]
+    origins = transforms[:, :3, 3].tolist()
+    axes = detect_rotation_axes(transforms, feature_type).tolist()
+    
+    radius = np.where(np.isnan(detections.radii[rows]), 0.35, detections.radii[rows])
+    height = np.where(np.isnan(detections.heights[rows]), 0.25, detections.heights[rows])
+    zone_radius = (radius * radius_scale).tolist()
+    zone_height = (height * height_scale).tolist()
+    radius = radius.tolist()
+    height = height.tolist()
+    confidences = detections.confidences[rows].tolist()
+    
+    if non_rotating_patches is None:
+        non_rotating_patches = ["ground", "body", "wall"]
+    cylindrical = feature_type in ["wheel", "fan", "turbine"]
+    
+    zones = []
+    for i, row in enumerate(rows.tolist()):
+        feature_id = detections.feature_id(row)
+        zone_name = f"{feature_id}_MRFZone"
+        if cylindrical:
+            cell_zone = {
+                "name": zone_name,
+                "type": "cylinder",
+                "origin": origins[i],
+                "axis": axes[i],
+                "radius": zone_radius[i],
+                "height": zone_height[i]
+            }
+        else:
+            cell_zone = {
+                "name": zone_name,
+                "type": "sphere",
+                "center": origins[i],
+                "radius": zone_radius[i]
+            }
+        
+        zones.append({
+            "type": "MRFZone",
+            "cellZone": zone_name,
+            "active": True,
+            "selectionMode": "cellZone",
+            "origin": origins[i],
+            "axis": axes[i],
+            "omega": omega if omega is not None else "constant 0",
+            "nonRotatingPatches": non_rotating_patches,
+            "_metadata": {
+                "feature_id": feature_id,
+                "feature_type": feature_type,
+                "confidence": confidences[i],
+                "radius": radius[i],
+                "height": height[i]
+            },
+            "_cellZone": cell_zone
+        })
+    
+    return zones
+
+
 def create_mrf_zone(
     detection: DetectionResult,
     feature_type: str = "wheel",
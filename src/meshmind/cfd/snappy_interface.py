@@ -1,10 +1,17 @@
 from typing import List,Dict
 from pathlib import Path
-from ..core.refinement import RefinementRegion
+import numpy as np
+from ..core.refinement import RefinementRegion, RegionTable
 from ..core.recognition.base_detector import DetectionResult
+from ..core.descriptors import HAS_NATIVE
+
+if HAS_NATIVE:
+    from .. import _native
 
 def generate_snappy_dict(regions: List[RefinementRegion]) -> str:
     """Generates the refinementRegions and refinementSurfaces sections of snappyHexMeshDict."""
+    if isinstance(regions, RegionTable):
+        return _generate_snappy_table(regions)
     
     output = "refinementRegions\n{\n"
     
@@ -33,8 +40,58 @@ def generate_snappy_dict(regions: List[RefinementRegion]) -> str:
     output += "}\n"
     return output
 
+def _generate_snappy_table(regions: RegionTable) -> str:
+    """generate_snappy_dict for a RegionTable: bounds are translated column-wise."""
+    records = regions.records
+    trans = records["transform"][:, :3, 3]
+    global_min = (trans + records["bounds"][:, 0]).tolist()
+    global_max = (trans + records["bounds"][:, 1]).tolist()
+    level_size = records["level_size"].tolist()
+    level = records["level"].tolist()
+    
+    parts = ["refinementRegions\n{\n"]
+    for i, name in enumerate(regions.names()):
+        lo, hi = global_min[i], global_max[i]
+        parts.append(
+            f"    {name}\n"
+            "    {\n"
+            "        mode    inside;\n"
+            f"        levels  (({level_size[i]} {level[i]}));\n"
+            f"        min     ({lo[0]} {lo[1]} {lo[2]});\n"
+            f"        max     ({hi[0]} {hi[1]} {hi[2]});\n"
+            "    }\n"
+        )
+    parts.append("}\n")
+    return "".join(parts)
+
+def _native_region_columns(regions):
+    """Columns for _native.write_snappy_dict, or None if the regions need the Python writer."""
+    if isinstance(regions, RegionTable):
+        records = regions.records
+        return (regions.names(), ["inside"] * len(regions), records["level_size"],
+                records["level"].astype(np.int64), records["transform"], records["bounds"])
+    if not all(
+        isinstance(reg.levels[0], float) and isinstance(reg.levels[1], int) and reg.bounds is not None
+        for reg in regions
+    ):
+        return None
+    count = len(regions)
+    return (
+        [reg.name for reg in regions],
+        [reg.mode for reg in regions],
+        np.array([reg.levels[0] for reg in regions], dtype=np.float64),
+        np.array([reg.levels[1] for reg in regions], dtype=np.int64),
+        np.array([reg.transform for reg in regions], dtype=np.float64).reshape(count, 4, 4),
+        np.array([reg.bounds for reg in regions], dtype=np.float64).reshape(count, 2, 3),
+    )
+
 def write_complete_dict(path: str, regions: List[RefinementRegion]):
     """Writes a full snappyHexMeshDict boilerplate with target regions."""
+    columns = _native_region_columns(regions) if HAS_NATIVE else None
+    if columns is not None:
+        _native.write_snappy_dict(str(path), *columns)
+        return
+
     body = generate_snappy_dict(regions)
     header = """/*--------------------------------*- C++ -*----------------------------------*\\
 | =========                 |                                                 |
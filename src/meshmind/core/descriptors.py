@@ -3,6 +3,11 @@ try:
     HAS_OPEN3D = True
 except ImportError:
     HAS_OPEN3D = False
+try:
+    from .. import _native
+    HAS_NATIVE = True
+except ImportError:
+    HAS_NATIVE = False
 import numpy as np
 import trimesh
 from .geometry import Mesh
@@ -19,9 +24,19 @@ def downsample_mesh(mesh: Mesh, n_points: int) -> Mesh:
 def compute_fpfh(mesh: Mesh, radius_normal: float = 0.1, radius_feature: float = 0.25) -> np.ndarray:
     """
     Compute Fast Point Feature Histograms (FPFH) for the given mesh.
-    Falls back to a simple vertex-density/curvature proxy if Open3D is missing.
+    Uses the native engine when built, then Open3D, and falls back to a simple
+    vertex-density/curvature proxy if neither is available.
     """
-    if HAS_OPEN3D:
+    if HAS_NATIVE:
+        # Neighbourhood kernels run on Z-ordered points; results come back in vertex order
+        vertices = np.asarray(mesh.vertices, dtype=np.float64)
+        order = _native.morton_order(vertices)
+        ordered = vertices[order]
+        normals = _native.estimate_normals(ordered, radius_normal, 30)
+        fpfh = np.empty((len(vertices), 33))
+        fpfh[order] = _native.compute_fpfh(ordered, normals, radius_feature, 100)
+        return fpfh
+    elif HAS_OPEN3D:
         pcd = o3d.geometry.PointCloud()
         pcd.points = o3d.utility.Vector3dVector(mesh.vertices)
         pcd.estimate_normals(
@@ -1,22 +1,69 @@
 import numpy as np
+import trimesh
 from scipy.spatial import KDTree
 from .geometry import Mesh
-from .descriptors import compute_fpfh, downsample_mesh
+from .descriptors import compute_fpfh, downsample_mesh, HAS_NATIVE
+
+if HAS_NATIVE:
+    from .. import _native
 
 class TemplateMatcher:
     """Matches a template mesh to a target mesh using geometric descriptors and hierarchical refinement."""
     
     def __init__(self, target_mesh: Mesh, coarse_points: int = 500):
         self.target_mesh = target_mesh
+        if HAS_NATIVE:
+            # Sampling, descriptors and the descriptor index all live in the native engine
+            self._native = _native.TemplateMatcher(
+                np.asarray(target_mesh.vertices, dtype=np.float64),
+                np.asarray(target_mesh.faces, dtype=np.int64),
+                coarse_points
+            )
+            self._attach_native_index()
+            return
+        self._native = None
         # Coarse target for speed
         self.coarse_target = downsample_mesh(target_mesh, coarse_points)
         self.target_features = compute_fpfh(self.coarse_target)
         self.target_kdtree = KDTree(self.target_features)
+
+    def _attach_native_index(self):
+        """Expose the native index through the usual attributes (zero-copy views)."""
+        self.coarse_target = Mesh(trimesh.Trimesh(vertices=self._native.coarse_points, process=False))
+        self.target_features = self._native.features
+        self.target_kdtree = _native.KDTree(self.target_features)
+        
+    @classmethod
+    def from_index(cls, target_mesh: Mesh, coarse_vertices: np.ndarray, target_features: np.ndarray):
+        """
+        Rebuild a matcher from a previously computed target index (e.g. a detector snapshot)
+        without re-sampling the target or recomputing its descriptors.
+        """
+        matcher = cls.__new__(cls)
+        matcher.target_mesh = target_mesh
+        if HAS_NATIVE:
+            matcher._native = _native.TemplateMatcher.from_index(
+                np.asarray(coarse_vertices, dtype=np.float64),
+                np.asarray(target_features, dtype=np.float64)
+            )
+            matcher._attach_native_index()
+            return matcher
+        matcher._native = None
+        matcher.coarse_target = Mesh(trimesh.Trimesh(vertices=np.asarray(coarse_vertices)))
+        matcher.target_features = np.asarray(target_features)
+        matcher.target_kdtree = KDTree(matcher.target_features)
+        return matcher
         
     def match(self, template_mesh: Mesh, coarse_points: int = 500):
         """
         Hierarchical matching process.
         """
+        if self._native is not None:
+            return self._native.match(
+                np.asarray(template_mesh.vertices, dtype=np.float64),
+                np.asarray(template_mesh.faces, dtype=np.int64)
+            )
+
         # Step 1: Coarse Matching
         coarse_template = downsample_mesh(template_mesh, coarse_points)
         template_features = compute_fpfh(coarse_template)
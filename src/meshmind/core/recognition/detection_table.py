@@ -0,0 +1,237 @@
+"""
+Columnar detection storage.
+
+A DetectionTable keeps detections as one NumPy structured array instead of a
+list of DetectionResult objects, so that region generation, MRF zones and the
+exporters can work on whole columns at once. Feature IDs are split into an
+interned type name and an instance number ("wheel_3" -> "wheel", 3), and the
+common metadata keys (radius, height) are columns with NaN meaning "absent".
+
+Iterating a table (or indexing a single row) yields DetectionView objects,
+which behave like DetectionResult and read/write the underlying row.
+"""
+
+import numpy as np
+from typing import Any, Dict, Iterable, List, Optional
+
+from .base_detector import DetectionResult
+
+DETECTION_DTYPE = np.dtype([
+    ("type_index", np.int32),         # index into DetectionTable.feature_types
+    ("instance", np.int32),           # "_<n>" suffix of the feature ID, -1 for none
+    ("transform", np.float64, (4, 4)),
+    ("confidence", np.float64),
+    ("radius", np.float64),           # NaN when absent
+    ("height", np.float64),           # NaN when absent
+])
+
+# Metadata keys stored as columns; everything else goes to the sparse extras
+METADATA_COLUMNS = ("radius", "height")
+
+
+def split_feature_id(feature_id: str):
+    """Split "wheel_3" into ("wheel", 3); IDs without a numeric suffix get instance -1."""
+    name, sep, suffix = feature_id.rpartition("_")
+    if sep and suffix.isdigit() and str(int(suffix)) == suffix:
+        return name, int(suffix)
+    return feature_id, -1
+
+
+class DetectionTable:
+    """Structure-of-arrays container for detection results."""
+
+    def __init__(self, records: Optional[np.ndarray] = None, feature_types: Optional[List[str]] = None,
+                 extras: Optional[Dict[int, Dict[str, Any]]] = None):
+        self.records = records if records is not None else np.zeros(0, dtype=DETECTION_DTYPE)
+        self.feature_types = list(feature_types or [])
+        self._type_ids = {name: i for i, name in enumerate(self.feature_types)}
+        # Row -> metadata that has no column (e.g. "bounds", "alignment_cost")
+        self.extras = extras or {}
+
+    @classmethod
+    def from_arrays(cls, feature_types: List[str], type_index, instances, transforms, confidences,
+                    radii=None, heights=None) -> "DetectionTable":
+        """Build a table from column arrays (as filled by the native engine)."""
+        count = len(confidences)
+        records = np.empty(count, dtype=DETECTION_DTYPE)
+        records["type_index"] = type_index
+        records["instance"] = instances
+        records["transform"] = np.asarray(transforms, dtype=np.float64).reshape(count, 4, 4)
+        records["confidence"] = confidences
+        records["radius"] = np.nan if radii is None else radii
+        records["height"] = np.nan if heights is None else heights
+        return cls(records, feature_types)
+
+    @classmethod
+    def from_detections(cls, detections: Iterable[DetectionResult]) -> "DetectionTable":
+        """Pack a list of DetectionResult objects into a table."""
+        detections = list(detections)
+        table = cls(np.zeros(len(detections), dtype=DETECTION_DTYPE))
+        for row, det in enumerate(detections):
+            table._set_row(row, det.feature_id, det.transform, det.confidence, det.region_metadata)
+        return table
+
+    def _set_row(self, row: int, feature_id: str, transform, confidence: float, metadata: Dict[str, Any]):
+        record = self.records[row]
+        self.set_feature_id(row, feature_id)
+        record["transform"] = transform
+        record["confidence"] = confidence
+        extras = {}
+        for key, value in (metadata or {}).items():
+            if key in METADATA_COLUMNS and np.isscalar(value):
+                record[key] = value
+            else:
+                extras[key] = value
+        for key in METADATA_COLUMNS:
+            if key not in (metadata or {}):
+                record[key] = np.nan
+        if extras:
+            self.extras[row] = extras
+        else:
+            self.extras.pop(row, None)
+
+    def intern(self, name: str) -> int:
+        """Index of a feature type name, adding it if new."""
+        index = self._type_ids.get(name)
+        if index is None:
+            index = len(self.feature_types)
+            self.feature_types.append(name)
+            self._type_ids[name] = index
+        return index
+
+    def set_feature_id(self, row: int, feature_id: str):
+        name, instance = split_feature_id(feature_id)
+        self.records["type_index"][row] = self.intern(name)
+        self.records["instance"][row] = instance
+
+    def feature_id(self, row: int) -> str:
+        record = self.records[row]
+        name = self.feature_types[record["type_index"]]
+        instance = int(record["instance"])
+        return name if instance < 0 else f"{name}_{instance}"
+
+    def feature_ids(self) -> List[str]:
+        return [self.feature_id(row) for row in range(len(self))]
+
+    def id_mask(self, feature_id: str) -> np.ndarray:
+        """Boolean mask of rows whose full feature ID equals feature_id."""
+        name, instance = split_feature_id(feature_id)
+        mask = np.zeros(len(self), dtype=bool)
+        if name in self._type_ids:
+            mask |= (self.type_index == self._type_ids[name]) & (self.instances == instance)
+        if instance >= 0 and feature_id in self._type_ids:
+            # Type names may themselves end in "_<n>" when no instance was assigned
+            mask |= (self.type_index == self._type_ids[feature_id]) & (self.instances < 0)
+        return mask
+
+    def base_types(self) -> np.ndarray:
+        """Per-row feature type as AutoMesher derives it (feature_id.split('_')[0])."""
+        bases = np.array([name.split("_")[0] for name in self.feature_types] or [""], dtype=object)
+        return bases[self.type_index]
+
+    # Column accessors (views into the records array)
+    @property
+    def type_index(self) -> np.ndarray:
+        return self.records["type_index"]
+
+    @property
+    def instances(self) -> np.ndarray:
+        return self.records["instance"]
+
+    @property
+    def transforms(self) -> np.ndarray:
+        return self.records["transform"]
+
+    @property
+    def positions(self) -> np.ndarray:
+        return self.records["transform"][:, :3, 3]
+
+    @property
+    def confidences(self) -> np.ndarray:
+        return self.records["confidence"]
+
+    @property
+    def radii(self) -> np.ndarray:
+        return self.records["radius"]
+
+    @property
+    def heights(self) -> np.ndarray:
+        return self.records["height"]
+
+    def metadata(self, row: int) -> Dict[str, Any]:
+        record = self.records[row]
+        result = {key: float(record[key]) for key in METADATA_COLUMNS if not np.isnan(record[key])}
+        result.update(self.extras.get(row, {}))
+        return result
+
+    def sorted_by_confidence(self) -> "DetectionTable":
+        """Copy of the table ordered by descending confidence (stable)."""
+        order = np.argsort(-self.confidences, kind="stable")
+        extras = {int(new): self.extras[int(old)] for new, old in enumerate(order) if int(old) in self.extras}
+        return DetectionTable(self.records[order], self.feature_types, extras)
+
+    def to_list(self) -> List[DetectionResult]:
+        """Materialise standalone DetectionResult objects."""
+        return [
+            DetectionResult(self.feature_id(row), self.transforms[row].copy(),
+                            float(self.confidences[row]), self.metadata(row))
+            for row in range(len(self))
+        ]
+
+    def __len__(self) -> int:
+        return len(self.records)
+
+    def __getitem__(self, row: int) -> "DetectionView":
+        if isinstance(row, slice):
+            return [DetectionView(self, i) for i in range(*row.indices(len(self)))]
+        if row < 0:
+            row += len(self)
+        if not 0 <= row < len(self):
+            raise IndexError("detection index out of range")
+        return DetectionView(self, row)
+
+    def __iter__(self):
+        for row in range(len(self)):
+            yield DetectionView(self, row)
+
+
+class DetectionView(DetectionResult):
+    """DetectionResult backed by a row of a DetectionTable."""
+
+    def __init__(self, table: DetectionTable, row: int):
+        self._table = table
+        self._row = row
+
+    @property
+    def feature_id(self) -> str:
+        return self._table.feature_id(self._row)
+
+    @feature_id.setter
+    def feature_id(self, value: str):
+        self._table.set_feature_id(self._row, value)
+
+    @property
+    def transform(self) -> np.ndarray:
+        # A view: in-place edits update the table
+        return self._table.transforms[self._row]
+
+    @transform.setter
+    def transform(self, value):
+        self._table.transforms[self._row] = value
+
+    @property
+    def confidence(self) -> float:
+        return float(self._table.confidences[self._row])
+
+    @confidence.setter
+    def confidence(self, value: float):
+        self._table.confidences[self._row] = value
+
+    @property
+    def region_metadata(self) -> Dict[str, Any]:
+        # A snapshot; assign the property to change the row's metadata
+        return self._table.metadata(self._row)
+
+    @region_metadata.setter
+    def region_metadata(self, value: Dict[str, Any]):
+        self._table._set_row(self._row, self.feature_id, self.transform, self.confidence, value)
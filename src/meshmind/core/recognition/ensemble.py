@@ -1,17 +1,236 @@
-from typing import List, Any
+"""
+Ensemble of feature detectors.
+
+Members run concurrently on one shared target index (the FPFH matcher's
+sampled target and descriptor tree are built once, MeshCNN caches the
+target's features), and their results are fused by mean-shift clustering
+in SE(3): hypotheses for the same template that agree on a pose become one
+detection whose confidence is a weighted noisy-OR of the members' scores.
+"""
+from concurrent.futures import ThreadPoolExecutor
+from typing import Any, Callable, Dict, List, Optional, Sequence
+
+import numpy as np
+
 from .base_detector import DetectionResult
+from .detection_table import split_feature_id
+from ..descriptors import HAS_NATIVE
+
+if HAS_NATIVE:
+    from ... import _native
+
+# Kernel truncated at 3 bandwidths; modes closer than half a bandwidth are merged
+_KERNEL_CUTOFF2 = 9.0
+_MERGE_RADIUS2 = 0.25
+_CONVERGED2 = 1e-10
+
+
+# Member-specific prefixes on IDs from the shared template library
+_MEMBER_PREFIXES = ("meshcnn_",)
+
+
+def template_key(feature_id: str):
+    """Default fusion group: template name and index without a member prefix ("template_3", "meshcnn_template_3")."""
+    name, instance = split_feature_id(feature_id)
+    for prefix in _MEMBER_PREFIXES:
+        if name.startswith(prefix):
+            name = name[len(prefix):]
+            break
+    return name, instance
+
 
 class EnsembleDetector:
     """Combines results from multiple detectors."""
-    
-    def __init__(self, detectors: List[Any]):
+
+    def __init__(self, detectors: List[Any], weights: Optional[Sequence[float]] = None, fuse: bool = True,
+                 translation_bandwidth: Optional[float] = None, rotation_bandwidth: float = 0.35,
+                 max_workers: Optional[int] = None, key: Callable[[str], Any] = template_key):
+        """
+        Args:
+            detectors: Member detectors (anything with detect(target_mesh))
+            weights: Per-detector trust in [0, 1] used by the fusion (default 1)
+            fuse: Fuse results in pose space; otherwise concatenate them
+            translation_bandwidth: Mean-shift kernel width; default 2% of the target's diagonal
+            rotation_bandwidth: Mean-shift kernel width in radians
+            max_workers: Threads for running members (default one per member)
+            key: Maps a feature_id to its fusion group
+        """
         self.detectors = detectors
-        
-    def detect(self, target_mesh: Any) -> List[DetectionResult]:
-        all_results = []
+        self.weights = list(weights) if weights is not None else [1.0] * len(detectors)
+        self.fuse = fuse
+        self.translation_bandwidth = translation_bandwidth
+        self.rotation_bandwidth = rotation_bandwidth
+        self.max_workers = max_workers
+        self.key = key
+
+    def _share_target(self, target_mesh: Any):
+        """Give members that accept a prepared matcher the same target index."""
+        shared = None
         for detector in self.detectors:
-            all_results.extend(detector.detect(target_mesh))
-            
-        # Simplistic ensemble: take highest confidence result per unique region/type
-        # In a real system, we'd cluster transformations
-        return sorted(all_results, key=lambda x: x.confidence, reverse=True)
+            if not hasattr(detector, "matcher"):
+                continue
+            if detector.matcher is not None and detector.matcher.target_mesh is target_mesh:
+                shared = shared or detector.matcher
+                continue
+            if shared is None:
+                from ..matcher import TemplateMatcher
+                shared = TemplateMatcher(target_mesh)
+            detector.matcher = shared
+
+    def detect(self, target_mesh: Any) -> List[DetectionResult]:
+        self._share_target(target_mesh)
+        if len(self.detectors) <= 1:
+            member_results = [detector.detect(target_mesh) for detector in self.detectors]
+        else:
+            # Native matching releases the GIL, so members overlap
+            with ThreadPoolExecutor(self.max_workers or len(self.detectors)) as pool:
+                member_results = list(pool.map(lambda detector: detector.detect(target_mesh), self.detectors))
+
+        if not self.fuse or len(self.detectors) <= 1:
+            all_results = [result for results in member_results for result in results]
+            return sorted(all_results, key=lambda x: x.confidence, reverse=True)
+        return self.fuse_results(member_results, target_mesh)
+
+    def fuse_results(self, member_results: List[List[DetectionResult]], target_mesh: Any = None) -> List[DetectionResult]:
+        """Cluster member results per template in SE(3) and merge each cluster into one detection."""
+        results, sources = [], []
+        for source, member in enumerate(member_results):
+            results.extend(member)
+            sources.extend([source] * len(member))
+        if not results:
+            return []
+
+        group_ids: Dict[Any, int] = {}
+        groups = np.array([group_ids.setdefault(self.key(r.feature_id), len(group_ids)) for r in results], dtype=np.int64)
+        transforms = np.array([np.asarray(r.transform, dtype=np.float64) for r in results]).reshape(-1, 4, 4)
+        confidences = np.array([r.confidence for r in results], dtype=np.float64)
+        sources = np.array(sources, dtype=np.int64)
+
+        bandwidth = self.translation_bandwidth
+        if bandwidth is None:
+            bandwidth = _default_bandwidth(target_mesh, transforms)
+
+        fuse = _native.fuse_poses if HAS_NATIVE else fuse_poses
+        fused, fused_confidence, representatives, support, _ = fuse(
+            transforms, confidences, groups, sources, self.weights, bandwidth, self.rotation_bandwidth)
+
+        detections = []
+        for transform, confidence, rep, count in zip(fused, fused_confidence, representatives, support):
+            best = results[int(rep)]
+            metadata = dict(best.region_metadata)
+            metadata["ensemble_support"] = int(count)
+            detections.append(DetectionResult(best.feature_id, transform, float(confidence), metadata))
+        return detections
+
+
+def _default_bandwidth(target_mesh: Any, transforms: np.ndarray) -> float:
+    bounds = getattr(target_mesh, "bounds", None)
+    if bounds is None:
+        positions = transforms[:, :3, 3]
+        bounds = np.array([positions.min(axis=0), positions.max(axis=0)])
+    diagonal = float(np.linalg.norm(np.asarray(bounds)[1] - np.asarray(bounds)[0]))
+    return 0.02 * diagonal if diagonal > 0 else 1.0
+
+
+def _quaternions(transforms: np.ndarray):
+    """(w, x, y, z) of the nearest rotations and the uniform scales, as the native engine computes them."""
+    M = transforms[:, :3, :3]
+    det = np.linalg.det(M)
+    scale = np.where(det > 0, np.cbrt(np.maximum(det, 0)), 1.0)
+    S = np.transpose(M, (0, 2, 1)) / scale[:, None, None]
+    N = np.empty((len(M), 4, 4))
+    N[:, 0] = np.stack([S[:, 0, 0] + S[:, 1, 1] + S[:, 2, 2], S[:, 1, 2] - S[:, 2, 1],
+                        S[:, 2, 0] - S[:, 0, 2], S[:, 0, 1] - S[:, 1, 0]], axis=1)
+    N[:, 1] = np.stack([S[:, 1, 2] - S[:, 2, 1], S[:, 0, 0] - S[:, 1, 1] - S[:, 2, 2],
+                        S[:, 0, 1] + S[:, 1, 0], S[:, 2, 0] + S[:, 0, 2]], axis=1)
+    N[:, 2] = np.stack([S[:, 2, 0] - S[:, 0, 2], S[:, 0, 1] + S[:, 1, 0],
+                        -S[:, 0, 0] + S[:, 1, 1] - S[:, 2, 2], S[:, 1, 2] + S[:, 2, 1]], axis=1)
+    N[:, 3] = np.stack([S[:, 0, 1] - S[:, 1, 0], S[:, 2, 0] + S[:, 0, 2],
+                        S[:, 1, 2] + S[:, 2, 1], -S[:, 0, 0] - S[:, 1, 1] + S[:, 2, 2]], axis=1)
+    return np.linalg.eigh(N)[1][:, :, 3], scale
+
+
+def _compose(t, q, scale):
+    w, x, y, z = q
+    R = np.array([
+        [w * w + x * x - y * y - z * z, 2 * (x * y - w * z), 2 * (x * z + w * y)],
+        [2 * (x * y + w * z), w * w - x * x + y * y - z * z, 2 * (y * z - w * x)],
+        [2 * (x * z - w * y), 2 * (y * z + w * x), w * w - x * x - y * y + z * z],
+    ])
+    transform = np.eye(4)
+    transform[:3, :3] = scale * R
+    transform[:3, 3] = t
+    return transform
+
+
+def fuse_poses(transforms, confidences, groups, sources, source_weights, translation_bandwidth,
+               rotation_bandwidth=0.35, max_iterations=30):
+    """NumPy counterpart of _native.fuse_poses (see cpp/src/native/ensemble.h)."""
+    if translation_bandwidth <= 0 or rotation_bandwidth <= 0:
+        raise ValueError("Fusion bandwidths must be positive")
+    transforms = np.asarray(transforms, dtype=np.float64).reshape(-1, 4, 4)
+    confidences = np.clip(np.asarray(confidences, dtype=np.float64), 0.0, 1.0)
+    groups = np.asarray(groups)
+    sources = np.asarray(sources)
+    n = len(confidences)
+    inv_t2 = 1.0 / translation_bandwidth ** 2
+    inv_r2 = 1.0 / rotation_bandwidth ** 2
+
+    weights = np.array([np.clip(source_weights[s], 0.0, 1.0) if 0 <= s < len(source_weights) else 1.0
+                        for s in sources], dtype=np.float64).reshape(n)
+    mass = np.maximum(weights * confidences, 1e-9)
+    t_all = transforms[:, :3, 3]
+    q_all, s_all = _quaternions(transforms)
+
+    def distance2(t, q, t_other, q_other):
+        angle = 2.0 * np.arccos(np.minimum(1.0, np.abs(q_other @ q)))
+        return ((t_other - t) ** 2).sum(axis=-1) * inv_t2 + angle ** 2 * inv_r2
+
+    modes = []
+    for i in range(n):
+        members = np.flatnonzero(groups == groups[i])
+        t, q, scale = t_all[i], q_all[i], s_all[i]
+        for _ in range(max_iterations):
+            d2 = distance2(t, q, t_all[members], q_all[members])
+            near = d2 <= _KERNEL_CUTOFF2
+            k = mass[members][near] * np.exp(-0.5 * d2[near])
+            total = k.sum()
+            next_t = (k[:, None] * t_all[members][near]).sum(axis=0) / total
+            next_scale = (k * s_all[members][near]).sum() / total
+            qs = q_all[members][near]
+            next_q = np.linalg.eigh((k[:, None] * qs).T @ qs)[1][:, 3]
+            shift2 = distance2(t, q, next_t[None], next_q[None])[0]
+            t, q, scale = next_t, next_q, next_scale
+            if shift2 < _CONVERGED2:
+                break
+        modes.append((t, q, scale))
+
+    representatives, cluster_of = [], np.zeros(n, dtype=np.int64)
+    for i in np.argsort(-mass, kind="stable"):
+        cluster = len(representatives)
+        for c, r in enumerate(representatives):
+            if groups[r] == groups[i] and distance2(modes[r][0], modes[r][1], modes[i][0][None],
+                                                    modes[i][1][None])[0] < _MERGE_RADIUS2:
+                cluster = c
+                break
+        if cluster == len(representatives):
+            representatives.append(i)
+        cluster_of[i] = cluster
+
+    fused_confidence = np.zeros(len(representatives))
+    support = np.bincount(cluster_of, minlength=len(representatives))
+    for c in range(len(representatives)):
+        members = cluster_of == c
+        miss = 1.0
+        for source in np.unique(sources[members]):
+            best = confidences[members & (sources == source)].max()
+            weight = np.clip(source_weights[source], 0.0, 1.0) if 0 <= source < len(source_weights) else 1.0
+            miss *= 1.0 - weight * best
+        fused_confidence[c] = 1.0 - miss
+
+    ranking = np.argsort(-fused_confidence, kind="stable")
+    rank_of = np.empty_like(ranking)
+    rank_of[ranking] = np.arange(len(ranking))
+    fused = np.array([_compose(*modes[representatives[c]]) for c in ranking]).reshape(-1, 4, 4)
+    return (fused, fused_confidence[ranking], np.array(representatives, dtype=np.int64)[ranking],
+            support[ranking], rank_of[cluster_of])
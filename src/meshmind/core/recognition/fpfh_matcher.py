@@ -4,21 +4,103 @@ from typing import List
 from .base_detector import BaseFeatureDetector, DetectionResult
 from ..geometry import Mesh
 from ..matcher import TemplateMatcher
-from ..descriptors import downsample_mesh
+from ..descriptors import downsample_mesh, HAS_NATIVE
 from ...registry.detector_registry import register_detector
 
+if HAS_NATIVE:
+    from ... import _native
+
 @register_detector("fpfh_template")
 class FPFHFeatureDetector(BaseFeatureDetector):
     """Detects features by matching a library of templates using FPFH descriptors."""
     
-    def __init__(self, template_library: List[Mesh]):
+    def __init__(self, template_library: List[Mesh], matcher: TemplateMatcher = None,
+                 localize_peaks: int = 0, refine_iterations: int = 0):
         self.templates = template_library
+        # Optional prepared target index, reused across detect() calls on the same target
+        self.matcher = matcher
+        # With the native engine: match each template only around its best
+        # FFT cross-correlation placements (bulky features such as wheels)
+        self.localize_peaks = localize_peaks
+        # With the native engine: ICP iterations per level refining the poses (0 to skip)
+        self.refine_iterations = refine_iterations
+        
+    @staticmethod
+    def _icp_levels(vertices, faces):
+        """Coarse-to-fine surface samples with normals, as (n, 6) arrays, for native ICP."""
+        mesh = trimesh.Trimesh(vertices, faces, process=False)
+        levels = []
+        for count in (64, 500):
+            points, face_index = trimesh.sample.sample_surface(mesh, count, seed=0)
+            levels.append(np.hstack([points, mesh.face_normals[face_index]]))
+        return levels
+        
+    def _refine(self, results, levels, target_mesh: Mesh):
+        """Refine native detections in place by ICP, in parallel across detections."""
+        if not results or self.refine_iterations <= 0:
+            return
+        transforms, rms = _native.icp_refine(
+            np.stack([res.transform for res in results]),
+            levels,
+            np.asarray(target_mesh.vertices, dtype=np.float64),
+            np.asarray(target_mesh.faces, dtype=np.int64),
+            iterations=self.refine_iterations
+        )
+        for res, transform, error in zip(results, transforms, rms):
+            res.transform = transform
+            res.region_metadata["icp_rms"] = float(error)
+        
+    def _localized_matcher(self, localizer, target_mesh: Mesh, vertices, faces):
+        """Native matcher over the target surface around the template's FFT peaks, or None."""
+        translations, _ = localizer.locate(vertices, faces, self.localize_peaks)
+        if len(translations) == 0:
+            return None
+        lo, hi = vertices.min(axis=0), vertices.max(axis=0)
+        pad = 0.25 * (hi - lo) + localizer.voxel_size
+        boxes = np.hstack([translations + lo - pad, translations + hi + pad])
+        return _native.TemplateMatcher(
+            np.asarray(target_mesh.vertices, dtype=np.float64),
+            np.asarray(target_mesh.faces, dtype=np.int64),
+            boxes=boxes
+        )
         
     def detect(self, target_mesh: Mesh) -> List[DetectionResult]:
-        matcher = TemplateMatcher(target_mesh)
+        if self.matcher is not None and self.matcher.target_mesh is target_mesh:
+            matcher = self.matcher
+        else:
+            matcher = TemplateMatcher(target_mesh)
+        localizer = None
+        if self.localize_peaks > 0 and getattr(matcher, "_native", None) is not None:
+            localizer = _native.FFTLocalizer(
+                np.asarray(target_mesh.vertices, dtype=np.float64),
+                np.asarray(target_mesh.faces, dtype=np.int64)
+            )
         results = []
+        native_results, native_levels = [], []
         
         for idx, template in enumerate(self.templates):
+            if getattr(matcher, "_native", None) is not None:
+                vertices = np.asarray(template.vertices, dtype=np.float64)
+                faces = np.asarray(template.faces, dtype=np.int64)
+                native = matcher._native
+                if localizer is not None:
+                    native = self._localized_matcher(localizer, target_mesh, vertices, faces) or native
+                # Matching and Procrustes run natively with the GIL released
+                transform, confidence, mean_dist, cost = native.detect(vertices, faces)
+                results.append(DetectionResult(
+                    feature_id=f"template_{idx}",
+                    transform=transform,
+                    confidence=confidence,
+                    region_metadata={
+                        "mean_feature_dist": mean_dist,
+                        "alignment_cost": float(cost)
+                    }
+                ))
+                if self.refine_iterations > 0:
+                    native_results.append(results[-1])
+                    native_levels.append(self._icp_levels(vertices, faces))
+                continue
+
             match_info = matcher.match(template)
             
             # Use Procrustes alignment for robust pose estimation
@@ -60,4 +142,5 @@ class FPFHFeatureDetector(BaseFeatureDetector):
             )
             results.append(res)
             
+        self._refine(native_results, native_levels, target_mesh)
         return sorted(results, key=lambda x: x.confidence, reverse=True)
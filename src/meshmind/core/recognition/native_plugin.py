@@ -0,0 +1,78 @@
+"""
+Detectors implemented as native plugins (shared libraries built against
+cpp/include/meshmind/plugin.h).
+
+A plugin runs inside the native engine on the target as the FPFH matcher
+prepared it (surface samples, descriptors, triangle BVH), so a template
+costs one call into C++ rather than Python marshalling on every query.
+"""
+from typing import Any, List, Sequence
+
+import numpy as np
+
+from .base_detector import BaseFeatureDetector, DetectionResult
+from ..descriptors import HAS_NATIVE
+from ..matcher import TemplateMatcher
+
+if HAS_NATIVE:
+    from ... import _native
+
+
+class NativePluginDetector(BaseFeatureDetector):
+    """Runs a native detector plugin over a template library."""
+
+    # Set on the subclasses registered by discovery.dynamic_loader.load_native_plugins
+    library_path = None
+
+    def __init__(self, template_library: Sequence[Any] = (), matcher: TemplateMatcher = None,
+                 config: str = "", library_path: str = None):
+        """
+        Args:
+            template_library: Template meshes to locate
+            matcher: Optional prepared target index (shared with other detectors)
+            config: Configuration string passed to the plugin's create()
+            library_path: Plugin library; defaults to the class's library_path
+        """
+        if not HAS_NATIVE:
+            raise RuntimeError("Native plugins require the meshmind._native module")
+        path = library_path or self.library_path
+        if path is None:
+            raise ValueError("No plugin library given")
+        self.plugin = _native.NativePlugin(str(path), config)
+        self.name = self.plugin.name
+        self.templates = list(template_library)
+        self.matcher = matcher
+        self._target = None  # (matcher, _native.PluginTarget) of the last target
+
+    def _plugin_target(self, target_mesh: Any):
+        if self.matcher is not None and self.matcher.target_mesh is target_mesh:
+            matcher = self.matcher
+        else:
+            matcher = TemplateMatcher(target_mesh)
+        if self._target is None or self._target[0] is not matcher:
+            # The BVH is built once per target; samples and descriptors are the matcher's own
+            self._target = (matcher, _native.PluginTarget(
+                matcher._native,
+                np.asarray(target_mesh.vertices, dtype=np.float64),
+                np.asarray(target_mesh.faces, dtype=np.int64),
+            ))
+        return self._target[1]
+
+    def detect(self, target_mesh: Any) -> List[DetectionResult]:
+        target = self._plugin_target(target_mesh)
+        results = []
+        for idx, template in enumerate(self.templates):
+            feature_id = f"template_{idx}"
+            transforms, confidences, radii = self.plugin.detect(
+                target,
+                np.asarray(template.vertices, dtype=np.float64),
+                np.asarray(template.faces, dtype=np.int64),
+                feature_id,
+                str(getattr(template, "path", "") or ""),
+            )
+            for transform, confidence, radius in zip(transforms, confidences, radii):
+                metadata = {"plugin": self.name}
+                if radius > 0:
+                    metadata["radius"] = float(radius)
+                results.append(DetectionResult(feature_id, transform, float(confidence), metadata))
+        return results
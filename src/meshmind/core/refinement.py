@@ -1,6 +1,12 @@
 import numpy as np
 from typing import List, Dict, Any
 from .recognition.base_detector import DetectionResult
+from .recognition.detection_table import DetectionTable
+
+def rotate_offsets(transforms: np.ndarray, offsets: np.ndarray) -> np.ndarray:
+    """Local offsets (n, 3) rotated into the frames of transforms (n, 4, 4)."""
+    return np.einsum("nij,nj->ni", transforms[:, :3, :3], offsets)
+
 
 class RefinementRegion:
     """Represents a 3D volume for mesh refinement."""
@@ -14,6 +20,53 @@ class RefinementRegion:
         self.bounds = bounds # e.g. np.array([[min_x, min_y, min_z], [max_x, max_y, max_z]])
         self.mode = mode
 
+REGION_DTYPE = np.dtype([
+    ("det_index", np.int32),          # source row in the DetectionTable
+    ("kind", np.int8),                # REGION_PRIMARY or REGION_WAKE
+    ("transform", np.float64, (4, 4)),
+    ("level_size", np.float64),       # levels[0]
+    ("level", np.int32),              # levels[1]
+    ("bounds", np.float64, (2, 3)),
+])
+
+REGION_PRIMARY = 0
+REGION_WAKE = 1
+REGION_SUFFIXES = ("_ref", "_wake")
+
+
+class RegionTable:
+    """
+    Columnar refinement regions generated from a DetectionTable.
+    Iterating yields RefinementRegion objects for code that expects a list.
+    """
+
+    def __init__(self, records: np.ndarray, detections: DetectionTable):
+        self.records = records
+        self.detections = detections
+
+    def names(self) -> List[str]:
+        return [
+            self.detections.feature_id(int(det)) + REGION_SUFFIXES[kind]
+            for det, kind in zip(self.records["det_index"], self.records["kind"])
+        ]
+
+    def __len__(self) -> int:
+        return len(self.records)
+
+    def __getitem__(self, index: int) -> RefinementRegion:
+        record = self.records[index]
+        return RefinementRegion(
+            name=self.detections.feature_id(int(record["det_index"])) + REGION_SUFFIXES[record["kind"]],
+            region_type="box",
+            transform=record["transform"],
+            levels=(float(record["level_size"]), int(record["level"])),
+            bounds=record["bounds"]
+        )
+
+    def __iter__(self):
+        for index in range(len(self)):
+            yield self[index]
+
 class RegionGenerator:
     """Generates refinement regions from detection results based on feature-specific rules."""
     
@@ -31,7 +84,19 @@ class RegionGenerator:
         }
         
     def generate(self, detections: List[DetectionResult]) -> List[RefinementRegion]:
+        if isinstance(detections, DetectionTable):
+            return self.generate_table(detections)
         regions = []
+        
+        # Wake offsets of all detections, rotated into their feature frames in one batch
+        wakes = [det for det in detections if "wake_offset" in self.rules.get(det.feature_id, self.rules["default"])]
+        wake_offsets = {}
+        if wakes:
+            offsets = np.array([self.rules.get(det.feature_id, self.rules["default"])["wake_offset"] for det in wakes],
+                               dtype=np.float64)
+            rotated = rotate_offsets(np.array([det.transform for det in wakes], dtype=np.float64), offsets)
+            wake_offsets = {id(det): offset for det, offset in zip(wakes, rotated)}
+        
         for det in detections:
             rule = self.rules.get(det.feature_id, self.rules["default"])
             
@@ -55,12 +120,9 @@ class RegionGenerator:
                 # Wake transform starts at feature transform
                 wake_transform = det.transform.copy()
                 
-                # The offset is in the feature's local coordinate system
-                # We multiply the local offset by the rotation part of the transform
-                local_offset = np.array(rule["wake_offset"])
-                global_offset = det.transform[:3, :3] @ local_offset
-                
-                wake_transform[:3, 3] += global_offset
+                # The offset is in the feature's local coordinate system,
+                # rotated by the rotation part of the transform above
+                wake_transform[:3, 3] += wake_offsets[id(det)]
                 
                 # Wake bounds (longer in x-direction usually)
                 wake_scale = np.array(rule.get("wake_scale", [1.0, 1.0, 1.0]))
@@ -76,3 +138,51 @@ class RegionGenerator:
                 regions.append(wake)
                 
         return regions
+
+    def generate_table(self, detections: DetectionTable) -> RegionTable:
+        """Vectorised generate(): same regions, in the same order, as a RegionTable."""
+        count = len(detections)
+        base_bounds = np.array([[-0.5, -0.5, -0.5], [0.5, 0.5, 0.5]])
+        
+        # Resolve the rule of every detection (rules are keyed by full feature ID)
+        rule_index = np.zeros(count, dtype=np.int32)
+        names = ["default"] + [name for name in self.rules if name != "default"]
+        for i, name in enumerate(names[1:], start=1):
+            rule_index[detections.id_mask(name)] = i
+        rules = [self.rules[name] for name in names]
+        
+        has_wake = np.array([("wake_offset" in rule) for rule in rules])[rule_index]
+        level_size = np.array([rule["levels"][0] for rule in rules], dtype=np.float64)[rule_index]
+        level = np.array([rule["levels"][1] for rule in rules], dtype=np.int32)[rule_index]
+        
+        # Each detection emits its primary region, directly followed by its wake
+        primary = np.arange(count) + np.concatenate(([0], np.cumsum(has_wake)[:-1])).astype(np.int64)
+        records = np.zeros(count + int(has_wake.sum()), dtype=REGION_DTYPE)
+        
+        records["det_index"][primary] = np.arange(count)
+        records["kind"][primary] = REGION_PRIMARY
+        records["transform"][primary] = detections.transforms
+        records["level_size"][primary] = level_size
+        records["level"][primary] = level
+        records["bounds"][primary] = base_bounds
+        
+        if has_wake.any():
+            rows = np.nonzero(has_wake)[0]
+            wake = primary[rows] + 1
+            offsets = np.array([rule.get("wake_offset", [0.0, 0.0, 0.0]) for rule in rules],
+                               dtype=np.float64)[rule_index[rows]]
+            scales = np.array([rule.get("wake_scale", [1.0, 1.0, 1.0]) for rule in rules],
+                              dtype=np.float64)[rule_index[rows]]
+            
+            # Local offset rotated into the feature frame
+            transforms = detections.transforms[rows].copy()
+            transforms[:, :3, 3] += rotate_offsets(transforms, offsets)
+            
+            records["det_index"][wake] = rows
+            records["kind"][wake] = REGION_WAKE
+            records["transform"][wake] = transforms
+            records["level_size"][wake] = level_size[rows] * 2.0
+            records["level"][wake] = np.maximum(1, level[rows] - 1)
+            records["bounds"][wake] = base_bounds[None, :, :] * scales[:, None, :]
+        
+        return RegionTable(records, detections)
@@ -89,6 +89,30 @@ class ModelNet40Dataset:
         """Load OFF file as trimesh object."""
         return trimesh.load(str(file_path))
     
+    def preprocess(self, output_dir=None, points_per_sample=1024, samples_per_shard=1024,
+                   splits=("train", "test"), seed=0):
+        """
+        Convert the OFF meshes into memory-mapped training shards
+        (see meshmind.datasets.shards). Labels index get_categories().
+        
+        Returns:
+            Dict of split -> JSON index path; load with ShardedMeshDataset
+        """
+        from .shards import write_shards
+        
+        output_dir = Path(output_dir) if output_dir else self.data_dir / f"{self.dataset_name}_cache"
+        categories = self.get_categories()
+        indices = {}
+        for split in splits:
+            paths, labels = [], []
+            for label, category in enumerate(categories):
+                files = sorted(self.get_category_files(category, split))
+                paths.extend(files)
+                labels.extend([label] * len(files))
+            indices[split] = write_shards(paths, labels, output_dir, split, categories,
+                                          points_per_sample, samples_per_shard, seed)
+        return indices
+    
     def get_stats(self):
         """Get dataset statistics."""
         categories = self.get_categories()
@@ -0,0 +1,186 @@
+"""
+Preprocessed, memory-mapped training data for MeshCNN.
+
+Meshes are converted once into .mmds shards of fixed-size samples (surface
+points, normals and a label; layout in cpp/src/native/dataset.h) plus a
+JSON index per split. ShardedMeshDataset memory-maps the shards, so
+training reads arrays from the page cache instead of re-parsing and
+re-sampling OFF files every epoch, and loader worker processes share the
+same pages.
+"""
+import json
+import os
+from pathlib import Path
+from typing import List, Optional, Sequence
+
+import numpy as np
+
+from ..core.descriptors import HAS_NATIVE
+
+if HAS_NATIVE:
+    from .. import _native
+
+SHARD_MAGIC = b"MMDS"
+SHARD_VERSION = 1
+HEADER_SIZE = 16
+INDEX_VERSION = 1
+
+
+def write_shards(paths: Sequence[str], labels: Sequence[int], output_dir, split: str = "train",
+                 categories: Optional[List[str]] = None, points_per_sample: int = 1024,
+                 samples_per_shard: int = 1024, seed: int = 0) -> Path:
+    """
+    Sample and normalise meshes into shards <output_dir>/<split>-NNNNN.mmds.
+
+    Args:
+        paths: Mesh files (OFF/STL/OBJ)
+        labels: Class index per mesh
+        categories: Class names, stored in the index
+        points_per_sample: Surface points per mesh
+        samples_per_shard: Meshes per shard file
+        seed: Sampling seed (mesh i uses seed + i)
+
+    Returns:
+        Path of the split's JSON index
+    """
+    output_dir = Path(output_dir)
+    output_dir.mkdir(parents=True, exist_ok=True)
+    prefix = str(output_dir / split)
+    paths = [str(p) for p in paths]
+    labels = [int(label) for label in labels]
+
+    if HAS_NATIVE:
+        shards, counts, skipped = _native.write_dataset_shards(
+            paths, labels, prefix, points_per_sample, samples_per_shard, seed)
+    else:
+        shards, counts, skipped = _write_shards_python(
+            paths, labels, prefix, points_per_sample, samples_per_shard, seed)
+    for message in skipped:
+        print(f"Skipping {message}")
+
+    index = {
+        "version": INDEX_VERSION,
+        "points_per_sample": points_per_sample,
+        "categories": list(categories or []),
+        "shards": [{"file": Path(shard).name, "count": int(count)} for shard, count in zip(shards, counts)],
+    }
+    index_path = output_dir / f"{split}.json"
+    with open(index_path, "w") as f:
+        json.dump(index, f, indent=2)
+    return index_path
+
+
+def _write_shards_python(paths, labels, prefix, points_per_sample, samples_per_shard, seed):
+    """Same output as _native.write_dataset_shards, using trimesh."""
+    import trimesh
+
+    shards, counts, skipped = [], [], []
+    for first in range(0, len(paths), samples_per_shard):
+        points, normals, shard_labels = [], [], []
+        for i in range(first, min(first + samples_per_shard, len(paths))):
+            try:
+                mesh = trimesh.load(paths[i], force="mesh")
+                samples, face_index = trimesh.sample.sample_surface(mesh, points_per_sample, seed=seed + i)
+            except Exception as e:
+                skipped.append(f"{paths[i]}: {e}")
+                continue
+            center = mesh.vertices.mean(axis=0)
+            scale = np.abs(mesh.vertices - center).max() + 1e-8
+            points.append((samples - center) / scale)
+            normals.append(mesh.face_normals[face_index])
+            shard_labels.append(labels[i])
+        if not points:
+            continue
+
+        path = f"{prefix}-{len(shards):05d}.mmds"
+        with open(path, "wb") as f:
+            f.write(SHARD_MAGIC)
+            f.write(np.array([SHARD_VERSION, len(points), points_per_sample], dtype="<u4").tobytes())
+            f.write(np.asarray(points, dtype="<f4").tobytes())
+            f.write(np.asarray(normals, dtype="<f4").tobytes())
+            f.write(np.asarray(shard_labels, dtype="<i4").tobytes())
+        shards.append(path)
+        counts.append(len(points))
+    return shards, counts, skipped
+
+
+def read_shard(path):
+    """Memory-map a shard; returns (points [N, P, 3], normals [N, P, 3], labels [N])."""
+    with open(path, "rb") as f:
+        header = f.read(HEADER_SIZE)
+    if len(header) < HEADER_SIZE or header[:4] != SHARD_MAGIC:
+        raise ValueError(f"Not a dataset shard: {path}")
+    version, count, points_per_sample = np.frombuffer(header[4:], dtype="<u4")
+    if version != SHARD_VERSION:
+        raise ValueError(f"Unsupported dataset shard version: {version}")
+
+    count, points_per_sample = int(count), int(points_per_sample)
+    block = count * points_per_sample * 3 * 4
+    shape = (count, points_per_sample, 3)
+    points = np.memmap(path, dtype="<f4", mode="r", offset=HEADER_SIZE, shape=shape)
+    normals = np.memmap(path, dtype="<f4", mode="r", offset=HEADER_SIZE + block, shape=shape)
+    labels = np.memmap(path, dtype="<i4", mode="r", offset=HEADER_SIZE + 2 * block, shape=(count,))
+    return points, normals, labels
+
+
+class ShardedMeshDataset:
+    """
+    Map-style dataset over the shards of one split.
+
+    Items are (points [P, 3], normals [P, 3], label) as float32/int arrays.
+    Compatible with torch.utils.data.DataLoader and its worker processes:
+    shards are mapped lazily in each process.
+    """
+
+    def __init__(self, directory, split: str = "train"):
+        self.directory = Path(directory)
+        self.split = split
+        with open(self.directory / f"{split}.json") as f:
+            index = json.load(f)
+        if index.get("version") != INDEX_VERSION:
+            raise ValueError(f"Unsupported dataset index version: {index.get('version')}")
+
+        self.categories = index["categories"]
+        self.points_per_sample = index["points_per_sample"]
+        self._files = [self.directory / shard["file"] for shard in index["shards"]]
+        self._offsets = np.cumsum([0] + [shard["count"] for shard in index["shards"]])
+        self._shards = None
+        self._pid = None
+
+    def _open(self):
+        # Re-map after fork so that every worker has its own file handles
+        if self._shards is None or self._pid != os.getpid():
+            self._shards = [read_shard(path) for path in self._files]
+            self._pid = os.getpid()
+        return self._shards
+
+    def __len__(self) -> int:
+        return int(self._offsets[-1])
+
+    def _locate(self, index: int):
+        if index < 0:
+            index += len(self)
+        if not 0 <= index < len(self):
+            raise IndexError("sample index out of range")
+        shard = int(np.searchsorted(self._offsets, index, side="right")) - 1
+        return shard, index - int(self._offsets[shard])
+
+    def __getitem__(self, index: int):
+        shard, row = self._locate(index)
+        points, normals, labels = self._open()[shard]
+        return np.array(points[row]), np.array(normals[row]), int(labels[row])
+
+    def get_batch(self, indices: Sequence[int]):
+        """Gather several samples into (points [B, P, 3], normals [B, P, 3], labels [B])."""
+        shards = self._open()
+        items = [self._locate(int(i)) for i in indices]
+        points = np.stack([shards[s][0][row] for s, row in items])
+        normals = np.stack([shards[s][1][row] for s, row in items])
+        labels = np.array([shards[s][2][row] for s, row in items], dtype=np.int64)
+        return points, normals, labels
+
+    @property
+    def labels(self) -> np.ndarray:
+        """Labels of all samples, in dataset order."""
+        return np.concatenate([np.asarray(labels, dtype=np.int64) for _, _, labels in self._open()]
+                              or [np.zeros(0, dtype=np.int64)])
@@ -25,6 +25,36 @@ def load_plugins(plugin_dir: str):
         except ImportError as e:
             print(f"Failed to load plugin {full_module_name}: {e}")
 
+NATIVE_PLUGIN_SUFFIXES = (".so", ".dylib", ".dll")
+
+def load_native_plugins(plugin_dir: str) -> List[str]:
+    """
+    Register every native detector plugin (shared library exporting
+    meshmind_detector_plugin) in the specified directory under its own name.
+    Returns the names that were registered.
+    """
+    from ..core.descriptors import HAS_NATIVE
+    from ..core.recognition.native_plugin import NativePluginDetector
+
+    if not HAS_NATIVE or not os.path.exists(plugin_dir):
+        return []
+    from .. import _native
+
+    names = []
+    for file_name in sorted(os.listdir(plugin_dir)):
+        if not file_name.endswith(NATIVE_PLUGIN_SUFFIXES):
+            continue
+        path = os.path.join(plugin_dir, file_name)
+        try:
+            name = _native.NativePlugin(path).name
+        except (RuntimeError, ValueError) as e:
+            print(f"Failed to load native plugin {path}: {e}")
+            continue
+        detector_cls = type(f"NativePlugin_{name}", (NativePluginDetector,), {"library_path": path})
+        DetectorRegistry.register(name)(detector_cls)
+        names.append(name)
+    return names
+
 def get_registered_detectors():
     """Returns the list of currently registered detector names."""
     return list(DetectorRegistry().list_detectors().keys())
@@ -1,8 +1,15 @@
 import trimesh
 from ..core.geometry import Mesh
+from ..core.descriptors import HAS_NATIVE
+
+if HAS_NATIVE:
+    from .. import _native
 
 def load_stl(file_path: str) -> Mesh:
     """Load an STL file and return a Mesh object."""
+    if HAS_NATIVE:
+        vertices, faces = _native.load_mesh(str(file_path))
+        return Mesh(trimesh.Trimesh(vertices=vertices, faces=faces, process=False))
     tm = trimesh.load(file_path, file_type='stl')
     if isinstance(tm, trimesh.Scene):
         # Merge if it's a scene
@@ -1,33 +1,53 @@
 """
 ML-based feature detector using MeshCNN.
 """
+import os
+import numpy as np
+
 try:
     import torch
-    import numpy as np
     from ..models.meshcnn import create_meshcnn, TORCH_AVAILABLE
-    import os
 except ImportError:
     TORCH_AVAILABLE = False
 
 from meshmind.core.recognition.base_detector import BaseFeatureDetector, DetectionResult
 from meshmind.core.geometry import Mesh
+from meshmind.core.descriptors import HAS_NATIVE
+
+if HAS_NATIVE:
+    from ... import _native
+
+DEFAULT_WEIGHTS = "assets/models/meshcnn_weights.pth"
+# Exported by scripts/export_meshcnn_weights.py for the native CPU engine
+DEFAULT_NATIVE_WEIGHTS = "assets/models/meshcnn_weights.mmnn"
 
 class MLFeatureDetector:
     """
     Wrapper for ML-based feature detection.
     
     Uses MeshCNN to extract global features and match against template features.
+    With native .mmnn weights, inference runs on the CPU engine without PyTorch.
     """
     
     def __init__(self, model=None, weights_path=None, num_classes=4):
+        self.native = None
+        # (target mesh, features): the target is shared by every template it is matched against
+        self._target_cache = (None, None)
+        if model is None and HAS_NATIVE:
+            native_weights = weights_path
+            if native_weights is None and os.path.exists(DEFAULT_NATIVE_WEIGHTS):
+                native_weights = DEFAULT_NATIVE_WEIGHTS
+            if native_weights is not None and str(native_weights).endswith(".mmnn"):
+                self.native = _native.MeshCNN(str(native_weights))
+                return
+        
         if not TORCH_AVAILABLE:
-            raise ImportError("PyTorch required for ML detector")
+            raise ImportError("PyTorch (or native .mmnn weights) required for ML detector")
         
         if model is None:
             # Try to load trained weights if available
-            default_weights = "assets/models/meshcnn_weights.pth"
-            if weights_path is None and os.path.exists(default_weights):
-                weights_path = default_weights
+            if weights_path is None and os.path.exists(DEFAULT_WEIGHTS):
+                weights_path = DEFAULT_WEIGHTS
             
             self.model = create_meshcnn(
                 num_classes=num_classes,
@@ -55,6 +75,9 @@ class MLFeatureDetector:
         Returns:
             features: numpy array of shape [feature_dim]
         """
+        if self.native is not None:
+            return self.native.extract_features(np.asarray(mesh.vertices, dtype=np.float64))
+        
         vertices = self.mesh_to_tensor(mesh)
         
         with torch.no_grad():
@@ -75,7 +98,10 @@ class MLFeatureDetector:
             transform: 4x4 transformation matrix
         """
         # Extract features
-        target_features = self.extract_features(target_mesh)
+        cached_mesh, target_features = self._target_cache
+        if cached_mesh is not target_mesh:
+            target_features = self.extract_features(target_mesh)
+            self._target_cache = (target_mesh, target_features)
         template_features = self.extract_features(template_mesh)
         
         # Compute cosine similarity
@@ -139,6 +139,146 @@ else:
     def create_meshcnn(num_classes=10, pretrained=False, weights_path=None):
         raise ImportError("PyTorch required for MeshCNN")
 
+def _fnv1a(data: bytes) -> int:
+    value = 1469598103934665603
+    for byte in data:
+        value = ((value ^ byte) * 1099511628211) & 0xFFFFFFFFFFFFFFFF
+    return value
+
+
+def export_native_weights(state_dict, output_path, layers=("1", "2", "3"), eps=1e-5, input_scales=None):
+    """
+    Write the feature layers (fcN + bnN) of a SimplifiedMeshCNN state dict in the
+    binary format read by the native engine (see cpp/src/native/meshcnn.h).
+    
+    Args:
+        state_dict: model.state_dict() or torch.load("meshcnn_weights.pth");
+            values may be tensors or NumPy arrays
+        output_path: Destination file (conventionally *.mmnn)
+        layers: Layer suffixes to export, in order
+        eps: BatchNorm epsilon (nn.BatchNorm1d default)
+        input_scales: Optional per-layer activation scales from
+            calibrate_input_scales(); layers with a scale > 0 run in INT8
+    """
+    import struct
+    
+    def array(name):
+        value = state_dict[name]
+        if hasattr(value, "detach"):
+            value = value.detach().cpu().numpy()
+        return np.ascontiguousarray(value, dtype="<f4")
+    
+    version = 1 if input_scales is None else 2
+    payload = bytearray(struct.pack("<I", len(layers)))
+    for i, layer in enumerate(layers):
+        weight = array(f"fc{layer}.weight")
+        out_dim, in_dim = weight.shape
+        payload += struct.pack("<IIf", in_dim, out_dim, eps)
+        if version >= 2:
+            payload += struct.pack("<f", input_scales[i])
+        payload += weight.tobytes()
+        for name in (f"fc{layer}.bias", f"bn{layer}.weight", f"bn{layer}.bias",
+                     f"bn{layer}.running_mean", f"bn{layer}.running_var"):
+            payload += array(name).tobytes()
+    
+    with open(output_path, "wb") as f:
+        f.write(b"MMNN")
+        f.write(struct.pack("<I", version))
+        f.write(payload)
+        f.write(struct.pack("<Q", _fnv1a(bytes(payload))))
+
+
+def load_native_weights(path):
+    """
+    Read a file written by export_native_weights().
+    
+    Returns:
+        (state_dict, eps, input_scales): NumPy state dict with layers named
+        "1", "2", ...; input_scales is None for float-only (version 1) files
+    """
+    import struct
+    
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != b"MMNN":
+        raise ValueError(f"Not a MeshCNN weights file: {path}")
+    version, = struct.unpack_from("<I", data, 4)
+    payload = data[8:-8]
+    if struct.unpack("<Q", data[-8:])[0] != _fnv1a(payload):
+        raise ValueError(f"MeshCNN weights checksum mismatch: {path}")
+    
+    offset = 4
+    count, = struct.unpack_from("<I", payload, 0)
+    state_dict, input_scales, eps = {}, [], 1e-5
+    
+    def floats(size):
+        nonlocal offset
+        values = np.frombuffer(payload, dtype="<f4", count=size, offset=offset).astype(np.float32)
+        offset += 4 * size
+        return values
+    
+    for layer in range(1, count + 1):
+        in_dim, out_dim, eps = struct.unpack_from("<IIf", payload, offset)
+        offset += 12
+        if version >= 2:
+            input_scales.append(struct.unpack_from("<f", payload, offset)[0])
+            offset += 4
+        state_dict[f"fc{layer}.weight"] = floats(out_dim * in_dim).reshape(out_dim, in_dim)
+        for name in (f"fc{layer}.bias", f"bn{layer}.weight", f"bn{layer}.bias",
+                     f"bn{layer}.running_mean", f"bn{layer}.running_var"):
+            state_dict[name] = floats(out_dim)
+    return state_dict, eps, (input_scales if version >= 2 else None)
+
+
+def calibrate_input_scales(state_dict, vertex_sets, layers=("1", "2", "3"), eps=1e-5,
+                           percentile=99.99, max_vertices=1024, seed=0):
+    """
+    Post-training INT8 calibration of the feature layers.
+    
+    Runs the float layers over calibration meshes and sets each layer's
+    activation scale so that the given percentile of its (non-negative)
+    inputs maps to the top of the 7-bit range. Weights are quantised per
+    output channel by the native engine at load time. Layers whose shape
+    the INT8 kernels do not cover (the xyz input layer) stay in float.
+    
+    Args:
+        state_dict: SimplifiedMeshCNN state dict (tensors or NumPy arrays)
+        vertex_sets: Iterable of [N, 3] vertex arrays
+        percentile: Clipping percentile of the activation distribution
+        max_vertices: Vertices sampled per mesh
+    
+    Returns:
+        List of per-layer input scales for export_native_weights()
+    """
+    def array(name):
+        value = state_dict[name]
+        if hasattr(value, "detach"):
+            value = value.detach().cpu().numpy()
+        return np.asarray(value, dtype=np.float64)
+    
+    rng = np.random.default_rng(seed)
+    samples = [[] for _ in layers]
+    for vertices in vertex_sets:
+        x = np.asarray(vertices, dtype=np.float64)
+        if len(x) > max_vertices:
+            x = x[rng.choice(len(x), max_vertices, replace=False)]
+        for i, layer in enumerate(layers):
+            samples[i].append(x.astype(np.float32).ravel())
+            scale = array(f"bn{layer}.weight") / np.sqrt(array(f"bn{layer}.running_var") + eps)
+            x = x @ array(f"fc{layer}.weight").T + array(f"fc{layer}.bias")
+            x = np.maximum((x - array(f"bn{layer}.running_mean")) * scale + array(f"bn{layer}.bias"), 0.0)
+    
+    scales = []
+    for i, layer in enumerate(layers):
+        out_dim, in_dim = array(f"fc{layer}.weight").shape
+        if i == 0 or in_dim % 4 or out_dim % 8 or not samples[i]:
+            scales.append(0.0)
+            continue
+        clip = float(np.percentile(np.concatenate(samples[i]), percentile))
+        scales.append(clip / 127.0 if clip > 0 else 0.0)
+    return scales
+
+
 # Backward compatibility
 MeshCNN = SimplifiedMeshCNN if TORCH_AVAILABLE else type('MeshCNN', (), {})
 create_mock_meshcnn = create_meshcnn
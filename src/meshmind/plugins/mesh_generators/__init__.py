@@ -8,7 +8,7 @@ Abstract base class for integrating various mesh generators
 from abc import ABC, abstractmethod
 from typing import List, Dict, Any
 from pathlib import Path
-from ..core.recognition.base_detector import DetectionResult
+from ...core.recognition.base_detector import DetectionResult
 
 
 class MeshGeneratorPlugin(ABC):
@@ -92,7 +92,7 @@ class SnappyHexMeshGenerator(MeshGeneratorPlugin):
         global_params: Dict[str, Any]
     ) -> Dict[str, Any]:
         """Generate snappyHexMeshDict configuration"""
-        from ..core.refinement import RegionGenerator
+        from ...core.refinement import RegionGenerator
         
         rules = global_params.get("rules")
         generator = RegionGenerator(rules=rules)
@@ -106,7 +106,7 @@ class SnappyHexMeshGenerator(MeshGeneratorPlugin):
     
     def export_config(self, config: Dict[str, Any], output_path: str):
         """Write snappyHexMeshDict"""
-        from ..cfd.snappy_interface import write_complete_dict
+        from ...cfd.snappy_interface import write_complete_dict
         
         regions = config.get("regions", [])
         write_complete_dict(output_path, regions)
@@ -6,6 +6,7 @@ https://github.com/wildmeshing/fTetWild
 """
 
 import json
+import numpy as np
 import subprocess
 import shutil
 from typing import List, Dict, Any
@@ -13,6 +14,11 @@ from pathlib import Path
 
 from . import MeshGeneratorPlugin, register_generator
 from ...core.recognition.base_detector import DetectionResult
+from ...core.recognition.detection_table import DetectionTable
+from ...core.descriptors import HAS_NATIVE
+
+if HAS_NATIVE:
+    from ... import _native
 
 
 @register_generator("ftetwild")
@@ -50,6 +56,19 @@ class FTetWildGenerator(MeshGeneratorPlugin):
         
         sizing_field = []
         
+        if isinstance(detections, DetectionTable) and not any(
+            "bounds" in extra for extra in detections.extras.values()
+        ):
+            # Column-wise: centres from the transforms, radius column with the 0.5 default
+            centers = detections.positions.tolist()
+            radii = np.where(np.isnan(detections.radii), 0.5, detections.radii).tolist()
+            edge_length = float(base_size * refinement_factor)
+            sizing_field = [
+                {"center": center, "radius": radius, "size": edge_length}
+                for center, radius in zip(centers, radii)
+            ]
+            detections = []
+        
         for det in detections:
             # Feature center from transform
             center = det.transform[:3, 3].tolist()
@@ -65,7 +84,7 @@ class FTetWildGenerator(MeshGeneratorPlugin):
             # Target edge length = base_size * refinement_factor
             edge_length = base_size * refinement_factor
             
-            siz ing_sphere = {
+            sizing_sphere = {
                 "center": center,
                 "radius": float(radius),
                 "size": float(edge_length)
@@ -92,6 +111,19 @@ class FTetWildGenerator(MeshGeneratorPlugin):
         """
         sizing_field = config.get("sizing", [])
         
+        if HAS_NATIVE and sizing_field and all(
+            isinstance(s["radius"], float) and isinstance(s["size"], float)
+            and all(isinstance(c, float) for c in s["center"])
+            for s in sizing_field
+        ):
+            _native.write_ftetwild_sizing(
+                str(output_path),
+                np.array([s["center"] for s in sizing_field], dtype=np.float64),
+                np.array([s["radius"] for s in sizing_field], dtype=np.float64),
+                np.array([s["size"] for s in sizing_field], dtype=np.float64)
+            )
+            return
+        
         # fTetWild expects a JSON array
         with open(output_path, 'w') as f:
             json.dump(sizing_field, f, indent=2)
@@ -1,13 +1,15 @@
 import os
+import numpy as np
 from typing import List, Dict, Any
 from ..io.stl_handler import load_stl
 from ..io.obj_handler import load_obj
 from ..core.geometry import Mesh
 from ..core.recognition.fpfh_matcher import FPFHFeatureDetector
 from ..core.recognition.ensemble import EnsembleDetector
+from ..core.recognition.detection_table import DetectionTable
 from ..core.refinement import RegionGenerator
 from ..cfd.snappy_interface import write_complete_dict, export_full_case
-from ..cfd.mrf_generator import create_mrf_zone
+from ..cfd.mrf_generator import create_mrf_zone, create_mrf_zones
 from ..cfd.rule_templates import is_rotating_feature, get_mrf_rules
 
 class AutoMesher:
@@ -33,6 +35,15 @@ class AutoMesher:
             raise ValueError(f"Unsupported file extension: {ext}")
         return self.target_mesh
         
+    def load_template(self, file_path: str) -> Mesh:
+        """Load a template geometry (STL/OBJ); returns None for unsupported extensions."""
+        ext = os.path.splitext(file_path)[1].lower()
+        if ext == '.stl':
+            return load_stl(file_path)
+        elif ext == '.obj':
+            return load_obj(file_path)
+        return None
+        
     def detect_features(self, template_paths: List[str]) -> List[Any]:
         """Load templates and run the feature recognition ensemble."""
         if not self.target_mesh:
@@ -42,11 +53,9 @@ class AutoMesher:
         self.template_types = []  # Track feature types from filenames
         
         for path in template_paths:
-            ext = os.path.splitext(path)[1].lower()
-            if ext == '.stl':
-                templates.append(load_stl(path))
-            elif ext == '.obj':
-                templates.append(load_obj(path))
+            template = self.load_template(path)
+            if template is not None:
+                templates.append(template)
             
             # Extract feature type from filename (e.g., "wheel_18inch.stl" -> "wheel")
             basename = os.path.basename(path)
@@ -57,7 +66,7 @@ class AutoMesher:
         detector = FPFHFeatureDetector(template_library=templates)
         ensemble = EnsembleDetector(detectors=[detector])
         
-        self.detections = ensemble.detect(self.target_mesh)
+        self.detections = DetectionTable.from_detections(ensemble.detect(self.target_mesh))
         
         # Update feature_ids with actual feature types
         for i, det in enumerate(self.detections):
@@ -91,7 +100,9 @@ class AutoMesher:
         self.regions = generator.generate(self.detections)
         
         # Generate MRF zones for rotating features
-        if enable_mrf:
+        if enable_mrf and isinstance(self.detections, DetectionTable):
+            self.mrf_zones = self._generate_mrf_table(mrf_params or {})
+        elif enable_mrf:
             self.mrf_zones = []
             mrf_params = mrf_params or {}
             
@@ -128,6 +139,31 @@ class AutoMesher:
         
         return self.regions
         
+    def _generate_mrf_table(self, mrf_params: Dict[str, Any]) -> List[Dict]:
+        """MRF zones for a DetectionTable, one vectorised batch per rotating feature type."""
+        base_types = self.detections.base_types()
+        zones = {}
+        for feature_type in set(base_types.tolist()):
+            if not is_rotating_feature(feature_type):
+                continue
+            mrf_rules = get_mrf_rules(feature_type)
+            rows = np.nonzero(base_types == feature_type)[0]
+            batch = create_mrf_zones(
+                self.detections,
+                rows,
+                feature_type=feature_type,
+                omega=mrf_params.get('omega'),
+                radius_scale=mrf_rules['cellZone'].get('radius_scale', 1.2),
+                height_scale=mrf_rules['cellZone'].get('height_scale', 1.1),
+                non_rotating_patches=mrf_params.get(
+                    'non_rotating_patches',
+                    mrf_rules['rotation'].get('non_rotating_patches')
+                )
+            )
+            zones.update(zip(rows.tolist(), batch))
+        # Keep detection order, as the per-object loop does
+        return [zones[row] for row in sorted(zones)]
+        
     def export_snappy_dict(self, output_path: str, include_mrf: bool = True):
         """
         Export the generated refinement regions to a snappyHexMeshDict.
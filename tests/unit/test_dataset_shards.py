@@ -0,0 +1,47 @@
+import pytest
+import numpy as np
+import trimesh
+from meshmind.datasets.shards import ShardedMeshDataset, write_shards, read_shard
+
+
+@pytest.fixture
+def off_files(tmp_path):
+    paths = []
+    shapes = [trimesh.creation.box(), trimesh.creation.icosphere(subdivisions=1), trimesh.creation.cylinder(0.5, 2.0)]
+    for i, mesh in enumerate(shapes):
+        mesh.apply_translation([i, 2 * i, -i])
+        path = tmp_path / f"shape_{i}.off"
+        path.write_text(trimesh.exchange.off.export_off(mesh))
+        paths.append(path)
+    # Unreadable meshes are skipped, not fatal
+    broken = tmp_path / "broken.off"
+    broken.write_text("OFF\n3 1 0\n0 0 0\n")
+    return paths + [broken]
+
+
+def test_shards_round_trip(tmp_path, off_files):
+    index = write_shards(off_files, [0, 1, 1, 2], tmp_path / "cache", "train",
+                         categories=["box", "round", "other"], points_per_sample=64, samples_per_shard=2)
+    dataset = ShardedMeshDataset(index.parent, "train")
+
+    assert len(dataset) == 3
+    assert dataset.categories == ["box", "round", "other"]
+    assert dataset.labels.tolist() == [0, 1, 1]
+
+    points, normals, label = dataset[2]
+    assert points.shape == (64, 3) and normals.shape == (64, 3) and label == 1
+    # Normalised as in train_meshcnn.py: centred, largest coordinate ~1
+    assert np.abs(points).max() <= 1.0 + 1e-5
+    np.testing.assert_allclose(np.linalg.norm(normals, axis=1), 1.0, rtol=1e-5)
+
+    batch_points, _, batch_labels = dataset.get_batch([2, 0])
+    assert batch_points.shape == (2, 64, 3)
+    np.testing.assert_array_equal(batch_points[0], points)
+    assert batch_labels.tolist() == [1, 0]
+
+
+def test_shard_is_memory_mapped(tmp_path, off_files):
+    index = write_shards(off_files[:2], [0, 1], tmp_path, points_per_sample=16)
+    points, normals, labels = read_shard(tmp_path / "train-00000.mmds")
+    assert isinstance(points, np.memmap)
+    assert points.shape == (2, 16, 3) and labels.tolist() == [0, 1]
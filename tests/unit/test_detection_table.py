@@ -0,0 +1,57 @@
+import pytest
+import numpy as np
+import trimesh
+from meshmind.core.recognition.base_detector import DetectionResult
+from meshmind.core.recognition.detection_table import DetectionTable
+from meshmind.core.refinement import RegionGenerator, RegionTable
+from meshmind.cfd.snappy_interface import generate_snappy_dict
+from meshmind.cfd.mrf_generator import create_mrf_zone, create_cell_zone, create_mrf_zones
+
+@pytest.fixture
+def detections():
+    rng = np.random.default_rng(0)
+    results = []
+    for i, feature_id in enumerate(["wheel", "wheel_1", "fan_2", "mirror", "template_0"]):
+        transform = trimesh.transformations.random_rotation_matrix(rng.random(3))
+        transform[:3, 3] = rng.normal(size=3)
+        metadata = {"radius": 0.3, "alignment_cost": 0.1} if i % 2 == 0 else {}
+        results.append(DetectionResult(feature_id, transform, float(rng.random()), metadata))
+    return results
+
+def test_table_round_trip(detections):
+    table = DetectionTable.from_detections(detections)
+    assert len(table) == len(detections)
+    assert table.feature_ids() == [det.feature_id for det in detections]
+
+    for det, view in zip(detections, table):
+        assert view.feature_id == det.feature_id
+        assert np.array_equal(view.transform, det.transform)
+        assert view.confidence == det.confidence
+        assert view.region_metadata == det.region_metadata
+
+def test_views_write_through(detections):
+    table = DetectionTable.from_detections(detections)
+    view = table[1]
+    view.feature_id = "wheel_7"
+    view.transform[0, 3] = 42.0
+
+    assert table.feature_id(1) == "wheel_7"
+    assert table.positions[1, 0] == 42.0
+    assert table.id_mask("wheel_7").tolist() == [False, True, False, False, False]
+
+def test_vectorised_regions_match(detections):
+    table = DetectionTable.from_detections(detections)
+    gen = RegionGenerator()
+
+    regions = gen.generate(table)
+    assert isinstance(regions, RegionTable)
+    assert generate_snappy_dict(regions) == generate_snappy_dict(gen.generate(detections))
+
+def test_vectorised_mrf_zones_match(detections):
+    table = DetectionTable.from_detections(detections)
+    zones = create_mrf_zones(table, np.arange(len(table)), "wheel")
+
+    for det, zone in zip(detections, zones):
+        expected = create_mrf_zone(det, "wheel")
+        expected["_cellZone"] = create_cell_zone(det, "wheel")
+        assert zone == expected
@@ -0,0 +1,66 @@
+import pytest
+import numpy as np
+import trimesh
+from meshmind.core.recognition.base_detector import DetectionResult
+from meshmind.core.recognition.ensemble import EnsembleDetector, fuse_poses
+
+
+class FixedDetector:
+    def __init__(self, results):
+        self.results = results
+
+    def detect(self, target_mesh):
+        return self.results
+
+
+def pose(rng, axis, position, noise=0.0):
+    transform = trimesh.transformations.rotation_matrix(
+        np.linalg.norm(axis) + rng.normal(scale=noise), axis)
+    transform[:3, 3] = np.asarray(position) + rng.normal(scale=noise / 4, size=3)
+    return transform
+
+
+def test_ensemble_fuses_agreeing_detectors():
+    rng = np.random.default_rng(0)
+    fpfh = FixedDetector([
+        DetectionResult("template_0", pose(rng, [0, 0, 1.0], [1, 2, 3], 0.02), 0.6),
+        DetectionResult("template_0", pose(rng, [0, 0, 1.0], [1, 2, 3], 0.02), 0.5),
+        DetectionResult("template_0", pose(rng, [1.0, 0, 0], [5, 5, 5]), 0.3),
+        DetectionResult("template_1", pose(rng, [0, 0, 1.0], [1, 2, 3], 0.02), 0.4),
+    ])
+    meshcnn = FixedDetector([
+        DetectionResult("meshcnn_template_0", pose(rng, [0, 0, 1.0], [1, 2, 3], 0.02), 0.7, {"ml_based": True}),
+    ])
+
+    results = EnsembleDetector([fpfh, meshcnn], translation_bandwidth=0.05).detect(None)
+
+    assert [r.feature_id for r in results] == ["meshcnn_template_0", "template_1", "template_0"]
+    # Noisy-OR over the detectors' best scores; the duplicate FPFH hit adds nothing
+    assert results[0].confidence == pytest.approx(1 - (1 - 0.6) * (1 - 0.7))
+    assert results[0].region_metadata == {"ml_based": True, "ensemble_support": 3}
+    np.testing.assert_allclose(results[0].transform[:3, 3], [1, 2, 3], atol=0.02)
+    rotation = results[0].transform[:3, :3]
+    np.testing.assert_allclose(rotation @ rotation.T, np.eye(3), atol=1e-9)
+
+
+def test_ensemble_keeps_templates_with_equal_indices_apart():
+    rng = np.random.default_rng(0)
+    wheel = FixedDetector([DetectionResult("wheel_3", pose(rng, [0, 0, 1.0], [1, 2, 3]), 0.6)])
+    bolt = FixedDetector([DetectionResult("bolt_3", pose(rng, [0, 0, 1.0], [1, 2, 3]), 0.5)])
+
+    results = EnsembleDetector([wheel, bolt], translation_bandwidth=0.05).detect(None)
+
+    assert sorted(r.feature_id for r in results) == ["bolt_3", "wheel_3"]
+    assert [r.confidence for r in results] == pytest.approx([0.6, 0.5])
+
+
+def test_fusion_weights_and_scale():
+    transform = np.eye(4)
+    transform[:3, :3] *= 2.0
+    transforms = np.array([transform, transform])
+    fused, confidence, representative, support, assignment = fuse_poses(
+        transforms, [0.5, 0.5], [0, 0], [0, 1], [1.0, 0.5], 0.1)
+
+    np.testing.assert_allclose(fused[0], transform, atol=1e-12)
+    assert confidence[0] == pytest.approx(1 - 0.5 * 0.75)
+    assert support.tolist() == [2] and assignment.tolist() == [0, 0]
@@ -0,0 +1,300 @@
+import pytest
+import json
+import numpy as np
+import trimesh
+
+_native = pytest.importorskip("meshmind._native")
+
+
+@pytest.fixture
+def sphere():
+    return trimesh.creation.icosphere(subdivisions=2)
+
+
+def test_kdtree_matches_scipy():
+    from scipy.spatial import KDTree
+    rng = np.random.default_rng(0)
+    points = rng.random((500, 33))
+    queries = rng.random((50, 33))
+
+    d_ref, i_ref = KDTree(points).query(queries, k=3)
+    d, i = _native.KDTree(points).query(queries, k=3)
+
+    np.testing.assert_array_equal(i, i_ref)
+    np.testing.assert_allclose(d, d_ref)
+
+
+def test_procrustes_recovers_similarity():
+    rng = np.random.default_rng(1)
+    source = rng.random((100, 3))
+    transform = trimesh.transformations.random_rotation_matrix(rng.random(3))
+    transform[:3, :3] *= 1.5
+    transform[:3, 3] = [0.5, -1.0, 2.0]
+    target = trimesh.transform_points(source, transform)
+
+    estimate, cost = _native.procrustes(source, target)
+    np.testing.assert_allclose(estimate, transform, atol=1e-9)
+    assert cost < 1e-12
+
+
+def test_ransac_procrustes_rejects_outliers():
+    rng = np.random.default_rng(2)
+    source = rng.random((400, 3))
+    transform = trimesh.transformations.random_rotation_matrix(rng.random(3))
+    transform[:3, 3] = (0.5, -1.0, 2.0)
+    target = trimesh.transform_points(source, transform)
+    target[40:] = rng.random((360, 3)) * 3.0
+
+    result, inliers, cost = _native.ransac_procrustes(source, target, threshold=0.01, iterations=20000, scale=False)
+    assert inliers == 40
+    np.testing.assert_allclose(result, transform, atol=1e-8)
+
+
+def test_robust_registration_survives_extreme_outliers():
+    rng = np.random.default_rng(3)
+    source = rng.random((600, 3))
+    transform = trimesh.transformations.random_rotation_matrix(rng.random(3))
+    transform[:3, :3] *= 1.5
+    transform[:3, 3] = (0.5, -1.0, 2.0)
+    target = trimesh.transform_points(source, transform)
+    target[20:] = rng.random((580, 3)) * 3.0
+
+    result, inliers, clique_size = _native.robust_registration(source, target, noise_bound=0.01)
+    assert clique_size == 20
+    assert sorted(inliers) == list(range(20))
+    np.testing.assert_allclose(result, transform, atol=1e-8)
+
+
+def test_verify_pose_measures_coverage(sphere):
+    samples, _ = trimesh.sample.sample_surface(sphere, 500, seed=0)
+    coverage, rms, rejected = _native.verify_pose(np.eye(4), samples, sphere.vertices, sphere.faces, 0.02)
+    assert coverage == 1.0 and rms < 1e-9 and not rejected
+
+    shifted = trimesh.transformations.translation_matrix((0.3, 0.0, 0.0))
+    coverage, rms, rejected = _native.verify_pose(shifted, samples, sphere.vertices, sphere.faces, 0.02)
+    assert coverage < 0.5 and rms <= 0.02
+    assert _native.verify_pose(shifted, samples, sphere.vertices, sphere.faces, 0.02, min_coverage=0.8)[2]
+
+
+def test_icp_refine_recovers_perturbed_pose():
+    box = trimesh.creation.box(extents=(1.0, 0.6, 0.3))
+    transform = trimesh.transformations.rotation_matrix(0.9, (0, 0, 1))
+    transform[:3, 3] = (0.5, -1.0, 2.0)
+    target = box.copy()
+    target.apply_transform(transform)
+
+    initial = transform @ trimesh.transformations.rotation_matrix(0.05, (1, 0, 0))
+    initial[:3, 3] += 0.03
+    levels = []
+    for count in (64, 500):
+        points, faces = trimesh.sample.sample_surface(box, count, seed=0)
+        levels.append(np.hstack([points, box.face_normals[faces]]))
+
+    for symmetric in (False, True):
+        refined, rms = _native.icp_refine(initial[None], [levels], target.vertices, target.faces, symmetric=symmetric)
+        np.testing.assert_allclose(refined[0], transform, atol=1e-6)
+        assert rms[0] < 1e-6
+
+
+def test_plan_query_prefers_cheap_strategies_for_large_templates():
+    assert _native.plan_query(0.3, 1.0)["strategy"] == "procrustes"
+    assert _native.plan_query(0.05, 1.0)["strategy"] == "ransac"
+    small = _native.plan_query(0.005, 1.0)
+    assert small["strategy"] == "max_clique" and small["coarse_points"] > 500
+    assert _native.plan_query(0.005, 1.0, instances=4)["cost"] < small["cost"]
+    assert not _native.plan_query(1e-4, 1.0)["feasible"]
+
+
+def test_cluster_templates_groups_scaled_variants():
+    template = trimesh.creation.torus(0.3, 0.1)
+    descriptors = []
+    for mesh in [template, template.copy().apply_scale(1.02), trimesh.creation.box(), template.copy().apply_scale(0.98)]:
+        points, faces = trimesh.sample.sample_surface_even(mesh, 500, seed=0)
+        descriptors.append(_native.compute_fpfh(points, mesh.face_normals[faces], 0.25))
+
+    family, representatives = _native.cluster_templates(descriptors, max_distance=0.08)
+    assert family.tolist() == [0, 0, 1, 0]
+    assert family[representatives[0]] == 0 and representatives[1] == 2
+
+    family, _ = _native.cluster_templates(descriptors, max_distance=0.08, groups=[0, 1, 0, 0])
+    assert family[1] != family[0] and family[3] == family[0]
+
+
+def test_vocabulary_tree_retrieves_template_from_patch(tmp_path):
+    rng = np.random.default_rng(6)
+    parts = rng.normal(scale=5.0, size=(100, 33))
+    templates = [parts[rng.choice(100, 8)][np.arange(200) % 8] + rng.normal(scale=0.3, size=(200, 33))
+                 for _ in range(20)]
+
+    tree = _native.VocabularyTree(np.concatenate(templates), branching=6, depth=3)
+    for k, descriptors in enumerate(templates):
+        tree.add_document(f"template_{k}", descriptors)
+    tree.save(str(tmp_path / "pack.mmvt"))
+    loaded = _native.VocabularyTree.load(str(tmp_path / "pack.mmvt"))
+    assert loaded.documents == 20 and loaded.words == tree.words
+
+    clutter = parts[rng.choice(100, 100)] + rng.normal(scale=0.3, size=(100, 33))
+    patch = np.concatenate([templates[7][:80], clutter])
+    hits = loaded.query(patch, top_k=3)
+    assert hits[0][0] == "template_7" and hits == tree.query(patch, top_k=3)
+
+
+def test_morton_order_keeps_neighbours_close():
+    rng = np.random.default_rng(7)
+    points = rng.random((5000, 3))
+    order = _native.morton_order(points)
+    np.testing.assert_array_equal(np.sort(order), np.arange(5000))
+
+    def mean_step(p):
+        return np.linalg.norm(np.diff(p, axis=0), axis=1).mean()
+    assert mean_step(points[order]) < 0.2 * mean_step(points)
+
+    # Descriptors are computed on Z-ordered vertices but reported in vertex order
+    from meshmind.core.descriptors import compute_fpfh
+    from meshmind.core.geometry import Mesh
+    sphere = trimesh.creation.icosphere(subdivisions=4)
+    vertices = np.asarray(sphere.vertices)
+    expected = _native.compute_fpfh(vertices, _native.estimate_normals(vertices, 0.1, 30), 0.25, 100)
+    np.testing.assert_allclose(compute_fpfh(Mesh(sphere)), expected, atol=1e-9)
+
+
+def test_transform_batch_matches_numpy():
+    rng = np.random.default_rng(11)
+    transforms = np.tile(np.eye(4), (20, 1, 1))
+    transforms[:, :3, :] = rng.normal(size=(20, 3, 4))
+    for count in (1, 3, 1000):
+        points = rng.normal(size=(count, 3))
+        expected = np.einsum("kij,nj->kni", transforms[:, :3, :3], points) + transforms[:, None, :3, 3]
+        np.testing.assert_allclose(_native.transform_batch(transforms, points), expected, atol=1e-12)
+        single = _native.transform_batch(transforms, points.astype(np.float32))
+        assert single.dtype == np.float32
+        np.testing.assert_allclose(single, expected, atol=1e-4)
+        vectors = _native.transform_batch(transforms, points, vectors=True)
+        np.testing.assert_allclose(vectors, expected - transforms[:, None, :3, 3], atol=1e-12)
+
+
+def test_fpfh_shape(sphere):
+    vertices = np.asarray(sphere.vertices)
+    normals = _native.estimate_normals(vertices, 0.1)
+    features = _native.compute_fpfh(vertices, normals, 0.25)
+    assert features.shape == (len(vertices), 33)
+    np.testing.assert_allclose(np.linalg.norm(normals, axis=1), 1.0)
+
+
+def test_matcher_self_alignment(sphere):
+    matcher = _native.TemplateMatcher(sphere.vertices, sphere.faces)
+    assert matcher.coarse_points.shape == (500, 3)
+    assert matcher.features.shape == (500, 33)
+
+    transform, confidence, mean_dist, cost = matcher.detect(sphere.vertices, sphere.faces)
+    assert transform.shape == (4, 4)
+    assert 0.0 < confidence <= 1.0
+
+
+def test_matcher_boxes_restrict_samples(sphere):
+    boxes = np.array([[0.0, -2.0, -2.0, 2.0, 2.0, 2.0], [-2.0, -2.0, 0.5, 2.0, 2.0, 2.0]])
+    matcher = _native.TemplateMatcher(sphere.vertices, sphere.faces, coarse_points=200, boxes=boxes)
+    points = matcher.coarse_points
+    assert len(points) > 0 and matcher.features.shape == (len(points), 33)
+
+    inside = np.zeros(len(points), dtype=bool)
+    for box in boxes:
+        inside |= np.all((points >= box[:3]) & (points <= box[3:]), axis=1)
+    assert inside.all()
+    assert points[:, 0].min() < 0.0
+
+
+def test_fft_localizer_finds_translated_template():
+    template = trimesh.creation.torus(0.3, 0.1)
+    body = trimesh.creation.box(extents=(4.0, 2.0, 1.0))
+    wheel = template.copy()
+    wheel.apply_translation((1.2, -1.0, -0.3))
+    target = trimesh.util.concatenate([body, wheel])
+
+    localizer = _native.FFTLocalizer(target.vertices, target.faces)
+    translations, scores = localizer.locate(template.vertices, template.faces, max_peaks=2)
+    assert len(translations) >= 1 and scores[0] > 0.8
+    np.testing.assert_allclose(translations[0], (1.2, -1.0, -0.3), atol=2 * localizer.voxel_size)
+
+
+def test_rotation_search_recovers_orientation():
+    template = trimesh.util.concatenate([
+        trimesh.creation.box(extents=(0.4, 0.1, 0.1)),
+        trimesh.creation.box(extents=(0.1, 0.3, 0.1), transform=trimesh.transformations.translation_matrix((-0.15, 0.2, 0))),
+        trimesh.creation.box(extents=(0.1, 0.1, 0.2), transform=trimesh.transformations.translation_matrix((0.15, 0, 0.15))),
+    ])
+    points = template.sample(500)
+    center = points.mean(axis=0)
+    radius = np.linalg.norm(points - center, axis=1).max()
+    rotation = trimesh.transformations.rotation_matrix(1.0, (0.3, 0.5, 0.8))[:3, :3]
+    target = (template.sample(500) - center) @ rotation.T + (2.0, 0.0, 0.0)
+
+    rotations, scores = _native.RotationSearch(points, center, radius).search(target, (2.0, 0.0, 0.0))
+    cos_angle = (np.trace(rotations[0].T @ rotation) - 1.0) / 2.0
+    assert scores[0] > 0.7
+    assert np.degrees(np.arccos(np.clip(cos_angle, -1.0, 1.0))) < 15.0
+
+
+def test_ftetwild_sizing_matches_json(tmp_path):
+    spheres = [{"center": [0.1, 2.0, 1e-05], "radius": 0.5, "size": 0.1 * 0.2}]
+    path = tmp_path / "native.sizing.json"
+    _native.write_ftetwild_sizing(
+        str(path),
+        np.array([s["center"] for s in spheres]),
+        np.array([s["radius"] for s in spheres]),
+        np.array([s["size"] for s in spheres])
+    )
+    assert path.read_text() == json.dumps(spheres, indent=2)
+
+
+def test_meshcnn_matches_numpy(tmp_path, sphere):
+    from meshmind.ml.models.meshcnn import export_native_weights
+    rng = np.random.default_rng(3)
+    state, dims = {}, [3, 64, 128, 256]
+    for i in range(3):
+        state[f"fc{i + 1}.weight"] = rng.normal(size=(dims[i + 1], dims[i])).astype(np.float32) * 0.3
+        state[f"fc{i + 1}.bias"] = rng.normal(size=dims[i + 1]).astype(np.float32) * 0.1
+        state[f"bn{i + 1}.weight"] = rng.random(dims[i + 1]).astype(np.float32) + 0.5
+        state[f"bn{i + 1}.bias"] = rng.normal(size=dims[i + 1]).astype(np.float32) * 0.1
+        state[f"bn{i + 1}.running_mean"] = rng.normal(size=dims[i + 1]).astype(np.float32) * 0.1
+        state[f"bn{i + 1}.running_var"] = rng.random(dims[i + 1]).astype(np.float32) + 0.5
+    path = tmp_path / "meshcnn.mmnn"
+    export_native_weights(state, path)
+
+    x = np.asarray(sphere.vertices, dtype=np.float64)
+    for i in range(1, 4):
+        x = x @ state[f"fc{i}.weight"].T + state[f"fc{i}.bias"]
+        x = (x - state[f"bn{i}.running_mean"]) / np.sqrt(state[f"bn{i}.running_var"] + 1e-5)
+        x = np.maximum(x * state[f"bn{i}.weight"] + state[f"bn{i}.bias"], 0.0)
+    expected = x.max(axis=0)
+
+    model = _native.MeshCNN(str(path))
+    assert model.feature_dim == 256
+    np.testing.assert_allclose(model.extract_features(sphere.vertices), expected, rtol=1e-4, atol=1e-5)
+    batch = model.extract_batch([sphere.vertices, sphere.vertices[:7]])
+    np.testing.assert_allclose(batch[0], expected, rtol=1e-4, atol=1e-5)
+
+
+def test_meshcnn_int8_close_to_float(tmp_path, sphere):
+    from meshmind.ml.models.meshcnn import export_native_weights, calibrate_input_scales
+    rng = np.random.default_rng(4)
+    state, dims = {}, [3, 64, 128, 256]
+    for i in range(3):
+        state[f"fc{i + 1}.weight"] = (rng.normal(size=(dims[i + 1], dims[i])) / np.sqrt(dims[i])).astype(np.float32)
+        state[f"fc{i + 1}.bias"] = rng.normal(size=dims[i + 1]).astype(np.float32) * 0.1
+        state[f"bn{i + 1}.weight"] = rng.random(dims[i + 1]).astype(np.float32) + 0.5
+        state[f"bn{i + 1}.bias"] = rng.normal(size=dims[i + 1]).astype(np.float32) * 0.1
+        state[f"bn{i + 1}.running_mean"] = np.zeros(dims[i + 1], dtype=np.float32)
+        state[f"bn{i + 1}.running_var"] = np.ones(dims[i + 1], dtype=np.float32)
+    scales = calibrate_input_scales(state, [sphere.vertices, trimesh.creation.box().vertices])
+    assert scales[0] == 0.0 and all(s > 0 for s in scales[1:])
+
+    export_native_weights(state, tmp_path / "f.mmnn")
+    export_native_weights(state, tmp_path / "q.mmnn", input_scales=scales)
+    dense, quantized = _native.MeshCNN(str(tmp_path / "f.mmnn")), _native.MeshCNN(str(tmp_path / "q.mmnn"))
+    assert quantized.quantized and not dense.quantized
+
+    expected = dense.extract_features(sphere.vertices)
+    features = quantized.extract_features(sphere.vertices)
+    cosine = features @ expected / (np.linalg.norm(features) * np.linalg.norm(expected))
+    assert cosine > 0.999
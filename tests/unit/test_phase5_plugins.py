@@ -35,3 +35,12 @@ def test_mock_plugin_execution():
     assert len(results) == 1
     assert results[0].feature_id == "mock_plugin_feature"
     assert results[0].confidence == 0.95
+
+def test_native_plugin_discovery_skips_python_modules():
+    from meshmind.discovery.dynamic_loader import load_native_plugins
+    registry = DetectorRegistry()
+    before = dict(registry.list_detectors())
+
+    names = load_native_plugins(os.path.abspath("src/meshmind/plugins/third_party"))
+    assert names == []
+    assert registry.list_detectors() == before